@@ -24,8 +24,8 @@
 /*!
  * Collection of common audio related math functions and buffer operations.
  *
- * Buffer operations are implemented in SSE/Altivec but do also support 
- * unaligned in and output buffers.
+ * Buffer operations are implemented with IPP, vDSP or runtime selected SSE2/AVX2 
+ * kernels, but do also support unaligned in and output buffers.
 !*/
 
 namespace TAudioMath
@@ -184,6 +184,25 @@ namespace TAudioMath
     double*       pDestBinBuffer,
     int           NumberOfBins);
 
+  //! Magnitude, PowerSpectrum and Phase of packed half spectrums, as produced by
+  //! TFftTransformReal. Writes \param NumberOfBins <= FftSize/2 + 1 bins, starting
+  //! at the DC bin. Bin FftSize/2 is the Nyquist bin.
+  void PackedMagnitude(
+    const double* pPackedSpectrum,
+    int           FftSize,
+    double*       pDestBinBuffer,
+    int           NumberOfBins);
+  void PackedPowerSpectrum(
+    const double* pPackedSpectrum,
+    int           FftSize,
+    double*       pDestBinBuffer,
+    int           NumberOfBins);
+  void PackedPhase(
+    const double* pPackedSpectrum,
+    int           FftSize,
+    double*       pDestBinBuffer,
+    int           NumberOfBins);
+
 
   // ... Conversions
 
@@ -81,6 +81,74 @@ private:
 
 // =================================================================================================
 
+/*!
+ * Perform real to complex forward and complex to real inverse DFT transforms.
+ *
+ * Spectrums are stored as "packed" half spectrums with FftSize values:
+ * [0] = Re(DC), [1] = Re(Nyquist), [2*k] = Re(k), [2*k + 1] = Im(k) for
+ * 0 < k < FftSize/2. The imaginary parts of DC and Nyquist bins are always 0.
+ * Use TAudioMath::PackedMagnitude and friends to convert packed spectrums.
+ *
+ * Signs and scaling of the spectrum match TFftTransformComplex, so this is a
+ * drop in replacement for complex transforms of real signals which needs about
+ * half of the processing time and memory.
+!*/
+
+class TFftTransformReal
+{
+public:
+  enum
+  {
+    kDivFwdByN = 1 << 0,
+    kDivInvByN = 1 << 1,
+    kNoDiv     = 1 << 3
+  };
+  typedef int TDivFlags;
+
+  TFftTransformReal();
+  ~TFftTransformReal();
+
+  void Initialize(
+    int       FftSize,
+    TDivFlags Flags = kNoDiv);
+
+  int FftSize()const;
+
+  // internal in-place buffer, used by ForwardInplace() and InverseInplace():
+  // real samples in the time domain, a packed half spectrum in the frequency domain.
+  double* Data();
+
+  // process a real input buffer and write an unpacked half spectrum with
+  // FftSize/2 + 1 bins (DC up to and including Nyquist) into the given buffers
+  void Forward(const double* pRealIn, double* pReOut, double* pImOut);
+
+  // process with internal \function Data() as in and output
+  void ForwardInplace();
+  // process on given external real/packed buffer as in and output
+  void ForwardInplace(double* pData);
+  // process with internal \function Data() as in and output
+  void InverseInplace();
+  // process on given external packed/real buffer as in and output
+  void InverseInplace(double* pData);
+
+private:
+  // private and not implemented.
+  TFftTransformReal(const TFftTransformReal& Other) = delete;
+  TFftTransformReal& operator=(const TFftTransformReal& Other) = delete;
+
+  void Free();
+
+  double* mpProcessedData;
+
+  double* mpTempDoubleBuffer;
+  int* mpTempIntBuffer;
+
+  unsigned int mFftSize;
+  TDivFlags mDivFlags;
+};
+
+// =================================================================================================
+
 /*!
  * Reference complex transform implementation. Use TFftTransformComplex in production instead.
 !*/
@@ -30,6 +30,22 @@ MForceInline double* TFftTransformComplex::Im()
 
 // -------------------------------------------------------------------------------------------------
 
+MForceInline int TFftTransformReal::FftSize()const
+{
+  return (int)mFftSize;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+MForceInline double* TFftTransformReal::Data()
+{
+  return mpProcessedData;
+}
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
 MForceInline double* TFftTransformComplexOouora::Re()
 {
   return mpProcessedReal;
@@ -56,6 +56,10 @@ public:
     TWhiteningType      WhiteningType = kWhiteningAdaptMax,
     float               WhiteningRelaxTime = 1.0f);
 
+  //! Reset the whitening history, to process a new audio stream with the 
+  //! same settings, without reallocating buffers and FFTs.
+  void Reset();
+
   //! Process a single FFT data frame for the given (normalized) mono audio signal.
   const TPolarBuffer* Process(const float* pBuffer);
   const TPolarBuffer* Process(const double* pBuffer);
@@ -89,7 +93,7 @@ private:
 
   TArray<double> mWindowBuffer;
 
-  TFftTransformComplex mFFT;
+  TFftTransformReal mFFT;
 };
 
 // =================================================================================================
@@ -134,6 +138,10 @@ public:
     float               ThresholdMedianSpan = 0.12f,
     float               MinimumGap = 0.06f);
 
+  //! Reset all onset detection function states, to process a new audio stream 
+  //! with the same settings, without reallocating buffers.
+  void Reset();
+
   //! Process a single FFT data frame in the audio signal. Note that processing
   //! assumes that each call to Process() is on a subsequent frame in the same audio stream
   //! to handle multiple streams you must use separate instances!
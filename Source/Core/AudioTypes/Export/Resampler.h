@@ -0,0 +1,113 @@
+#pragma once
+
+#ifndef _Resampler_h_
+#define _Resampler_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/BaseTypes.h"
+#include "CoreTypes/Export/Array.h"
+
+class TResamplerFilter;
+
+// =================================================================================================
+
+/*!
+ * Streaming windowed sinc resampler for mono float buffers.
+ *
+ * Converts between any two sample rates with a polyphase filter: the rate ratio
+ * is reduced to a fraction L/M, and each output sample is a single inner product
+ * of the input with one of the L filter phases. For fractions with a huge L, the
+ * filter phases are quantized and linearly interpolated instead.
+ *
+ * Filter tables only depend on the reduced rate ratio and the quality, so they
+ * are calculated once and are shared by all resamplers in all threads.
+ *
+ * The output is not delayed: dest frame n is the source signal at the time
+ * n * SourceSampleRate / DestSampleRate. A stream of N source frames results
+ * in exactly \function DestFrameCount(N) dest frames, after calling \function
+ * Flush. Source frames can be fed in blocks of arbitrary size.
+ *
+ * Inner products use the fastest dot product kernel the CPU supports, so results
+ * may differ in the last bits between machines with different instruction sets.
+!*/
+
+class TResampler
+{
+public:
+  enum TQuality
+  {
+    kLowQuality,    // 16 zero crossings, 60 dB stop band attenuation
+    kMediumQuality, // 32 zero crossings, 80 dB stop band attenuation
+    kHighQuality,   // 64 zero crossings, 100 dB stop band attenuation
+
+    kNumberOfQualities
+  };
+
+  //! Number of dest frames a stream of \param NumberOfSourceFrames will result in.
+  static long long SDestFrameCount(
+    int       SourceSampleRate,
+    int       DestSampleRate,
+    long long NumberOfSourceFrames);
+
+  TResampler(
+    int       SourceSampleRate,
+    int       DestSampleRate,
+    TQuality  Quality = kHighQuality);
+
+  ~TResampler();
+
+  int SourceSampleRate() const;
+  int DestSampleRate() const;
+  TQuality Quality() const;
+
+  //! Source frames it takes until a source impulse fully appeared in the output.
+  int FilterLength() const;
+
+  //! Number of dest frames this resampler results in for the given stream length.
+  long long DestFrameCount(long long NumberOfSourceFrames) const;
+
+  //! Maximum number of dest frames a single call to \function Process with
+  //! \param NumberOfSourceFrames, or to \function Flush will write.
+  int MaxDestFrames(int NumberOfSourceFrames) const;
+
+  //! Reset the resampler's state, to process a new stream with the same rates.
+  void Reset();
+
+  //! Feed the next block of source frames and write all dest frames which can be
+  //! calculated from the source so far into \param pDestBuffer.
+  //! @return the number of written dest frames: at most MaxDestFrames.
+  int Process(
+    const float*  pSourceBuffer,
+    int           NumberOfSourceFrames,
+    float*        pDestBuffer);
+
+  //! Finish the stream: write all pending dest frames into \param pDestBuffer.
+  //! Call \function Reset before processing a new stream afterwards.
+  //! @return the number of written dest frames: at most MaxDestFrames(0).
+  int Flush(float* pDestBuffer);
+
+private:
+  int ProcessBufferedFrames(float* pDestBuffer, int NumberOfDestFrames);
+
+  const int mSourceSampleRate;
+  const int mDestSampleRate;
+  const TQuality mQuality;
+
+  // shared, cached filter table
+  const TResamplerFilter* mpFilter;
+
+  // source frames, starting at the first frame the next dest frame needs
+  TArray<float> mBuffer;
+  int mBufferedFrames;
+
+  // fractional source position of the next dest frame, in 1/L source frames
+  long long mPhase;
+
+  long long mSourceFramesProcessed;
+  long long mDestFramesProcessed;
+};
+
+
+#endif // _Resampler_h_
+
@@ -4,6 +4,8 @@
 #include "CoreTypes/Export/Log.h"
 #include "CoreTypes/Export/Memory.h"
 
+#include "AudioTypes/Source/AudioMathKernels.h"
+
 #if defined(MHaveIntelIPP)
   #include "../../3rdParty/IPP/Export/IPPs.h"
 #endif
@@ -55,6 +57,17 @@ void TAudioMath::Init()
   #if defined(MHaveIntelIPP)
     TLog::SLog()->AddLine("IPP", "Detected CPU type: 0x%x", (int)::ippGetCpuType());
   #endif
+
+  // select kernels for the buffer operations which are not handled by IPP or vDSP
+  #if !defined(MMac)
+    const TAudioMathKernels::TInstructionSet InstructionSet = 
+      TAudioMathKernels::SBestInstructionSet();
+    
+    TAudioMathKernels::SSelectKernels(InstructionSet);
+
+    TLog::SLog()->AddLine("AudioMath", "Using %s buffer kernels", 
+      TAudioMathKernels::SInstructionSetName(InstructionSet));
+  #endif
 }
 
 
@@ -78,10 +91,8 @@ void TAudioMath::AddBuffer(
     
   #else
     MAssert(NumberOfSamples >= 0, "");
-    for (int i = 0; i < NumberOfSamples; ++i)
-    {
-      pDestBuffer[i] += pSourceBuffer[i];
-    }
+    TAudioMathKernels::SSelectedKernels().mpAddBufferFloat(
+      pSourceBuffer, pDestBuffer, NumberOfSamples);
   #endif
 }
 
@@ -103,10 +114,8 @@ void TAudioMath::AddBuffer(
     
   #else
     MAssert(NumberOfSamples >= 0, "");
-    for (int i = 0; i < NumberOfSamples; ++i)
-    {
-      pDestBuffer[i] += pSourceBuffer[i];
-    }
+    TAudioMathKernels::SSelectedKernels().mpAddBufferDouble(
+      pSourceBuffer, pDestBuffer, NumberOfSamples);
   #endif
 }
 
@@ -173,10 +182,8 @@ void TAudioMath::CopyBufferScaled(
   
   #else
     MAssert(NumberOfSamples >= 0, "");
-    for (int i = 0; i < NumberOfSamples; ++i)
-    {
-      pDestBuffer[i] = pSourceBuffer[i] * ScaleFactor;
-    }
+    TAudioMathKernels::SSelectedKernels().mpCopyBufferScaledFloat(
+      pSourceBuffer, pDestBuffer, NumberOfSamples, ScaleFactor);
   #endif
 }
 
@@ -206,10 +213,8 @@ void TAudioMath::CopyBufferScaled(
   
   #else
     MAssert(NumberOfSamples >= 0, "");
-    for (int i = 0; i < NumberOfSamples; ++i)
-    {
-      pDestBuffer[i] = pSourceBuffer[i] * ScaleFactor;
-    }
+    TAudioMathKernels::SSelectedKernels().mpCopyBufferScaledDouble(
+      pSourceBuffer, pDestBuffer, NumberOfSamples, ScaleFactor);
   #endif
 }
 
@@ -234,10 +239,8 @@ void TAudioMath::MultiplyBuffers(
   
   #else
     MAssert(NumberOfSamples >= 0, "");
-    for (int i = 0; i < NumberOfSamples; ++i)
-    {
-      pDestBuffer[i] = pSourceBufferA[i] * pSourceBufferB[i];
-    }
+    TAudioMathKernels::SSelectedKernels().mpMultiplyBuffersFloat(
+      pSourceBufferA, pSourceBufferB, pDestBuffer, NumberOfSamples);
   #endif
 }
 
@@ -260,10 +263,8 @@ void TAudioMath::MultiplyBuffers(
   
   #else
     MAssert(NumberOfSamples >= 0, "");
-    for (int i = 0; i < NumberOfSamples; ++i)
-    {
-      pDestBuffer[i] = pSourceBufferA[i] * pSourceBufferB[i];
-    }
+    TAudioMathKernels::SSelectedKernels().mpMultiplyBuffersDouble(
+      pSourceBufferA, pSourceBufferB, pDestBuffer, NumberOfSamples);
   #endif
 }
 
@@ -292,10 +293,8 @@ void TAudioMath::ScaleBuffer(
 
   #else
     MAssert(NumberOfSamples >= 0, "");
-    for (int i = 0; i < NumberOfSamples; ++i)
-    {
-      pSourceBuffer[i] *= ScaleFactor;
-    }
+    TAudioMathKernels::SSelectedKernels().mpScaleBufferFloat(
+      pSourceBuffer, NumberOfSamples, ScaleFactor);
   #endif
 }
   
@@ -322,10 +321,8 @@ void TAudioMath::ScaleBuffer(
 
   #else
     MAssert(NumberOfSamples >= 0, "");
-    for (int i = 0; i < NumberOfSamples; ++i)
-    {
-      pSourceBuffer[i] *= ScaleFactor;
-    }
+    TAudioMathKernels::SSelectedKernels().mpScaleBufferDouble(
+      pSourceBuffer, NumberOfSamples, ScaleFactor);
   #endif
 }
 
@@ -356,10 +353,8 @@ void TAudioMath::AddBufferScaled(
     
   #else
     MAssert(NumberOfSamples >= 0, "");
-    for (int i = 0; i < NumberOfSamples; ++i)
-    {
-      pDestBuffer[i] += pSrcBuffer[i] * SrcScaleFactor;
-    }
+    TAudioMathKernels::SSelectedKernels().mpAddBufferScaledFloat(
+      pSrcBuffer, pDestBuffer, NumberOfSamples, SrcScaleFactor);
   #endif
 }
 
@@ -386,10 +381,8 @@ void TAudioMath::AddBufferScaled(
   
   #else
     MAssert(NumberOfSamples >= 0, "");
-    for (int i = 0; i < NumberOfSamples; ++i)
-    {
-      pDestBuffer[i] += pSrcBuffer[i] * SrcScaleFactor;
-    }
+    TAudioMathKernels::SSelectedKernels().mpAddBufferScaledDouble(
+      pSrcBuffer, pDestBuffer, NumberOfSamples, SrcScaleFactor);
   #endif
 }
 
@@ -459,13 +452,8 @@ void TAudioMath::Magnitude(
         
   #else
     MAssert(NumberOfBins > 0, "");
-    for (int i = 0; i < NumberOfBins; i++)
-    {
-      const float Real = *pComplexBufferReal++;
-      const float Imag = *pComplexBufferImag++;
-
-      *pDestBinBuffer++ = ::sqrtf(Real * Real + Imag * Imag);
-    }
+    TAudioMathKernels::SSelectedKernels().mpMagnitudeFloat(
+      pComplexBufferReal, pComplexBufferImag, pDestBinBuffer, NumberOfBins);
   #endif
 }
 
@@ -494,13 +482,8 @@ void TAudioMath::Magnitude(
         
   #else
     MAssert(NumberOfBins > 0, "");
-    for (int i = 0; i < NumberOfBins; i++)
-    {
-      const double Real = *pComplexBufferReal++;
-      const double Imag = *pComplexBufferImag++;
-
-      *pDestBinBuffer++ = ::sqrt(Real * Real + Imag * Imag);
-    }
+    TAudioMathKernels::SSelectedKernels().mpMagnitudeDouble(
+      pComplexBufferReal, pComplexBufferImag, pDestBinBuffer, NumberOfBins);
   #endif
 }
 
@@ -530,13 +513,8 @@ void TAudioMath::PowerSpectrum(
         
   #else
     MAssert(NumberOfBins > 0, "");
-    for (int i = 0; i < NumberOfBins; i++)
-    {
-      const float Real = *pComplexBufferReal++;
-      const float Imag = *pComplexBufferImag++;
-
-      *pDestBinBuffer++ = Real * Real + Imag * Imag;
-    }
+    TAudioMathKernels::SSelectedKernels().mpPowerSpectrumFloat(
+      pComplexBufferReal, pComplexBufferImag, pDestBinBuffer, NumberOfBins);
   #endif
 }
 
@@ -564,13 +542,8 @@ void TAudioMath::PowerSpectrum(
         
   #else
     MAssert(NumberOfBins > 0, "");
-    for (int i = 0; i < NumberOfBins; i++)
-    {
-      const double Real = *pComplexBufferReal++;
-      const double Imag = *pComplexBufferImag++;
-
-      *pDestBinBuffer++ = Real * Real + Imag * Imag;
-    }
+    TAudioMathKernels::SSelectedKernels().mpPowerSpectrumDouble(
+      pComplexBufferReal, pComplexBufferImag, pDestBinBuffer, NumberOfBins);
   #endif
 }
 
@@ -644,3 +617,90 @@ void TAudioMath::Phase(
   #endif
 }
 
+// -------------------------------------------------------------------------------------------------
+
+void TAudioMath::PackedMagnitude(
+  const double* pPackedSpectrum,
+  int           FftSize,
+  double*       pDestBinBuffer,
+  int           NumberOfBins)
+{
+  MAssert(NumberOfBins > 0 && NumberOfBins <= FftSize / 2 + 1, "Invalid bin count");
+
+  const int HalfSize = FftSize / 2;
+  const int NumberOfComplexBins = MMin(NumberOfBins, HalfSize);
+
+  pDestBinBuffer[0] = ::fabs(pPackedSpectrum[0]);
+
+  for (int i = 1; i < NumberOfComplexBins; ++i)
+  {
+    const double Real = pPackedSpectrum[2*i + 0];
+    const double Imag = pPackedSpectrum[2*i + 1];
+
+    pDestBinBuffer[i] = ::sqrt(Real * Real + Imag * Imag);
+  }
+
+  if (NumberOfBins > HalfSize)
+  {
+    pDestBinBuffer[HalfSize] = ::fabs(pPackedSpectrum[1]);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAudioMath::PackedPowerSpectrum(
+  const double* pPackedSpectrum,
+  int           FftSize,
+  double*       pDestBinBuffer,
+  int           NumberOfBins)
+{
+  MAssert(NumberOfBins > 0 && NumberOfBins <= FftSize / 2 + 1, "Invalid bin count");
+
+  const int HalfSize = FftSize / 2;
+  const int NumberOfComplexBins = MMin(NumberOfBins, HalfSize);
+
+  pDestBinBuffer[0] = pPackedSpectrum[0] * pPackedSpectrum[0];
+
+  for (int i = 1; i < NumberOfComplexBins; ++i)
+  {
+    const double Real = pPackedSpectrum[2*i + 0];
+    const double Imag = pPackedSpectrum[2*i + 1];
+
+    pDestBinBuffer[i] = Real * Real + Imag * Imag;
+  }
+
+  if (NumberOfBins > HalfSize)
+  {
+    pDestBinBuffer[HalfSize] = pPackedSpectrum[1] * pPackedSpectrum[1];
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAudioMath::PackedPhase(
+  const double* pPackedSpectrum,
+  int           FftSize,
+  double*       pDestBinBuffer,
+  int           NumberOfBins)
+{
+  MAssert(NumberOfBins > 0 && NumberOfBins <= FftSize / 2 + 1, "Invalid bin count");
+
+  const int HalfSize = FftSize / 2;
+  const int NumberOfComplexBins = MMin(NumberOfBins, HalfSize);
+
+  pDestBinBuffer[0] = ::atan2(0.0, pPackedSpectrum[0]);
+
+  for (int i = 1; i < NumberOfComplexBins; ++i)
+  {
+    const double Real = pPackedSpectrum[2*i + 0];
+    const double Imag = pPackedSpectrum[2*i + 1];
+
+    pDestBinBuffer[i] = ::atan2(Imag, Real);
+  }
+
+  if (NumberOfBins > HalfSize)
+  {
+    pDestBinBuffer[HalfSize] = ::atan2(0.0, pPackedSpectrum[1]);
+  }
+}
+
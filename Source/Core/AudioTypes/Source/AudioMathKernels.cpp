@@ -0,0 +1,720 @@
+#include "AudioTypesPrecompiledHeader.h"
+
+#include "CoreTypes/Export/Cpu.h"
+
+#include "AudioTypes/Source/AudioMathKernels.h"
+
+#if defined(MArch_X86) || defined(MArch_X64)
+  #include <emmintrin.h>
+  #include <immintrin.h>
+#endif
+
+#include <cmath>
+
+// =================================================================================================
+
+#if defined(MArch_X86) || defined(MArch_X64)
+  #define MHaveSse2Kernels
+
+  // AVX2 kernels are compiled per function, so the rest of the library
+  // still runs on CPUs without AVX
+  #if defined(MCompiler_GCC)
+    #define MHaveAvx2Kernels
+    #define MAvx2Kernel __attribute__((target("avx2")))
+  #elif defined(MCompiler_VisualCPP)
+    #define MHaveAvx2Kernels
+    #define MAvx2Kernel
+  #endif
+#endif
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+template <typename T>
+static void SScalarAddBuffer(const T* pSrc, T* pDest, int NumberOfSamples)
+{
+  for (int i = 0; i < NumberOfSamples; ++i)
+  {
+    pDest[i] += pSrc[i];
+  }
+}
+
+template <typename T>
+static void SScalarScaleBuffer(T* pBuffer, int NumberOfSamples, T Scale)
+{
+  for (int i = 0; i < NumberOfSamples; ++i)
+  {
+    pBuffer[i] *= Scale;
+  }
+}
+
+template <typename T>
+static void SScalarAddBufferScaled(const T* pSrc, T* pDest, int NumberOfSamples, T Scale)
+{
+  for (int i = 0; i < NumberOfSamples; ++i)
+  {
+    pDest[i] += pSrc[i] * Scale;
+  }
+}
+
+template <typename T>
+static void SScalarCopyBufferScaled(const T* pSrc, T* pDest, int NumberOfSamples, T Scale)
+{
+  for (int i = 0; i < NumberOfSamples; ++i)
+  {
+    pDest[i] = pSrc[i] * Scale;
+  }
+}
+
+template <typename T>
+static void SScalarMultiplyBuffers(const T* pSrcA, const T* pSrcB, T* pDest, int NumberOfSamples)
+{
+  for (int i = 0; i < NumberOfSamples; ++i)
+  {
+    pDest[i] = pSrcA[i] * pSrcB[i];
+  }
+}
+
+template <typename T>
+static void SScalarMagnitude(const T* pRe, const T* pIm, T* pDest, int NumberOfBins)
+{
+  for (int i = 0; i < NumberOfBins; ++i)
+  {
+    pDest[i] = std::sqrt(pRe[i] * pRe[i] + pIm[i] * pIm[i]);
+  }
+}
+
+template <typename T>
+static void SScalarPowerSpectrum(const T* pRe, const T* pIm, T* pDest, int NumberOfBins)
+{
+  for (int i = 0; i < NumberOfBins; ++i)
+  {
+    pDest[i] = pRe[i] * pRe[i] + pIm[i] * pIm[i];
+  }
+}
+
+template <typename T>
+static T SScalarDotProduct(const T* pSrcA, const T* pSrcB, int NumberOfSamples)
+{
+  T Sum = (T)0;
+  for (int i = 0; i < NumberOfSamples; ++i)
+  {
+    Sum += pSrcA[i] * pSrcB[i];
+  }
+  return Sum;
+}
+
+// =================================================================================================
+
+#if defined(MHaveSse2Kernels)
+
+// -------------------------------------------------------------------------------------------------
+
+static void SSse2AddBufferFloat(const float* pSrc, float* pDest, int NumberOfSamples)
+{
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm_storeu_ps(pDest + i, _mm_add_ps(_mm_loadu_ps(pDest + i), _mm_loadu_ps(pSrc + i)));
+  }
+  SScalarAddBuffer(pSrc + i, pDest + i, NumberOfSamples - i);
+}
+
+static void SSse2AddBufferDouble(const double* pSrc, double* pDest, int NumberOfSamples)
+{
+  int i = 0;
+  for (; i + 2 <= NumberOfSamples; i += 2)
+  {
+    _mm_storeu_pd(pDest + i, _mm_add_pd(_mm_loadu_pd(pDest + i), _mm_loadu_pd(pSrc + i)));
+  }
+  SScalarAddBuffer(pSrc + i, pDest + i, NumberOfSamples - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void SSse2ScaleBufferFloat(float* pBuffer, int NumberOfSamples, float Scale)
+{
+  const __m128 ScaleVector = _mm_set1_ps(Scale);
+
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm_storeu_ps(pBuffer + i, _mm_mul_ps(_mm_loadu_ps(pBuffer + i), ScaleVector));
+  }
+  SScalarScaleBuffer(pBuffer + i, NumberOfSamples - i, Scale);
+}
+
+static void SSse2ScaleBufferDouble(double* pBuffer, int NumberOfSamples, double Scale)
+{
+  const __m128d ScaleVector = _mm_set1_pd(Scale);
+
+  int i = 0;
+  for (; i + 2 <= NumberOfSamples; i += 2)
+  {
+    _mm_storeu_pd(pBuffer + i, _mm_mul_pd(_mm_loadu_pd(pBuffer + i), ScaleVector));
+  }
+  SScalarScaleBuffer(pBuffer + i, NumberOfSamples - i, Scale);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void SSse2AddBufferScaledFloat(
+  const float* pSrc, float* pDest, int NumberOfSamples, float Scale)
+{
+  const __m128 ScaleVector = _mm_set1_ps(Scale);
+
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm_storeu_ps(pDest + i, _mm_add_ps(_mm_loadu_ps(pDest + i),
+      _mm_mul_ps(_mm_loadu_ps(pSrc + i), ScaleVector)));
+  }
+  SScalarAddBufferScaled(pSrc + i, pDest + i, NumberOfSamples - i, Scale);
+}
+
+static void SSse2AddBufferScaledDouble(
+  const double* pSrc, double* pDest, int NumberOfSamples, double Scale)
+{
+  const __m128d ScaleVector = _mm_set1_pd(Scale);
+
+  int i = 0;
+  for (; i + 2 <= NumberOfSamples; i += 2)
+  {
+    _mm_storeu_pd(pDest + i, _mm_add_pd(_mm_loadu_pd(pDest + i),
+      _mm_mul_pd(_mm_loadu_pd(pSrc + i), ScaleVector)));
+  }
+  SScalarAddBufferScaled(pSrc + i, pDest + i, NumberOfSamples - i, Scale);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void SSse2CopyBufferScaledFloat(
+  const float* pSrc, float* pDest, int NumberOfSamples, float Scale)
+{
+  const __m128 ScaleVector = _mm_set1_ps(Scale);
+
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm_storeu_ps(pDest + i, _mm_mul_ps(_mm_loadu_ps(pSrc + i), ScaleVector));
+  }
+  SScalarCopyBufferScaled(pSrc + i, pDest + i, NumberOfSamples - i, Scale);
+}
+
+static void SSse2CopyBufferScaledDouble(
+  const double* pSrc, double* pDest, int NumberOfSamples, double Scale)
+{
+  const __m128d ScaleVector = _mm_set1_pd(Scale);
+
+  int i = 0;
+  for (; i + 2 <= NumberOfSamples; i += 2)
+  {
+    _mm_storeu_pd(pDest + i, _mm_mul_pd(_mm_loadu_pd(pSrc + i), ScaleVector));
+  }
+  SScalarCopyBufferScaled(pSrc + i, pDest + i, NumberOfSamples - i, Scale);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void SSse2MultiplyBuffersFloat(
+  const float* pSrcA, const float* pSrcB, float* pDest, int NumberOfSamples)
+{
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm_storeu_ps(pDest + i, _mm_mul_ps(_mm_loadu_ps(pSrcA + i), _mm_loadu_ps(pSrcB + i)));
+  }
+  SScalarMultiplyBuffers(pSrcA + i, pSrcB + i, pDest + i, NumberOfSamples - i);
+}
+
+static void SSse2MultiplyBuffersDouble(
+  const double* pSrcA, const double* pSrcB, double* pDest, int NumberOfSamples)
+{
+  int i = 0;
+  for (; i + 2 <= NumberOfSamples; i += 2)
+  {
+    _mm_storeu_pd(pDest + i, _mm_mul_pd(_mm_loadu_pd(pSrcA + i), _mm_loadu_pd(pSrcB + i)));
+  }
+  SScalarMultiplyBuffers(pSrcA + i, pSrcB + i, pDest + i, NumberOfSamples - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void SSse2PowerSpectrumFloat(
+  const float* pRe, const float* pIm, float* pDest, int NumberOfBins)
+{
+  int i = 0;
+  for (; i + 4 <= NumberOfBins; i += 4)
+  {
+    const __m128 Re = _mm_loadu_ps(pRe + i);
+    const __m128 Im = _mm_loadu_ps(pIm + i);
+    _mm_storeu_ps(pDest + i, _mm_add_ps(_mm_mul_ps(Re, Re), _mm_mul_ps(Im, Im)));
+  }
+  SScalarPowerSpectrum(pRe + i, pIm + i, pDest + i, NumberOfBins - i);
+}
+
+static void SSse2PowerSpectrumDouble(
+  const double* pRe, const double* pIm, double* pDest, int NumberOfBins)
+{
+  int i = 0;
+  for (; i + 2 <= NumberOfBins; i += 2)
+  {
+    const __m128d Re = _mm_loadu_pd(pRe + i);
+    const __m128d Im = _mm_loadu_pd(pIm + i);
+    _mm_storeu_pd(pDest + i, _mm_add_pd(_mm_mul_pd(Re, Re), _mm_mul_pd(Im, Im)));
+  }
+  SScalarPowerSpectrum(pRe + i, pIm + i, pDest + i, NumberOfBins - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void SSse2MagnitudeFloat(
+  const float* pRe, const float* pIm, float* pDest, int NumberOfBins)
+{
+  int i = 0;
+  for (; i + 4 <= NumberOfBins; i += 4)
+  {
+    const __m128 Re = _mm_loadu_ps(pRe + i);
+    const __m128 Im = _mm_loadu_ps(pIm + i);
+    _mm_storeu_ps(pDest + i,
+      _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(Re, Re), _mm_mul_ps(Im, Im))));
+  }
+  SScalarMagnitude(pRe + i, pIm + i, pDest + i, NumberOfBins - i);
+}
+
+static void SSse2MagnitudeDouble(
+  const double* pRe, const double* pIm, double* pDest, int NumberOfBins)
+{
+  int i = 0;
+  for (; i + 2 <= NumberOfBins; i += 2)
+  {
+    const __m128d Re = _mm_loadu_pd(pRe + i);
+    const __m128d Im = _mm_loadu_pd(pIm + i);
+    _mm_storeu_pd(pDest + i,
+      _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(Re, Re), _mm_mul_pd(Im, Im))));
+  }
+  SScalarMagnitude(pRe + i, pIm + i, pDest + i, NumberOfBins - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static float SSse2DotProductFloat(
+  const float* pSrcA, const float* pSrcB, int NumberOfSamples)
+{
+  // two accumulators to hide the add latency
+  __m128 Sum0 = _mm_setzero_ps();
+  __m128 Sum1 = _mm_setzero_ps();
+
+  int i = 0;
+  for (; i + 8 <= NumberOfSamples; i += 8)
+  {
+    Sum0 = _mm_add_ps(Sum0, _mm_mul_ps(_mm_loadu_ps(pSrcA + i), _mm_loadu_ps(pSrcB + i)));
+    Sum1 = _mm_add_ps(Sum1, _mm_mul_ps(_mm_loadu_ps(pSrcA + i + 4), _mm_loadu_ps(pSrcB + i + 4)));
+  }
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    Sum0 = _mm_add_ps(Sum0, _mm_mul_ps(_mm_loadu_ps(pSrcA + i), _mm_loadu_ps(pSrcB + i)));
+  }
+
+  Sum0 = _mm_add_ps(Sum0, Sum1);
+  Sum0 = _mm_add_ps(Sum0, _mm_movehl_ps(Sum0, Sum0));
+  Sum0 = _mm_add_ss(Sum0, _mm_shuffle_ps(Sum0, Sum0, 0x55));
+
+  return _mm_cvtss_f32(Sum0) + 
+    SScalarDotProduct(pSrcA + i, pSrcB + i, NumberOfSamples - i);
+}
+
+#endif // defined(MHaveSse2Kernels)
+
+// =================================================================================================
+
+#if defined(MHaveAvx2Kernels)
+
+// -------------------------------------------------------------------------------------------------
+
+MAvx2Kernel static void SAvx2AddBufferFloat(
+  const float* pSrc, float* pDest, int NumberOfSamples)
+{
+  int i = 0;
+  for (; i + 8 <= NumberOfSamples; i += 8)
+  {
+    _mm256_storeu_ps(pDest + i,
+      _mm256_add_ps(_mm256_loadu_ps(pDest + i), _mm256_loadu_ps(pSrc + i)));
+  }
+  SScalarAddBuffer(pSrc + i, pDest + i, NumberOfSamples - i);
+}
+
+MAvx2Kernel static void SAvx2AddBufferDouble(
+  const double* pSrc, double* pDest, int NumberOfSamples)
+{
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm256_storeu_pd(pDest + i,
+      _mm256_add_pd(_mm256_loadu_pd(pDest + i), _mm256_loadu_pd(pSrc + i)));
+  }
+  SScalarAddBuffer(pSrc + i, pDest + i, NumberOfSamples - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+MAvx2Kernel static void SAvx2ScaleBufferFloat(
+  float* pBuffer, int NumberOfSamples, float Scale)
+{
+  const __m256 ScaleVector = _mm256_set1_ps(Scale);
+
+  int i = 0;
+  for (; i + 8 <= NumberOfSamples; i += 8)
+  {
+    _mm256_storeu_ps(pBuffer + i, _mm256_mul_ps(_mm256_loadu_ps(pBuffer + i), ScaleVector));
+  }
+  SScalarScaleBuffer(pBuffer + i, NumberOfSamples - i, Scale);
+}
+
+MAvx2Kernel static void SAvx2ScaleBufferDouble(
+  double* pBuffer, int NumberOfSamples, double Scale)
+{
+  const __m256d ScaleVector = _mm256_set1_pd(Scale);
+
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm256_storeu_pd(pBuffer + i, _mm256_mul_pd(_mm256_loadu_pd(pBuffer + i), ScaleVector));
+  }
+  SScalarScaleBuffer(pBuffer + i, NumberOfSamples - i, Scale);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+MAvx2Kernel static void SAvx2AddBufferScaledFloat(
+  const float* pSrc, float* pDest, int NumberOfSamples, float Scale)
+{
+  const __m256 ScaleVector = _mm256_set1_ps(Scale);
+
+  int i = 0;
+  for (; i + 8 <= NumberOfSamples; i += 8)
+  {
+    _mm256_storeu_ps(pDest + i, _mm256_add_ps(_mm256_loadu_ps(pDest + i),
+      _mm256_mul_ps(_mm256_loadu_ps(pSrc + i), ScaleVector)));
+  }
+  SScalarAddBufferScaled(pSrc + i, pDest + i, NumberOfSamples - i, Scale);
+}
+
+MAvx2Kernel static void SAvx2AddBufferScaledDouble(
+  const double* pSrc, double* pDest, int NumberOfSamples, double Scale)
+{
+  const __m256d ScaleVector = _mm256_set1_pd(Scale);
+
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm256_storeu_pd(pDest + i, _mm256_add_pd(_mm256_loadu_pd(pDest + i),
+      _mm256_mul_pd(_mm256_loadu_pd(pSrc + i), ScaleVector)));
+  }
+  SScalarAddBufferScaled(pSrc + i, pDest + i, NumberOfSamples - i, Scale);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+MAvx2Kernel static void SAvx2CopyBufferScaledFloat(
+  const float* pSrc, float* pDest, int NumberOfSamples, float Scale)
+{
+  const __m256 ScaleVector = _mm256_set1_ps(Scale);
+
+  int i = 0;
+  for (; i + 8 <= NumberOfSamples; i += 8)
+  {
+    _mm256_storeu_ps(pDest + i, _mm256_mul_ps(_mm256_loadu_ps(pSrc + i), ScaleVector));
+  }
+  SScalarCopyBufferScaled(pSrc + i, pDest + i, NumberOfSamples - i, Scale);
+}
+
+MAvx2Kernel static void SAvx2CopyBufferScaledDouble(
+  const double* pSrc, double* pDest, int NumberOfSamples, double Scale)
+{
+  const __m256d ScaleVector = _mm256_set1_pd(Scale);
+
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm256_storeu_pd(pDest + i, _mm256_mul_pd(_mm256_loadu_pd(pSrc + i), ScaleVector));
+  }
+  SScalarCopyBufferScaled(pSrc + i, pDest + i, NumberOfSamples - i, Scale);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+MAvx2Kernel static void SAvx2MultiplyBuffersFloat(
+  const float* pSrcA, const float* pSrcB, float* pDest, int NumberOfSamples)
+{
+  int i = 0;
+  for (; i + 8 <= NumberOfSamples; i += 8)
+  {
+    _mm256_storeu_ps(pDest + i,
+      _mm256_mul_ps(_mm256_loadu_ps(pSrcA + i), _mm256_loadu_ps(pSrcB + i)));
+  }
+  SScalarMultiplyBuffers(pSrcA + i, pSrcB + i, pDest + i, NumberOfSamples - i);
+}
+
+MAvx2Kernel static void SAvx2MultiplyBuffersDouble(
+  const double* pSrcA, const double* pSrcB, double* pDest, int NumberOfSamples)
+{
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm256_storeu_pd(pDest + i,
+      _mm256_mul_pd(_mm256_loadu_pd(pSrcA + i), _mm256_loadu_pd(pSrcB + i)));
+  }
+  SScalarMultiplyBuffers(pSrcA + i, pSrcB + i, pDest + i, NumberOfSamples - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+MAvx2Kernel static void SAvx2PowerSpectrumFloat(
+  const float* pRe, const float* pIm, float* pDest, int NumberOfBins)
+{
+  int i = 0;
+  for (; i + 8 <= NumberOfBins; i += 8)
+  {
+    const __m256 Re = _mm256_loadu_ps(pRe + i);
+    const __m256 Im = _mm256_loadu_ps(pIm + i);
+    _mm256_storeu_ps(pDest + i, _mm256_add_ps(_mm256_mul_ps(Re, Re), _mm256_mul_ps(Im, Im)));
+  }
+  SScalarPowerSpectrum(pRe + i, pIm + i, pDest + i, NumberOfBins - i);
+}
+
+MAvx2Kernel static void SAvx2PowerSpectrumDouble(
+  const double* pRe, const double* pIm, double* pDest, int NumberOfBins)
+{
+  int i = 0;
+  for (; i + 4 <= NumberOfBins; i += 4)
+  {
+    const __m256d Re = _mm256_loadu_pd(pRe + i);
+    const __m256d Im = _mm256_loadu_pd(pIm + i);
+    _mm256_storeu_pd(pDest + i, _mm256_add_pd(_mm256_mul_pd(Re, Re), _mm256_mul_pd(Im, Im)));
+  }
+  SScalarPowerSpectrum(pRe + i, pIm + i, pDest + i, NumberOfBins - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+MAvx2Kernel static void SAvx2MagnitudeFloat(
+  const float* pRe, const float* pIm, float* pDest, int NumberOfBins)
+{
+  int i = 0;
+  for (; i + 8 <= NumberOfBins; i += 8)
+  {
+    const __m256 Re = _mm256_loadu_ps(pRe + i);
+    const __m256 Im = _mm256_loadu_ps(pIm + i);
+    _mm256_storeu_ps(pDest + i,
+      _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(Re, Re), _mm256_mul_ps(Im, Im))));
+  }
+  SScalarMagnitude(pRe + i, pIm + i, pDest + i, NumberOfBins - i);
+}
+
+MAvx2Kernel static void SAvx2MagnitudeDouble(
+  const double* pRe, const double* pIm, double* pDest, int NumberOfBins)
+{
+  int i = 0;
+  for (; i + 4 <= NumberOfBins; i += 4)
+  {
+    const __m256d Re = _mm256_loadu_pd(pRe + i);
+    const __m256d Im = _mm256_loadu_pd(pIm + i);
+    _mm256_storeu_pd(pDest + i,
+      _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(Re, Re), _mm256_mul_pd(Im, Im))));
+  }
+  SScalarMagnitude(pRe + i, pIm + i, pDest + i, NumberOfBins - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+MAvx2Kernel static float SAvx2DotProductFloat(
+  const float* pSrcA, const float* pSrcB, int NumberOfSamples)
+{
+  // two accumulators to hide the add latency
+  __m256 Sum0 = _mm256_setzero_ps();
+  __m256 Sum1 = _mm256_setzero_ps();
+
+  int i = 0;
+  for (; i + 16 <= NumberOfSamples; i += 16)
+  {
+    Sum0 = _mm256_add_ps(Sum0, 
+      _mm256_mul_ps(_mm256_loadu_ps(pSrcA + i), _mm256_loadu_ps(pSrcB + i)));
+    Sum1 = _mm256_add_ps(Sum1, 
+      _mm256_mul_ps(_mm256_loadu_ps(pSrcA + i + 8), _mm256_loadu_ps(pSrcB + i + 8)));
+  }
+  for (; i + 8 <= NumberOfSamples; i += 8)
+  {
+    Sum0 = _mm256_add_ps(Sum0, 
+      _mm256_mul_ps(_mm256_loadu_ps(pSrcA + i), _mm256_loadu_ps(pSrcB + i)));
+  }
+
+  Sum0 = _mm256_add_ps(Sum0, Sum1);
+  __m128 Sum = _mm_add_ps(_mm256_castps256_ps128(Sum0), _mm256_extractf128_ps(Sum0, 1));
+  Sum = _mm_add_ps(Sum, _mm_movehl_ps(Sum, Sum));
+  Sum = _mm_add_ss(Sum, _mm_shuffle_ps(Sum, Sum, 0x55));
+
+  return _mm_cvtss_f32(Sum) + 
+    SScalarDotProduct(pSrcA + i, pSrcB + i, NumberOfSamples - i);
+}
+
+#endif // defined(MHaveAvx2Kernels)
+
+// =================================================================================================
+
+static const TAudioMathKernels sScalarKernels =
+{
+  TAudioMathKernels::kScalar,
+  SScalarAddBuffer<float>, SScalarAddBuffer<double>,
+  SScalarScaleBuffer<float>, SScalarScaleBuffer<double>,
+  SScalarAddBufferScaled<float>, SScalarAddBufferScaled<double>,
+  SScalarCopyBufferScaled<float>, SScalarCopyBufferScaled<double>,
+  SScalarMultiplyBuffers<float>, SScalarMultiplyBuffers<double>,
+  SScalarMagnitude<float>, SScalarMagnitude<double>,
+  SScalarPowerSpectrum<float>, SScalarPowerSpectrum<double>,
+  SScalarDotProduct<float>
+};
+
+#if defined(MHaveSse2Kernels)
+
+static const TAudioMathKernels sSse2Kernels =
+{
+  TAudioMathKernels::kSse2,
+  SSse2AddBufferFloat, SSse2AddBufferDouble,
+  SSse2ScaleBufferFloat, SSse2ScaleBufferDouble,
+  SSse2AddBufferScaledFloat, SSse2AddBufferScaledDouble,
+  SSse2CopyBufferScaledFloat, SSse2CopyBufferScaledDouble,
+  SSse2MultiplyBuffersFloat, SSse2MultiplyBuffersDouble,
+  SSse2MagnitudeFloat, SSse2MagnitudeDouble,
+  SSse2PowerSpectrumFloat, SSse2PowerSpectrumDouble,
+  SSse2DotProductFloat
+};
+
+#endif
+
+#if defined(MHaveAvx2Kernels)
+
+static const TAudioMathKernels sAvx2Kernels =
+{
+  TAudioMathKernels::kAvx2,
+  SAvx2AddBufferFloat, SAvx2AddBufferDouble,
+  SAvx2ScaleBufferFloat, SAvx2ScaleBufferDouble,
+  SAvx2AddBufferScaledFloat, SAvx2AddBufferScaledDouble,
+  SAvx2CopyBufferScaledFloat, SAvx2CopyBufferScaledDouble,
+  SAvx2MultiplyBuffersFloat, SAvx2MultiplyBuffersDouble,
+  SAvx2MagnitudeFloat, SAvx2MagnitudeDouble,
+  SAvx2PowerSpectrumFloat, SAvx2PowerSpectrumDouble,
+  SAvx2DotProductFloat
+};
+
+#endif
+
+// selected kernels: set once in TAudioMath::Init
+static const TAudioMathKernels* spSelectedKernels = &sScalarKernels;
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+const char* TAudioMathKernels::SInstructionSetName(TInstructionSet InstructionSet)
+{
+  switch (InstructionSet)
+  {
+  case kScalar:
+    return "Scalar";
+  case kSse2:
+    return "SSE2";
+  case kAvx2:
+    return "AVX2";
+
+  default:
+    MInvalid("Unknown instruction set");
+    return "Unknown";
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TAudioMathKernels::SIsSupported(TInstructionSet InstructionSet)
+{
+  switch (InstructionSet)
+  {
+  case kScalar:
+    return true;
+
+  case kSse2:
+    #if defined(MHaveSse2Kernels)
+      return (TCpu::Caps() & TCpu::kSse2) != 0;
+    #else
+      return false;
+    #endif
+
+  case kAvx2:
+    #if defined(MHaveAvx2Kernels)
+      return (TCpu::Caps() & TCpu::kAvx2) != 0;
+    #else
+      return false;
+    #endif
+
+  default:
+    MInvalid("Unknown instruction set");
+    return false;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TAudioMathKernels::TInstructionSet TAudioMathKernels::SBestInstructionSet()
+{
+  if (SIsSupported(kAvx2))
+  {
+    return kAvx2;
+  }
+  else if (SIsSupported(kSse2))
+  {
+    return kSse2;
+  }
+  else
+  {
+    return kScalar;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+const TAudioMathKernels& TAudioMathKernels::SKernels(TInstructionSet InstructionSet)
+{
+  MAssert(SIsSupported(InstructionSet), "Instruction set is not supported");
+
+  switch (InstructionSet)
+  {
+  #if defined(MHaveSse2Kernels)
+    case kSse2:
+      return sSse2Kernels;
+  #endif
+
+  #if defined(MHaveAvx2Kernels)
+    case kAvx2:
+      return sAvx2Kernels;
+  #endif
+
+  default:
+    return sScalarKernels;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+const TAudioMathKernels& TAudioMathKernels::SSelectedKernels()
+{
+  return *spSelectedKernels;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAudioMathKernels::SSelectKernels(TInstructionSet InstructionSet)
+{
+  spSelectedKernels = &SKernels(InstructionSet);
+}
+
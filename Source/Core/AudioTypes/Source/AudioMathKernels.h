@@ -0,0 +1,74 @@
+#pragma once
+
+#ifndef _AudioMathKernels_h_
+#define _AudioMathKernels_h_
+
+// =================================================================================================
+
+/*!
+ * Scalar, SSE2 and AVX2 implementations of TAudioMath's buffer operations,
+ * used in builds which have neither IPP nor the Accelerate framework, and of
+ * the inner products of TResampler's polyphase filters.
+ *
+ * TAudioMath::Init selects the best kernels for the running CPU via TCpu::Caps().
+ * All kernels support unaligned in and output buffers.
+!*/
+
+struct TAudioMathKernels
+{
+  enum TInstructionSet
+  {
+    kScalar,
+    kSse2,
+    kAvx2,
+
+    kNumberOfInstructionSets
+  };
+
+  //! name of the given instruction set, for logging
+  static const char* SInstructionSetName(TInstructionSet InstructionSet);
+
+  //! true when the instruction set got compiled in and is supported by the CPU
+  static bool SIsSupported(TInstructionSet InstructionSet);
+  //! the best instruction set that is supported by the running CPU
+  static TInstructionSet SBestInstructionSet();
+
+  //! kernels for the given, supported instruction set
+  static const TAudioMathKernels& SKernels(TInstructionSet InstructionSet);
+
+  //! kernels that are currently used by TAudioMath (scalar until selected)
+  static const TAudioMathKernels& SSelectedKernels();
+  static void SSelectKernels(TInstructionSet InstructionSet);
+
+
+  TInstructionSet mInstructionSet;
+
+  void (*mpAddBufferFloat)(const float* pSrc, float* pDest, int NumberOfSamples);
+  void (*mpAddBufferDouble)(const double* pSrc, double* pDest, int NumberOfSamples);
+
+  void (*mpScaleBufferFloat)(float* pBuffer, int NumberOfSamples, float Scale);
+  void (*mpScaleBufferDouble)(double* pBuffer, int NumberOfSamples, double Scale);
+
+  void (*mpAddBufferScaledFloat)(const float* pSrc, float* pDest, int NumberOfSamples, float Scale);
+  void (*mpAddBufferScaledDouble)(const double* pSrc, double* pDest, int NumberOfSamples, double Scale);
+
+  void (*mpCopyBufferScaledFloat)(const float* pSrc, float* pDest, int NumberOfSamples, float Scale);
+  void (*mpCopyBufferScaledDouble)(const double* pSrc, double* pDest, int NumberOfSamples, double Scale);
+
+  void (*mpMultiplyBuffersFloat)(const float* pSrcA, const float* pSrcB, float* pDest, int NumberOfSamples);
+  void (*mpMultiplyBuffersDouble)(const double* pSrcA, const double* pSrcB, double* pDest, int NumberOfSamples);
+
+  void (*mpMagnitudeFloat)(const float* pRe, const float* pIm, float* pDest, int NumberOfBins);
+  void (*mpMagnitudeDouble)(const double* pRe, const double* pIm, double* pDest, int NumberOfBins);
+
+  void (*mpPowerSpectrumFloat)(const float* pRe, const float* pIm, float* pDest, int NumberOfBins);
+  void (*mpPowerSpectrumDouble)(const double* pRe, const double* pIm, double* pDest, int NumberOfBins);
+
+  // NB: the SIMD variants sum in a different order than the scalar one, so results
+  // depend on the instruction set the CPU supports and are not bit-identical across machines
+  float (*mpDotProductFloat)(const float* pSrcA, const float* pSrcB, int NumberOfSamples);
+};
+
+
+#endif // _AudioMathKernels_h_
+
@@ -18,6 +18,7 @@
 #include "AudioTypes/Export/Envelopes.h"
 #include "AudioTypes/Export/SampleBuffers.h"
 #include "AudioTypes/Export/OnsetDetector.h"
+#include "AudioTypes/Export/Resampler.h"
 
 
 #endif // _AudioTypesPrecompiledHeader_h_
@@ -341,6 +341,148 @@ void TFftTransformComplex::InverseInplace(double* pRe, double* pIm)
 
 // -------------------------------------------------------------------------------------------------
 
+TFftTransformReal::TFftTransformReal()
+  : mFftSize(0)
+  , mDivFlags(0)
+  , mpProcessedData(NULL)
+  , mpTempDoubleBuffer(NULL)
+  , mpTempIntBuffer(NULL)
+{
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TFftTransformReal::~TFftTransformReal()
+{
+  Free();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFftTransformReal::Initialize(
+  int       FftSize,
+  TDivFlags Flags)
+{
+  Free();
+
+  MAssert(FftSize > 4 && TMath::IsPowerOfTwo(FftSize), "Invalid fft size");
+
+  mDivFlags = Flags;
+  mFftSize = FftSize;
+
+  // Ooura's rdft needs n/2 cos/sin table and 2 + sqrt(n/2) bit reversal entries
+  mpTempDoubleBuffer = TAlignedAllocator<double>::SNew(FftSize / 2);
+
+  mpTempIntBuffer = TAlignedAllocator<int>::SNew(FftSize / 2 + 2);
+  mpTempIntBuffer[0] = 0;
+
+  mpProcessedData = TAlignedAllocator<double>::SNew(FftSize);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFftTransformReal::Free()
+{
+  TAlignedAllocator<double>::SDelete(mpTempDoubleBuffer, mFftSize / 2);
+  mpTempDoubleBuffer = NULL;
+
+  TAlignedAllocator<int>::SDelete(mpTempIntBuffer, mFftSize / 2 + 2);
+  mpTempIntBuffer = NULL;
+
+  TAlignedAllocator<double>::SDelete(mpProcessedData, mFftSize);
+  mpProcessedData = NULL;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFftTransformReal::Forward(
+  const double* pRealIn,
+  double*       pReOut,
+  double*       pImOut)
+{
+  TAudioMath::CopyBuffer(pRealIn, mpProcessedData, mFftSize);
+
+  ForwardInplace();
+
+  const unsigned int HalfSize = mFftSize / 2;
+
+  pReOut[0] = mpProcessedData[0];
+  pImOut[0] = 0.0;
+
+  for (unsigned int i = 1; i < HalfSize; ++i)
+  {
+    pReOut[i] = mpProcessedData[2*i + 0];
+    pImOut[i] = mpProcessedData[2*i + 1];
+  }
+
+  pReOut[HalfSize] = mpProcessedData[1];
+  pImOut[HalfSize] = 0.0;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFftTransformReal::ForwardInplace()
+{
+  ForwardInplace(mpProcessedData);
+}
+
+void TFftTransformReal::ForwardInplace(double* pData)
+{
+  #if defined(MArch_X86) || defined(MArch_X64)
+    const TAudioMath::TDisableSseDenormals DisableDenormals;
+  #endif
+
+  M__DisableFloatingPointAssertions
+
+  ::ooura_rdft(
+    mFftSize,
+    1,
+    pData,
+    mpTempIntBuffer,
+    mpTempDoubleBuffer);
+
+  if (mDivFlags & kDivFwdByN)
+  {
+    const double ScaleFactor = 1.0 / mFftSize;
+    TAudioMath::ScaleBuffer(pData, mFftSize, ScaleFactor);
+  }
+
+  M__EnableFloatingPointAssertions
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFftTransformReal::InverseInplace()
+{
+  InverseInplace(mpProcessedData);
+}
+
+void TFftTransformReal::InverseInplace(double* pData)
+{
+  #if defined(MArch_X86) || defined(MArch_X64)
+    const TAudioMath::TDisableSseDenormals DisableDenormals;
+  #endif
+
+  M__DisableFloatingPointAssertions
+
+  ::ooura_rdft(
+    mFftSize,
+    -1,
+    pData,
+    mpTempIntBuffer,
+    mpTempDoubleBuffer);
+
+  // Ooura's inverse rdft scales by N/2: apply div options relative to that
+  const double ScaleFactor = (mDivFlags & kDivInvByN) ? 2.0 / mFftSize : 2.0;
+  TAudioMath::ScaleBuffer(pData, mFftSize, ScaleFactor);
+
+  M__EnableFloatingPointAssertions
+}
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
 TFftTransformComplexOouora::TFftTransformComplexOouora()
   : mFftSize(0)
   , mDivFlags(0)
@@ -49,8 +49,7 @@ TOnsetFftProcessor::TOnsetFftProcessor(
   MAssert(WhiteningRelaxTime >= 0.0f, "Invalid relax time");
 
   // Initialize the FFT transform
-  const bool HighQuality = true;
-  mFFT.Initialize(mFftsize, HighQuality, TFftTransformComplex::kNoDiv);
+  mFFT.Initialize(mFftsize, TFftTransformReal::kNoDiv);
 
   // Calculate window coefs
   mWindowBuffer.SetSize(mFftsize);
@@ -59,20 +58,32 @@ TOnsetFftProcessor::TOnsetFftProcessor(
   // Allocate whitening history
   const unsigned int RealNumBins = mNumbins + 2;
   mPsp.SetSize(RealNumBins);
+
+  // Allocate polar buffer
+  mPolarBuffer.mBin.SetSize(mNumbins);
+
+  // Default settings for Adaptive Whitening, user can set own values after init
+  SetRelaxTime(WhiteningRelaxTime);
+
+  // Clear whitening history and polar buffer
+  Reset();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TOnsetFftProcessor::Reset()
+{
+  // Reset whitening history
   mPsp.Init(0.0f);
 
   // Reset polar buffer
   mPolarBuffer.mDC = 0;
   mPolarBuffer.mNyquist = 0;
-  mPolarBuffer.mBin.SetSize(mNumbins);
   for (unsigned int i = 0; i < mNumbins; ++i) 
   {
     mPolarBuffer.mBin[i].mMagn = 0;
     mPolarBuffer.mBin[i].mPhase = 0;
   }
-  
-  // Default settings for Adaptive Whitening, user can set own values after init
-  SetRelaxTime(WhiteningRelaxTime);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -116,10 +127,8 @@ void TOnsetFftProcessor::LoadFrame(const double* pBuffer)
 {
   // ... copy and window the data
 
-  TAudioMath::CopyBuffer(pBuffer, mFFT.Re(), mFftsize);
-  TAudioMath::MultiplyBuffers(mWindowBuffer.FirstRead(), mFFT.Re(), mFFT.Re(), mFftsize);
-
-  TAudioMath::ClearBuffer(mFFT.Im(), mFftsize);
+  TAudioMath::CopyBuffer(pBuffer, mFFT.Data(), mFftsize);
+  TAudioMath::MultiplyBuffers(mWindowBuffer.FirstRead(), mFFT.Data(), mFFT.Data(), mFftsize);
 
 
   // ... do the FFT
@@ -133,20 +142,20 @@ void TOnsetFftProcessor::LoadFrame(const double* pBuffer)
     TAllocaArray<double> Magnitude(mNumbins);
     MInitAllocaArray(Magnitude);
 
-    TAudioMath::Magnitude(mFFT.Re(), mFFT.Im(),
+    TAudioMath::PackedMagnitude(mFFT.Data(), mFftsize,
       Magnitude.FirstWrite(), mNumbins);
 
     TAllocaArray<double> Phase(mNumbins);
     MInitAllocaArray(Phase);
 
-    TAudioMath::Phase(mFFT.Re(), mFFT.Im(),
+    TAudioMath::PackedPhase(mFFT.Data(), mFftsize,
       Phase.FirstWrite(), mNumbins);
 
-    mPolarBuffer.mDC = (float)mFFT.Re()[0];
+    mPolarBuffer.mDC = (float)mFFT.Data()[0];
     MUnDenormalize(mPolarBuffer.mDC);
 
-    mPolarBuffer.mNyquist = (float)mFFT.Im()[0];
-    MUnDenormalize(mPolarBuffer.mNyquist);
+    // NB: this is the imaginary part of the DC bin, which is 0 for real input
+    mPolarBuffer.mNyquist = 0.0f;
 
     for (unsigned int i = 0; i < mNumbins; i++)
     {
@@ -353,6 +362,19 @@ TOnsetDetector::TOnsetDetector(
 
 // -------------------------------------------------------------------------------------------------
 
+void TOnsetDetector::Reset()
+{
+  mGapLeft = 0;
+
+  mOdfvalpost = 0.0f;
+  mOdfvalpostprev = 0.0f;
+
+  mpOdfvals.Init(0.0f);
+  mpOther.Init(0.0f);
+}
+
+// -------------------------------------------------------------------------------------------------
+
 float TOnsetDetector::CurrentOdfValue()const  
 { 
   return mOdfvalpost; 
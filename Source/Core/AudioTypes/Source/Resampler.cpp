@@ -0,0 +1,420 @@
+#include "AudioTypesPrecompiledHeader.h"
+
+#include "CoreTypes/Export/Memory.h"
+
+#include "AudioTypes/Export/Resampler.h"
+#include "AudioTypes/Source/AudioMathKernels.h"
+
+#include <cmath>
+#include <mutex>
+#include <memory>
+#include <vector>
+
+// =================================================================================================
+
+// max number of filter phases in a table. Rate ratios with more phases use
+// linearly interpolated, quantized phases.
+#define MMaxResamplerFilterPhases 512
+
+// =================================================================================================
+
+namespace
+{
+  struct TResamplerQualitySettings
+  {
+    int mZeroCrossings;   // sinc zero crossings on each side, at the source rate
+    double mAttenuation;  // Kaiser window stop band attenuation in dB
+    double mRolloff;      // cutoff, relative to the lower rate's Nyquist frequency
+  };
+
+  // the rolloffs place the Kaiser transition bands just below the Nyquist frequency
+  const TResamplerQualitySettings sQualitySettings[TResampler::kNumberOfQualities] =
+  {
+    {  8,  60.0, 0.78 },  // kLowQuality
+    { 16,  80.0, 0.86 },  // kMediumQuality
+    { 32, 100.0, 0.90 }   // kHighQuality
+  };
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static long long SGreatestCommonDivisor(long long a, long long b)
+{
+  while (b != 0)
+  {
+    const long long t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static double SZeroOrderBessel(double x)
+{
+  double d = 0.0;
+  double ds = 1.0;
+  double s = 1.0;
+  do
+  {
+    d += 2.0;
+    ds *= (x * x) / (d * d);
+    s += ds;
+  }
+  while (ds > s * 1e-12);
+  return s;
+}
+
+// =================================================================================================
+
+/*!
+ * Polyphase filter table of a TResampler: L + 1 (or MMaxResamplerFilterPhases + 1)
+ * rows of kaiser windowed sinc coefficients for the fractional source positions
+ * 0/L, 1/L ... L/L. The last row is used to interpolate quantized phases only.
+!*/
+
+class TResamplerFilter
+{
+public:
+  TResamplerFilter(
+    long long           InterpolationFactor,
+    long long           DecimationFactor,
+    TResampler::TQuality Quality)
+    : mInterpolationFactor(InterpolationFactor),
+      mDecimationFactor(DecimationFactor),
+      mQuality(Quality)
+  {
+    const TResamplerQualitySettings& Settings = sQualitySettings[Quality];
+
+    // when downsampling, the cutoff is the dest rate's Nyquist frequency:
+    // stretch the filter to keep the number of zero crossings
+    const double Ratio = MMin(1.0,
+      (double)InterpolationFactor / (double)DecimationFactor);
+
+    const double Cutoff = Settings.mRolloff * Ratio;
+
+    mHalfLength = (int)::ceil(Settings.mZeroCrossings / Ratio);
+    mLength = 2 * mHalfLength;
+
+    mNumberOfPhases = (int)MMin<long long>(InterpolationFactor,
+      MMaxResamplerFilterPhases);
+
+    mCoefficients.SetSize((mNumberOfPhases + 1) * mLength);
+
+    const double Alpha = 0.1102 * (Settings.mAttenuation - 8.7);
+    const double AlphaBessel = SZeroOrderBessel(Alpha);
+
+    for (int p = 0; p <= mNumberOfPhases; ++p)
+    {
+      float* pPhase = mCoefficients.FirstWrite() + p * mLength;
+      const double Fraction = (double)p / (double)mNumberOfPhases;
+
+      double Sum = 0.0;
+      for (int j = 0; j < mLength; ++j)
+      {
+        // distance of the tap's source frame to the dest position
+        const double t = Fraction + (mHalfLength - 1 - j);
+        const double r = t / mHalfLength;
+
+        double Value = 0.0;
+        if (r > -1.0 && r < 1.0)
+        {
+          const double x = MPi * Cutoff * t;
+          const double Sinc = (x == 0.0) ? 1.0 : ::sin(x) / x;
+
+          Value = Cutoff * Sinc *
+            SZeroOrderBessel(Alpha * ::sqrt(1.0 - r * r)) / AlphaBessel;
+        }
+
+        pPhase[j] = (float)Value;
+        Sum += Value;
+      }
+
+      // normalize each phase to unity DC gain
+      for (int j = 0; j < mLength; ++j)
+      {
+        pPhase[j] = (float)(pPhase[j] / Sum);
+      }
+    }
+  }
+
+  //! coefficients of the given phase: mLength values
+  const float* Phase(int Phase) const
+  {
+    return mCoefficients.FirstRead() + Phase * mLength;
+  }
+
+  const long long mInterpolationFactor; // L
+  const long long mDecimationFactor;    // M
+  const TResampler::TQuality mQuality;
+
+  int mHalfLength;
+  int mLength;
+  int mNumberOfPhases;
+
+  TArray<float> mCoefficients;
+};
+
+// -------------------------------------------------------------------------------------------------
+
+// Get or create the shared filter table for the given rates and quality.
+// Tables are kept until the process exits.
+
+static const TResamplerFilter* SSharedResamplerFilter(
+  int                   SourceSampleRate,
+  int                   DestSampleRate,
+  TResampler::TQuality  Quality)
+{
+  static std::mutex sLock;
+  static std::vector< std::unique_ptr<TResamplerFilter> > sFilters;
+
+  const long long Divisor = SGreatestCommonDivisor(SourceSampleRate, DestSampleRate);
+
+  const long long InterpolationFactor = DestSampleRate / Divisor;
+  const long long DecimationFactor = SourceSampleRate / Divisor;
+
+  const std::lock_guard<std::mutex> Lock(sLock);
+
+  for (size_t i = 0; i < sFilters.size(); ++i)
+  {
+    if (sFilters[i]->mInterpolationFactor == InterpolationFactor &&
+        sFilters[i]->mDecimationFactor == DecimationFactor &&
+        sFilters[i]->mQuality == Quality)
+    {
+      return sFilters[i].get();
+    }
+  }
+
+  sFilters.emplace_back(new TResamplerFilter(
+    InterpolationFactor, DecimationFactor, Quality));
+
+  return sFilters.back().get();
+}
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+long long TResampler::SDestFrameCount(
+  int       SourceSampleRate,
+  int       DestSampleRate,
+  long long NumberOfSourceFrames)
+{
+  MAssert(SourceSampleRate > 0 && DestSampleRate > 0, "Invalid sample rates");
+
+  const long long Divisor = SGreatestCommonDivisor(SourceSampleRate, DestSampleRate);
+
+  const long long InterpolationFactor = DestSampleRate / Divisor;
+  const long long DecimationFactor = SourceSampleRate / Divisor;
+
+  // number of dest frames at source positions < NumberOfSourceFrames
+  return (NumberOfSourceFrames * InterpolationFactor + DecimationFactor - 1) /
+    DecimationFactor;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TResampler::TResampler(
+  int       SourceSampleRate,
+  int       DestSampleRate,
+  TQuality  Quality)
+  : mSourceSampleRate(SourceSampleRate),
+    mDestSampleRate(DestSampleRate),
+    mQuality(Quality),
+    mpFilter(NULL),
+    mBufferedFrames(0),
+    mPhase(0),
+    mSourceFramesProcessed(0),
+    mDestFramesProcessed(0)
+{
+  MAssert(SourceSampleRate > 0 && DestSampleRate > 0, "Invalid sample rates");
+  MAssert(Quality >= 0 && Quality < kNumberOfQualities, "Invalid quality");
+
+  mpFilter = SSharedResamplerFilter(SourceSampleRate, DestSampleRate, Quality);
+
+  Reset();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TResampler::~TResampler()
+{
+  // nothing to do: filters are shared
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TResampler::SourceSampleRate() const
+{
+  return mSourceSampleRate;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TResampler::DestSampleRate() const
+{
+  return mDestSampleRate;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TResampler::TQuality TResampler::Quality() const
+{
+  return mQuality;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TResampler::FilterLength() const
+{
+  return mpFilter->mLength;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+long long TResampler::DestFrameCount(long long NumberOfSourceFrames) const
+{
+  return (NumberOfSourceFrames * mpFilter->mInterpolationFactor +
+    mpFilter->mDecimationFactor - 1) / mpFilter->mDecimationFactor;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TResampler::MaxDestFrames(int NumberOfSourceFrames) const
+{
+  // up to mLength frames may be buffered from previous calls
+  return (int)((NumberOfSourceFrames + mpFilter->mLength) *
+    mpFilter->mInterpolationFactor / mpFilter->mDecimationFactor) + 1;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TResampler::Reset()
+{
+  // start with a silent history, so the first dest frame is at source frame 0
+  mBufferedFrames = mpFilter->mHalfLength - 1;
+
+  mBuffer.Grow(mpFilter->mLength + mBufferedFrames);
+  TAudioMath::ClearBuffer(mBuffer.FirstWrite(), mBufferedFrames);
+
+  mPhase = 0;
+
+  mSourceFramesProcessed = 0;
+  mDestFramesProcessed = 0;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TResampler::Process(
+  const float*  pSourceBuffer,
+  int           NumberOfSourceFrames,
+  float*        pDestBuffer)
+{
+  MAssert(NumberOfSourceFrames >= 0, "Invalid frame count");
+
+  mBuffer.Grow(mBufferedFrames + NumberOfSourceFrames);
+  TMemory::Copy(mBuffer.FirstWrite() + mBufferedFrames, pSourceBuffer,
+    NumberOfSourceFrames * sizeof(float));
+
+  mBufferedFrames += NumberOfSourceFrames;
+  mSourceFramesProcessed += NumberOfSourceFrames;
+
+  return ProcessBufferedFrames(pDestBuffer, MaxDestFrames(NumberOfSourceFrames));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TResampler::Flush(float* pDestBuffer)
+{
+  // pad with silence, so the filters of all pending dest frames are complete
+  const int PaddingFrames = mpFilter->mHalfLength;
+
+  mBuffer.Grow(mBufferedFrames + PaddingFrames);
+  TAudioMath::ClearBuffer(mBuffer.FirstWrite() + mBufferedFrames, PaddingFrames);
+
+  mBufferedFrames += PaddingFrames;
+
+  const int PendingDestFrames = (int)(
+    DestFrameCount(mSourceFramesProcessed) - mDestFramesProcessed);
+
+  return ProcessBufferedFrames(pDestBuffer, PendingDestFrames);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TResampler::ProcessBufferedFrames(float* pDestBuffer, int NumberOfDestFrames)
+{
+  #if defined(MArch_X86) || defined(MArch_X64)
+    const TAudioMath::TDisableSseDenormals DisableDenormals;
+  #endif
+
+  float (* const pDotProduct)(const float*, const float*, int) =
+    TAudioMathKernels::SSelectedKernels().mpDotProductFloat;
+
+  const int FilterLength = mpFilter->mLength;
+  const int NumberOfPhases = mpFilter->mNumberOfPhases;
+
+  const long long InterpolationFactor = mpFilter->mInterpolationFactor;
+  const long long DecimationFactor = mpFilter->mDecimationFactor;
+
+  const bool InterpolatePhases = (NumberOfPhases != InterpolationFactor);
+
+  // mBuffer starts at the first source frame of the next dest frame's filter
+  const float* pBuffer = mBuffer.FirstRead();
+  int BufferOffset = 0;
+
+  int DestFramesWritten = 0;
+  while (DestFramesWritten < NumberOfDestFrames &&
+         BufferOffset + FilterLength <= mBufferedFrames)
+  {
+    if (InterpolatePhases)
+    {
+      const double PhasePosition = (double)mPhase *
+        NumberOfPhases / InterpolationFactor;
+
+      const int Phase = (int)PhasePosition;
+      const float Fraction = (float)(PhasePosition - Phase);
+
+      const float a = pDotProduct(mpFilter->Phase(Phase),
+        pBuffer + BufferOffset, FilterLength);
+      const float b = pDotProduct(mpFilter->Phase(Phase + 1),
+        pBuffer + BufferOffset, FilterLength);
+
+      pDestBuffer[DestFramesWritten++] = a + (b - a) * Fraction;
+    }
+    else
+    {
+      pDestBuffer[DestFramesWritten++] = pDotProduct(
+        mpFilter->Phase((int)mPhase), pBuffer + BufferOffset, FilterLength);
+    }
+
+    // advance by M / L source frames. This never exceeds the filter length,
+    // so BufferOffset stays within the buffered frames.
+    mPhase += DecimationFactor;
+
+    const long long SourceFrames = mPhase / InterpolationFactor;
+    mPhase -= SourceFrames * InterpolationFactor;
+
+    BufferOffset += (int)SourceFrames;
+  }
+
+  mDestFramesProcessed += DestFramesWritten;
+
+  // drop source frames which are no longer needed
+  if (BufferOffset > 0)
+  {
+    const int RemainingFrames = mBufferedFrames - BufferOffset;
+
+    if (RemainingFrames > 0)
+    {
+      TMemory::Move(mBuffer.FirstWrite(), mBuffer.FirstRead() + BufferOffset,
+        RemainingFrames * sizeof(float));
+    }
+
+    mBufferedFrames = RemainingFrames;
+  }
+
+  return DestFramesWritten;
+}
+
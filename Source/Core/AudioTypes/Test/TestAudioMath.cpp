@@ -0,0 +1,224 @@
+#include "AudioTypesPrecompiledHeader.h"
+
+#include "CoreTypes/Export/InlineMath.h"
+#include "CoreTypes/Export/TestHelpers.h"
+#include "CoreTypes/Export/Timer.h"
+
+#include "AudioTypes/Source/AudioMathKernels.h"
+#include "AudioTypes/Test/TestAudioMath.h"
+
+#include <sstream>
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+template <typename T>
+static void SFillRandom(TArray<T>& Buffer)
+{
+  for (int i = 0; i < Buffer.Size(); ++i)
+  {
+    Buffer[i] = (T)(((double)TMath::RandFloat() - 0.5) * 2.0);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <typename T>
+static void SCheckKernels(
+  const TAudioMathKernels&  Kernels,
+  const TAudioMathKernels&  ScalarKernels,
+  void (*const TAudioMathKernels::*pAddBuffer)(const T*, T*, int),
+  void (*const TAudioMathKernels::*pScaleBuffer)(T*, int, T),
+  void (*const TAudioMathKernels::*pAddBufferScaled)(const T*, T*, int, T),
+  void (*const TAudioMathKernels::*pCopyBufferScaled)(const T*, T*, int, T),
+  void (*const TAudioMathKernels::*pMultiplyBuffers)(const T*, const T*, T*, int),
+  void (*const TAudioMathKernels::*pMagnitude)(const T*, const T*, T*, int),
+  void (*const TAudioMathKernels::*pPowerSpectrum)(const T*, const T*, T*, int))
+{
+  // odd size and offset: test unaligned buffers and remainders
+  const int Size = 1027;
+  const int Offset = 1;
+
+  TArray<T> SourceA(Size + Offset), SourceB(Size + Offset);
+  SFillRandom(SourceA);
+  SFillRandom(SourceB);
+
+  TArray<T> Expected(Size + Offset), Result(Size + Offset);
+
+  const T* pA = SourceA.FirstRead() + Offset;
+  const T* pB = SourceB.FirstRead() + Offset;
+  T* pExpected = Expected.FirstWrite() + Offset;
+  T* pResult = Result.FirstWrite() + Offset;
+
+  const T Epsilon = (T)0.00001;
+
+  Expected = SourceB; Result = SourceB;
+  (ScalarKernels.*pAddBuffer)(pA, pExpected, Size);
+  (Kernels.*pAddBuffer)(pA, pResult, Size);
+  BOOST_CHECK_ARRAYS_EQUAL_EPSILON(pExpected, Size, pResult, Size, Epsilon);
+
+  Expected = SourceA; Result = SourceA;
+  (ScalarKernels.*pScaleBuffer)(pExpected, Size, (T)0.75);
+  (Kernels.*pScaleBuffer)(pResult, Size, (T)0.75);
+  BOOST_CHECK_ARRAYS_EQUAL_EPSILON(pExpected, Size, pResult, Size, Epsilon);
+
+  Expected = SourceB; Result = SourceB;
+  (ScalarKernels.*pAddBufferScaled)(pA, pExpected, Size, (T)-0.5);
+  (Kernels.*pAddBufferScaled)(pA, pResult, Size, (T)-0.5);
+  BOOST_CHECK_ARRAYS_EQUAL_EPSILON(pExpected, Size, pResult, Size, Epsilon);
+
+  (ScalarKernels.*pCopyBufferScaled)(pA, pExpected, Size, (T)2.0);
+  (Kernels.*pCopyBufferScaled)(pA, pResult, Size, (T)2.0);
+  BOOST_CHECK_ARRAYS_EQUAL_EPSILON(pExpected, Size, pResult, Size, Epsilon);
+
+  (ScalarKernels.*pMultiplyBuffers)(pA, pB, pExpected, Size);
+  (Kernels.*pMultiplyBuffers)(pA, pB, pResult, Size);
+  BOOST_CHECK_ARRAYS_EQUAL_EPSILON(pExpected, Size, pResult, Size, Epsilon);
+
+  (ScalarKernels.*pMagnitude)(pA, pB, pExpected, Size);
+  (Kernels.*pMagnitude)(pA, pB, pResult, Size);
+  BOOST_CHECK_ARRAYS_EQUAL_EPSILON(pExpected, Size, pResult, Size, Epsilon);
+
+  (ScalarKernels.*pPowerSpectrum)(pA, pB, pExpected, Size);
+  (Kernels.*pPowerSpectrum)(pA, pB, pResult, Size);
+  BOOST_CHECK_ARRAYS_EQUAL_EPSILON(pExpected, Size, pResult, Size, Epsilon);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAudioTypesTest::AudioMath()
+{
+  const TAudioMathKernels& ScalarKernels = 
+    TAudioMathKernels::SKernels(TAudioMathKernels::kScalar);
+
+  for (int i = 0; i < TAudioMathKernels::kNumberOfInstructionSets; ++i)
+  {
+    const TAudioMathKernels::TInstructionSet InstructionSet = 
+      (TAudioMathKernels::TInstructionSet)i;
+
+    if (!TAudioMathKernels::SIsSupported(InstructionSet))
+    {
+      BOOST_TEST_MESSAGE("    Skipping unsupported " << 
+        TAudioMathKernels::SInstructionSetName(InstructionSet) << " kernels");
+      continue;
+    }
+
+    const TAudioMathKernels& Kernels = TAudioMathKernels::SKernels(InstructionSet);
+    BOOST_CHECK_EQUAL((int)Kernels.mInstructionSet, i);
+
+    SCheckKernels<float>(Kernels, ScalarKernels,
+      &TAudioMathKernels::mpAddBufferFloat,
+      &TAudioMathKernels::mpScaleBufferFloat,
+      &TAudioMathKernels::mpAddBufferScaledFloat,
+      &TAudioMathKernels::mpCopyBufferScaledFloat,
+      &TAudioMathKernels::mpMultiplyBuffersFloat,
+      &TAudioMathKernels::mpMagnitudeFloat,
+      &TAudioMathKernels::mpPowerSpectrumFloat);
+
+    SCheckKernels<double>(Kernels, ScalarKernels,
+      &TAudioMathKernels::mpAddBufferDouble,
+      &TAudioMathKernels::mpScaleBufferDouble,
+      &TAudioMathKernels::mpAddBufferScaledDouble,
+      &TAudioMathKernels::mpCopyBufferScaledDouble,
+      &TAudioMathKernels::mpMultiplyBuffersDouble,
+      &TAudioMathKernels::mpMagnitudeDouble,
+      &TAudioMathKernels::mpPowerSpectrumDouble);
+
+    // dot products: summation order differs, so compare with a relative epsilon
+    TArray<float> SourceA(1027), SourceB(1027);
+    SFillRandom(SourceA);
+    SFillRandom(SourceB);
+
+    const int DotProductSizes[] = { 0, 3, 17, 64, 1026 };
+    for (size_t s = 0; s < MCountOf(DotProductSizes); ++s)
+    {
+      const float Expected = ScalarKernels.mpDotProductFloat(
+        SourceA.FirstRead() + 1, SourceB.FirstRead() + 1, DotProductSizes[s]);
+      const float Result = Kernels.mpDotProductFloat(
+        SourceA.FirstRead() + 1, SourceB.FirstRead() + 1, DotProductSizes[s]);
+
+      BOOST_CHECK(TMathT<float>::Abs(Expected - Result) <= 
+        0.0001f * MMax(1.0f, TMathT<float>::Abs(Expected)));
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAudioTypesTest::AudioMathBenchmark()
+{
+  // ... Compare kernel speeds against the scalar implementation
+
+  const int Size = 4096;
+  const int NumberOfIterations = 2000;
+
+  TArray<float> SourceFloatA(Size), SourceFloatB(Size), DestFloat(Size);
+  SFillRandom(SourceFloatA);
+  SFillRandom(SourceFloatB);
+
+  TArray<double> SourceDoubleA(Size), SourceDoubleB(Size), DestDouble(Size);
+  SFillRandom(SourceDoubleA);
+  SFillRandom(SourceDoubleB);
+
+  double ScalarTimes[2] = { 0.0, 0.0 };
+
+  for (int i = 0; i < TAudioMathKernels::kNumberOfInstructionSets; ++i)
+  {
+    const TAudioMathKernels::TInstructionSet InstructionSet = 
+      (TAudioMathKernels::TInstructionSet)i;
+
+    if (!TAudioMathKernels::SIsSupported(InstructionSet))
+    {
+      continue;
+    }
+
+    const TAudioMathKernels& Kernels = TAudioMathKernels::SKernels(InstructionSet);
+
+    // float: multiply, magnitude and add scaled (window, spectrum, mix)
+    TStamp FloatTime;
+    for (int n = 0; n < NumberOfIterations; ++n)
+    {
+      Kernels.mpMultiplyBuffersFloat(SourceFloatA.FirstRead(), 
+        SourceFloatB.FirstRead(), DestFloat.FirstWrite(), Size);
+      Kernels.mpMagnitudeFloat(SourceFloatA.FirstRead(), 
+        SourceFloatB.FirstRead(), DestFloat.FirstWrite(), Size);
+      Kernels.mpAddBufferScaledFloat(SourceFloatA.FirstRead(), 
+        DestFloat.FirstWrite(), Size, 0.5f);
+    }
+    const double FloatTimeInMs = FloatTime.DiffInMs();
+
+    // double: same as above
+    TStamp DoubleTime;
+    for (int n = 0; n < NumberOfIterations; ++n)
+    {
+      Kernels.mpMultiplyBuffersDouble(SourceDoubleA.FirstRead(), 
+        SourceDoubleB.FirstRead(), DestDouble.FirstWrite(), Size);
+      Kernels.mpMagnitudeDouble(SourceDoubleA.FirstRead(), 
+        SourceDoubleB.FirstRead(), DestDouble.FirstWrite(), Size);
+      Kernels.mpAddBufferScaledDouble(SourceDoubleA.FirstRead(), 
+        DestDouble.FirstWrite(), Size, 0.5);
+    }
+    const double DoubleTimeInMs = DoubleTime.DiffInMs();
+
+    if (InstructionSet == TAudioMathKernels::kScalar)
+    {
+      ScalarTimes[0] = FloatTimeInMs;
+      ScalarTimes[1] = DoubleTimeInMs;
+    }
+
+    std::stringstream Message;
+    Message.precision(2);
+    Message << std::fixed << "    " << 
+      TAudioMathKernels::SInstructionSetName(InstructionSet) << " kernels: " << 
+      "float " << FloatTimeInMs << " ms (x" << 
+        ScalarTimes[0] / MMax(FloatTimeInMs, 0.001) << "), " <<
+      "double " << DoubleTimeInMs << " ms (x" << 
+        ScalarTimes[1] / MMax(DoubleTimeInMs, 0.001) << ")";
+
+    BOOST_TEST_MESSAGE(Message.str());
+  }
+
+  BOOST_CHECK(true);
+}
+
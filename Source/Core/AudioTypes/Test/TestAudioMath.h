@@ -0,0 +1,16 @@
+#pragma once
+
+#ifndef _TestAudioMath_h_
+#define _TestAudioMath_h_
+
+// =================================================================================================
+
+namespace TAudioTypesTest
+{
+  void AudioMath();
+  void AudioMathBenchmark();
+}
+
+
+#endif // _TestAudioMath_h_
+
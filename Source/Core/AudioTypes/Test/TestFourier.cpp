@@ -81,4 +81,79 @@ void TAudioTypesTest::Fourier()
       BufferOouoraRe, sFftSize,
       0.0001);
   }
+
+  // . Real
+  {
+    constexpr int sNumberOfBins = sFftSize / 2 + 1;
+
+    double BufferOouoraRe[sFftSize];
+    double BufferOouoraIm[sFftSize];
+    double BufferPacked[sFftSize];
+
+    TFftTransformComplexOouora FftTransformComplexOouora;
+    FftTransformComplexOouora.Initialize(sFftSize, true, TFftTransformComplex::kDivFwdByN);
+
+    TFftTransformReal FftTransformReal;
+    FftTransformReal.Initialize(sFftSize, TFftTransformReal::kDivFwdByN);
+
+    TAudioMath::CopyBuffer(TestData, BufferOouoraRe, sFftSize);
+    TAudioMath::ClearBuffer(BufferOouoraIm, sFftSize);
+
+    TAudioMath::CopyBuffer(TestData, BufferPacked, sFftSize);
+
+    // forward transform
+    FftTransformComplexOouora.ForwardInplace(BufferOouoraRe, BufferOouoraIm);
+    FftTransformReal.ForwardInplace(BufferPacked);
+
+    // check if the unpacked half spectrum matches the complex transform
+    double BufferRe[sNumberOfBins];
+    double BufferIm[sNumberOfBins];
+    FftTransformReal.Forward(TestData, BufferRe, BufferIm);
+
+    BOOST_CHECK_ARRAYS_EQUAL_EPSILON(
+      BufferOouoraRe, sNumberOfBins,
+      BufferRe, sNumberOfBins,
+      0.0001);
+
+    BOOST_CHECK_ARRAYS_EQUAL_EPSILON(
+      BufferOouoraIm, sNumberOfBins,
+      BufferIm, sNumberOfBins,
+      0.0001);
+
+    // check packed magnitude and power spectrum helpers
+    double MagnitudeOouora[sNumberOfBins];
+    TAudioMath::Magnitude(BufferOouoraRe, BufferOouoraIm, 
+      MagnitudeOouora, sNumberOfBins);
+
+    double Magnitude[sNumberOfBins];
+    TAudioMath::PackedMagnitude(BufferPacked, sFftSize, 
+      Magnitude, sNumberOfBins);
+
+    BOOST_CHECK_ARRAYS_EQUAL_EPSILON(
+      MagnitudeOouora, sNumberOfBins,
+      Magnitude, sNumberOfBins,
+      0.0001);
+
+    double PowerOouora[sNumberOfBins];
+    TAudioMath::PowerSpectrum(BufferOouoraRe, BufferOouoraIm, 
+      PowerOouora, sNumberOfBins);
+
+    double Power[sNumberOfBins];
+    TAudioMath::PackedPowerSpectrum(BufferPacked, sFftSize, 
+      Power, sNumberOfBins);
+
+    BOOST_CHECK_ARRAYS_EQUAL_EPSILON(
+      PowerOouora, sNumberOfBins,
+      Power, sNumberOfBins,
+      0.0001);
+
+    // inverse transform (forward already got scaled by 1/N): 
+    // check if we got the original signal again
+    FftTransformReal.InverseInplace(BufferPacked);
+
+    BOOST_CHECK_ARRAYS_EQUAL_EPSILON(
+      TestDataCopy, sFftSize,
+      BufferPacked, sFftSize,
+      0.0001);
+  }
  }
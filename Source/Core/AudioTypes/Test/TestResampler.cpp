@@ -0,0 +1,106 @@
+#include "AudioTypesPrecompiledHeader.h"
+
+#include "CoreTypes/Export/InlineMath.h"
+#include "CoreTypes/Export/TestHelpers.h"
+
+#include "AudioTypes/Export/Resampler.h"
+#include "AudioTypes/Test/TestResampler.h"
+
+#include <cmath>
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+// Resample a sine in one go and in randomly sized blocks, and check the output
+// length, that both results are the same, and the error to the ideal sine.
+
+static void SCheckResampler(
+  int                   SourceSampleRate,
+  int                   DestSampleRate,
+  TResampler::TQuality  Quality,
+  double                MinSignalToNoiseInDb)
+{
+  const int NumberOfSourceFrames = 20000;
+  const double Frequency = 1000.0;
+
+  TArray<float> SourceBuffer(NumberOfSourceFrames);
+  for (int i = 0; i < NumberOfSourceFrames; ++i)
+  {
+    SourceBuffer[i] = (float)::sin(2.0 * MPi * Frequency * i / SourceSampleRate);
+  }
+
+  TResampler Resampler(SourceSampleRate, DestSampleRate, Quality);
+
+  const int NumberOfDestFrames = (int)Resampler.DestFrameCount(NumberOfSourceFrames);
+  BOOST_CHECK_EQUAL(NumberOfDestFrames, (int)TResampler::SDestFrameCount(
+    SourceSampleRate, DestSampleRate, NumberOfSourceFrames));
+
+  // . in one go
+
+  TArray<float> DestBuffer(NumberOfDestFrames);
+
+  int DestFramesWritten = Resampler.Process(SourceBuffer.FirstRead(),
+    NumberOfSourceFrames, DestBuffer.FirstWrite());
+  DestFramesWritten += Resampler.Flush(DestBuffer.FirstWrite() + DestFramesWritten);
+
+  BOOST_CHECK_EQUAL(DestFramesWritten, NumberOfDestFrames);
+
+  // . in blocks (after resetting)
+
+  Resampler.Reset();
+
+  TArray<float> BlockDestBuffer(NumberOfDestFrames);
+
+  int BlockDestFramesWritten = 0;
+  for (int SourceFramesRead = 0; SourceFramesRead < NumberOfSourceFrames; )
+  {
+    const int BlockSize = MMin(1 + TMath::Rand() % 700,
+      NumberOfSourceFrames - SourceFramesRead);
+
+    const int DestFrames = Resampler.Process(SourceBuffer.FirstRead() + SourceFramesRead,
+      BlockSize, BlockDestBuffer.FirstWrite() + BlockDestFramesWritten);
+    BOOST_CHECK(DestFrames <= Resampler.MaxDestFrames(BlockSize));
+
+    BlockDestFramesWritten += DestFrames;
+    SourceFramesRead += BlockSize;
+  }
+  BlockDestFramesWritten += Resampler.Flush(
+    BlockDestBuffer.FirstWrite() + BlockDestFramesWritten);
+
+  BOOST_CHECK_EQUAL(BlockDestFramesWritten, NumberOfDestFrames);
+  BOOST_CHECK(DestBuffer == BlockDestBuffer);
+
+  // . compare with the ideal sine, ignoring the edges
+
+  double SignalPower = 0.0, NoisePower = 0.0;
+  for (int i = Resampler.FilterLength(); i < NumberOfDestFrames - Resampler.FilterLength(); ++i)
+  {
+    const double Expected = ::sin(2.0 * MPi * Frequency * i / DestSampleRate);
+
+    SignalPower += Expected * Expected;
+    NoisePower += TMathT<double>::Square(DestBuffer[i] - Expected);
+  }
+
+  const double SignalToNoiseInDb = 10.0 * ::log10(SignalPower / NoisePower);
+  BOOST_CHECK(SignalToNoiseInDb > MinSignalToNoiseInDb);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAudioTypesTest::Resampler()
+{
+  const int Rates[][2] = {
+    { 48000, 44100 }, { 96000, 44100 }, { 192000, 44100 },
+    { 22050, 44100 }, { 44100, 48000 },
+    { 44100, 44101 } // interpolated phases
+  };
+
+  for (size_t r = 0; r < MCountOf(Rates); ++r)
+  {
+    SCheckResampler(Rates[r][0], Rates[r][1], TResampler::kLowQuality, 50.0);
+    SCheckResampler(Rates[r][0], Rates[r][1], TResampler::kMediumQuality, 75.0);
+    SCheckResampler(Rates[r][0], Rates[r][1], TResampler::kHighQuality, 100.0);
+  }
+}
+
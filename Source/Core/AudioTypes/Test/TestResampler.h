@@ -0,0 +1,15 @@
+#pragma once
+
+#ifndef _TestResampler_h_
+#define _TestResampler_h_
+
+// =================================================================================================
+
+namespace TAudioTypesTest
+{
+  void Resampler();
+}
+
+
+#endif // _TestResampler_h_
+
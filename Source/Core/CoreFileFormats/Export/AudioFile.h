@@ -7,6 +7,7 @@
 
 #include "CoreTypes/Export/Array.h"
 #include "CoreTypes/Export/File.h"
+#include "CoreTypes/Export/Pointer.h"
 
 #include "AudioTypes/Export/AudioTypes.h"
 
@@ -342,6 +343,12 @@ private:
     void* pDestBuffer, 
     int   NumberOfSampleFrames) = 0;
 
+  //! optionally return the next NumberOfSampleFrames in the system's byte order
+  //! without copying them into a temp buffer first, advancing the read position 
+  //! as OnReadBuffer does. When NULL is returned, OnReadBuffer will be used. 
+  //! The returned buffer must stay valid until the next read call.
+  virtual const void* OnReadBufferInPlace(int NumberOfSampleFrames);
+
   virtual void OnWriteBuffer(
     const void* pSrcBuffer, 
     int         NumberOfSampleFrames) = 0;
@@ -361,7 +368,9 @@ private:
 // =================================================================================================
 
 /*! 
- * AudioStream which reads content directly from a file 
+ * AudioStream which reads content directly from a file. Files which are opened 
+ * read-only are read via a memory mapped view of the file, so samples get 
+ * converted directly from the mapped file content.
 !*/
 
 class TAudioFileStream : public TAudioStream
@@ -392,6 +401,8 @@ private:
     void* pDestBuffer, 
     int   NumberOfSampleFrames);
 
+  virtual const void* OnReadBufferInPlace(int NumberOfSampleFrames);
+
   virtual void OnWriteBuffer(
     const void* pSrcBuffer, 
     int         NumberOfSampleFrames);
@@ -403,6 +414,13 @@ private:
   long long mBytesWritten;
 
   TByteOrder::TByteOrder mSampleDataByteOrder;
+
+  // set for read-only files only
+  TOwnerPtr<TMappedFileView> mpMappedView;
+  // read position in frames, when reading from the mapped view
+  long long mMappedReadPosition;
+  // temp buffer for mapped content which needs to be swapped or aligned
+  TArray<char> mMappedTempBuffer;
 };
 
 
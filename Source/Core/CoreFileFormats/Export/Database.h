@@ -125,6 +125,10 @@ public:
     
     //! reset the statement    
     void Reset();
+    
+    //! set all bound parameters back to NULL. Use together with Reset() to
+    //! re-execute a precompiled statement with new parameters.
+    void ClearBindings();
     //@}
     
     
@@ -16,6 +16,10 @@ namespace TSampleConverter
   // NOTE: 'Internal Float' in all conversions below is [-(2<<14) <> (2<<14) - 1] 
   // see also M16BitSampleMin, M16BitSampleMax in AudioTypes.h
 
+  //! Select the fastest conversion kernels for the running CPU. Called by
+  //! CoreFileFormatsInit: until then, plain scalar conversions are used.
+  void Init();
+
   // ===============================================================================================
 
   // -----------------------------------------------------------------------------------------------
@@ -375,6 +379,18 @@ namespace TSampleConverter
     float*        pDestBuffer,
     int           NumberOfSampleFrames);
 
+  // -----------------------------------------------------------------------------------------------
+
+  // ... Byte swapping
+
+  //! copy NumberOfSamples 8, 16, 24, 32 or 64 bit samples, reversing the byte 
+  //! order of each sample. Src and dest buffers may be the same.
+  void CopySwapped(
+    const void* pSrcBuffer,
+    void*       pDestBuffer,
+    int         BytesPerSample,
+    int         NumberOfSamples);
+
   // ===============================================================================================
 
   // ... 8 Bit Unsigned
@@ -946,6 +946,14 @@ bool TAudioStream::SeekTo(long long SampleIndex)
   return OnSeekTo(SampleIndex);
 }
 
+// -------------------------------------------------------------------------------------------------
+
+const void* TAudioStream::OnReadBufferInPlace(int NumberOfSampleFrames)
+{
+  MUnused(NumberOfSampleFrames);
+  return NULL;
+}
+
 // =================================================================================================
 
 // -------------------------------------------------------------------------------------------------
@@ -1238,16 +1246,24 @@ void TAudioStream::ReadSamples(
   const int SrcBytesPerFrame = TAudioFile::SNumBitsFromSampleType(mSampleType) / 8;
   
 
-  // ... read src data into a temp buffer
-  
-  // mTempBuffer is a member to avoid reallocation when calling ReadSamples
-  // frequently with the same number of frames. Available for every thread because
-  // a stream can be accessed from several threads at once
-  mTempBuffer.Grow(
-    NumberOfSampleFrames * SrcChaCount * SrcBytesPerFrame);
+  // ... access src data in place or read it into a temp buffer
   
   // this will take care about endianess
-  OnReadBuffer(mTempBuffer.FirstWrite(), NumberOfSampleFrames);
+  const void* pSrcBuffer = OnReadBufferInPlace(NumberOfSampleFrames);
+
+  if (pSrcBuffer == NULL)
+  {
+    // mTempBuffer is a member to avoid reallocation when calling ReadSamples
+    // frequently with the same number of frames. Available for every thread because
+    // a stream can be accessed from several threads at once
+    mTempBuffer.Grow(
+      NumberOfSampleFrames * SrcChaCount * SrcBytesPerFrame);
+    
+    // this will take care about endianess
+    OnReadBuffer(mTempBuffer.FirstWrite(), NumberOfSampleFrames);
+
+    pSrcBuffer = mTempBuffer.FirstRead();
+  }
   
 
   // ... Convert to the dest format
@@ -1266,7 +1282,7 @@ void TAudioStream::ReadSamples(
       for (int Cha = 0; Cha < DestChaCount; ++Cha)
       {               
         TSampleConverter::Int8BitSignedToInternalFloat(
-          (const TInt8*)mTempBuffer.FirstRead(), 
+          (const TInt8*)pSrcBuffer, 
           DestChannelPtrs[Cha], NumberOfSampleFrames);
       }
     }                      
@@ -1275,13 +1291,13 @@ void TAudioStream::ReadSamples(
       if (DestChaCount == 1)
       {
         TSampleConverter::Int8BitSignedInterleavedStereoToInternalFloatMono(
-          (const TInt8*)mTempBuffer.FirstRead(), 
+          (const TInt8*)pSrcBuffer, 
           DestChannelPtrs[0], NumberOfSampleFrames);
       }
       else if (DestChaCount == 2)
       {              
         TSampleConverter::Int8BitSignedInterleavedToInternalFloat(
-          (const TInt8*)mTempBuffer.FirstRead(), 
+          (const TInt8*)pSrcBuffer, 
           DestChannelPtrs[0], DestChannelPtrs[1], NumberOfSampleFrames);
       }
       else
@@ -1292,7 +1308,7 @@ void TAudioStream::ReadSamples(
     else if (SrcChaCount == DestChaCount)
     {
       TSampleConverter::Int8BitSignedInterleavedToInternalFloat(
-        (const TInt8*)mTempBuffer.FirstRead(),
+        (const TInt8*)pSrcBuffer,
         DestChannelPtrs, NumberOfSampleFrames );
     }
     else
@@ -1312,7 +1328,7 @@ void TAudioStream::ReadSamples(
       for (int Cha = 0; Cha < DestChaCount; ++Cha)
       {               
         TSampleConverter::Int8BitUnsignedToInternalFloat(
-          (const TUInt8*)mTempBuffer.FirstRead(), 
+          (const TUInt8*)pSrcBuffer, 
           DestChannelPtrs[Cha], NumberOfSampleFrames);
       }
     }                      
@@ -1321,13 +1337,13 @@ void TAudioStream::ReadSamples(
       if (DestChaCount == 1)
       {
         TSampleConverter::Int8BitUnsignedInterleavedStereoToInternalFloatMono(
-          (const TUInt8*)mTempBuffer.FirstRead(), 
+          (const TUInt8*)pSrcBuffer, 
           DestChannelPtrs[0], NumberOfSampleFrames);
       }
       else if (DestChaCount == 2)
       {              
         TSampleConverter::Int8BitUnsignedInterleavedToInternalFloat(
-          (const TUInt8*)mTempBuffer.FirstRead(), 
+          (const TUInt8*)pSrcBuffer, 
           DestChannelPtrs[0], DestChannelPtrs[1], NumberOfSampleFrames);
       }
       else
@@ -1338,7 +1354,7 @@ void TAudioStream::ReadSamples(
     else if (SrcChaCount == DestChaCount)
     {
       TSampleConverter::Int8BitUnsignedInterleavedToInternalFloat(
-        (const TUInt8*)mTempBuffer.FirstRead(),
+        (const TUInt8*)pSrcBuffer,
         DestChannelPtrs, NumberOfSampleFrames);
     }
     else
@@ -1358,7 +1374,7 @@ void TAudioStream::ReadSamples(
       for (int Cha = 0; Cha < DestChaCount; ++Cha)
       {               
         TSampleConverter::Int16BitToInternalFloat(
-          (const TInt16*)mTempBuffer.FirstRead(), 
+          (const TInt16*)pSrcBuffer, 
           DestChannelPtrs[Cha], NumberOfSampleFrames);
       }
     }
@@ -1367,13 +1383,13 @@ void TAudioStream::ReadSamples(
       if (DestChaCount == 1)
       {               
         TSampleConverter::Int16BitInterleavedStereoToInternalFloatMono(
-          (const TInt16*)mTempBuffer.FirstRead(), 
+          (const TInt16*)pSrcBuffer, 
           DestChannelPtrs[0], NumberOfSampleFrames);
       }
       else if (DestChaCount == 2)
       {
         TSampleConverter::Int16BitInterleavedToInternalFloat(
-          (const TInt16*)mTempBuffer.FirstRead(), 
+          (const TInt16*)pSrcBuffer, 
           DestChannelPtrs[0], DestChannelPtrs[1], NumberOfSampleFrames);
       }
       else
@@ -1384,7 +1400,7 @@ void TAudioStream::ReadSamples(
     else if (SrcChaCount == DestChaCount)
     {
       TSampleConverter::Int16BitInterleavedToInternalFloat(
-        (const TInt16*)mTempBuffer.FirstRead(),
+        (const TInt16*)pSrcBuffer,
         DestChannelPtrs, NumberOfSampleFrames);
     }
     else 
@@ -1404,7 +1420,7 @@ void TAudioStream::ReadSamples(
       for (int Cha = 0; Cha < DestChaCount; ++Cha)
       {               
         TSampleConverter::Int24BitToInternalFloat(
-          (const T24*)mTempBuffer.FirstRead(), 
+          (const T24*)pSrcBuffer, 
           DestChannelPtrs[Cha], NumberOfSampleFrames);
       }
     }
@@ -1413,13 +1429,13 @@ void TAudioStream::ReadSamples(
       if (DestChaCount == 1)
       {
         TSampleConverter::Int24BitInterleavedStereoToInternalFloatMono(
-          (const T24*)mTempBuffer.FirstRead(), 
+          (const T24*)pSrcBuffer, 
           DestChannelPtrs[0], NumberOfSampleFrames);
       }
       else if (DestChaCount == 2)
       {
         TSampleConverter::Int24BitInterleavedToInternalFloat(
-          (const T24*)mTempBuffer.FirstRead(), 
+          (const T24*)pSrcBuffer, 
           DestChannelPtrs[0], DestChannelPtrs[1], NumberOfSampleFrames);
       }
       else
@@ -1430,7 +1446,7 @@ void TAudioStream::ReadSamples(
     else if (SrcChaCount == DestChaCount)
     {
       TSampleConverter::Int24BitInterleavedToInternalFloat(
-        (const T24*)mTempBuffer.FirstRead(),
+        (const T24*)pSrcBuffer,
         DestChannelPtrs, NumberOfSampleFrames);
     }
     else
@@ -1450,7 +1466,7 @@ void TAudioStream::ReadSamples(
       for (int Cha = 0; Cha < DestChaCount; ++Cha)
       {               
         TSampleConverter::Int32BitToInternalFloat(
-          (const TInt32*)mTempBuffer.FirstRead(), 
+          (const TInt32*)pSrcBuffer, 
           DestChannelPtrs[Cha], NumberOfSampleFrames);
       }
     }
@@ -1459,13 +1475,13 @@ void TAudioStream::ReadSamples(
       if (DestChaCount == 1)
       { 
         TSampleConverter::Int32BitInterleavedStereoToInternalFloatMono(
-          (const TInt32*)mTempBuffer.FirstRead(), 
+          (const TInt32*)pSrcBuffer, 
           DestChannelPtrs[0], NumberOfSampleFrames);
       }
       else if (DestChaCount == 2)
       {
         TSampleConverter::Int32BitInterleavedToInternalFloat(
-          (const TInt32*)mTempBuffer.FirstRead(), 
+          (const TInt32*)pSrcBuffer, 
           DestChannelPtrs[0], DestChannelPtrs[1], NumberOfSampleFrames);
       }
       else
@@ -1476,7 +1492,7 @@ void TAudioStream::ReadSamples(
     else if (SrcChaCount == DestChaCount)
     {
       TSampleConverter::Int32BitInterleavedToInternalFloat(
-        (const TInt32*)mTempBuffer.FirstRead(),
+        (const TInt32*)pSrcBuffer,
         DestChannelPtrs, NumberOfSampleFrames);
     }
     else
@@ -1496,7 +1512,7 @@ void TAudioStream::ReadSamples(
       for (int Cha = 0; Cha < DestChaCount; ++Cha)
       {               
         TSampleConverter::Float32BitToInternalFloat(
-          (const float*)mTempBuffer.FirstRead(), 
+          (const float*)pSrcBuffer, 
           DestChannelPtrs[Cha], NumberOfSampleFrames);
       }
     }
@@ -1505,13 +1521,13 @@ void TAudioStream::ReadSamples(
       if (DestChaCount == 1)
       {                    
         TSampleConverter::Float32BitInterleavedStereoToInternalFloatMono(
-          (const float*)mTempBuffer.FirstRead(), 
+          (const float*)pSrcBuffer, 
           DestChannelPtrs[0], NumberOfSampleFrames);
       }
       else if (DestChaCount == 2)
       {   
         TSampleConverter::Float32BitInterleavedToInternalFloat(
-          (const float*)mTempBuffer.FirstRead(), 
+          (const float*)pSrcBuffer, 
           DestChannelPtrs[0], DestChannelPtrs[1], NumberOfSampleFrames);
       }
       else
@@ -1522,7 +1538,7 @@ void TAudioStream::ReadSamples(
     else if (SrcChaCount == DestChaCount)
     {
       TSampleConverter::Float32BitInterleavedToInternalFloat(
-        (const float*)mTempBuffer.FirstRead(),
+        (const float*)pSrcBuffer,
         DestChannelPtrs, NumberOfSampleFrames);
     }
     else
@@ -1542,7 +1558,7 @@ void TAudioStream::ReadSamples(
       for (int Cha = 0; Cha < DestChaCount; ++Cha)
       { 
         TSampleConverter::Float64BitToInternalFloat(
-          (const double*)mTempBuffer.FirstRead(), 
+          (const double*)pSrcBuffer, 
           DestChannelPtrs[Cha], NumberOfSampleFrames);
       }
     }
@@ -1551,13 +1567,13 @@ void TAudioStream::ReadSamples(
       if (DestChaCount == 1)
       {               
         TSampleConverter::Float64BitInterleavedStereoToInternalFloatMono(
-          (const double*)mTempBuffer.FirstRead(), 
+          (const double*)pSrcBuffer, 
           DestChannelPtrs[0], NumberOfSampleFrames);
       }
       else if (DestChaCount == 2)
       {
         TSampleConverter::Float64BitInterleavedToInternalFloat(
-          (const double*)mTempBuffer.FirstRead(), 
+          (const double*)pSrcBuffer, 
           DestChannelPtrs[0], DestChannelPtrs[1], NumberOfSampleFrames);
       }
       else
@@ -1568,7 +1584,7 @@ void TAudioStream::ReadSamples(
     else if (SrcChaCount == DestChaCount)
     {
       TSampleConverter::Float64BitInterleavedToInternalFloat(
-        (const double*)mTempBuffer.FirstRead(),
+        (const double*)pSrcBuffer,
         DestChannelPtrs, NumberOfSampleFrames );
     }
     else
@@ -1989,10 +2005,17 @@ TAudioFileStream::TAudioFileStream(
     mpFile(pFile),
     mSampleDataOffset(SampleDataOffset),
     mBytesWritten(0),
-    mSampleDataByteOrder(SampleDataByteOrder)
+    mSampleDataByteOrder(SampleDataByteOrder),
+    mMappedReadPosition(0)
 {
   // seek to the PCM chunk start
   mpFile->SetPosition((size_t)mSampleDataOffset);
+
+  // map read-only files only: the file's size may change when writing
+  if (mpFile->AccessMode() == TFile::kRead)
+  {
+    mpMappedView = TOwnerPtr<TMappedFileView>(new TMappedFileView(mpFile));
+  }
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -2024,6 +2047,11 @@ bool TAudioFileStream::OnSeekTo(long long Frame)
   const bool Succeeded = mpFile->SetPosition(
     (size_t)(mSampleDataOffset + (long long)BytesPerSampleFrame * NumChannels() * Frame));
   
+  if (Succeeded)
+  {
+    mMappedReadPosition = Frame;
+  }
+
   return Succeeded;
 }
 
@@ -2038,6 +2066,18 @@ void TAudioFileStream::OnReadBuffer(
 
   MStaticAssert(TAudioFile::kNumOfSampleTypes == 7); // Update me
 
+  const int BytesPerSample = 
+    TAudioFile::SNumBitsFromSampleType(SampleType()) / 8;
+
+  if (mpMappedView)
+  {
+    // streams which share a file track their read positions on their own
+    mpFile->SetPosition((size_t)(mSampleDataOffset + 
+      (long long)BytesPerSample * NumChannels() * mMappedReadPosition));
+
+    mMappedReadPosition += NumberOfSampleFrames;
+  }
+
   // Set PCM byte order
   const TFileSetAndRestoreByteOrder SetPcmByteOrder(*mpFile, mSampleDataByteOrder);
 
@@ -2077,6 +2117,62 @@ void TAudioFileStream::OnReadBuffer(
 
 // -------------------------------------------------------------------------------------------------
 
+const void* TAudioFileStream::OnReadBufferInPlace(int NumberOfSampleFrames)
+{
+  if (! mpMappedView)
+  {
+    return NULL;
+  }
+
+  MAssert(mpFile->IsOpenForReading(),
+    "File stream is not or no longer open");
+
+  MStaticAssert(TAudioFile::kNumOfSampleTypes == 7); // Update me
+
+  const int BytesPerSample = 
+    TAudioFile::SNumBitsFromSampleType(SampleType()) / 8;
+
+  const size_t NumberOfSamples = (size_t)NumberOfSampleFrames * NumChannels();
+  const size_t NumberOfBytes = NumberOfSamples * BytesPerSample;
+
+  const char* pMappedBuffer = mpMappedView->Map(mSampleDataOffset + 
+    (long long)BytesPerSample * NumChannels() * mMappedReadPosition, NumberOfBytes);
+
+  if (pMappedBuffer == NULL)
+  {
+    // range not present or mapping failed: let OnReadBuffer handle this
+    return NULL;
+  }
+
+  mMappedReadPosition += NumberOfSampleFrames;
+
+  // 24 bit samples are accessed bytewise, all other types need to be aligned
+  const bool NeedsSwap = (MSystemByteOrder != mSampleDataByteOrder);
+  const bool NeedsAlignment = (BytesPerSample != 3 && 
+    ((size_t)pMappedBuffer % BytesPerSample) != 0);
+
+  if (! NeedsSwap && ! NeedsAlignment)
+  {
+    return pMappedBuffer;
+  }
+
+  mMappedTempBuffer.Grow((int)NumberOfBytes);
+
+  if (NeedsSwap)
+  {
+    TSampleConverter::CopySwapped(pMappedBuffer, 
+      mMappedTempBuffer.FirstWrite(), BytesPerSample, (int)NumberOfSamples);
+  }
+  else
+  {
+    TMemory::Copy(mMappedTempBuffer.FirstWrite(), pMappedBuffer, NumberOfBytes);
+  }
+
+  return mMappedTempBuffer.FirstRead();
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void TAudioFileStream::OnWriteBuffer(
   const void* pSrcBuffer, 
   int         NumberOfSampleFrames)
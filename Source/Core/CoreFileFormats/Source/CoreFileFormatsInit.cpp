@@ -14,6 +14,8 @@ void CoreFileFormatsInit()
 {
   CoreFileFormatsCoreInit(); // TSocketBase
   
+  TSampleConverter::Init();
+
   #if !defined(MNoMp3LibMpg)
     TMp3File::SInit();
   #endif
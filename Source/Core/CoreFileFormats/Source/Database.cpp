@@ -741,6 +741,19 @@ void TDatabase::TStatement::Reset()
 
 // -------------------------------------------------------------------------------------------------
 
+void TDatabase::TStatement::ClearBindings()
+{
+  MAssert(mpSqliteStatement != NULL, "");
+  
+  #if defined(MDebug)
+    m__BoundParameters.Init(false);
+  #endif
+  
+  SHandleSqlError(mDatabase, ::sqlite3_clear_bindings(mpSqliteStatement));
+}
+
+// -------------------------------------------------------------------------------------------------
+
 // always returns 0 as type! 
 /*TDatabase::TStatement::TColumnType TDatabase::TStatement::ColumnType(int ColumnIndex)const
 {
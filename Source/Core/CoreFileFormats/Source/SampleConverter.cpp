@@ -1,5 +1,24 @@
 #include "CoreFileFormatsPrecompiledHeader.h"
 
+#include "CoreTypes/Export/Log.h"
+
+#include "CoreFileFormats/Source/SampleConverterKernels.h"
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleConverter::Init()
+{
+  const TSampleConverterKernels::TInstructionSet InstructionSet = 
+    TSampleConverterKernels::SBestInstructionSet();
+  
+  TSampleConverterKernels::SSelectKernels(InstructionSet);
+
+  TLog::SLog()->AddLine("SampleConverter", "Using %s conversion kernels", 
+    TSampleConverterKernels::SInstructionSetName(InstructionSet));
+}
+
 // =================================================================================================
 
 // -------------------------------------------------------------------------------------------------
@@ -474,10 +493,10 @@ void TSampleConverter::Int8BitSignedToInternalFloat(
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBuffer[i] = S8BitSignedTo16BitFloat(pSrcBuffer[i]);
-  }
+  float* const pDestBuffers[1] = { pDestBuffer };
+
+  TSampleConverterKernels::SSelectedKernels().mpInt8BitSignedToInternalFloat(
+    pSrcBuffer, pDestBuffers, 1, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -488,11 +507,10 @@ void TSampleConverter::Int8BitSignedInterleavedToInternalFloat(
   float*        pDestBufferRight, 
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBufferLeft[i] = S8BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    pDestBufferRight[i] = S8BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-  }
+  float* const pDestBuffers[2] = { pDestBufferLeft, pDestBufferRight };
+
+  TSampleConverterKernels::SSelectedKernels().mpInt8BitSignedToInternalFloat(
+    pInterleavedSrcBuffer, pDestBuffers, 2, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -502,14 +520,9 @@ void TSampleConverter::Int8BitSignedInterleavedToInternalFloat(
   const TArray<float*>& pDestBufferPointers,
   int                   NumberOfSampleFrames)
 {
-  const int NumberOfChannels = pDestBufferPointers.Size();
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    for (int c = 0; c < NumberOfChannels; ++c)
-    {
-      pDestBufferPointers[c][i] = S8BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    }
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt8BitSignedToInternalFloat(
+    pInterleavedSrcBuffer, pDestBufferPointers.FirstRead(), 
+    pDestBufferPointers.Size(), NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -519,13 +532,8 @@ void TSampleConverter::Int8BitSignedInterleavedStereoToInternalFloatMono(
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
 {
-  for ( int i = 0; i < NumberOfSampleFrames; ++i )
-  {
-    const float Left = S8BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    const float Right = S8BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-
-    pDestBuffer[i] = (Left + Right) * 0.5f;
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt8BitSignedStereoToInternalFloatMono(
+    pInterleavedSrcBuffer, pDestBuffer, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -535,10 +543,10 @@ void TSampleConverter::Int8BitUnsignedToInternalFloat(
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBuffer[i] = S8BitUnsignedTo16BitFloat(pSrcBuffer[i]);
-  }
+  float* const pDestBuffers[1] = { pDestBuffer };
+
+  TSampleConverterKernels::SSelectedKernels().mpInt8BitUnsignedToInternalFloat(
+    pSrcBuffer, pDestBuffers, 1, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -549,11 +557,10 @@ void TSampleConverter::Int8BitUnsignedInterleavedToInternalFloat(
   float*        pDestBufferRight, 
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBufferLeft[i] = S8BitUnsignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    pDestBufferRight[i] = S8BitUnsignedTo16BitFloat(*pInterleavedSrcBuffer++);
-  }
+  float* const pDestBuffers[2] = { pDestBufferLeft, pDestBufferRight };
+
+  TSampleConverterKernels::SSelectedKernels().mpInt8BitUnsignedToInternalFloat(
+    pInterleavedSrcBuffer, pDestBuffers, 2, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -563,14 +570,9 @@ void TSampleConverter::Int8BitUnsignedInterleavedToInternalFloat(
   const TArray<float*>& pDestBufferPointers,
   int                   NumberOfSampleFrames)
 {
-  const int NumberOfChannels = pDestBufferPointers.Size();
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    for (int c = 0; c < NumberOfChannels; ++c)
-    {
-      pDestBufferPointers[c][i] = S8BitUnsignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    }
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt8BitUnsignedToInternalFloat(
+    pInterleavedSrcBuffer, pDestBufferPointers.FirstRead(), 
+    pDestBufferPointers.Size(), NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -580,13 +582,8 @@ void TSampleConverter::Int8BitUnsignedInterleavedStereoToInternalFloatMono(
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    const float Left = S8BitUnsignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    const float Right = S8BitUnsignedTo16BitFloat(*pInterleavedSrcBuffer++);
-
-    pDestBuffer[i] = (Left + Right) * 0.5f;
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt8BitUnsignedStereoToInternalFloatMono(
+    pInterleavedSrcBuffer, pDestBuffer, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -596,10 +593,10 @@ void TSampleConverter::Int16BitToInternalFloat(
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBuffer[i] = S16BitSignedTo16BitFloat(pSrcBuffer[i]);
-  }
+  float* const pDestBuffers[1] = { pDestBuffer };
+
+  TSampleConverterKernels::SSelectedKernels().mpInt16BitToInternalFloat(
+    pSrcBuffer, pDestBuffers, 1, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -610,11 +607,10 @@ void TSampleConverter::Int16BitInterleavedToInternalFloat(
   float*        pDestBufferRight,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBufferLeft[i] = S16BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    pDestBufferRight[i] = S16BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-  }
+  float* const pDestBuffers[2] = { pDestBufferLeft, pDestBufferRight };
+
+  TSampleConverterKernels::SSelectedKernels().mpInt16BitToInternalFloat(
+    pInterleavedSrcBuffer, pDestBuffers, 2, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -624,14 +620,9 @@ void TSampleConverter::Int16BitInterleavedToInternalFloat(
   const TArray<float*>& pDestBufferPointers,
   int                   NumberOfSampleFrames)
 {
-  const int NumberOfChannels = pDestBufferPointers.Size();
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    for (int c = 0; c < NumberOfChannels; ++c)
-    {
-      pDestBufferPointers[c][i] = S16BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    }
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt16BitToInternalFloat(
+    pInterleavedSrcBuffer, pDestBufferPointers.FirstRead(), 
+    pDestBufferPointers.Size(), NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -641,13 +632,8 @@ void TSampleConverter::Int16BitInterleavedStereoToInternalFloatMono(
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    const float Left = S16BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    const float Right = S16BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    
-    pDestBuffer[i] = (Left + Right) * 0.5f;
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt16BitStereoToInternalFloatMono(
+    pInterleavedSrcBuffer, pDestBuffer, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -657,12 +643,10 @@ void TSampleConverter::Int24BitToInternalFloat(
   float*      pDestBuffer,
   int         NumberOfSampleFrames)
 {
-  T24Pack* pT24Buffer = (T24Pack*)pSrcBuffer;
+  float* const pDestBuffers[1] = { pDestBuffer };
 
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBuffer[i] = S24BitTo16BitFloat(pT24Buffer[i]);
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt24BitToInternalFloat(
+    pSrcBuffer, pDestBuffers, 1, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -673,13 +657,10 @@ void TSampleConverter::Int24BitInterleavedToInternalFloat(
   float*      pDestBufferRight,
   int         NumberOfSampleFrames)
 {
-  T24Pack* pT24Buffer = (T24Pack*)pInterleavedSrcBuffer;
+  float* const pDestBuffers[2] = { pDestBufferLeft, pDestBufferRight };
 
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBufferLeft[i] = S24BitTo16BitFloat(*pT24Buffer++);
-    pDestBufferRight[i] = S24BitTo16BitFloat(*pT24Buffer++);
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt24BitToInternalFloat(
+    pInterleavedSrcBuffer, pDestBuffers, 2, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -689,16 +670,9 @@ void TSampleConverter::Int24BitInterleavedToInternalFloat(
   const TArray<float*>& pDestBufferPointers,
   int                   NumberOfSampleFrames)
 {
-  T24Pack* pT24Buffer = (T24Pack*)pInterleavedSrcBuffer;
-  const int NumberOfChannels = pDestBufferPointers.Size();
-
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    for (int c = 0; c < NumberOfChannels; ++c)
-    {
-      pDestBufferPointers[c][i] = S24BitTo16BitFloat(*pT24Buffer++);
-    }
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt24BitToInternalFloat(
+    pInterleavedSrcBuffer, pDestBufferPointers.FirstRead(), 
+    pDestBufferPointers.Size(), NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -708,15 +682,8 @@ void TSampleConverter::Int24BitInterleavedStereoToInternalFloatMono(
   float*      pDestBuffer,
   int         NumberOfSampleFrames)
 {
-  T24Pack* pT24Buffer = (T24Pack*)pInterleavedSrcBuffer;
-  
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    const float Left = S24BitTo16BitFloat(*pT24Buffer++);
-    const float Right = S24BitTo16BitFloat(*pT24Buffer++);
-    
-    pDestBuffer[i] = (Left + Right) * 0.5f;
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt24BitStereoToInternalFloatMono(
+    pInterleavedSrcBuffer, pDestBuffer, NumberOfSampleFrames);
 }
   
 // -------------------------------------------------------------------------------------------------
@@ -725,11 +692,11 @@ void TSampleConverter::Int32BitToInternalFloat(
   const TInt32* pSrcBuffer,
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
-{  
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBuffer[i] = S32BitSignedTo16BitFloat(pSrcBuffer[i]);
-  }
+{
+  float* const pDestBuffers[1] = { pDestBuffer };
+
+  TSampleConverterKernels::SSelectedKernels().mpInt32BitToInternalFloat(
+    pSrcBuffer, pDestBuffers, 1, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -740,11 +707,10 @@ void TSampleConverter::Int32BitInterleavedToInternalFloat(
   float*        pDestBufferRight,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBufferLeft[i] = S32BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    pDestBufferRight[i] = S32BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-  }
+  float* const pDestBuffers[2] = { pDestBufferLeft, pDestBufferRight };
+
+  TSampleConverterKernels::SSelectedKernels().mpInt32BitToInternalFloat(
+    pInterleavedSrcBuffer, pDestBuffers, 2, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -754,14 +720,9 @@ void TSampleConverter::Int32BitInterleavedToInternalFloat(
   const TArray<float*>& pDestBufferPointers,
   int                   NumberOfSampleFrames)
 {
-  const int NumberOfChannels = pDestBufferPointers.Size();
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    for (int c = 0; c < NumberOfChannels; ++c)
-    {
-      pDestBufferPointers[c][i] = S32BitSignedTo16BitFloat( *pInterleavedSrcBuffer++ );
-    }
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt32BitToInternalFloat(
+    pInterleavedSrcBuffer, pDestBufferPointers.FirstRead(), 
+    pDestBufferPointers.Size(), NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -771,13 +732,8 @@ void TSampleConverter::Int32BitInterleavedStereoToInternalFloatMono(
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    const float Left = S32BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    const float Right = S32BitSignedTo16BitFloat(*pInterleavedSrcBuffer++);
-    
-    pDestBuffer[i] = (Left + Right) * 0.5f;
-  }
+  TSampleConverterKernels::SSelectedKernels().mpInt32BitStereoToInternalFloatMono(
+    pInterleavedSrcBuffer, pDestBuffer, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -786,11 +742,11 @@ void TSampleConverter::Float32BitToInternalFloat(
   const float*  pSrcBuffer,
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
-{  
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBuffer[i] = S0To1FloatTo16BitFloat(pSrcBuffer[i]);
-  }
+{
+  float* const pDestBuffers[1] = { pDestBuffer };
+
+  TSampleConverterKernels::SSelectedKernels().mpFloat32BitToInternalFloat(
+    pSrcBuffer, pDestBuffers, 1, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -801,11 +757,10 @@ void TSampleConverter::Float32BitInterleavedToInternalFloat(
   float*        pDestBufferRight,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBufferLeft[i] = S0To1FloatTo16BitFloat(*pInterleavedSrcBuffer++);
-    pDestBufferRight[i] = S0To1FloatTo16BitFloat(*pInterleavedSrcBuffer++);
-  }
+  float* const pDestBuffers[2] = { pDestBufferLeft, pDestBufferRight };
+
+  TSampleConverterKernels::SSelectedKernels().mpFloat32BitToInternalFloat(
+    pInterleavedSrcBuffer, pDestBuffers, 2, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -815,14 +770,9 @@ void TSampleConverter::Float32BitInterleavedToInternalFloat(
   const TArray<float*>& pDestBufferPointers,
   int                   NumberOfSampleFrames)
 {
-  const int NumberOfChannels = pDestBufferPointers.Size();
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    for (int c = 0; c < NumberOfChannels; ++c)
-    {
-      pDestBufferPointers[c][i] = S0To1FloatTo16BitFloat(*pInterleavedSrcBuffer++);
-    }
-  }
+  TSampleConverterKernels::SSelectedKernels().mpFloat32BitToInternalFloat(
+    pInterleavedSrcBuffer, pDestBufferPointers.FirstRead(), 
+    pDestBufferPointers.Size(), NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -832,13 +782,8 @@ void TSampleConverter::Float32BitInterleavedStereoToInternalFloatMono(
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    const float Left = S0To1FloatTo16BitFloat(*pInterleavedSrcBuffer++);
-    const float Right = S0To1FloatTo16BitFloat(*pInterleavedSrcBuffer++);
-    
-    pDestBuffer[i] = (Left + Right) * 0.5f;
-  }
+  TSampleConverterKernels::SSelectedKernels().mpFloat32BitStereoToInternalFloatMono(
+    pInterleavedSrcBuffer, pDestBuffer, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -847,11 +792,11 @@ void TSampleConverter::Float64BitToInternalFloat(
   const double* pSrcBuffer,
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
-{  
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBuffer[i] = S0To1FloatTo16BitFloat(pSrcBuffer[i]);
-  }
+{
+  float* const pDestBuffers[1] = { pDestBuffer };
+
+  TSampleConverterKernels::SSelectedKernels().mpFloat64BitToInternalFloat(
+    pSrcBuffer, pDestBuffers, 1, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -862,11 +807,10 @@ void TSampleConverter::Float64BitInterleavedToInternalFloat(
   float*        pDestBufferRight,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    pDestBufferLeft[i] = S0To1FloatTo16BitFloat(*pInterleavedSrcBuffer++);
-    pDestBufferRight[i] = S0To1FloatTo16BitFloat(*pInterleavedSrcBuffer++);
-  }
+  float* const pDestBuffers[2] = { pDestBufferLeft, pDestBufferRight };
+
+  TSampleConverterKernels::SSelectedKernels().mpFloat64BitToInternalFloat(
+    pInterleavedSrcBuffer, pDestBuffers, 2, NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -876,14 +820,9 @@ void TSampleConverter::Float64BitInterleavedToInternalFloat(
   const TArray<float*>& pDestBufferPointers,
   int                   NumberOfSampleFrames)
 {
-  const int NumberOfChannels = pDestBufferPointers.Size();
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
-  {
-    for (int c = 0; c < NumberOfChannels; ++c)
-    {
-      pDestBufferPointers[c][i] = S0To1FloatTo16BitFloat(*pInterleavedSrcBuffer++);
-    }
-  }
+  TSampleConverterKernels::SSelectedKernels().mpFloat64BitToInternalFloat(
+    pInterleavedSrcBuffer, pDestBufferPointers.FirstRead(), 
+    pDestBufferPointers.Size(), NumberOfSampleFrames);
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -893,12 +832,42 @@ void TSampleConverter::Float64BitInterleavedStereoToInternalFloatMono(
   float*        pDestBuffer,
   int           NumberOfSampleFrames)
 {
-  for (int i = 0; i < NumberOfSampleFrames; ++i)
+  TSampleConverterKernels::SSelectedKernels().mpFloat64BitStereoToInternalFloatMono(
+    pInterleavedSrcBuffer, pDestBuffer, NumberOfSampleFrames);
+}
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleConverter::CopySwapped(
+  const void* pSrcBuffer,
+  void*       pDestBuffer,
+  int         BytesPerSample,
+  int         NumberOfSamples)
+{
+  const TSampleConverterKernels& Kernels = TSampleConverterKernels::SSelectedKernels();
+
+  switch (BytesPerSample)
   {
-    const float Left = S0To1FloatTo16BitFloat(*pInterleavedSrcBuffer++);
-    const float Right = S0To1FloatTo16BitFloat(*pInterleavedSrcBuffer++);
-    
-    pDestBuffer[i] = (Left + Right) * 0.5f;
+  case 1:
+    TMemory::Move(pDestBuffer, pSrcBuffer, NumberOfSamples);
+    break;
+  case 2:
+    Kernels.mpCopySwapped16Bit(pSrcBuffer, pDestBuffer, NumberOfSamples);
+    break;
+  case 3:
+    Kernels.mpCopySwapped24Bit(pSrcBuffer, pDestBuffer, NumberOfSamples);
+    break;
+  case 4:
+    Kernels.mpCopySwapped32Bit(pSrcBuffer, pDestBuffer, NumberOfSamples);
+    break;
+  case 8:
+    Kernels.mpCopySwapped64Bit(pSrcBuffer, pDestBuffer, NumberOfSamples);
+    break;
+
+  default:
+    MInvalid("Unexpected sample size");
+    break;
   }
 }
-
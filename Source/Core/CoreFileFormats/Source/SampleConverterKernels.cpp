@@ -0,0 +1,860 @@
+#include "CoreFileFormatsPrecompiledHeader.h"
+
+#include "CoreTypes/Export/Cpu.h"
+
+#include "CoreFileFormats/Source/SampleConverterKernels.h"
+
+#if defined(MArch_X86) || defined(MArch_X64)
+  #include <emmintrin.h>
+  #include <immintrin.h>
+#endif
+
+#include <cstring>
+
+// =================================================================================================
+
+#if defined(MArch_X86) || defined(MArch_X64)
+  #define MHaveSse2Kernels
+
+  // AVX2 kernels are compiled per function, so the rest of the library
+  // still runs on CPUs without AVX
+  #if defined(MCompiler_GCC)
+    #define MHaveAvx2Kernels
+    #define MAvx2Kernel __attribute__((target("avx2")))
+  #elif defined(MCompiler_VisualCPP)
+    #define MHaveAvx2Kernels
+    #define MAvx2Kernel
+  #endif
+
+  // SIMD kernels assemble 24 bit samples from little endian bytes
+  MStaticAssert(MSystemByteOrder == MIntelByteOrder);
+#endif
+
+// max number of samples that get converted at once when deinterleaving
+// more than two channels (via a temp buffer on the stack)
+#define MDeinterleaveBlockSize 1024
+
+// =================================================================================================
+
+/*!
+ * Sample type traits for the generic kernels below:
+ *
+ * SConvert converts a single sample with TSampleConverter's scalar functions.
+ * SSse2Load and SAvx2Load convert 4 or 8 subsequent samples. kAvx2OverRead is
+ * the number of samples that SAvx2Load may read behind the converted ones.
+!*/
+
+struct TInt8SignedSample
+{
+  typedef TInt8 TSrc;
+  enum { kAvx2OverRead = 0 };
+
+  static float SConvert(const TSrc* pSrc)
+  {
+    return TSampleConverter::S8BitSignedTo16BitFloat(*pSrc);
+  }
+
+  #if defined(MHaveSse2Kernels)
+  static __m128 SSse2Load(const TSrc* pSrc)
+  {
+    int Bytes; ::memcpy(&Bytes, pSrc, 4);
+    __m128i Values = _mm_cvtsi32_si128(Bytes);
+    Values = _mm_unpacklo_epi8(Values, Values);
+    Values = _mm_unpacklo_epi16(Values, Values);
+    Values = _mm_slli_epi32(_mm_srai_epi32(Values, 24), 8);
+    return _mm_cvtepi32_ps(Values);
+  }
+  #endif
+
+  #if defined(MHaveAvx2Kernels)
+  MAvx2Kernel static __m256 SAvx2Load(const TSrc* pSrc)
+  {
+    const __m256i Values = _mm256_cvtepi8_epi32(
+      _mm_loadl_epi64((const __m128i*)pSrc));
+    return _mm256_cvtepi32_ps(_mm256_slli_epi32(Values, 8));
+  }
+  #endif
+};
+
+// -------------------------------------------------------------------------------------------------
+
+struct TInt8UnsignedSample
+{
+  typedef TUInt8 TSrc;
+  enum { kAvx2OverRead = 0 };
+
+  static float SConvert(const TSrc* pSrc)
+  {
+    return TSampleConverter::S8BitUnsignedTo16BitFloat(*pSrc);
+  }
+
+  #if defined(MHaveSse2Kernels)
+  static __m128 SSse2Load(const TSrc* pSrc)
+  {
+    const __m128i Zero = _mm_setzero_si128();
+    int Bytes; ::memcpy(&Bytes, pSrc, 4);
+    __m128i Values = _mm_cvtsi32_si128(Bytes);
+    Values = _mm_unpacklo_epi16(_mm_unpacklo_epi8(Values, Zero), Zero);
+    Values = _mm_slli_epi32(_mm_sub_epi32(Values, _mm_set1_epi32(128)), 8);
+    return _mm_cvtepi32_ps(Values);
+  }
+  #endif
+
+  #if defined(MHaveAvx2Kernels)
+  MAvx2Kernel static __m256 SAvx2Load(const TSrc* pSrc)
+  {
+    const __m256i Values = _mm256_cvtepu8_epi32(
+      _mm_loadl_epi64((const __m128i*)pSrc));
+    return _mm256_cvtepi32_ps(_mm256_slli_epi32(
+      _mm256_sub_epi32(Values, _mm256_set1_epi32(128)), 8));
+  }
+  #endif
+};
+
+// -------------------------------------------------------------------------------------------------
+
+struct TInt16Sample
+{
+  typedef TInt16 TSrc;
+  enum { kAvx2OverRead = 0 };
+
+  static float SConvert(const TSrc* pSrc)
+  {
+    return TSampleConverter::S16BitSignedTo16BitFloat(*pSrc);
+  }
+
+  #if defined(MHaveSse2Kernels)
+  static __m128 SSse2Load(const TSrc* pSrc)
+  {
+    const __m128i Values = _mm_loadl_epi64((const __m128i*)pSrc);
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Values, Values), 16));
+  }
+  #endif
+
+  #if defined(MHaveAvx2Kernels)
+  MAvx2Kernel static __m256 SAvx2Load(const TSrc* pSrc)
+  {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+      _mm_loadu_si128((const __m128i*)pSrc)));
+  }
+  #endif
+};
+
+// -------------------------------------------------------------------------------------------------
+
+struct TInt24Sample
+{
+  typedef T24 TSrc;
+  // the second 16 byte load starts at byte 12 and thus reads 4 bytes more
+  enum { kAvx2OverRead = 2 };
+
+  static float SConvert(const TSrc* pSrc)
+  {
+    return TSampleConverter::S24BitTo16BitFloat(
+      *(const TSampleConverter::T24Pack*)pSrc);
+  }
+
+  #if defined(MHaveSse2Kernels)
+  static int SInt32(const TSrc* pSrc)
+  {
+    const TUInt8* pBytes = (const TUInt8*)pSrc;
+    return (int)(((TUInt32)pBytes[0] << 8) |
+      ((TUInt32)pBytes[1] << 16) | ((TUInt32)pBytes[2] << 24));
+  }
+
+  static __m128 SSse2Load(const TSrc* pSrc)
+  {
+    // no byte shuffles in SSE2: assemble the samples one by one
+    const __m128i Values = _mm_setr_epi32(
+      SInt32(pSrc), SInt32(pSrc + 1), SInt32(pSrc + 2), SInt32(pSrc + 3));
+    // (x << 8) * 32768 / 2^31 is exact in float
+    return _mm_mul_ps(_mm_cvtepi32_ps(Values), _mm_set1_ps(1.0f / 65536.0f));
+  }
+  #endif
+
+  #if defined(MHaveAvx2Kernels)
+  MAvx2Kernel static __m256 SAvx2Load(const TSrc* pSrc)
+  {
+    const __m256i Bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(
+      _mm_loadu_si128((const __m128i*)pSrc)),
+      _mm_loadu_si128((const __m128i*)(pSrc + 4)), 1);
+
+    // move the 3 bytes of each sample into the upper bytes of an int32
+    const __m256i Shuffle = _mm256_setr_epi8(
+      -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+      -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_shuffle_epi8(Bytes, Shuffle)),
+      _mm256_set1_ps(1.0f / 65536.0f));
+  }
+  #endif
+};
+
+// -------------------------------------------------------------------------------------------------
+
+struct TInt32Sample
+{
+  typedef TInt32 TSrc;
+  enum { kAvx2OverRead = 0 };
+
+  static float SConvert(const TSrc* pSrc)
+  {
+    return TSampleConverter::S32BitSignedTo16BitFloat(*pSrc);
+  }
+
+  // NB: scaling by a power of two after rounding to float is exactly what
+  // the scalar version does, when rounding the exactly scaled double to float.
+  // Clipping operand order matches MMin/MMax, also for NaNs.
+
+  #if defined(MHaveSse2Kernels)
+  static __m128 SSse2Load(const TSrc* pSrc)
+  {
+    const __m128 Values = _mm_mul_ps(_mm_cvtepi32_ps(
+      _mm_loadu_si128((const __m128i*)pSrc)), _mm_set1_ps(1.0f / 65536.0f));
+    return _mm_max_ps(_mm_set1_ps(-32768.0f), _mm_min_ps(_mm_set1_ps(32767.0f), Values));
+  }
+  #endif
+
+  #if defined(MHaveAvx2Kernels)
+  MAvx2Kernel static __m256 SAvx2Load(const TSrc* pSrc)
+  {
+    const __m256 Values = _mm256_mul_ps(_mm256_cvtepi32_ps(
+      _mm256_loadu_si256((const __m256i*)pSrc)), _mm256_set1_ps(1.0f / 65536.0f));
+    return _mm256_max_ps(_mm256_set1_ps(-32768.0f),
+      _mm256_min_ps(_mm256_set1_ps(32767.0f), Values));
+  }
+  #endif
+};
+
+// -------------------------------------------------------------------------------------------------
+
+struct TFloat32Sample
+{
+  typedef float TSrc;
+  enum { kAvx2OverRead = 0 };
+
+  static float SConvert(const TSrc* pSrc)
+  {
+    return TSampleConverter::S0To1FloatTo16BitFloat(*pSrc);
+  }
+
+  // NB: scaling by 32768 is exact in float too, unless it overflows to +-inf,
+  // which gets clipped in the same way as the scalar double values.
+
+  #if defined(MHaveSse2Kernels)
+  static __m128 SSse2Load(const TSrc* pSrc)
+  {
+    const __m128 Values = _mm_mul_ps(_mm_loadu_ps(pSrc), _mm_set1_ps(32768.0f));
+    return _mm_max_ps(_mm_set1_ps(-32768.0f), _mm_min_ps(_mm_set1_ps(32767.0f), Values));
+  }
+  #endif
+
+  #if defined(MHaveAvx2Kernels)
+  MAvx2Kernel static __m256 SAvx2Load(const TSrc* pSrc)
+  {
+    const __m256 Values = _mm256_mul_ps(_mm256_loadu_ps(pSrc), _mm256_set1_ps(32768.0f));
+    return _mm256_max_ps(_mm256_set1_ps(-32768.0f),
+      _mm256_min_ps(_mm256_set1_ps(32767.0f), Values));
+  }
+  #endif
+};
+
+// -------------------------------------------------------------------------------------------------
+
+struct TFloat64Sample
+{
+  typedef double TSrc;
+  enum { kAvx2OverRead = 0 };
+
+  static float SConvert(const TSrc* pSrc)
+  {
+    return TSampleConverter::S0To1FloatTo16BitFloat(*pSrc);
+  }
+
+  #if defined(MHaveSse2Kernels)
+  static __m128 SSse2Load2(const TSrc* pSrc)
+  {
+    const __m128d Values = _mm_mul_pd(_mm_loadu_pd(pSrc), _mm_set1_pd(32768.0));
+    return _mm_cvtpd_ps(_mm_max_pd(_mm_set1_pd(-32768.0),
+      _mm_min_pd(_mm_set1_pd(32767.0), Values)));
+  }
+
+  static __m128 SSse2Load(const TSrc* pSrc)
+  {
+    return _mm_movelh_ps(SSse2Load2(pSrc), SSse2Load2(pSrc + 2));
+  }
+  #endif
+
+  #if defined(MHaveAvx2Kernels)
+  MAvx2Kernel static __m128 SAvx2Load4(const TSrc* pSrc)
+  {
+    const __m256d Values = _mm256_mul_pd(_mm256_loadu_pd(pSrc), _mm256_set1_pd(32768.0));
+    return _mm256_cvtpd_ps(_mm256_max_pd(_mm256_set1_pd(-32768.0),
+      _mm256_min_pd(_mm256_set1_pd(32767.0), Values)));
+  }
+
+  MAvx2Kernel static __m256 SAvx2Load(const TSrc* pSrc)
+  {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(
+      SAvx2Load4(pSrc)), SAvx2Load4(pSrc + 4), 1);
+  }
+  #endif
+};
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+template <class TSample>
+static void SScalarConvert(
+  const typename TSample::TSrc* pSrc,
+  float*                        pDest,
+  int                           NumberOfSamples)
+{
+  for (int i = 0; i < NumberOfSamples; ++i)
+  {
+    pDest[i] = TSample::SConvert(pSrc + i);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! deinterleave more than two channels: convert blocks of samples into a
+//! temp buffer with the given kernel, then scatter them into the channels
+template <class TSample, void (*TConvert)(const typename TSample::TSrc*, float*, int)>
+static void SDeinterleaveBlocks(
+  const typename TSample::TSrc* pSrc,
+  float* const*                 ppDest,
+  int                           NumberOfChannels,
+  int                           NumberOfSampleFrames)
+{
+  float TempBuffer[MDeinterleaveBlockSize];
+
+  const int FramesPerBlock = MDeinterleaveBlockSize / NumberOfChannels;
+  MAssert(FramesPerBlock > 0, "Too many channels");
+
+  for (int Frame = 0; Frame < NumberOfSampleFrames; Frame += FramesPerBlock)
+  {
+    const int BlockFrames = MMin(FramesPerBlock, NumberOfSampleFrames - Frame);
+    TConvert(pSrc + Frame * NumberOfChannels, TempBuffer, BlockFrames * NumberOfChannels);
+
+    for (int c = 0; c < NumberOfChannels; ++c)
+    {
+      float* pDest = ppDest[c] + Frame;
+      for (int i = 0; i < BlockFrames; ++i)
+      {
+        pDest[i] = TempBuffer[i * NumberOfChannels + c];
+      }
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <class TSample>
+static void SScalarToInternalFloat(
+  const typename TSample::TSrc* pSrc,
+  float* const*                 ppDest,
+  int                           NumberOfChannels,
+  int                           NumberOfSampleFrames)
+{
+  for (int i = 0; i < NumberOfSampleFrames; ++i)
+  {
+    for (int c = 0; c < NumberOfChannels; ++c)
+    {
+      ppDest[c][i] = TSample::SConvert(pSrc++);
+    }
+  }
+}
+
+template <class TSample>
+static void SScalarStereoToInternalFloatMono(
+  const typename TSample::TSrc* pSrc,
+  float*                        pDest,
+  int                           NumberOfSampleFrames)
+{
+  for (int i = 0; i < NumberOfSampleFrames; ++i)
+  {
+    const float Left = TSample::SConvert(pSrc++);
+    const float Right = TSample::SConvert(pSrc++);
+
+    pDest[i] = (Left + Right) * 0.5f;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <int sBytesPerSample>
+static void SScalarCopySwapped(const void* pSrc, void* pDest, int NumberOfSamples)
+{
+  const TUInt8* pSrcBytes = (const TUInt8*)pSrc;
+  TUInt8* pDestBytes = (TUInt8*)pDest;
+
+  for (int i = 0; i < NumberOfSamples; ++i)
+  {
+    // copy first: buffers may overlap
+    TUInt8 Bytes[sBytesPerSample];
+    for (int b = 0; b < sBytesPerSample; ++b)
+    {
+      Bytes[b] = pSrcBytes[b];
+    }
+    for (int b = 0; b < sBytesPerSample; ++b)
+    {
+      pDestBytes[b] = Bytes[sBytesPerSample - 1 - b];
+    }
+
+    pSrcBytes += sBytesPerSample;
+    pDestBytes += sBytesPerSample;
+  }
+}
+
+// =================================================================================================
+
+#if defined(MHaveSse2Kernels)
+
+// -------------------------------------------------------------------------------------------------
+
+template <class TSample>
+static void SSse2Convert(
+  const typename TSample::TSrc* pSrc,
+  float*                        pDest,
+  int                           NumberOfSamples)
+{
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    _mm_storeu_ps(pDest + i, TSample::SSse2Load(pSrc + i));
+  }
+  SScalarConvert<TSample>(pSrc + i, pDest + i, NumberOfSamples - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <class TSample>
+static void SSse2ToInternalFloat(
+  const typename TSample::TSrc* pSrc,
+  float* const*                 ppDest,
+  int                           NumberOfChannels,
+  int                           NumberOfSampleFrames)
+{
+  if (NumberOfChannels == 1)
+  {
+    SSse2Convert<TSample>(pSrc, ppDest[0], NumberOfSampleFrames);
+  }
+  else if (NumberOfChannels == 2)
+  {
+    float* pLeft = ppDest[0];
+    float* pRight = ppDest[1];
+
+    int i = 0;
+    for (; i + 4 <= NumberOfSampleFrames; i += 4)
+    {
+      const __m128 A = TSample::SSse2Load(pSrc + 2 * i);
+      const __m128 B = TSample::SSse2Load(pSrc + 2 * i + 4);
+      _mm_storeu_ps(pLeft + i, _mm_shuffle_ps(A, B, _MM_SHUFFLE(2, 0, 2, 0)));
+      _mm_storeu_ps(pRight + i, _mm_shuffle_ps(A, B, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    for (; i < NumberOfSampleFrames; ++i)
+    {
+      pLeft[i] = TSample::SConvert(pSrc + 2 * i);
+      pRight[i] = TSample::SConvert(pSrc + 2 * i + 1);
+    }
+  }
+  else
+  {
+    SDeinterleaveBlocks<TSample, SSse2Convert<TSample> >(
+      pSrc, ppDest, NumberOfChannels, NumberOfSampleFrames);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <class TSample>
+static void SSse2StereoToInternalFloatMono(
+  const typename TSample::TSrc* pSrc,
+  float*                        pDest,
+  int                           NumberOfSampleFrames)
+{
+  const __m128 Half = _mm_set1_ps(0.5f);
+
+  int i = 0;
+  for (; i + 4 <= NumberOfSampleFrames; i += 4)
+  {
+    const __m128 A = TSample::SSse2Load(pSrc + 2 * i);
+    const __m128 B = TSample::SSse2Load(pSrc + 2 * i + 4);
+    _mm_storeu_ps(pDest + i, _mm_mul_ps(_mm_add_ps(
+      _mm_shuffle_ps(A, B, _MM_SHUFFLE(2, 0, 2, 0)),
+      _mm_shuffle_ps(A, B, _MM_SHUFFLE(3, 1, 3, 1))), Half));
+  }
+  SScalarStereoToInternalFloatMono<TSample>(
+    pSrc + 2 * i, pDest + i, NumberOfSampleFrames - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static MForceInline __m128i SSse2Swap16(__m128i Values)
+{
+  return _mm_or_si128(_mm_slli_epi16(Values, 8), _mm_srli_epi16(Values, 8));
+}
+
+static void SSse2CopySwapped16Bit(const void* pSrc, void* pDest, int NumberOfSamples)
+{
+  const TUInt8* pSrcBytes = (const TUInt8*)pSrc;
+  TUInt8* pDestBytes = (TUInt8*)pDest;
+
+  int i = 0;
+  for (; i + 8 <= NumberOfSamples; i += 8)
+  {
+    _mm_storeu_si128((__m128i*)(pDestBytes + 2 * i),
+      SSse2Swap16(_mm_loadu_si128((const __m128i*)(pSrcBytes + 2 * i))));
+  }
+  SScalarCopySwapped<2>(pSrcBytes + 2 * i, pDestBytes + 2 * i, NumberOfSamples - i);
+}
+
+static void SSse2CopySwapped32Bit(const void* pSrc, void* pDest, int NumberOfSamples)
+{
+  const TUInt8* pSrcBytes = (const TUInt8*)pSrc;
+  TUInt8* pDestBytes = (TUInt8*)pDest;
+
+  int i = 0;
+  for (; i + 4 <= NumberOfSamples; i += 4)
+  {
+    __m128i Values = _mm_loadu_si128((const __m128i*)(pSrcBytes + 4 * i));
+    Values = _mm_shufflelo_epi16(Values, _MM_SHUFFLE(2, 3, 0, 1));
+    Values = _mm_shufflehi_epi16(Values, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_si128((__m128i*)(pDestBytes + 4 * i), SSse2Swap16(Values));
+  }
+  SScalarCopySwapped<4>(pSrcBytes + 4 * i, pDestBytes + 4 * i, NumberOfSamples - i);
+}
+
+static void SSse2CopySwapped64Bit(const void* pSrc, void* pDest, int NumberOfSamples)
+{
+  const TUInt8* pSrcBytes = (const TUInt8*)pSrc;
+  TUInt8* pDestBytes = (TUInt8*)pDest;
+
+  int i = 0;
+  for (; i + 2 <= NumberOfSamples; i += 2)
+  {
+    __m128i Values = _mm_loadu_si128((const __m128i*)(pSrcBytes + 8 * i));
+    Values = _mm_shufflelo_epi16(Values, _MM_SHUFFLE(0, 1, 2, 3));
+    Values = _mm_shufflehi_epi16(Values, _MM_SHUFFLE(0, 1, 2, 3));
+    _mm_storeu_si128((__m128i*)(pDestBytes + 8 * i), SSse2Swap16(Values));
+  }
+  SScalarCopySwapped<8>(pSrcBytes + 8 * i, pDestBytes + 8 * i, NumberOfSamples - i);
+}
+
+#endif // defined(MHaveSse2Kernels)
+
+// =================================================================================================
+
+#if defined(MHaveAvx2Kernels)
+
+// -------------------------------------------------------------------------------------------------
+
+template <class TSample>
+MAvx2Kernel static void SAvx2Convert(
+  const typename TSample::TSrc* pSrc,
+  float*                        pDest,
+  int                           NumberOfSamples)
+{
+  int i = 0;
+  for (; i + 8 + TSample::kAvx2OverRead <= NumberOfSamples; i += 8)
+  {
+    _mm256_storeu_ps(pDest + i, TSample::SAvx2Load(pSrc + i));
+  }
+  SScalarConvert<TSample>(pSrc + i, pDest + i, NumberOfSamples - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! deinterleave 8 stereo frames from two 8 sample vectors
+MAvx2Kernel static MForceInline void SAvx2Deinterleave(
+  __m256 A, __m256 B, __m256& Left, __m256& Right)
+{
+  // in lane shuffles result in frames 0, 1, 4, 5 | 2, 3, 6, 7
+  Left = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(
+    _mm256_shuffle_ps(A, B, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+  Right = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(
+    _mm256_shuffle_ps(A, B, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <class TSample>
+MAvx2Kernel static void SAvx2ToInternalFloat(
+  const typename TSample::TSrc* pSrc,
+  float* const*                 ppDest,
+  int                           NumberOfChannels,
+  int                           NumberOfSampleFrames)
+{
+  if (NumberOfChannels == 1)
+  {
+    SAvx2Convert<TSample>(pSrc, ppDest[0], NumberOfSampleFrames);
+  }
+  else if (NumberOfChannels == 2)
+  {
+    float* pLeft = ppDest[0];
+    float* pRight = ppDest[1];
+
+    int i = 0;
+    for (; 2 * i + 16 + TSample::kAvx2OverRead <= 2 * NumberOfSampleFrames; i += 8)
+    {
+      __m256 Left, Right;
+      SAvx2Deinterleave(TSample::SAvx2Load(pSrc + 2 * i),
+        TSample::SAvx2Load(pSrc + 2 * i + 8), Left, Right);
+      _mm256_storeu_ps(pLeft + i, Left);
+      _mm256_storeu_ps(pRight + i, Right);
+    }
+    for (; i < NumberOfSampleFrames; ++i)
+    {
+      pLeft[i] = TSample::SConvert(pSrc + 2 * i);
+      pRight[i] = TSample::SConvert(pSrc + 2 * i + 1);
+    }
+  }
+  else
+  {
+    SDeinterleaveBlocks<TSample, SAvx2Convert<TSample> >(
+      pSrc, ppDest, NumberOfChannels, NumberOfSampleFrames);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <class TSample>
+MAvx2Kernel static void SAvx2StereoToInternalFloatMono(
+  const typename TSample::TSrc* pSrc,
+  float*                        pDest,
+  int                           NumberOfSampleFrames)
+{
+  const __m256 Half = _mm256_set1_ps(0.5f);
+
+  int i = 0;
+  for (; 2 * i + 16 + TSample::kAvx2OverRead <= 2 * NumberOfSampleFrames; i += 8)
+  {
+    __m256 Left, Right;
+    SAvx2Deinterleave(TSample::SAvx2Load(pSrc + 2 * i),
+      TSample::SAvx2Load(pSrc + 2 * i + 8), Left, Right);
+    _mm256_storeu_ps(pDest + i, _mm256_mul_ps(_mm256_add_ps(Left, Right), Half));
+  }
+  SScalarStereoToInternalFloatMono<TSample>(
+    pSrc + 2 * i, pDest + i, NumberOfSampleFrames - i);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <int sBytesPerSample>
+MAvx2Kernel static void SAvx2CopySwapped(const void* pSrc, void* pDest, int NumberOfSamples)
+{
+  MStaticAssert(sBytesPerSample == 2 || sBytesPerSample == 4 || sBytesPerSample == 8);
+
+  const __m256i Shuffle = (sBytesPerSample == 2) ?
+    _mm256_setr_epi8(
+      1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+      1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14) :
+    (sBytesPerSample == 4) ?
+    _mm256_setr_epi8(
+      3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+      3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12) :
+    _mm256_setr_epi8(
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+  const TUInt8* pSrcBytes = (const TUInt8*)pSrc;
+  TUInt8* pDestBytes = (TUInt8*)pDest;
+
+  const int SamplesPerVector = 32 / sBytesPerSample;
+
+  int i = 0;
+  for (; i + SamplesPerVector <= NumberOfSamples; i += SamplesPerVector)
+  {
+    _mm256_storeu_si256((__m256i*)(pDestBytes + sBytesPerSample * i), _mm256_shuffle_epi8(
+      _mm256_loadu_si256((const __m256i*)(pSrcBytes + sBytesPerSample * i)), Shuffle));
+  }
+  SScalarCopySwapped<sBytesPerSample>(pSrcBytes + sBytesPerSample * i,
+    pDestBytes + sBytesPerSample * i, NumberOfSamples - i);
+}
+
+#endif // defined(MHaveAvx2Kernels)
+
+// =================================================================================================
+
+static const TSampleConverterKernels sScalarKernels =
+{
+  TSampleConverterKernels::kScalar,
+  SScalarToInternalFloat<TInt8SignedSample>,
+  SScalarToInternalFloat<TInt8UnsignedSample>,
+  SScalarToInternalFloat<TInt16Sample>,
+  SScalarToInternalFloat<TInt24Sample>,
+  SScalarToInternalFloat<TInt32Sample>,
+  SScalarToInternalFloat<TFloat32Sample>,
+  SScalarToInternalFloat<TFloat64Sample>,
+  SScalarStereoToInternalFloatMono<TInt8SignedSample>,
+  SScalarStereoToInternalFloatMono<TInt8UnsignedSample>,
+  SScalarStereoToInternalFloatMono<TInt16Sample>,
+  SScalarStereoToInternalFloatMono<TInt24Sample>,
+  SScalarStereoToInternalFloatMono<TInt32Sample>,
+  SScalarStereoToInternalFloatMono<TFloat32Sample>,
+  SScalarStereoToInternalFloatMono<TFloat64Sample>,
+  SScalarCopySwapped<2>, SScalarCopySwapped<3>,
+  SScalarCopySwapped<4>, SScalarCopySwapped<8>
+};
+
+#if defined(MHaveSse2Kernels)
+
+static const TSampleConverterKernels sSse2Kernels =
+{
+  TSampleConverterKernels::kSse2,
+  SSse2ToInternalFloat<TInt8SignedSample>,
+  SSse2ToInternalFloat<TInt8UnsignedSample>,
+  SSse2ToInternalFloat<TInt16Sample>,
+  SSse2ToInternalFloat<TInt24Sample>,
+  SSse2ToInternalFloat<TInt32Sample>,
+  SSse2ToInternalFloat<TFloat32Sample>,
+  SSse2ToInternalFloat<TFloat64Sample>,
+  SSse2StereoToInternalFloatMono<TInt8SignedSample>,
+  SSse2StereoToInternalFloatMono<TInt8UnsignedSample>,
+  SSse2StereoToInternalFloatMono<TInt16Sample>,
+  SSse2StereoToInternalFloatMono<TInt24Sample>,
+  SSse2StereoToInternalFloatMono<TInt32Sample>,
+  SSse2StereoToInternalFloatMono<TFloat32Sample>,
+  SSse2StereoToInternalFloatMono<TFloat64Sample>,
+  SSse2CopySwapped16Bit, SScalarCopySwapped<3>,
+  SSse2CopySwapped32Bit, SSse2CopySwapped64Bit
+};
+
+#endif
+
+#if defined(MHaveAvx2Kernels)
+
+static const TSampleConverterKernels sAvx2Kernels =
+{
+  TSampleConverterKernels::kAvx2,
+  SAvx2ToInternalFloat<TInt8SignedSample>,
+  SAvx2ToInternalFloat<TInt8UnsignedSample>,
+  SAvx2ToInternalFloat<TInt16Sample>,
+  SAvx2ToInternalFloat<TInt24Sample>,
+  SAvx2ToInternalFloat<TInt32Sample>,
+  SAvx2ToInternalFloat<TFloat32Sample>,
+  SAvx2ToInternalFloat<TFloat64Sample>,
+  SAvx2StereoToInternalFloatMono<TInt8SignedSample>,
+  SAvx2StereoToInternalFloatMono<TInt8UnsignedSample>,
+  SAvx2StereoToInternalFloatMono<TInt16Sample>,
+  SAvx2StereoToInternalFloatMono<TInt24Sample>,
+  SAvx2StereoToInternalFloatMono<TInt32Sample>,
+  SAvx2StereoToInternalFloatMono<TFloat32Sample>,
+  SAvx2StereoToInternalFloatMono<TFloat64Sample>,
+  SAvx2CopySwapped<2>, SScalarCopySwapped<3>,
+  SAvx2CopySwapped<4>, SAvx2CopySwapped<8>
+};
+
+#endif
+
+// selected kernels: set once in TSampleConverter::Init
+static const TSampleConverterKernels* spSelectedKernels = &sScalarKernels;
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+const char* TSampleConverterKernels::SInstructionSetName(TInstructionSet InstructionSet)
+{
+  switch (InstructionSet)
+  {
+  case kScalar:
+    return "Scalar";
+  case kSse2:
+    return "SSE2";
+  case kAvx2:
+    return "AVX2";
+
+  default:
+    MInvalid("Unknown instruction set");
+    return "Unknown";
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TSampleConverterKernels::SIsSupported(TInstructionSet InstructionSet)
+{
+  switch (InstructionSet)
+  {
+  case kScalar:
+    return true;
+
+  case kSse2:
+    #if defined(MHaveSse2Kernels)
+      return (TCpu::Caps() & TCpu::kSse2) != 0;
+    #else
+      return false;
+    #endif
+
+  case kAvx2:
+    #if defined(MHaveAvx2Kernels)
+      return (TCpu::Caps() & TCpu::kAvx2) != 0;
+    #else
+      return false;
+    #endif
+
+  default:
+    MInvalid("Unknown instruction set");
+    return false;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleConverterKernels::TInstructionSet TSampleConverterKernels::SBestInstructionSet()
+{
+  if (SIsSupported(kAvx2))
+  {
+    return kAvx2;
+  }
+  else if (SIsSupported(kSse2))
+  {
+    return kSse2;
+  }
+  else
+  {
+    return kScalar;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+const TSampleConverterKernels& TSampleConverterKernels::SKernels(
+  TInstructionSet InstructionSet)
+{
+  MAssert(SIsSupported(InstructionSet), "Instruction set is not supported");
+
+  switch (InstructionSet)
+  {
+  #if defined(MHaveSse2Kernels)
+    case kSse2:
+      return sSse2Kernels;
+  #endif
+
+  #if defined(MHaveAvx2Kernels)
+    case kAvx2:
+      return sAvx2Kernels;
+  #endif
+
+  default:
+    return sScalarKernels;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+const TSampleConverterKernels& TSampleConverterKernels::SSelectedKernels()
+{
+  return *spSelectedKernels;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleConverterKernels::SSelectKernels(TInstructionSet InstructionSet)
+{
+  spSelectedKernels = &SKernels(InstructionSet);
+}
+
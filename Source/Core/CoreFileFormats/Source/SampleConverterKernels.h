@@ -0,0 +1,98 @@
+#pragma once
+
+#ifndef _SampleConverterKernels_h_
+#define _SampleConverterKernels_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/BaseTypes.h"
+
+// =================================================================================================
+
+/*!
+ * Scalar, SSE2 and AVX2 implementations of TSampleConverter's PCM to internal
+ * float conversions, which deinterleave, convert and scale in one pass, and of
+ * byte swapping copies for PCM data in a foreign byte order.
+ *
+ * TSampleConverter::Init selects the best kernels for the running CPU via
+ * TCpu::Caps(). Results of all kernels are bit-exact to the scalar ones.
+ * All kernels support unaligned in and output buffers.
+!*/
+
+struct TSampleConverterKernels
+{
+  enum TInstructionSet
+  {
+    kScalar,
+    kSse2,
+    kAvx2,
+
+    kNumberOfInstructionSets
+  };
+
+  //! name of the given instruction set, for logging
+  static const char* SInstructionSetName(TInstructionSet InstructionSet);
+
+  //! true when the instruction set got compiled in and is supported by the CPU
+  static bool SIsSupported(TInstructionSet InstructionSet);
+  //! the best instruction set that is supported by the running CPU
+  static TInstructionSet SBestInstructionSet();
+
+  //! kernels for the given, supported instruction set
+  static const TSampleConverterKernels& SKernels(TInstructionSet InstructionSet);
+
+  //! kernels that are currently used by TSampleConverter (scalar until selected)
+  static const TSampleConverterKernels& SSelectedKernels();
+  static void SSelectKernels(TInstructionSet InstructionSet);
+
+
+  TInstructionSet mInstructionSet;
+
+  //@{ ... interleaved, NumberOfChannels PCM -> deinterleaved internal float
+
+  void (*mpInt8BitSignedToInternalFloat)(const TInt8* pSrc,
+    float* const* ppDest, int NumberOfChannels, int NumberOfSampleFrames);
+  void (*mpInt8BitUnsignedToInternalFloat)(const TUInt8* pSrc,
+    float* const* ppDest, int NumberOfChannels, int NumberOfSampleFrames);
+  void (*mpInt16BitToInternalFloat)(const TInt16* pSrc,
+    float* const* ppDest, int NumberOfChannels, int NumberOfSampleFrames);
+  void (*mpInt24BitToInternalFloat)(const T24* pSrc,
+    float* const* ppDest, int NumberOfChannels, int NumberOfSampleFrames);
+  void (*mpInt32BitToInternalFloat)(const TInt32* pSrc,
+    float* const* ppDest, int NumberOfChannels, int NumberOfSampleFrames);
+  void (*mpFloat32BitToInternalFloat)(const float* pSrc,
+    float* const* ppDest, int NumberOfChannels, int NumberOfSampleFrames);
+  void (*mpFloat64BitToInternalFloat)(const double* pSrc,
+    float* const* ppDest, int NumberOfChannels, int NumberOfSampleFrames);
+  //@}
+
+  //@{ ... interleaved stereo PCM -> mono internal float
+
+  void (*mpInt8BitSignedStereoToInternalFloatMono)(const TInt8* pSrc,
+    float* pDest, int NumberOfSampleFrames);
+  void (*mpInt8BitUnsignedStereoToInternalFloatMono)(const TUInt8* pSrc,
+    float* pDest, int NumberOfSampleFrames);
+  void (*mpInt16BitStereoToInternalFloatMono)(const TInt16* pSrc,
+    float* pDest, int NumberOfSampleFrames);
+  void (*mpInt24BitStereoToInternalFloatMono)(const T24* pSrc,
+    float* pDest, int NumberOfSampleFrames);
+  void (*mpInt32BitStereoToInternalFloatMono)(const TInt32* pSrc,
+    float* pDest, int NumberOfSampleFrames);
+  void (*mpFloat32BitStereoToInternalFloatMono)(const float* pSrc,
+    float* pDest, int NumberOfSampleFrames);
+  void (*mpFloat64BitStereoToInternalFloatMono)(const double* pSrc,
+    float* pDest, int NumberOfSampleFrames);
+  //@}
+
+  //@{ ... copy NumberOfSamples 16, 24, 32 or 64 bit values, swapping their bytes
+
+  void (*mpCopySwapped16Bit)(const void* pSrc, void* pDest, int NumberOfSamples);
+  void (*mpCopySwapped24Bit)(const void* pSrc, void* pDest, int NumberOfSamples);
+  void (*mpCopySwapped32Bit)(const void* pSrc, void* pDest, int NumberOfSamples);
+  void (*mpCopySwapped64Bit)(const void* pSrc, void* pDest, int NumberOfSamples);
+  //@}
+};
+
+
+#endif // _SampleConverterKernels_h_
+
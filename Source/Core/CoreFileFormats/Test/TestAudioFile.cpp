@@ -2,8 +2,13 @@
 
 #include "CoreTypes/Export/TestHelpers.h"
 #include "CoreTypes/Export/Directory.h"
+#include "CoreTypes/Export/Timer.h"
 
+#include "CoreFileFormats/Source/SampleConverterKernels.h"
 #include "CoreFileFormats/Test/TestAudioFile.h"
+
+#include <cstring>
+#include <sstream>
                   
 // =================================================================================================
 
@@ -492,3 +497,484 @@ void TCoreFileFormatsTest::AudioFile()
     DestFloatSamplesRight, DestFloatSamplesRight.Size(), Allowed8BitIntError);
 }
 
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+//! random PCM data for the given sample type with \param NumberOfSamples 
+//! samples. floats deliberately exceed [-1, 1] to test clipping.
+static void SRandomSampleData(
+  TArray<char>&           Data,
+  TAudioFile::TSampleType SampleType,
+  int                     NumberOfSamples)
+{
+  const int BytesPerSample = TAudioFile::SNumBitsFromSampleType(SampleType) / 8;
+  Data.SetSize(NumberOfSamples * BytesPerSample);
+
+  for (int i = 0; i < NumberOfSamples; ++i)
+  {
+    const double Value = ((double)TMath::RandFloat() - 0.5) * 3.0;
+
+    if (SampleType == TAudioFile::k32BitFloat)
+    {
+      ((float*)Data.FirstWrite())[i] = (float)Value;
+    }
+    else if (SampleType == TAudioFile::k64BitFloat)
+    {
+      ((double*)Data.FirstWrite())[i] = Value;
+    }
+    else
+    {
+      for (int b = 0; b < BytesPerSample; ++b)
+      {
+        Data[i * BytesPerSample + b] = (char)TRandom::Integer(256);
+      }
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <typename T>
+static void SCheckConverterKernels(
+  const TSampleConverterKernels&  Kernels,
+  const TSampleConverterKernels&  ScalarKernels,
+  TAudioFile::TSampleType         SampleType,
+  void (*const TSampleConverterKernels::*pToInternalFloat)(
+    const T*, float* const*, int, int),
+  void (*const TSampleConverterKernels::*pStereoToInternalFloatMono)(
+    const T*, float*, int))
+{
+  // odd size and offset: test unaligned buffers and remainders
+  const int NumberOfFrames = 1027;
+  const int Offset = 1;
+  const int MaxNumberOfChannels = 6;
+
+  TArray<char> Data;
+  SRandomSampleData(Data, SampleType, 
+    NumberOfFrames * MaxNumberOfChannels + Offset);
+  
+  const T* pSrc = (const T*)Data.FirstRead() + Offset;
+
+  for (int NumberOfChannels = 1; NumberOfChannels <= MaxNumberOfChannels; ++NumberOfChannels)
+  {
+    TArray<float> Expected(NumberOfFrames * NumberOfChannels);
+    TArray<float> Result(NumberOfFrames * NumberOfChannels);
+
+    TArray<float*> ExpectedPtrs(NumberOfChannels), ResultPtrs(NumberOfChannels);
+    for (int c = 0; c < NumberOfChannels; ++c)
+    {
+      ExpectedPtrs[c] = Expected.FirstWrite() + c * NumberOfFrames;
+      ResultPtrs[c] = Result.FirstWrite() + c * NumberOfFrames;
+    }
+
+    (ScalarKernels.*pToInternalFloat)(pSrc, 
+      ExpectedPtrs.FirstRead(), NumberOfChannels, NumberOfFrames);
+    (Kernels.*pToInternalFloat)(pSrc, 
+      ResultPtrs.FirstRead(), NumberOfChannels, NumberOfFrames);
+
+    // kernels must be bit-exact
+    BOOST_CHECK(::memcmp(Expected.FirstRead(), Result.FirstRead(), 
+      Expected.Size() * sizeof(float)) == 0);
+  }
+
+  TArray<float> ExpectedMono(NumberOfFrames), ResultMono(NumberOfFrames);
+  (ScalarKernels.*pStereoToInternalFloatMono)(
+    pSrc, ExpectedMono.FirstWrite(), NumberOfFrames);
+  (Kernels.*pStereoToInternalFloatMono)(
+    pSrc, ResultMono.FirstWrite(), NumberOfFrames);
+
+  BOOST_CHECK(::memcmp(ExpectedMono.FirstRead(), ResultMono.FirstRead(), 
+    ExpectedMono.Size() * sizeof(float)) == 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void SCheckCopySwappedKernel(
+  void (*pCopySwapped)(const void*, void*, int),
+  int   BytesPerSample)
+{
+  const int NumberOfSamples = 1027;
+
+  TArray<char> Source(NumberOfSamples * BytesPerSample);
+  for (int i = 0; i < Source.Size(); ++i)
+  {
+    Source[i] = (char)TRandom::Integer(256);
+  }
+
+  TArray<char> Result(Source.Size());
+  pCopySwapped(Source.FirstRead(), Result.FirstWrite(), NumberOfSamples);
+
+  bool Swapped = true;
+  for (int i = 0; i < NumberOfSamples; ++i)
+  {
+    for (int b = 0; b < BytesPerSample; ++b)
+    {
+      Swapped &= (Result[i * BytesPerSample + b] == 
+        Source[i * BytesPerSample + BytesPerSample - 1 - b]);
+    }
+  }
+  BOOST_CHECK(Swapped);
+
+  // swapping in place twice restores the source
+  pCopySwapped(Result.FirstRead(), Result.FirstWrite(), NumberOfSamples);
+  BOOST_CHECK(Result == Source);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TCoreFileFormatsTest::SampleConverter()
+{
+  const TSampleConverterKernels& ScalarKernels = 
+    TSampleConverterKernels::SKernels(TSampleConverterKernels::kScalar);
+
+  for (int i = 0; i < TSampleConverterKernels::kNumberOfInstructionSets; ++i)
+  {
+    const TSampleConverterKernels::TInstructionSet InstructionSet = 
+      (TSampleConverterKernels::TInstructionSet)i;
+
+    if (!TSampleConverterKernels::SIsSupported(InstructionSet))
+    {
+      BOOST_TEST_MESSAGE("    Skipping unsupported " << 
+        TSampleConverterKernels::SInstructionSetName(InstructionSet) << " kernels");
+      continue;
+    }
+
+    const TSampleConverterKernels& Kernels = 
+      TSampleConverterKernels::SKernels(InstructionSet);
+    BOOST_CHECK_EQUAL((int)Kernels.mInstructionSet, i);
+
+    SCheckConverterKernels<TInt8>(Kernels, ScalarKernels, 
+      TAudioFile::k8BitSigned,
+      &TSampleConverterKernels::mpInt8BitSignedToInternalFloat,
+      &TSampleConverterKernels::mpInt8BitSignedStereoToInternalFloatMono);
+
+    SCheckConverterKernels<TUInt8>(Kernels, ScalarKernels, 
+      TAudioFile::k8BitUnsigned,
+      &TSampleConverterKernels::mpInt8BitUnsignedToInternalFloat,
+      &TSampleConverterKernels::mpInt8BitUnsignedStereoToInternalFloatMono);
+
+    SCheckConverterKernels<TInt16>(Kernels, ScalarKernels, 
+      TAudioFile::k16Bit,
+      &TSampleConverterKernels::mpInt16BitToInternalFloat,
+      &TSampleConverterKernels::mpInt16BitStereoToInternalFloatMono);
+
+    SCheckConverterKernels<T24>(Kernels, ScalarKernels, 
+      TAudioFile::k24Bit,
+      &TSampleConverterKernels::mpInt24BitToInternalFloat,
+      &TSampleConverterKernels::mpInt24BitStereoToInternalFloatMono);
+
+    SCheckConverterKernels<TInt32>(Kernels, ScalarKernels, 
+      TAudioFile::k32BitInt,
+      &TSampleConverterKernels::mpInt32BitToInternalFloat,
+      &TSampleConverterKernels::mpInt32BitStereoToInternalFloatMono);
+
+    SCheckConverterKernels<float>(Kernels, ScalarKernels, 
+      TAudioFile::k32BitFloat,
+      &TSampleConverterKernels::mpFloat32BitToInternalFloat,
+      &TSampleConverterKernels::mpFloat32BitStereoToInternalFloatMono);
+
+    SCheckConverterKernels<double>(Kernels, ScalarKernels, 
+      TAudioFile::k64BitFloat,
+      &TSampleConverterKernels::mpFloat64BitToInternalFloat,
+      &TSampleConverterKernels::mpFloat64BitStereoToInternalFloatMono);
+
+    SCheckCopySwappedKernel(Kernels.mpCopySwapped16Bit, 2);
+    SCheckCopySwappedKernel(Kernels.mpCopySwapped24Bit, 3);
+    SCheckCopySwappedKernel(Kernels.mpCopySwapped32Bit, 4);
+    SCheckCopySwappedKernel(Kernels.mpCopySwapped64Bit, 8);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TCoreFileFormatsTest::SampleConverterBenchmark()
+{
+  // ... Compare kernel speeds against the scalar implementation
+
+  const int NumberOfFrames = 4096;
+  const int NumberOfIterations = 2000;
+
+  TArray<char> Int16Data, Int24Data, Float32Data;
+  SRandomSampleData(Int16Data, TAudioFile::k16Bit, 2 * NumberOfFrames);
+  SRandomSampleData(Int24Data, TAudioFile::k24Bit, 2 * NumberOfFrames);
+  SRandomSampleData(Float32Data, TAudioFile::k32BitFloat, 2 * NumberOfFrames);
+
+  TArray<float> Left(NumberOfFrames), Right(NumberOfFrames);
+  float* const pDestBuffers[2] = { Left.FirstWrite(), Right.FirstWrite() };
+
+  double ScalarTimeInMs = 0.0;
+
+  for (int i = 0; i < TSampleConverterKernels::kNumberOfInstructionSets; ++i)
+  {
+    const TSampleConverterKernels::TInstructionSet InstructionSet = 
+      (TSampleConverterKernels::TInstructionSet)i;
+
+    if (!TSampleConverterKernels::SIsSupported(InstructionSet))
+    {
+      continue;
+    }
+
+    const TSampleConverterKernels& Kernels = 
+      TSampleConverterKernels::SKernels(InstructionSet);
+
+    // deinterleave and convert stereo 16, 24 bit and float data
+    TStamp Time;
+    for (int n = 0; n < NumberOfIterations; ++n)
+    {
+      Kernels.mpInt16BitToInternalFloat((const TInt16*)Int16Data.FirstRead(), 
+        pDestBuffers, 2, NumberOfFrames);
+      Kernels.mpInt24BitToInternalFloat((const T24*)Int24Data.FirstRead(), 
+        pDestBuffers, 2, NumberOfFrames);
+      Kernels.mpFloat32BitToInternalFloat((const float*)Float32Data.FirstRead(), 
+        pDestBuffers, 2, NumberOfFrames);
+    }
+    const double TimeInMs = Time.DiffInMs();
+
+    if (InstructionSet == TSampleConverterKernels::kScalar)
+    {
+      ScalarTimeInMs = TimeInMs;
+    }
+
+    const double MegaSamplesPerSecond = 3.0 * 2.0 * NumberOfFrames * 
+      NumberOfIterations / MMax(TimeInMs, 0.001) / 1000.0;
+
+    std::stringstream Message;
+    Message.precision(2);
+    Message << std::fixed << "    " << 
+      TSampleConverterKernels::SInstructionSetName(InstructionSet) << " kernels: " << 
+      TimeInMs << " ms, " << MegaSamplesPerSecond << " MSamples/s (x" << 
+      ScalarTimeInMs / MMax(TimeInMs, 0.001) << ")";
+
+    BOOST_TEST_MESSAGE(Message.str());
+  }
+
+  BOOST_CHECK(true);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! write 16 bit PCM data into a plain RIFF WAVE file. 
+//! @return offset of the PCM data in the file.
+static long long SWriteWaveFile(
+  const TString&        FileName,
+  const TArray<TInt16>& InterleavedSamples,
+  int                   NumberOfChannels)
+{
+  const TUInt32 DataSize = (TUInt32)(InterleavedSamples.Size() * sizeof(TInt16));
+
+  TFile File(FileName, TByteOrder::kIntel);
+  BOOST_REQUIRE(File.Open(TFile::kWrite));
+
+  File.Write("RIFF", 4);
+  File.Write((TUInt32)(4 + 8 + 16 + 8 + DataSize));
+  File.Write("WAVE", 4);
+
+  File.Write("fmt ", 4);
+  File.Write((TUInt32)16);
+  File.Write((TUInt16)1); // PCM
+  File.Write((TUInt16)NumberOfChannels);
+  File.Write((TUInt32)44100);
+  File.Write((TUInt32)(44100 * NumberOfChannels * sizeof(TInt16)));
+  File.Write((TUInt16)(NumberOfChannels * sizeof(TInt16)));
+  File.Write((TUInt16)16);
+
+  File.Write("data", 4);
+  File.Write(DataSize);
+
+  const long long SampleDataOffset = (long long)File.Position();
+  File.Write(InterleavedSamples.FirstRead(), InterleavedSamples.Size());
+
+  return SampleDataOffset;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! write 16 bit PCM data into a plain, big-endian AIFF file. 
+//! @return offset of the PCM data in the file.
+static long long SWriteAiffFile(
+  const TString&        FileName,
+  const TArray<TInt16>& InterleavedSamples,
+  int                   NumberOfChannels)
+{
+  const TUInt32 DataSize = (TUInt32)(InterleavedSamples.Size() * sizeof(TInt16));
+
+  // 44100 as 80 bit IEEE 754 extended float
+  const char SampleRate[10] = { 0x40, 0x0E, (char)0xAC, 0x44, 0, 0, 0, 0, 0, 0 };
+
+  TFile File(FileName, TByteOrder::kMotorola);
+  BOOST_REQUIRE(File.Open(TFile::kWrite));
+
+  File.Write("FORM", 4);
+  File.Write((TUInt32)(4 + 8 + 18 + 8 + 8 + DataSize));
+  File.Write("AIFF", 4);
+
+  File.Write("COMM", 4);
+  File.Write((TUInt32)18);
+  File.Write((TInt16)NumberOfChannels);
+  File.Write((TUInt32)(InterleavedSamples.Size() / NumberOfChannels));
+  File.Write((TInt16)16);
+  File.Write(SampleRate, sizeof(SampleRate));
+
+  File.Write("SSND", 4);
+  File.Write((TUInt32)(8 + DataSize));
+  File.Write((TUInt32)0); // offset
+  File.Write((TUInt32)0); // block size
+
+  const long long SampleDataOffset = (long long)File.Position();
+  File.Write(InterleavedSamples.FirstRead(), InterleavedSamples.Size());
+
+  return SampleDataOffset;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! read all samples from the given stereo stream in odd sized blocks, so that
+//! blocks straddle the mapped window boundaries.
+static void SReadStereoStream(
+  TAudioStream*   pStream,
+  TArray<float>&  Left,
+  TArray<float>&  Right)
+{
+  const int NumberOfFrames = (int)pStream->NumSamples();
+  const int BlockSize = 3001;
+
+  Left.SetSize(NumberOfFrames);
+  Right.SetSize(NumberOfFrames);
+
+  TArray<float*> DestChannelPtrs(2);
+
+  for (int Frame = 0; Frame < NumberOfFrames; Frame += BlockSize)
+  {
+    DestChannelPtrs[0] = Left.FirstWrite() + Frame;
+    DestChannelPtrs[1] = Right.FirstWrite() + Frame;
+
+    pStream->ReadSamples(DestChannelPtrs, MMin(BlockSize, NumberOfFrames - Frame));
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! read a file via TAudioFile, which maps read-only files, and via a non 
+//! mapped TAudioFileStream on the same file, opened in (non truncating) read/append mode.
+static void SCheckMappedAndStreamedReads(
+  TAudioFile*             pAudioFile,
+  const TString&          FileName,
+  long long               SampleDataOffset,
+  TByteOrder::TByteOrder  SampleDataByteOrder,
+  const TArray<TInt16>&   InterleavedSamples)
+{
+  const int NumberOfFrames = InterleavedSamples.Size() / 2;
+
+  TArray<float> ExpectedLeft(NumberOfFrames), ExpectedRight(NumberOfFrames);
+  for (int i = 0; i < NumberOfFrames; ++i)
+  {
+    ExpectedLeft[i] = (float)InterleavedSamples[2 * i];
+    ExpectedRight[i] = (float)InterleavedSamples[2 * i + 1];
+  }
+
+  // ... mapped
+
+  TArray<float> MappedLeft, MappedRight;
+
+  pAudioFile->OpenForRead(FileName);
+  BOOST_CHECK_EQUAL(pAudioFile->SampleType(), TAudioFile::k16Bit);
+  BOOST_CHECK_EQUAL(pAudioFile->NumChannels(), 2);
+  BOOST_REQUIRE_EQUAL(pAudioFile->NumSamples(), NumberOfFrames);
+  SReadStereoStream(pAudioFile->Stream(), MappedLeft, MappedRight);
+  pAudioFile->Close();
+
+  // ... streamed
+
+  TArray<float> StreamedLeft, StreamedRight;
+
+  TFile File(FileName, SampleDataByteOrder);
+  BOOST_REQUIRE(File.Open(TFile::kReadWriteAppend));
+  TPtr<TAudioStream> pStream(new TAudioFileStream(&File, SampleDataOffset, 
+    NumberOfFrames, 2, TAudioFile::k16Bit, SampleDataByteOrder));
+  SReadStereoStream(pStream, StreamedLeft, StreamedRight);
+  pStream = NULL;
+  File.Close();
+
+  BOOST_CHECK_ARRAYS_EQUAL(MappedLeft, MappedLeft.Size(), 
+    StreamedLeft, StreamedLeft.Size());
+  BOOST_CHECK_ARRAYS_EQUAL(MappedRight, MappedRight.Size(), 
+    StreamedRight, StreamedRight.Size());
+
+  BOOST_CHECK_ARRAYS_EQUAL(MappedLeft, MappedLeft.Size(), 
+    ExpectedLeft, ExpectedLeft.Size());
+  BOOST_CHECK_ARRAYS_EQUAL(MappedRight, MappedRight.Size(), 
+    ExpectedRight, ExpectedRight.Size());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TCoreFileFormatsTest::MappedAudioFile()
+{
+  const TDirectory TempDir = gTempDir(); 
+
+  // ... 16 bit stereo files which span more than two default mapping windows
+
+  const int NumberOfFrames = 2 * TMappedFileView::kDefaultWindowSize / 4 + 12345;
+
+  TArray<TInt16> InterleavedSamples(2 * NumberOfFrames);
+  for (int i = 0; i < InterleavedSamples.Size(); ++i)
+  {
+    InterleavedSamples[i] = (TInt16)(TRandom::Integer(0x10000) - 0x8000);
+  }
+
+  const TString WaveFileName = TempDir.Path() + "MappedStereo.wav";
+  const long long WaveDataOffset = SWriteWaveFile(WaveFileName, InterleavedSamples, 2);
+
+  TPtr<TWaveFile> pWaveFile(new TWaveFile());
+  SCheckMappedAndStreamedReads(pWaveFile, WaveFileName, 
+    WaveDataOffset, TByteOrder::kIntel, InterleavedSamples);
+
+  const TString AiffFileName = TempDir.Path() + "MappedStereo.aiff";
+  const long long AiffDataOffset = SWriteAiffFile(AiffFileName, InterleavedSamples, 2);
+
+  TPtr<TAifFile> pAiffFile(new TAifFile());
+  SCheckMappedAndStreamedReads(pAiffFile, AiffFileName, 
+    AiffDataOffset, TByteOrder::kMotorola, InterleavedSamples);
+
+  // ... map ranges of a file through a small window and compare with plain reads
+
+  const size_t WindowSize = 64 * 1024;
+
+  TFile File(WaveFileName);
+  BOOST_REQUIRE(File.Open(TFile::kRead));
+
+  const long long FileSize = (long long)File.SizeInBytes();
+  TMappedFileView View(&File, WindowSize);
+
+  TArray<char> Expected;
+  for (int Run = 0; Run < 64; ++Run)
+  {
+    // small and window sized ranges, including some which cross window boundaries
+    const size_t Size = (Run % 4 == 0) ? WindowSize : 1 + TRandom::Integer(4096);
+    const long long Offset = (Run % 2 == 0) ? 
+      (long long)TRandom::Integer((int)(FileSize - Size)) : 
+      (long long)(1 + TRandom::Integer(16)) * WindowSize - Size / 2;
+
+    const char* pMapped = View.Map(Offset, Size);
+    BOOST_REQUIRE(pMapped != NULL);
+
+    Expected.SetSize((int)Size);
+    size_t BytesToRead = Size;
+    File.SetPosition((size_t)Offset);
+    BOOST_REQUIRE(File.ReadBytes(Expected.FirstWrite(), &BytesToRead));
+    BOOST_REQUIRE_EQUAL(BytesToRead, Size);
+
+    BOOST_CHECK(::memcmp(pMapped, Expected.FirstRead(), Size) == 0);
+  }
+
+  // ranges outside of the file can't be mapped
+  BOOST_CHECK(View.Map(FileSize - 10, 11) == NULL);
+  BOOST_CHECK(View.Map(FileSize, 1) == NULL);
+
+  View.Unmap();
+  File.Close();
+
+  TFile(WaveFileName).Unlink();
+  TFile(AiffFileName).Unlink();
+}
@@ -8,6 +8,9 @@
 namespace TCoreFileFormatsTest
 {
   void AudioFile();
+  void MappedAudioFile();
+  void SampleConverter();
+  void SampleConverterBenchmark();
 }
 
 
@@ -19,7 +19,9 @@ namespace TCpu
     kE3dnow         = 1 << 2,
     kSse            = 1 << 3,
     kSse2           = 1 << 4,
-    kAltiVec        = 1 << 5
+    kAltiVec        = 1 << 5,
+    kAvx            = 1 << 6,
+    kAvx2           = 1 << 7
   };
   typedef unsigned int TCpuCapsFlags;
 
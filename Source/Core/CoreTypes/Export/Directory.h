@@ -13,6 +13,7 @@
 
 #include <ctime> // time_t
 #include <map>
+#include <mutex>
 #include <functional>
 
 // =================================================================================================
@@ -123,6 +124,7 @@ public:
   // When recursively walking folders, instanciate TSymLinkRecursionTest outside of 
   // the initial 'FindSubDir' and pass this instance to all following FindSubDir calls.
   // When a recursion is detected, 'FindSubDir' will not include the folder anymore.
+  // Tests are thread-safe, so a single instance can also be used in 'Traverse'.
   class TSymLinkRecursionTest
   {
   public:
@@ -133,6 +135,7 @@ public:
       const TDirectory& LinkTarget);
   
   private:
+    std::mutex mLock;
     std::map<TString, TList<TString> > mVisitedDirectories;
   };
 
@@ -158,6 +161,40 @@ public:
   TList<TFileProperties> FindSubDirs(
     const TString&          Searchmask = TString("*"),
     TSymLinkRecursionTest*  pSymLinkRecursionTest = NULL)const;
+
+  //! Same as FindFileNames and FindSubDirNames("*"), but in a single pass. On Linux,
+  //! entries are classified via the directory entry types, so only symlinks and
+  //! entries of file systems which provide no entry types need to be stat'ed.
+  void FindFileAndSubDirNames(
+    const TList<TString>&   Extensions,
+    TList<TString>&         FileNames,
+    TList<TString>&         SubDirNames,
+    TSymLinkRecursionTest*  pSymLinkRecursionTest = NULL)const;
+
+  //! Function which receives the matching file names (without path) of a single
+  //! directory in \function Traverse. Return false to stop traversing.
+  typedef std::function<bool (
+    const TDirectory&     Directory, 
+    const TList<TString>& FileNames)> TTraverseFilesFunction;
+  //! Function which decides if the given sub directory of \param Directory 
+  //! should be traversed in \function Traverse.
+  typedef std::function<bool (
+    const TDirectory& Directory, 
+    const TString&    SubDirName)> TTraverseSubDirFilter;
+
+  //! Recursively walk this directory and all its sub directories, reading each
+  //! directory only once. Sub directories are fanned out to \param NumberOfThreads 
+  //! threads (including the calling one). Matching files are streamed, directory 
+  //! by directory, to \param FilesFunction. \param FilesFunction calls are 
+  //! serialized, \param SubDirFilter calls may be invoked concurrently.
+  //! When param TSymLinkRecursionTest is set, recursive symlinks are not followed.
+  //! Exceptions from the functions stop the walk and are rethrown here.
+  void Traverse(
+    const TList<TString>&         Extensions,
+    const TTraverseFilesFunction& FilesFunction,
+    const TTraverseSubDirFilter&  SubDirFilter = TTraverseSubDirFilter(),
+    int                           NumberOfThreads = 1,
+    TSymLinkRecursionTest*        pSymLinkRecursionTest = NULL)const;
   //@}
   
   
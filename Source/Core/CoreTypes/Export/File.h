@@ -117,6 +117,23 @@ public:
   //! return the time, where the file was modified, as used in stat
   int ModificationStatTime()const;
   //@}
+
+  //! Size, modification time and identity of a file
+  struct TStat
+  {
+    TStat() 
+      : mSizeInBytes(0), mModificationStatTime(0), mFileId(0) {}
+
+    long long mSizeInBytes;
+    //! modification time, as used in stat
+    int mModificationStatTime;
+    //! unique id of the file on its volume (inode) or 0 when unknown
+    long long mFileId;
+  };
+
+  //! fetch the file's size, modification time and id with a single stat call.
+  //! File has no (but can be) open. @return false when the file does not exist.
+  bool Stat(TStat& Stat)const;
   
   //@{ Generic base type reading/writing. 
   //   Will assert on non base types to avoid problems with endian safeness 
@@ -207,6 +224,8 @@ public:
   //@}
   
 private:
+  friend class TMappedFileView;
+
   //! private and not implemented: size of long and thus reading/writing 
   //! long is not portable. Use TInt32 or TInt64 instead...
   void Read(long& Value);
@@ -261,6 +280,50 @@ private:
 
 // =================================================================================================
 
+/*!
+ * Read-only, memory mapped view into a file which is open for reading. 
+ * Only a window of the file gets mapped at once: the window is moved on demand 
+ * when accessing regions outside of the currently mapped one, so large files 
+ * can be read sequentially without mapping them completely.
+!*/
+
+class TMappedFileView
+{
+public:
+  enum { 
+    kDefaultWindowSize = 4 * 1024 * 1024 
+  };
+
+  //! The file must stay open for reading as long as the view is used.
+  TMappedFileView(const TFile* pFile, size_t WindowSize = kDefaultWindowSize);
+  ~TMappedFileView();
+
+  //! Returns a pointer to the given range of bytes in the file, remapping the 
+  //! view when necessary. Returns NULL, when the range is not part of the file 
+  //! or the file can't be mapped. Returned pointers are valid until the next 
+  //! Map or Unmap call.
+  const char* Map(long long Offset, size_t Size);
+
+  //! release the currently mapped window, if any
+  void Unmap();
+
+private:
+  TMappedFileView(const TMappedFileView& Other);
+  TMappedFileView& operator=(const TMappedFileView& Other);
+
+  const TFile* mpFile;
+  const size_t mWindowSize;
+
+  long long mFileSize;
+  bool mMappingFailed;
+
+  char* mpView;
+  long long mViewOffset;
+  size_t mViewSize;
+};
+
+// =================================================================================================
+
 // -------------------------------------------------------------------------------------------------
 
 template <typename T>
@@ -4,6 +4,11 @@
 
 #include <cstring>
 #include <cwctype> 
+#include <deque>
+#include <vector>
+#include <thread>
+#include <condition_variable>
+#include <exception>
  
 // =================================================================================================
 
@@ -39,6 +44,8 @@ bool TDirectory::TSymLinkRecursionTest::IsRecursedLink(
   const TDirectory& LinkSrcDirectory, 
   const TDirectory& LinkTargetDirectory)
 {
+  const std::lock_guard<std::mutex> Lock(mLock);
+
   // subpath of resolved path? 
   if (LinkSrcDirectory.IsSubDirOf(LinkTargetDirectory)) 
   {
@@ -285,6 +292,128 @@ TDirectory& TDirectory::Descend(const TString& NewSubDir)
   
 // -------------------------------------------------------------------------------------------------
 
+void TDirectory::Traverse(
+  const TList<TString>&         Extensions,
+  const TTraverseFilesFunction& FilesFunction,
+  const TTraverseSubDirFilter&  SubDirFilter,
+  int                           NumberOfThreads,
+  TSymLinkRecursionTest*        pSymLinkRecursionTest)const
+{
+  MAssert(Exists(), "Traversing a non existing directory");
+
+  // guards all pending state below
+  std::mutex Lock;
+  std::condition_variable Condition;
+
+  std::deque<TDirectory> PendingDirectories;
+  PendingDirectories.push_back(*this);
+  int NumberOfBusyWorkers = 0;
+  bool Stop = false;
+
+  std::exception_ptr pFirstError;
+
+  // serializes FilesFunction calls
+  std::mutex FilesFunctionLock;
+
+  auto Worker = [&]() {
+    for (;;)
+    {
+      TDirectory Directory;
+      {
+        std::unique_lock<std::mutex> WaitLock(Lock);
+        
+        // wait for work, until no busy worker can produce any new work
+        Condition.wait(WaitLock, [&]() {
+          return Stop || !PendingDirectories.empty() || NumberOfBusyWorkers == 0;
+        });
+
+        if (Stop || PendingDirectories.empty())
+        {
+          return;
+        }
+
+        Directory = PendingDirectories.front();
+        PendingDirectories.pop_front();
+        ++NumberOfBusyWorkers;
+      }
+
+      TList<TDirectory> SubDirectories;
+      bool Continue = true;
+      
+      try
+      {
+        TList<TString> FileNames, SubDirNames;
+        Directory.FindFileAndSubDirNames(
+          Extensions, FileNames, SubDirNames, pSymLinkRecursionTest);
+
+        if (!FileNames.IsEmpty())
+        {
+          const std::lock_guard<std::mutex> FunctionLock(FilesFunctionLock);
+          Continue = FilesFunction(Directory, FileNames);
+        }
+
+        for (int i = 0; i < SubDirNames.Size() && Continue; ++i)
+        {
+          if (!SubDirFilter || SubDirFilter(Directory, SubDirNames[i]))
+          {
+            SubDirectories.Append(TDirectory(Directory).Descend(SubDirNames[i]));
+          }
+        }
+      }
+      catch (...)
+      {
+        const std::lock_guard<std::mutex> ErrorLock(Lock);
+        if (!pFirstError)
+        {
+          pFirstError = std::current_exception();
+        }
+        Continue = false;
+      }
+
+      {
+        const std::lock_guard<std::mutex> QueueLock(Lock);
+
+        if (!Continue)
+        {
+          Stop = true;
+        }
+        else
+        {
+          // prefer walking depth first, to keep the number of pending dirs low
+          for (int i = SubDirectories.Size() - 1; i >= 0; --i)
+          {
+            PendingDirectories.push_front(SubDirectories[i]);
+          }
+        }
+
+        --NumberOfBusyWorkers;
+      }
+
+      Condition.notify_all();
+    }
+  };
+
+  std::vector<std::thread> Threads;
+  for (int i = 1; i < NumberOfThreads; ++i)
+  {
+    Threads.push_back(std::thread(Worker));
+  }
+
+  Worker();
+
+  for (auto& Thread : Threads)
+  {
+    Thread.join();
+  }
+
+  if (pFirstError)
+  {
+    std::rethrow_exception(pFirstError);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void TDirectory::DeleteAllFiles()const
 {
   if (Exists())
@@ -16,9 +16,11 @@
 #elif defined(MMac)
   #include <fcntl.h>  // ::fcntl
   #include <unistd.h> // unlink
+  #include <sys/mman.h> // ::mmap
 
 #elif defined(MLinux)
   #include <unistd.h> // ::fsync
+  #include <sys/mman.h> // ::mmap
 
 #endif
 
@@ -507,6 +509,60 @@ int TFile::ModificationStatTime()const
 
 // -------------------------------------------------------------------------------------------------
 
+bool TFile::Stat(TStat& Stat)const
+{
+  if (mFileName.IsEmpty())
+  {
+    return false;
+  }
+
+  #if defined(MWindows)
+    // NB: avoid using stat here. It's broken in the WinXP runtime.
+    WIN32_FILE_ATTRIBUTE_DATA Attributes;
+    if (!::GetFileAttributesEx(mFileName.Chars(), GetFileExInfoStandard, &Attributes) ||
+        (Attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+      return false;
+    }
+
+    LARGE_INTEGER Size;
+    Size.HighPart = Attributes.nFileSizeHigh;
+    Size.LowPart = Attributes.nFileSizeLow;
+    Stat.mSizeInBytes = Size.QuadPart;
+
+    // convert Windows filetime_t into a UNIX time_t (see ModificationStatTime)
+    LARGE_INTEGER Time;
+    Time.HighPart = Attributes.ftLastWriteTime.dwHighDateTime;
+    Time.LowPart = Attributes.ftLastWriteTime.dwLowDateTime;
+    Time.QuadPart -= 11644473600000 * 10000;
+    Stat.mModificationStatTime = (int)(Time.QuadPart / 10000000);
+
+    // file ids would need an open file handle on Windows
+    Stat.mFileId = 0;
+    
+    return true;
+
+  #else
+    const std::string Utf8FileName = 
+      mFileName.StdCString(TString::kFileSystemEncoding);
+  
+    struct stat buf;
+    if (::stat(Utf8FileName.c_str(), &buf) != 0 || S_ISDIR(buf.st_mode))
+    {
+      return false;
+    }
+
+    Stat.mSizeInBytes = (long long)buf.st_size;
+    Stat.mModificationStatTime = (int)buf.st_mtime;
+    Stat.mFileId = (long long)buf.st_ino;
+    
+    return true;
+
+  #endif
+}
+
+// -------------------------------------------------------------------------------------------------
+
 bool TFile::Unlink()
 {
   MAssert(!IsOpen(), "Can only unlink closed Files !");
@@ -959,6 +1015,164 @@ TFileSetAndRestoreByteOrder::~TFileSetAndRestoreByteOrder()
 
 // -------------------------------------------------------------------------------------------------
 
+TMappedFileView::TMappedFileView(const TFile* pFile, size_t WindowSize)
+  : mpFile(pFile),
+    mWindowSize(WindowSize),
+    mFileSize(-1),
+    mMappingFailed(false),
+    mpView(NULL),
+    mViewOffset(0),
+    mViewSize(0)
+{
+  MAssert(mpFile && mpFile->IsOpenForReading(), "Expected a file open for reading");
+  MAssert(mWindowSize > 0, "Invalid window size");
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TMappedFileView::~TMappedFileView()
+{
+  Unmap();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+const char* TMappedFileView::Map(long long Offset, size_t Size)
+{
+  MAssert(mpFile->IsOpenForReading(), "File is not or no longer open");
+
+  // ... fast path: range is in the current window
+
+  if (mpView && Offset >= mViewOffset && 
+      Offset + (long long)Size <= mViewOffset + (long long)mViewSize)
+  {
+    return mpView + (Offset - mViewOffset);
+  }
+
+  if (mMappingFailed)
+  {
+    return NULL;
+  }
+
+  // ... fetch the file size (once) and the platforms mapping granularity
+
+  #if defined(MWindows)
+    const HANDLE FileHandle = (HANDLE)::_get_osfhandle(::_fileno(mpFile->mFileHandle));
+
+    if (mFileSize < 0)
+    {
+      LARGE_INTEGER FileSize;
+      if (FileHandle == INVALID_HANDLE_VALUE || !::GetFileSizeEx(FileHandle, &FileSize))
+      {
+        mMappingFailed = true;
+        return NULL;
+      }
+      mFileSize = (long long)FileSize.QuadPart;
+    }
+
+    SYSTEM_INFO SystemInfo;
+    ::GetSystemInfo(&SystemInfo);
+    const long long Granularity = (long long)SystemInfo.dwAllocationGranularity;
+
+  #else
+    const int FileDescriptor = ::fileno(mpFile->mFileHandle);
+
+    if (mFileSize < 0)
+    {
+      struct stat buf;
+      if (::fstat(FileDescriptor, &buf) != 0)
+      {
+        mMappingFailed = true;
+        return NULL;
+      }
+      mFileSize = (long long)buf.st_size;
+    }
+
+    const long long Granularity = (long long)::sysconf(_SC_PAGESIZE);
+
+  #endif
+
+  if (Offset < 0 || Size == 0 || Offset + (long long)Size > mFileSize)
+  {
+    return NULL;
+  }
+
+  // ... move the window: align its start and map at least the requested range
+
+  Unmap();
+
+  const long long ViewOffset = Offset - Offset % Granularity;
+  const long long ViewSize = MMin(mFileSize - ViewOffset,
+    MMax((long long)mWindowSize, Offset - ViewOffset + (long long)Size));
+
+  #if defined(MWindows)
+    const HANDLE MappingHandle = ::CreateFileMapping(
+      FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (MappingHandle == NULL)
+    {
+      mMappingFailed = true;
+      return NULL;
+    }
+
+    void* pView = ::MapViewOfFile(MappingHandle, FILE_MAP_READ,
+      (DWORD)((unsigned long long)ViewOffset >> 32), 
+      (DWORD)((unsigned long long)ViewOffset & 0xFFFFFFFF), 
+      (SIZE_T)ViewSize);
+
+    // the view keeps a reference to the mapping
+    ::CloseHandle(MappingHandle);
+
+    if (pView == NULL)
+    {
+      mMappingFailed = true;
+      return NULL;
+    }
+
+  #else
+    void* pView = ::mmap(NULL, (size_t)ViewSize, PROT_READ, MAP_SHARED, 
+      FileDescriptor, (off_t)ViewOffset);
+
+    if (pView == MAP_FAILED)
+    {
+      mMappingFailed = true;
+      return NULL;
+    }
+
+    // views are usually read front to back: enable aggressive read-ahead
+    ::madvise(pView, (size_t)ViewSize, MADV_SEQUENTIAL);
+
+  #endif
+
+  mpView = (char*)pView;
+  mViewOffset = ViewOffset;
+  mViewSize = (size_t)ViewSize;
+
+  return mpView + (Offset - mViewOffset);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TMappedFileView::Unmap()
+{
+  if (mpView)
+  {
+    #if defined(MWindows)
+      ::UnmapViewOfFile(mpView);
+    #else
+      ::munmap(mpView, mViewSize);
+    #endif
+
+    mpView = NULL;
+    mViewOffset = 0;
+    mViewSize = 0;
+  }
+}
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
 TFileStamp::TFileStamp(TFile* pFile)
   : mpFile(pFile)
 {
@@ -4,6 +4,7 @@
 #include <set>
 
 #include <cstring> // strchr, strstr, strcasecmp
+#include <cctype> // isspace
 #include <unistd.h>
 
 // =================================================================================================
@@ -37,6 +38,29 @@ private:
 
 // -------------------------------------------------------------------------------------------------
 
+//! returns true when the space separated flag list contains the given flag.
+//! Unlike strstr, "avx" will not match "avx2" or "avx512f".
+static bool SHasFlag(const char* pFlags, const char* pFlag)
+{
+  const size_t FlagLength = ::strlen(pFlag);
+
+  for (const char* pMatch = ::strstr(pFlags, pFlag); pMatch != NULL; 
+       pMatch = ::strstr(pMatch + 1, pFlag))
+  {
+    const bool StartsWord = (pMatch == pFlags || ::isspace(pMatch[-1]));
+    const bool EndsWord = (pMatch[FlagLength] == '\0' || ::isspace(pMatch[FlagLength]));
+
+    if (StartsWord && EndsWord)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// -------------------------------------------------------------------------------------------------
+
 TSystemInfo TSystemInfo::SSystemInfo()
 {
   TSystemInfo Info;
@@ -49,7 +73,8 @@ TSystemInfo TSystemInfo::SSystemInfo()
     
   core_entry current_core_entry;
 
-  char line[200];
+  // NB: flags lines of recent CPUs are way longer than 1k
+  char line[4096];
   FILE *f = ::fopen("/proc/cpuinfo", "r");
 
   if (!f)
@@ -253,6 +278,17 @@ TSystemInfo TSystemInfo::SSystemInfo()
         Info.mCpuFlags |= TCpu::kSse2;
       }
       
+      // NB: the kernel only lists avx flags when it also saves the AVX state
+      if (SHasFlag(value, "avx"))
+      {
+        Info.mCpuFlags |= TCpu::kAvx;
+      }
+      
+      if (SHasFlag(value, "avx2"))
+      {
+        Info.mCpuFlags |= TCpu::kAvx2;
+      }
+      
       continue;
     }
   }
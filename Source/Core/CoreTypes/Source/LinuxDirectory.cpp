@@ -6,6 +6,7 @@
 #include <sys/stat.h>
 
 #include <dirent.h>
+#include <fcntl.h> // AT_SYMLINK_NOFOLLOW
 #include <pwd.h>
 #include <unistd.h>
 
@@ -718,6 +719,121 @@ TList<TFileProperties> TDirectory::FindSubDirs(
 
 // -------------------------------------------------------------------------------------------------
 
+void TDirectory::FindFileAndSubDirNames(
+  const TList<TString>&   Extensions,
+  TList<TString>&         FileNames,
+  TList<TString>&         SubDirNames,
+  TSymLinkRecursionTest*  pSymlinkChecker)const
+{
+  MAssert(Exists(), "Querying for files in a non existing directory");
+  
+  const std::string PathCString = Path().StdCString(TString::kFileSystemEncoding);
+  MAssert(PathCString[PathCString.size() - 1] == '/', "Expected a trailing /");
+
+  FileNames.Empty();
+  SubDirNames.Empty();
+
+  // open directory
+  DIR* dir = ::opendir(PathCString.c_str());
+
+  if (!dir)
+  {
+    // opendir failed (may not have sufficient permissions)
+    return;
+  }
+
+  const TList<TString> SubDirExtensions = MakeList<TString>("*");
+
+  dirent* dp;
+
+  // loop while there are still entries
+  while ((dp = ::readdir(dir)) != NULL)
+  {
+    if (dp->d_name[0] == 0 || ::strcmp(dp->d_name, ".") == 0 || ::strcmp(dp->d_name, "..") == 0)
+    {
+      continue;
+    }
+
+    unsigned char EntryType = dp->d_type;
+    
+    // stat entries only when the file system provides no entry types
+    if (EntryType == DT_UNKNOWN)
+    {
+      struct stat EntryInfo;
+      if (::fstatat(::dirfd(dir), dp->d_name, &EntryInfo, AT_SYMLINK_NOFOLLOW) != 0)
+      {
+        continue;
+      }
+
+      EntryType = S_ISREG(EntryInfo.st_mode) ? DT_REG :
+        S_ISDIR(EntryInfo.st_mode) ? DT_DIR :
+        S_ISLNK(EntryInfo.st_mode) ? DT_LNK : DT_UNKNOWN;
+    }
+
+    bool IsFile = false, IsDirectory = false;
+    
+    if (EntryType == DT_REG)
+    {
+      IsFile = true;
+    }
+    else if (EntryType == DT_DIR)
+    {
+      IsDirectory = true;
+    }
+    else if (EntryType == DT_LNK)
+    {
+      // resolve links to get the type of the link target
+      if (PathCString.size() + ::strlen(dp->d_name) >= PATH_MAX + NAME_MAX)
+      {
+        MInvalid("Unexpected path size...");
+        continue;
+      }
+
+      char fullpath[PATH_MAX + NAME_MAX];
+      ::strcpy(fullpath, PathCString.c_str());
+      ::strcat(fullpath, dp->d_name);
+
+      char linkbuf[PATH_MAX + NAME_MAX];
+      struct stat LinkInfo;
+      if (SResolveLink(linkbuf, sizeof(linkbuf), fullpath) && 
+          ::lstat(linkbuf, &LinkInfo) == 0)
+      {
+        if (S_ISREG(LinkInfo.st_mode))
+        {
+          IsFile = true;
+        }
+        else if (S_ISDIR(LinkInfo.st_mode))
+        {
+          // check for recursive links, when pSymlinkChecker is present
+          IsDirectory = (pSymlinkChecker == NULL || 
+            !pSymlinkChecker->IsRecursedLink(
+              TDirectory(TString(fullpath, TString::kFileSystemEncoding)), 
+              TDirectory(TString(linkbuf, TString::kFileSystemEncoding))));
+        }
+      }
+    }
+
+    if (IsFile || IsDirectory)
+    {
+      const TString Name = TString(dp->d_name, TString::kFileSystemEncoding);
+
+      if (IsFile && gFileMatchesExtension(Name, Extensions))
+      {
+        FileNames.Append(Name);
+      }
+      else if (IsDirectory && gFileMatchesExtension(Name, SubDirExtensions))
+      {
+        SubDirNames.Append(Name);
+      }
+    }
+  }
+  
+  // close directory when we're done
+  ::closedir(dir);
+}
+
+// -------------------------------------------------------------------------------------------------
+
 bool TDirectory::Create(bool CreateParentDirs)const
 {
   if (Exists())
@@ -120,6 +120,23 @@ void TCpuImpl::Init()
       ::perror("Failed to query sysctl hw.optional.sse2. Assuming false");
     }
     
+    // NB: avx flags are missing on older OSX versions: silently assume false then
+    unsigned int  avx;
+    Length = sizeof(avx);
+  
+    if (::sysctlbyname("hw.optional.avx1_0", &avx, &Length, NULL, 0) != -1 && avx)
+    {
+      mCaps |= TCpu::kAvx;
+    }
+    
+    unsigned int  avx2;
+    Length = sizeof(avx2);
+  
+    if (::sysctlbyname("hw.optional.avx2_0", &avx2, &Length, NULL, 0) != -1 && avx2)
+    {
+      mCaps |= TCpu::kAvx2;
+    }
+    
   #else
     #error "unknown platform"
 
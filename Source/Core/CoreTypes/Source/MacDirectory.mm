@@ -704,6 +704,18 @@ TList<TFileProperties> TDirectory::FindSubDirs(
 
 // -------------------------------------------------------------------------------------------------
 
+void TDirectory::FindFileAndSubDirNames(
+  const TList<TString>&   Extensions,
+  TList<TString>&         FileNames,
+  TList<TString>&         SubDirNames,
+  TSymLinkRecursionTest*  pSymlinkChecker)const
+{
+  FileNames = FindFileNames(Extensions);
+  SubDirNames = FindSubDirNames("*", pSymlinkChecker);
+}
+
+// -------------------------------------------------------------------------------------------------
+
 bool TDirectory::Create(bool CreateParentDirs)const
 {
   if (Exists())
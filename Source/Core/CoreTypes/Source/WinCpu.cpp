@@ -602,6 +602,26 @@ void TCpuImpl::Init()
     {
       Caps |= TCpu::kSse2;
     }
+
+    // AVX needs CPU support and an OS which saves the YMM state (OSXSAVE + XCR0)
+    const int ExtendedFeatureInfo = CPUInfo[2];
+    const bool OsSavesYmmState = (ExtendedFeatureInfo & (1 << 27)) && 
+      ((::_xgetbv(0) & 0x6) == 0x6);
+
+    if (OsSavesYmmState && (ExtendedFeatureInfo & (1 << 28)))
+    {
+      Caps |= TCpu::kAvx;
+
+      if (nIds >= 7)
+      {
+        __cpuidex((int*)CPUInfo, 7, 0);
+
+        if (CPUInfo[1] & (1 << 5))
+        {
+          Caps |= TCpu::kAvx2;
+        }
+      }
+    }
   }
 
   // Calling __cpuid with 0x80000000 as the InfoType argument
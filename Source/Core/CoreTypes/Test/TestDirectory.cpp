@@ -5,6 +5,8 @@
 
 #include "CoreTypes/Test/TestDirectory.h"
 
+#include <set>
+
 // =================================================================================================
 
 // -------------------------------------------------------------------------------------------------
@@ -107,6 +109,46 @@ void TCoreTypesTest::Directory()
   BOOST_CHECK(! gTempDir().Descend("CreateTest3").Exists());
 
 
+  // . test traversal
+
+  const TDirectory TraverseDir = gTempDir().Descend("TraverseTest");
+  BOOST_CHECK(TraverseDir.Create());
+
+  const int NumberOfTraverseSubDirs = 8;
+  for (int i = 0; i < NumberOfTraverseSubDirs; ++i)
+  {
+    const TDirectory SubDir = TDirectory(TraverseDir).Descend(
+      ToString(i)).Descend("Nested");
+    BOOST_CHECK(SubDir.Create());
+
+    TFile(SubDir.Path() + "File.wav").Open(TFile::kWrite);
+    TFile(SubDir.Path() + "File.txt").Open(TFile::kWrite);
+  }
+
+  for (int NumberOfThreads = 1; NumberOfThreads <= 4; NumberOfThreads += 3)
+  {
+    std::set<TString> TraversedFiles;
+    TraverseDir.Traverse(MakeList<TString>("*.wav"),
+      [&](const TDirectory& Directory, const TList<TString>& FileNames) {
+        for (int i = 0; i < FileNames.Size(); ++i)
+        {
+          TraversedFiles.insert(Directory.Path() + FileNames[i]);
+        }
+        return true;
+      },
+      [](const TDirectory& Directory, const TString& SubDirName) {
+        return SubDirName != "7";
+      },
+      NumberOfThreads);
+
+    BOOST_CHECK_EQUAL((int)TraversedFiles.size(), NumberOfTraverseSubDirs - 1);
+    BOOST_CHECK(TraversedFiles.find(TDirectory(TraverseDir).Descend("0").Descend(
+      "Nested").Path() + "File.wav") != TraversedFiles.end());
+  }
+
+  BOOST_CHECK(TraverseDir.Unlink());
+
+
   // . test normalization
 
   BOOST_CHECK_EQUAL(TDirectory("/Olla").Descend(".."), TDirectory("/"));
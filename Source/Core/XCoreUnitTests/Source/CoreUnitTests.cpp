@@ -18,6 +18,8 @@
 
 #include "AudioTypes/Export/AudioTypesInit.h"
 #include "AudioTypes/Test/TestFourier.h"
+#include "AudioTypes/Test/TestAudioMath.h"
+#include "AudioTypes/Test/TestResampler.h"
 
 #include "CoreFileFormats/Export/CoreFileFormatsInit.h"
 #include "CoreFileFormats/Test/TestZipFile.h"
@@ -98,6 +100,8 @@ boost::unit_test::test_suite* RegisterUnitTests(int, char*[])
     }));
 
     pAudioTypesTests->add(BOOST_TEST_CASE(TAudioTypesTest::Fourier));
+    pAudioTypesTests->add(BOOST_TEST_CASE(TAudioTypesTest::AudioMath));
+    pAudioTypesTests->add(BOOST_TEST_CASE(TAudioTypesTest::Resampler));
   }
   boost::unit_test::framework::master_test_suite().add(pAudioTypesTests);
 
@@ -113,10 +117,24 @@ boost::unit_test::test_suite* RegisterUnitTests(int, char*[])
     pCoreFileFormatsTests->add(BOOST_TEST_CASE(TCoreFileFormatsTest::ZipFile));
     pCoreFileFormatsTests->add(BOOST_TEST_CASE(TCoreFileFormatsTest::ZipArchive));
     pCoreFileFormatsTests->add(BOOST_TEST_CASE(TCoreFileFormatsTest::AudioFile));
+    pCoreFileFormatsTests->add(BOOST_TEST_CASE(TCoreFileFormatsTest::MappedAudioFile));
+    pCoreFileFormatsTests->add(BOOST_TEST_CASE(TCoreFileFormatsTest::SampleConverter));
     pCoreFileFormatsTests->add(BOOST_TEST_CASE(TCoreFileFormatsTest::Database));
   }
   boost::unit_test::framework::master_test_suite().add(pCoreFileFormatsTests);
 
+
+  // . Benchmarks
+
+  // disabled by default: run them explicitly with --run_test=Benchmarks
+  boost::unit_test::test_suite* pBenchmarkTests = BOOST_TEST_SUITE("Benchmarks");
+  {
+    pBenchmarkTests->add(BOOST_TEST_CASE(TAudioTypesTest::AudioMathBenchmark));
+    pBenchmarkTests->add(BOOST_TEST_CASE(TCoreFileFormatsTest::SampleConverterBenchmark));
+  }
+  pBenchmarkTests->p_default_status.value = boost::unit_test::test_unit::RS_DISABLED;
+  boost::unit_test::framework::master_test_suite().add(pBenchmarkTests);
+
   return 0;
 }
 
@@ -75,6 +75,34 @@ public:
     const TClassificationTestDataItem& Item) const;
   //@}
 
+  //@{ ... Evaluation of raw sample features
+
+  //! Normalize and clamp a single sample's features (see TSampleClassificationDescriptors) 
+  //! in place, just like the train data got normalized and clamped with the model's 
+  //! Normalizer and OutlierLimits, but with a fused scale, offset and clamp table.
+  //! @throws shark::Exception when the number of features does not match.
+  void NormalizeFeatures(std::vector<double>& Features) const;
+  //! Get class predictions for a single sample's normalized features.
+  //! Avoids creating shark data sets, so this is the preferred way to evaluate 
+  //! single samples.
+  TList<float> EvaluateFeatures(
+    const std::vector<double>& NormalizedFeatures) const;
+
+  //! Normalize and clamp \param NumberOfRows samples' features at once. Features
+  //! of all samples are stored row after row in \param FeatureRows.
+  //! @throws shark::Exception when the number of features does not match.
+  void NormalizeFeatureRows(
+    std::vector<double>& FeatureRows,
+    int                  NumberOfRows) const;
+  //! Get class predictions for \param NumberOfRows samples' normalized features
+  //! at once: returns one prediction list per row. Results are the same as when
+  //! evaluating each row with EvaluateFeatures, but models may evaluate the whole
+  //! batch in one go, which is a lot more cache friendly for trees and ensembles.
+  TList< TList<float> > EvaluateFeatureRows(
+    const std::vector<double>& NormalizedFeatureRows,
+    int                        NumberOfRows) const;
+  //@}
+
 
   //@{ ... Loading & Saving
 
@@ -121,6 +149,15 @@ protected:
   //! Evaluate the pretrained model.
   virtual TList<float> OnEvaluate(
     const TClassificationTestDataItem& Item) const = 0;
+  //! Evaluate the pretrained model with normalized sample features.
+  //! By default creates a TClassificationTestDataItem and calls OnEvaluate.
+  virtual TList<float> OnEvaluateFeatures(
+    const std::vector<double>& NormalizedFeatures) const;
+  //! Evaluate the pretrained model with multiple rows of normalized sample features.
+  //! By default calls OnEvaluateFeatures for each row.
+  virtual TList< TList<float> > OnEvaluateFeatureRows(
+    const std::vector<double>& NormalizedFeatureRows,
+    int                        NumberOfRows) const;
 
   //! Load the pretrained model.
   virtual void OnLoadModel(
@@ -131,11 +168,22 @@ protected:
   //@}
 
 private:
+  //! Update the fused feature normalization table from mpNormalizer and mOutlierLimits.
+  void UpdateFeatureNormalization();
+  //! Apply the fused feature normalization table to a single row of features.
+  void NormalizeFeatureRow(double* pFeatures) const;
+
   TPoint mInputFeaturesSize;
   std::vector<TString> mOutputClasses;
 
   TOwnerPtr< shark::Normalizer<shark::RealVector> > mpNormalizer;
   shark::RealVector mOutlierLimits;
+
+  // fused normalizer and outlier limits: x = clamp(x * scale + offset, min, max)
+  TArray<double> mFeatureScales;
+  TArray<double> mFeatureOffsets; // empty when the normalizer has no offset
+  TArray<double> mFeatureMinimums;
+  TArray<double> mFeatureMaximums;
 };
 
 // =================================================================================================
@@ -39,6 +39,11 @@ public:
     const shark::Normalizer<shark::RealVector>& Normalizer,
     const shark::RealVector&                    OutlierLimits);
 
+  //! Construct a test item from already normalized and clamped features,
+  //! see TClassificationModel::NormalizeFeatures.
+  explicit TClassificationTestDataItem(
+    const std::vector<double>& NormalizedFeatures);
+
   //! number of input features in the set
   int DescriptorSize()const;
 
@@ -46,6 +51,9 @@ public:
   const shark::Data<shark::RealVector>& TestData()const;
 
 private:
+  //! Create a data set with a single item from the given features.
+  void SetFeatures(const std::vector<double>& Features);
+
   shark::Data<shark::RealVector> mTestData;
 };
 
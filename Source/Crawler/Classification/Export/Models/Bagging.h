@@ -44,6 +44,11 @@ private:
 
   virtual TList<float> OnEvaluate(
     const TClassificationTestDataItem& Item) const override;
+  virtual TList<float> OnEvaluateFeatures(
+    const std::vector<double>& NormalizedFeatures) const override;
+  virtual TList< TList<float> > OnEvaluateFeatureRows(
+    const std::vector<double>& NormalizedFeatureRows,
+    int                        NumberOfRows) const override;
 
   virtual void OnLoadModel(
     eos::portable_iarchive& Archive) override;
@@ -51,6 +56,10 @@ private:
     eos::portable_oarchive& Archive) const override;
   //@}
 
+  //! Mean of all sub model's evaluation results
+  TList<float> MeanResult(
+    const TStaticArray<TList<float>, sNumberOfModels>& Results) const;
+
   TStaticArray< TPtr<TClassificationModel>, sNumberOfModels > mModels;
 };
 
@@ -199,6 +208,65 @@ TList<float> TBaggingClassificationModel<TModelType, sNumberOfModels>::OnEvaluat
     Results[i] = mModels[i]->Evaluate(Item);
   }
 
+  return MeanResult(Results);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <typename TModelType, size_t sNumberOfModels>
+TList<float> TBaggingClassificationModel<TModelType, sNumberOfModels>::OnEvaluateFeatures(
+  const std::vector<double>& NormalizedFeatures) const
+{
+  TStaticArray<TList<float>, sNumberOfModels> Results;
+
+  for (int i = 0; i < (int)sNumberOfModels; ++i)
+  {
+    Results[i] = mModels[i]->EvaluateFeatures(NormalizedFeatures);
+  }
+
+  return MeanResult(Results);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <typename TModelType, size_t sNumberOfModels>
+TList< TList<float> > 
+TBaggingClassificationModel<TModelType, sNumberOfModels>::OnEvaluateFeatureRows(
+  const std::vector<double>& NormalizedFeatureRows,
+  int                        NumberOfRows) const
+{
+  // evaluate all rows with one sub model after the other
+  TStaticArray<TList< TList<float> >, sNumberOfModels> ModelResults;
+
+  for (int i = 0; i < (int)sNumberOfModels; ++i)
+  {
+    ModelResults[i] = mModels[i]->EvaluateFeatureRows(
+      NormalizedFeatureRows, NumberOfRows);
+  }
+
+  TList< TList<float> > Ret;
+  Ret.PreallocateSpace(NumberOfRows);
+
+  for (int Row = 0; Row < NumberOfRows; ++Row)
+  {
+    TStaticArray<TList<float>, sNumberOfModels> Results;
+    for (int i = 0; i < (int)sNumberOfModels; ++i)
+    {
+      Results[i] = ModelResults[i][Row];
+    }
+
+    Ret.Append(MeanResult(Results));
+  }
+
+  return Ret;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+template <typename TModelType, size_t sNumberOfModels>
+TList<float> TBaggingClassificationModel<TModelType, sNumberOfModels>::MeanResult(
+  const TStaticArray<TList<float>, sNumberOfModels>& Results) const
+{
   TList<float> Ret;
 
   for (int c = 0; c < NumberOfOutputClasses(); ++c)
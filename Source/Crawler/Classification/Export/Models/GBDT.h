@@ -18,10 +18,15 @@ namespace LightGBM {
   class Metric;
 }
 
+class TGbdtForest;
+
 // =================================================================================================
 
 /*!
  * Gradient Boosting Descision Tree model, implemented with LightGBM.
+ *
+ * Trained and loaded models are compiled into a TGbdtForest, which is used to
+ * evaluate the model: evaluations are thread-safe and don't allocate memory.
 !*/
 
 class TGbdtClassificationModel : public TClassificationModel
@@ -46,17 +51,31 @@ private:
 
   virtual TList<float> OnEvaluate(
     const TClassificationTestDataItem& Item) const override;
+  virtual TList<float> OnEvaluateFeatures(
+    const std::vector<double>& NormalizedFeatures) const override;
+  virtual TList< TList<float> > OnEvaluateFeatureRows(
+    const std::vector<double>& NormalizedFeatureRows,
+    int                        NumberOfRows) const override;
 
   virtual void OnLoadModel(
     eos::portable_iarchive& Archive) override;
   virtual void OnSaveModel(
     eos::portable_oarchive& Archive) const override;
 
+  //! Compile the current boosting model into mpForest.
+  void CompileForest();
+  //! Evaluate the compiled model with the given normalized features.
+  TList<float> EvaluateForest(
+    const double* pNormalizedFeatures, 
+    int           NumberOfFeatures) const;
+
   // All configs 
   std::unique_ptr<LightGBM::Config> mpConfig;
 
   // Boosting object
   std::unique_ptr<LightGBM::Boosting> mpBoosting;
+  // Compiled boosting model, used for predictions
+  std::unique_ptr<TGbdtForest> mpForest;
   // Training objective function 
   std::unique_ptr<LightGBM::ObjectiveFunction> mpObjectiveFunction;
 
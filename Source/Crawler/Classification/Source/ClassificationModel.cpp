@@ -1,5 +1,8 @@
 #include "Classification/Export/ClassificationModel.h"
 
+#include <algorithm>
+#include <limits>
+
 // =================================================================================================
 
 // -------------------------------------------------------------------------------------------------
@@ -120,6 +123,8 @@ TClassificationTestResults TClassificationModel::Train(
 
   mOutlierLimits = DataSet.OutlierLimits();
 
+  UpdateFeatureNormalization();
+
   // split data into train and validation data, train the model and return results
   return OnSplitDataAndTrain(DataSet, TestSizeFraction);
 }
@@ -147,6 +152,8 @@ TClassificationTestResults TClassificationModel::Train(
 
   mOutlierLimits = DataSet.OutlierLimits();
 
+  UpdateFeatureNormalization();
+
   // train already split data and return the results
   return OnTrain(
     DataSet.DatabaseFileName(),
@@ -199,6 +206,177 @@ TList<float> TClassificationModel::Evaluate(
 
 // -------------------------------------------------------------------------------------------------
 
+void TClassificationModel::NormalizeFeatures(std::vector<double>& Features) const
+{
+  if ((int)Features.size() != mFeatureScales.Size())
+  {
+    throw shark::Exception(
+      "Sample features and model descriptor count do not match. Model out of date?");
+  }
+
+  NormalizeFeatureRow(Features.data());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TList<float> TClassificationModel::EvaluateFeatures(
+  const std::vector<double>& NormalizedFeatures) const
+{
+  if ((int)NormalizedFeatures.size() != mInputFeaturesSize.mX * mInputFeaturesSize.mY)
+  {
+    throw shark::Exception(
+      "Sample features and model descriptor count do not match. Model out of date?");
+  }
+
+  return OnEvaluateFeatures(NormalizedFeatures);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TClassificationModel::NormalizeFeatureRows(
+  std::vector<double>& FeatureRows,
+  int                  NumberOfRows) const
+{
+  const int NumberOfFeatures = mFeatureScales.Size();
+  if (NumberOfRows < 0 || FeatureRows.size() != (size_t)NumberOfRows * NumberOfFeatures)
+  {
+    throw shark::Exception(
+      "Sample features and model descriptor count do not match. Model out of date?");
+  }
+
+  for (int Row = 0; Row < NumberOfRows; ++Row)
+  {
+    NormalizeFeatureRow(FeatureRows.data() + (size_t)Row * NumberOfFeatures);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TList< TList<float> > TClassificationModel::EvaluateFeatureRows(
+  const std::vector<double>& NormalizedFeatureRows,
+  int                        NumberOfRows) const
+{
+  const int NumberOfFeatures = mInputFeaturesSize.mX * mInputFeaturesSize.mY;
+  if (NumberOfRows < 0 || 
+      NormalizedFeatureRows.size() != (size_t)NumberOfRows * NumberOfFeatures)
+  {
+    throw shark::Exception(
+      "Sample features and model descriptor count do not match. Model out of date?");
+  }
+
+  if (NumberOfRows == 0)
+  {
+    return TList< TList<float> >();
+  }
+
+  const TList< TList<float> > Results = 
+    OnEvaluateFeatureRows(NormalizedFeatureRows, NumberOfRows);
+  MAssert(Results.Size() == NumberOfRows, "Expecting one result per row");
+
+  return Results;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TList<float> TClassificationModel::OnEvaluateFeatures(
+  const std::vector<double>& NormalizedFeatures) const
+{
+  return OnEvaluate(TClassificationTestDataItem(NormalizedFeatures));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TList< TList<float> > TClassificationModel::OnEvaluateFeatureRows(
+  const std::vector<double>& NormalizedFeatureRows,
+  int                        NumberOfRows) const
+{
+  const size_t NumberOfFeatures = NormalizedFeatureRows.size() / NumberOfRows;
+
+  TList< TList<float> > Results;
+  Results.PreallocateSpace(NumberOfRows);
+
+  std::vector<double> NormalizedFeatures(NumberOfFeatures);
+  for (int Row = 0; Row < NumberOfRows; ++Row)
+  {
+    const auto RowBegin = NormalizedFeatureRows.begin() + Row * NumberOfFeatures;
+    std::copy(RowBegin, RowBegin + NumberOfFeatures, NormalizedFeatures.begin());
+
+    Results.Append(OnEvaluateFeatures(NormalizedFeatures));
+  }
+
+  return Results;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TClassificationModel::UpdateFeatureNormalization()
+{
+  const int NumberOfFeatures = mpNormalizer->isValid() ? 
+    (int)mpNormalizer->inputSize() : 0;
+
+  mFeatureScales.SetSize(NumberOfFeatures);
+  mFeatureOffsets.SetSize(mpNormalizer->hasOffset() ? NumberOfFeatures : 0);
+  mFeatureMinimums.SetSize(NumberOfFeatures);
+  mFeatureMaximums.SetSize(NumberOfFeatures);
+
+  const bool HasOutlierLimits = ((int)mOutlierLimits.size() == NumberOfFeatures);
+  MAssert(HasOutlierLimits || mOutlierLimits.size() == 0, "Unexpected outlier limit size");
+
+  for (int i = 0; i < NumberOfFeatures; ++i)
+  {
+    mFeatureScales[i] = mpNormalizer->diagonal()(i);
+
+    if (!mFeatureOffsets.IsEmpty())
+    {
+      mFeatureOffsets[i] = mpNormalizer->offset()(i);
+    }
+
+    if (HasOutlierLimits)
+    {
+      mFeatureMinimums[i] = -mOutlierLimits(i);
+      mFeatureMaximums[i] = mOutlierLimits(i);
+    }
+    else
+    {
+      mFeatureMinimums[i] = -std::numeric_limits<double>::infinity();
+      mFeatureMaximums[i] = std::numeric_limits<double>::infinity();
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TClassificationModel::NormalizeFeatureRow(double* pFeatures) const
+{
+  const int NumberOfFeatures = mFeatureScales.Size();
+
+  const double* pScales = mFeatureScales.FirstRead();
+  const double* pMinimums = mFeatureMinimums.FirstRead();
+  const double* pMaximums = mFeatureMaximums.FirstRead();
+
+  // NB: same operations and order as shark::Normalizer and shark::Truncate,
+  // so results are exactly the same as with the shark data set transforms
+  if (!mFeatureOffsets.IsEmpty())
+  {
+    const double* pOffsets = mFeatureOffsets.FirstRead();
+    for (int i = 0; i < NumberOfFeatures; ++i)
+    {
+      const double Value = pFeatures[i] * pScales[i] + pOffsets[i];
+      pFeatures[i] = std::max(pMinimums[i], std::min(pMaximums[i], Value));
+    }
+  }
+  else
+  {
+    for (int i = 0; i < NumberOfFeatures; ++i)
+    {
+      const double Value = pFeatures[i] * pScales[i];
+      pFeatures[i] = std::max(pMinimums[i], std::min(pMaximums[i], Value));
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void TClassificationModel::Load(const TString& FileName)
 {
   const std::ios_base::openmode Flags = std::ifstream::binary;
@@ -231,6 +409,8 @@ void TClassificationModel::Load(eos::portable_iarchive& Archive)
   Archive >> *mpNormalizer;
   Archive >> mOutlierLimits;
 
+  UpdateFeatureNormalization();
+
   // model
   OnLoadModel(Archive);
 }
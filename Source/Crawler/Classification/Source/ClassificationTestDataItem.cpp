@@ -12,26 +12,7 @@ TClassificationTestDataItem::TClassificationTestDataItem(
   const shark::Normalizer<shark::RealVector>& Normalizer,
   const shark::RealVector&                    OutlierLimits)
 {
-  const std::size_t DataDimensions = Descriptors.mFeatures.size();
-
-  // calculate batch sizes - well for one item only
-  const std::vector<std::size_t> BatchSizes = shark::detail::optimalBatchSizes(
-    1, shark::Data<shark::RealVector>::DefaultBatchSize);
-
-  mTestData = shark::Data<shark::RealVector>(BatchSizes.size());
-
-  // copy content into the batch
-  MAssert(BatchSizes.size() == 1, "Expecting one batch for one element");
-
-  shark::RealMatrix& DataInputBatch = mTestData.batch(0);
-  DataInputBatch.resize(BatchSizes[0], DataDimensions);
-
-  for (std::size_t j = 0; j < DataDimensions; ++j)
-  {
-    DataInputBatch(0, j) = Descriptors.mFeatures[j];
-  }
-
-  MAssert(mTestData.numberOfElements() == 1, "Expecting one element only");
+  SetFeatures(Descriptors.mFeatures);
 
   // normalize data
   mTestData = shark::transform(mTestData, Normalizer);
@@ -43,6 +24,14 @@ TClassificationTestDataItem::TClassificationTestDataItem(
 
 // -------------------------------------------------------------------------------------------------
 
+TClassificationTestDataItem::TClassificationTestDataItem(
+  const std::vector<double>& NormalizedFeatures)
+{
+  SetFeatures(NormalizedFeatures);
+}
+
+// -------------------------------------------------------------------------------------------------
+
 int TClassificationTestDataItem::DescriptorSize()const
 {
   return (int)shark::dataDimension(mTestData);
@@ -55,3 +44,28 @@ const shark::Data<shark::RealVector>& TClassificationTestDataItem::TestData()con
   return mTestData;
 }
 
+// -------------------------------------------------------------------------------------------------
+
+void TClassificationTestDataItem::SetFeatures(const std::vector<double>& Features)
+{
+  const std::size_t DataDimensions = Features.size();
+
+  // calculate batch sizes - well for one item only
+  const std::vector<std::size_t> BatchSizes = shark::detail::optimalBatchSizes(
+    1, shark::Data<shark::RealVector>::DefaultBatchSize);
+
+  mTestData = shark::Data<shark::RealVector>(BatchSizes.size());
+
+  // copy content into the batch
+  MAssert(BatchSizes.size() == 1, "Expecting one batch for one element");
+
+  shark::RealMatrix& DataInputBatch = mTestData.batch(0);
+  DataInputBatch.resize(BatchSizes[0], DataDimensions);
+
+  for (std::size_t j = 0; j < DataDimensions; ++j)
+  {
+    DataInputBatch(0, j) = Features[j];
+  }
+
+  MAssert(mTestData.numberOfElements() == 1, "Expecting one element only");
+}
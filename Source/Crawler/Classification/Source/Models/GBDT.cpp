@@ -1,5 +1,7 @@
 #include "Classification/Export/Models/GBDT.h"
+#include "Classification/Source/Models/GbdtForest.h"
 
+#include "CoreTypes/Export/Alloca.h"
 #include "CoreTypes/Export/Exception.h"
 #include "CoreTypes/Export/File.h"
 #include "CoreFileFormats/Export/ZipFile.h"
@@ -19,6 +21,7 @@
 // -------------------------------------------------------------------------------------------------
 
 TGbdtClassificationModel::TGbdtClassificationModel()
+  : mpForest(new TGbdtForest())
 { 
 }
 
@@ -281,6 +284,9 @@ TClassificationTestResults TGbdtClassificationModel::OnTrain(
  
   // ... Evaluate Results
 
+  // compile the trained model for predictions
+  CompileForest();
+
   // preallocate predictions data
   shark::Data<shark::RealVector> Predictions(TestData.numberOfElements(),
     shark::RealVector(NumberOfClasses));
@@ -289,33 +295,35 @@ TClassificationTestResults TGbdtClassificationModel::OnTrain(
   // we'll apply the prediction on
   Predictions.repartition(TestData.getPartitioning());
 
-  LightGBM::PredictionEarlyStopConfig EarlyStopConfig;
-  EarlyStopConfig.margin_threshold = mpConfig->pred_early_stop_margin;
-  EarlyStopConfig.round_period = mpConfig->pred_early_stop_freq;
+  if (mpForest->NumberOfOutputs() != NumberOfClasses ||
+      mpForest->NumberOfFeatures() > NumberOfFeatures)
+  {
+    throw TReadableException("Unexpected GBDT model layout");
+  }
 
-  LightGBM::PredictionEarlyStopInstance EarlyStop = 
-    LightGBM::CreatePredictionEarlyStopInstance("multiclass", EarlyStopConfig);
+  // gather all test rows and predict them in one batch
+  const int NumberOfTestRows = (int)TestData.numberOfElements();
 
-  const int StartIteration = 0;
-  const int NumberOfIterations = -1;
-  const bool PredictFeatureContribution = false;
-  mpBoosting->InitPredict(StartIteration, NumberOfIterations, PredictFeatureContribution);
+  std::vector<double> InputFeatures((size_t)NumberOfTestRows * mpForest->NumberOfFeatures());
+  for (int Row = 0; Row < NumberOfTestRows; ++Row)
+  {
+    auto InputRow = TestData.element(Row);
+    std::copy(InputRow.input.begin(), InputRow.input.begin() + mpForest->NumberOfFeatures(),
+      InputFeatures.begin() + (size_t)Row * mpForest->NumberOfFeatures());
+  }
+
+  std::vector<double> Outputs((size_t)NumberOfTestRows * NumberOfClasses);
+  mpForest->Predict(InputFeatures.data(), NumberOfTestRows, Outputs.data());
 
-  // evaluate and convert LightGBM predictions to shark::Data<shark::RealVector>
+  // convert predictions to shark::Data<shark::RealVector>
   int CurrentRow = 0;
   for (auto Prediction : Predictions.elements())
   {
-    auto InputRow = TestData.element(CurrentRow++);
-
-    std::vector<double> InputFeatures(NumberOfFeatures);
-    std::copy(InputRow.input.begin(), InputRow.input.end(), InputFeatures.begin());
-
-    std::vector<double> Outputs(NumberOfClasses);
-    mpBoosting->Predict(InputFeatures.data(), Outputs.data(), &EarlyStop);
     for (size_t c = 0; c < (size_t)NumberOfClasses; ++c)
     {
-      Prediction[c] = Outputs[c];
+      Prediction[c] = Outputs[(size_t)CurrentRow * NumberOfClasses + c];
     }
+    ++CurrentRow;
   }
   
   return TClassificationTestResults(TestData, TestDataSampleNames, Predictions);
@@ -326,7 +334,7 @@ TClassificationTestResults TGbdtClassificationModel::OnTrain(
 TList<float> TGbdtClassificationModel::OnEvaluate(
   const TClassificationTestDataItem& Item) const
 {
-  MAssert(mpBoosting.get(), "Need to train or load a model first");
+  MAssert(!mpForest->IsEmpty(), "Need to train or load a model first");
 
   const shark::Data<shark::RealVector>& SharkTestData = Item.TestData();
 
@@ -336,37 +344,79 @@ TList<float> TGbdtClassificationModel::OnEvaluate(
   MAssert(SharkTestDataView.size() == 1, "Expecting one item only");
   auto Element = SharkTestDataView[0];
   
-  std::vector<double> InputFeatures;
-  InputFeatures.reserve(Element.size());
-  for (auto Value : Element)
-  {
-    InputFeatures.push_back(Value);
-  }
+  // copy the shark element into a continuous feature array
+  const int NumberOfFeatures = (int)Element.size();
 
-  LightGBM::Config DefaultConfig;
-  LightGBM::Config* pConfig = mpConfig ? mpConfig.get() : &DefaultConfig;
+  TAllocaArray<double> InputFeatures(NumberOfFeatures);
+  MInitAllocaArray(InputFeatures);
 
-  LightGBM::PredictionEarlyStopConfig EarlyStopConfig;
-  EarlyStopConfig.margin_threshold = pConfig->pred_early_stop_margin;
-  EarlyStopConfig.round_period = pConfig->pred_early_stop_freq;
+  std::copy(Element.begin(), Element.end(), InputFeatures.FirstWrite());
 
-  LightGBM::PredictionEarlyStopInstance EarlyStop =
-    LightGBM::CreatePredictionEarlyStopInstance("multiclass", EarlyStopConfig);
+  return EvaluateForest(InputFeatures.FirstRead(), NumberOfFeatures);
+}
 
-  const int StartIteration = 0;
-  const int NumberOfIterations = -1;
-  const bool PredictFeatureContribution = false;
-  mpBoosting->InitPredict(StartIteration , NumberOfIterations, PredictFeatureContribution);
+// -------------------------------------------------------------------------------------------------
+
+TList<float> TGbdtClassificationModel::OnEvaluateFeatures(
+  const std::vector<double>& NormalizedFeatures) const
+{
+  MAssert(!mpForest->IsEmpty(), "Need to train or load a model first");
+
+  return EvaluateForest(NormalizedFeatures.data(), (int)NormalizedFeatures.size());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TList< TList<float> > TGbdtClassificationModel::OnEvaluateFeatureRows(
+  const std::vector<double>& NormalizedFeatureRows,
+  int                        NumberOfRows) const
+{
+  MAssert(!mpForest->IsEmpty(), "Need to train or load a model first");
+
+  const int NumberOfFeatures = (int)(NormalizedFeatureRows.size() / NumberOfRows);
+  const int NumberOfForestFeatures = mpForest->NumberOfFeatures();
 
   const int NumberOfClasses = NumberOfOutputClasses();
-  std::vector<double> Outputs(NumberOfClasses);
-  mpBoosting->Predict(InputFeatures.data(), Outputs.data(), &EarlyStop);
+  MAssert(mpForest->NumberOfOutputs() == NumberOfClasses, "Unexpected model outputs");
 
-  TList<float> Ret;
-  Ret.PreallocateSpace(NumberOfClasses);
-  for (size_t c = 0; c < (size_t)NumberOfClasses; ++c)
+  if (NumberOfFeatures < NumberOfForestFeatures)
   {
-    Ret.Append((float)Outputs[c]);
+    throw TReadableException("Unexpected number of input features");
+  }
+
+  // predict all rows in one batch. the forest expects rows of its own size
+  std::vector<double> Outputs((size_t)NumberOfRows * NumberOfClasses);
+
+  if (NumberOfFeatures == NumberOfForestFeatures)
+  {
+    mpForest->Predict(NormalizedFeatureRows.data(), NumberOfRows, Outputs.data());
+  }
+  else
+  {
+    std::vector<double> InputFeatures((size_t)NumberOfRows * NumberOfForestFeatures);
+    for (int Row = 0; Row < NumberOfRows; ++Row)
+    {
+      const auto RowBegin = NormalizedFeatureRows.begin() + (size_t)Row * NumberOfFeatures;
+      std::copy(RowBegin, RowBegin + NumberOfForestFeatures,
+        InputFeatures.begin() + (size_t)Row * NumberOfForestFeatures);
+    }
+
+    mpForest->Predict(InputFeatures.data(), NumberOfRows, Outputs.data());
+  }
+
+  TList< TList<float> > Ret;
+  Ret.PreallocateSpace(NumberOfRows);
+
+  for (int Row = 0; Row < NumberOfRows; ++Row)
+  {
+    TList<float> RowResults;
+    RowResults.PreallocateSpace(NumberOfClasses);
+    for (int c = 0; c < NumberOfClasses; ++c)
+    {
+      RowResults.Append((float)Outputs[(size_t)Row * NumberOfClasses + c]);
+    }
+
+    Ret.Append(RowResults);
   }
 
   return Ret;
@@ -398,6 +448,9 @@ void TGbdtClassificationModel::OnLoadModel(
     ModelByteArray.FirstRead(), ModelByteArray.Size());
   
   mpBoosting.reset(pNewBoosting.release());
+
+  // compile it for predictions
+  CompileForest();
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -430,3 +483,51 @@ void TGbdtClassificationModel::OnSaveModel(
     CompressedModelByteArray.Size());
 }
 
+// -------------------------------------------------------------------------------------------------
+
+void TGbdtClassificationModel::CompileForest()
+{
+  MAssert(mpBoosting, "Need to train or load a model first");
+
+  // use the same prediction early stopping settings as LightGBM
+  LightGBM::Config DefaultConfig;
+  LightGBM::Config* pConfig = mpConfig ? mpConfig.get() : &DefaultConfig;
+
+  const int StartIteration = 0;
+  const int NumberOfIterations = -1;
+  const int FeatureImportance = 0; // 0: split, 1: gain
+  const std::string ModelString = mpBoosting->SaveModelToString(
+    StartIteration, NumberOfIterations, FeatureImportance);
+
+  mpForest->Compile(ModelString.c_str(), ModelString.size(),
+    pConfig->pred_early_stop_margin, pConfig->pred_early_stop_freq);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TList<float> TGbdtClassificationModel::EvaluateForest(
+  const double* pNormalizedFeatures, 
+  int           NumberOfFeatures) const
+{
+  if (NumberOfFeatures < mpForest->NumberOfFeatures())
+  {
+    throw TReadableException("Unexpected number of input features");
+  }
+
+  const int NumberOfClasses = NumberOfOutputClasses();
+  MAssert(mpForest->NumberOfOutputs() == NumberOfClasses, "Unexpected model outputs");
+
+  TAllocaArray<double> Outputs(NumberOfClasses);
+  MInitAllocaArray(Outputs);
+
+  mpForest->Predict(pNormalizedFeatures, Outputs.FirstWrite());
+
+  TList<float> Ret;
+  Ret.PreallocateSpace(NumberOfClasses);
+  for (int c = 0; c < NumberOfClasses; ++c)
+  {
+    Ret.Append((float)Outputs[c]);
+  }
+
+  return Ret;
+}
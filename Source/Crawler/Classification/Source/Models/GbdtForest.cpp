@@ -0,0 +1,675 @@
+#include "Classification/Source/Models/GbdtForest.h"
+
+#include "CoreTypes/Export/Exception.h"
+
+#include "../../3rdParty/LightGBM/Export/LightGBM.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+// =================================================================================================
+
+// LightGBM's tree decision type bits and missing value types
+static const TUInt8 sCategoricalMask = 1;
+static const TUInt8 sDefaultLeftMask = 2;
+static const TUInt8 sMissingTypeMask = 12;
+
+static const int sMissingZero = 1;
+static const int sMissingNaN = 2;
+
+// number of rows the batch prediction processes at once
+#define MGbdtPredictionBlockSize 32
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+//! Value of the given key in the given key value list or NULL.
+static const std::string* SFindValue(
+  const std::vector<std::pair<std::string, std::string>>& KeyValues,
+  const char*                                             pKey)
+{
+  for (const auto& KeyValue : KeyValues)
+  {
+    if (KeyValue.first == pKey)
+    {
+      return &KeyValue.second;
+    }
+  }
+  return NULL;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Like SFindValue, but throws when the key is missing.
+static const std::string& SValue(
+  const std::vector<std::pair<std::string, std::string>>& KeyValues,
+  const char*                                             pKey)
+{
+  if (const std::string* pValue = SFindValue(KeyValues, pKey))
+  {
+    return *pValue;
+  }
+  throw TReadableException(TString("Invalid GBDT model: missing '") + pKey + "' field");
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Split the given string into "key=value" lines until an empty line or
+//! a line which starts with \param pStopLine is found.
+//! @return position of the line which stopped parsing.
+static const char* SParseKeyValueLines(
+  const char*                                       pBegin,
+  const char*                                       pEnd,
+  const char*                                       pStopLine,
+  std::vector<std::pair<std::string, std::string>>& KeyValues)
+{
+  const size_t StopLineLength = ::strlen(pStopLine);
+
+  const char* pLine = pBegin;
+  while (pLine < pEnd)
+  {
+    const char* pLineEnd = pLine;
+    while (pLineEnd < pEnd && *pLineEnd != '\r' && *pLineEnd != '\n')
+    {
+      ++pLineEnd;
+    }
+
+    const size_t LineLength = pLineEnd - pLine;
+    if (LineLength == 0 ||
+        (LineLength >= StopLineLength && ::strncmp(pLine, pStopLine, StopLineLength) == 0))
+    {
+      break;
+    }
+
+    const char* pSeparator = pLine;
+    while (pSeparator < pLineEnd && *pSeparator != '=')
+    {
+      ++pSeparator;
+    }
+
+    KeyValues.emplace_back(
+      std::string(pLine, pSeparator),
+      (pSeparator < pLineEnd) ? std::string(pSeparator + 1, pLineEnd) : std::string());
+
+    pLine = pLineEnd;
+    if (pLine < pEnd && *pLine == '\r') { ++pLine; }
+    if (pLine < pEnd && *pLine == '\n') { ++pLine; }
+  }
+
+  return pLine;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Skip all new line characters at the given position.
+static const char* SSkipNewLines(const char* pBegin, const char* pEnd)
+{
+  while (pBegin < pEnd && (*pBegin == '\r' || *pBegin == '\n'))
+  {
+    ++pBegin;
+  }
+  return pBegin;
+}
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+TGbdtForest::TGbdtForest()
+  : mNumberOfFeatures(0),
+    mNumberOfOutputs(0),
+    mNumberOfIterations(0),
+    mObjective(kRawScore),
+    mSigmoid(1.0),
+    mAverageOutput(false),
+    mEarlyStopMargin(0.0),
+    mEarlyStopRoundPeriod(0)
+{
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TGbdtForest::Compile(
+  const char* pModelString,
+  size_t      ModelStringLength,
+  double      EarlyStopMargin,
+  int         EarlyStopRoundPeriod)
+{
+  Clear();
+
+  try
+  {
+    const char* pPos = pModelString;
+    const char* pEnd = pModelString + ModelStringLength;
+
+    // ... header
+
+    std::vector<std::pair<std::string, std::string>> Header;
+    pPos = SParseKeyValueLines(pPos, pEnd, "Tree=", Header);
+    pPos = SSkipNewLines(pPos, pEnd);
+
+    int NumberOfClasses = 0;
+    LightGBM::Common::Atoi(SValue(Header, "num_class").c_str(), &NumberOfClasses);
+
+    mNumberOfOutputs = NumberOfClasses;
+    if (const std::string* pValue = SFindValue(Header, "num_tree_per_iteration"))
+    {
+      LightGBM::Common::Atoi(pValue->c_str(), &mNumberOfOutputs);
+    }
+
+    int MaxFeatureIndex = -1;
+    LightGBM::Common::Atoi(SValue(Header, "max_feature_idx").c_str(), &MaxFeatureIndex);
+    mNumberOfFeatures = MaxFeatureIndex + 1;
+
+    mAverageOutput = (SFindValue(Header, "average_output") != NULL);
+
+    mObjective = kRawScore;
+    if (const std::string* pValue = SFindValue(Header, "objective"))
+    {
+      const std::vector<std::string> Tokens = LightGBM::Common::Split(pValue->c_str(), ' ');
+      const std::string Type = Tokens.empty() ? std::string() :
+        LightGBM::ParseObjectiveAlias(Tokens[0]);
+
+      if (Type == "multiclass")
+      {
+        mObjective = kSoftmax;
+      }
+      else if (Type == "multiclassova")
+      {
+        mObjective = kSigmoid;
+        mSigmoid = -1.0;
+        for (const std::string& Token : Tokens)
+        {
+          const std::vector<std::string> Pair = LightGBM::Common::Split(Token.c_str(), ':');
+          if (Pair.size() == 2 && Pair[0] == "sigmoid")
+          {
+            LightGBM::Common::Atof(Pair[1].c_str(), &mSigmoid);
+          }
+        }
+        if (mSigmoid <= 0.0)
+        {
+          throw TReadableException("Invalid GBDT model: missing or invalid sigmoid parameter");
+        }
+      }
+      else
+      {
+        throw TReadableException(TString("Unsupported GBDT model objective: '") +
+          TString(pValue->c_str(), TString::kUtf8) + "'");
+      }
+    }
+
+    // multiclass early stopping needs at least two outputs
+    if (mNumberOfOutputs < 2 || mNumberOfFeatures < 1)
+    {
+      throw TReadableException("Unsupported GBDT model: expecting a multi class model");
+    }
+
+    // ... trees
+
+    while (pPos < pEnd && ::strncmp(pPos, "Tree=", 5) == 0)
+    {
+      // skip "Tree=N" line
+      while (pPos < pEnd && *pPos != '\r' && *pPos != '\n')
+      {
+        ++pPos;
+      }
+      pPos = SSkipNewLines(pPos, pEnd);
+
+      std::vector<std::pair<std::string, std::string>> TreeKeyValues;
+      pPos = SParseKeyValueLines(pPos, pEnd, "Tree=", TreeKeyValues);
+      pPos = SSkipNewLines(pPos, pEnd);
+
+      AddTree(TreeKeyValues);
+    }
+
+    if (mTreeRoots.size() % mNumberOfOutputs != 0)
+    {
+      throw TReadableException("Invalid GBDT model: unexpected number of trees");
+    }
+
+    mNumberOfIterations = (int)(mTreeRoots.size() / mNumberOfOutputs);
+
+    mEarlyStopMargin = EarlyStopMargin;
+    mEarlyStopRoundPeriod = EarlyStopRoundPeriod;
+  }
+  catch (const TReadableException&)
+  {
+    Clear();
+    throw;
+  }
+  catch (const std::exception& Exception)
+  {
+    // LightGBM's parsers report errors via std::runtime_error
+    Clear();
+    throw TReadableException(TString("Invalid GBDT model: ") +
+      TString(Exception.what(), TString::kUtf8));
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TGbdtForest::Clear()
+{
+  mNumberOfFeatures = 0;
+  mNumberOfOutputs = 0;
+  mNumberOfIterations = 0;
+
+  mObjective = kRawScore;
+  mSigmoid = 1.0;
+  mAverageOutput = false;
+
+  mTreeRoots.clear();
+
+  mSplitFeatures.clear();
+  mThresholds.clear();
+  mDecisionTypes.clear();
+  mChilds.clear();
+
+  mLeafValues.clear();
+
+  mCatBoundaries.clear();
+  mCatThresholds.clear();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TGbdtForest::IsEmpty() const
+{
+  return mTreeRoots.empty();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TGbdtForest::NumberOfFeatures() const
+{
+  return mNumberOfFeatures;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TGbdtForest::NumberOfOutputs() const
+{
+  return mNumberOfOutputs;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TGbdtForest::NumberOfIterations() const
+{
+  return mNumberOfIterations;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TGbdtForest::Predict(
+  const double* pFeatures,
+  double*       pOutputs) const
+{
+  MAssert(!IsEmpty(), "Need to compile a model first");
+
+  for (int k = 0; k < mNumberOfOutputs; ++k)
+  {
+    pOutputs[k] = 0.0;
+  }
+
+  for (int i = 0; i < mNumberOfIterations; ++i)
+  {
+    const int FirstTree = i * mNumberOfOutputs;
+    for (int k = 0; k < mNumberOfOutputs; ++k)
+    {
+      pOutputs[k] += PredictTree(FirstTree + k, pFeatures);
+    }
+
+    if (mEarlyStopRoundPeriod > 0 && (i + 1) % mEarlyStopRoundPeriod == 0 &&
+        ShouldStopEarly(pOutputs))
+    {
+      break;
+    }
+  }
+
+  ConvertOutputs(pOutputs);
+}
+
+void TGbdtForest::Predict(
+  const double* pFeatureRows,
+  int           NumberOfRows,
+  double*       pOutputRows) const
+{
+  MAssert(!IsEmpty(), "Need to compile a model first");
+
+  for (int BlockStart = 0; BlockStart < NumberOfRows; BlockStart += MGbdtPredictionBlockSize)
+  {
+    const int BlockSize = MMin(MGbdtPredictionBlockSize, NumberOfRows - BlockStart);
+
+    const double* pBlockFeatures = pFeatureRows + (size_t)BlockStart * mNumberOfFeatures;
+    double* pBlockOutputs = pOutputRows + (size_t)BlockStart * mNumberOfOutputs;
+
+    for (int r = 0; r < BlockSize * mNumberOfOutputs; ++r)
+    {
+      pBlockOutputs[r] = 0.0;
+    }
+
+    // rows which did not stop early yet
+    int ActiveRows[MGbdtPredictionBlockSize];
+    int NumberOfActiveRows = BlockSize;
+    for (int r = 0; r < BlockSize; ++r)
+    {
+      ActiveRows[r] = r;
+    }
+
+    // walk the trees of one iteration for all active rows of the block at once,
+    // keeping each row's summation order the same as in the single row version
+    for (int i = 0; i < mNumberOfIterations && NumberOfActiveRows > 0; ++i)
+    {
+      const int FirstTree = i * mNumberOfOutputs;
+      for (int k = 0; k < mNumberOfOutputs; ++k)
+      {
+        for (int a = 0; a < NumberOfActiveRows; ++a)
+        {
+          const int Row = ActiveRows[a];
+          pBlockOutputs[Row * mNumberOfOutputs + k] += PredictTree(
+            FirstTree + k, pBlockFeatures + (size_t)Row * mNumberOfFeatures);
+        }
+      }
+
+      if (mEarlyStopRoundPeriod > 0 && (i + 1) % mEarlyStopRoundPeriod == 0)
+      {
+        int NumberOfRemainingRows = 0;
+        for (int a = 0; a < NumberOfActiveRows; ++a)
+        {
+          const int Row = ActiveRows[a];
+          if (!ShouldStopEarly(pBlockOutputs + Row * mNumberOfOutputs))
+          {
+            ActiveRows[NumberOfRemainingRows++] = Row;
+          }
+        }
+        NumberOfActiveRows = NumberOfRemainingRows;
+      }
+    }
+
+    for (int r = 0; r < BlockSize; ++r)
+    {
+      ConvertOutputs(pBlockOutputs + r * mNumberOfOutputs);
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TGbdtForest::AddTree(
+  const std::vector<std::pair<std::string, std::string>>& KeyValues)
+{
+  int NumberOfLeaves = 0;
+  LightGBM::Common::Atoi(SValue(KeyValues, "num_leaves").c_str(), &NumberOfLeaves);
+
+  int NumberOfCategories = 0;
+  LightGBM::Common::Atoi(SValue(KeyValues, "num_cat").c_str(), &NumberOfCategories);
+
+  if (const std::string* pValue = SFindValue(KeyValues, "is_linear"))
+  {
+    int IsLinear = 0;
+    LightGBM::Common::Atoi(pValue->c_str(), &IsLinear);
+    if (IsLinear != 0)
+    {
+      throw TReadableException("Unsupported GBDT model: linear trees are not supported");
+    }
+  }
+
+  if (NumberOfLeaves < 1)
+  {
+    throw TReadableException("Invalid GBDT model: trees need at least one leaf");
+  }
+
+  // parse values with LightGBM's parsers, to get bit-exact values
+  const std::vector<double> LeafValues = LightGBM::CommonC::StringToArray<double>(
+    SValue(KeyValues, "leaf_value"), NumberOfLeaves);
+
+  const int LeafOffset = (int)mLeafValues.size();
+  mLeafValues.insert(mLeafValues.end(), LeafValues.begin(), LeafValues.end());
+
+  if (NumberOfLeaves == 1)
+  {
+    mTreeRoots.push_back(~LeafOffset);
+    return;
+  }
+
+  const int NumberOfNodes = NumberOfLeaves - 1;
+
+  const std::vector<int> SplitFeatures = LightGBM::CommonC::StringToArrayFast<int>(
+    SValue(KeyValues, "split_feature"), NumberOfNodes);
+  const std::vector<double> Thresholds = LightGBM::CommonC::StringToArray<double>(
+    SValue(KeyValues, "threshold"), NumberOfNodes);
+  const std::vector<int> LeftChilds = LightGBM::CommonC::StringToArrayFast<int>(
+    SValue(KeyValues, "left_child"), NumberOfNodes);
+  const std::vector<int> RightChilds = LightGBM::CommonC::StringToArrayFast<int>(
+    SValue(KeyValues, "right_child"), NumberOfNodes);
+
+  std::vector<TInt8> DecisionTypes(NumberOfNodes, 0);
+  if (const std::string* pValue = SFindValue(KeyValues, "decision_type"))
+  {
+    DecisionTypes = LightGBM::CommonC::StringToArrayFast<TInt8>(*pValue, NumberOfNodes);
+  }
+
+  // append categorical bitsets, continuing the global boundary list
+  int CatIndexOffset = 0;
+  if (NumberOfCategories > 0)
+  {
+    const std::vector<int> CatBoundaries = LightGBM::CommonC::StringToArrayFast<int>(
+      SValue(KeyValues, "cat_boundaries"), NumberOfCategories + 1);
+    const std::vector<TUInt32> CatThresholds = LightGBM::CommonC::StringToArrayFast<TUInt32>(
+      SValue(KeyValues, "cat_threshold"), CatBoundaries.back());
+
+    if (mCatBoundaries.empty())
+    {
+      mCatBoundaries.push_back(0);
+    }
+
+    CatIndexOffset = (int)mCatBoundaries.size() - 1;
+    const int CatThresholdOffset = (int)mCatThresholds.size();
+    for (int c = 1; c <= NumberOfCategories; ++c)
+    {
+      mCatBoundaries.push_back(CatThresholdOffset + CatBoundaries[c]);
+    }
+    mCatThresholds.insert(mCatThresholds.end(), CatThresholds.begin(), CatThresholds.end());
+  }
+
+  // append nodes, relocating child and leaf indices
+  const int NodeOffset = (int)mSplitFeatures.size();
+  for (int n = 0; n < NumberOfNodes; ++n)
+  {
+    const TUInt8 DecisionType = (TUInt8)DecisionTypes[n];
+
+    if (SplitFeatures[n] < 0 || SplitFeatures[n] >= mNumberOfFeatures)
+    {
+      throw TReadableException("Invalid GBDT model: split feature out of range");
+    }
+    mSplitFeatures.push_back(SplitFeatures[n]);
+    mDecisionTypes.push_back(DecisionType);
+
+    if (DecisionType & sCategoricalMask)
+    {
+      const int CatIndex = (int)Thresholds[n];
+      if (CatIndex < 0 || CatIndex >= NumberOfCategories)
+      {
+        throw TReadableException("Invalid GBDT model: categorical split out of range");
+      }
+      mThresholds.push_back((double)(CatIndexOffset + CatIndex));
+    }
+    else
+    {
+      mThresholds.push_back(Thresholds[n]);
+    }
+
+    const int Childs[2] = { LeftChilds[n], RightChilds[n] };
+    for (int c = 0; c < 2; ++c)
+    {
+      const int Child = Childs[c];
+      if (Child >= NumberOfNodes || ~Child >= NumberOfLeaves)
+      {
+        throw TReadableException("Invalid GBDT model: tree node out of range");
+      }
+      const int RelocatedChild = (Child >= 0) ?
+        NodeOffset + Child : ~(LeafOffset + ~Child);
+      mChilds.push_back(RelocatedChild);
+    }
+  }
+
+  mTreeRoots.push_back(NodeOffset);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+MForceInline int TGbdtForest::NextNode(int Node, double FeatureValue) const
+{
+  // mirrors LightGBM::Tree::NumericalDecision and CategoricalDecision
+  const TUInt8 DecisionType = mDecisionTypes[Node];
+  const int* pChilds = &mChilds[2 * Node];
+
+  // plain numerical split without missing value handling: the common case
+  if ((DecisionType & (sCategoricalMask | sMissingTypeMask)) == 0)
+  {
+    if (std::isnan(FeatureValue))
+    {
+      FeatureValue = 0.0;
+    }
+    return pChilds[(FeatureValue <= mThresholds[Node]) ? 0 : 1];
+  }
+
+  const int MissingType = (DecisionType & sMissingTypeMask) >> 2;
+
+  if (!(DecisionType & sCategoricalMask))
+  {
+    if (std::isnan(FeatureValue) && MissingType != sMissingNaN)
+    {
+      FeatureValue = 0.0;
+    }
+
+    if ((MissingType == sMissingZero &&
+          FeatureValue >= -LightGBM::kZeroThreshold &&
+          FeatureValue <= LightGBM::kZeroThreshold) ||
+        (MissingType == sMissingNaN && std::isnan(FeatureValue)))
+    {
+      return pChilds[(DecisionType & sDefaultLeftMask) ? 0 : 1];
+    }
+
+    return pChilds[(FeatureValue <= mThresholds[Node]) ? 0 : 1];
+  }
+  else
+  {
+    int Category = (int)FeatureValue;
+    if (Category < 0)
+    {
+      return pChilds[1];
+    }
+    else if (std::isnan(FeatureValue))
+    {
+      if (MissingType == sMissingNaN)
+      {
+        return pChilds[1];
+      }
+      Category = 0;
+    }
+
+    const int CatIndex = (int)mThresholds[Node];
+    const int BitsetStart = mCatBoundaries[CatIndex];
+    const int BitsetSize = mCatBoundaries[CatIndex + 1] - BitsetStart;
+
+    const int Word = Category / 32;
+    const bool InBitset = Word < BitsetSize &&
+      ((mCatThresholds[BitsetStart + Word] >> (Category % 32)) & 1);
+    return pChilds[InBitset ? 0 : 1];
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+double TGbdtForest::PredictTree(int Tree, const double* pFeatures) const
+{
+  int Node = mTreeRoots[Tree];
+  while (Node >= 0)
+  {
+    Node = NextNode(Node, pFeatures[mSplitFeatures[Node]]);
+  }
+  return mLeafValues[~Node];
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TGbdtForest::ShouldStopEarly(const double* pOutputs) const
+{
+  // mirrors LightGBM's "multiclass" prediction early stopping: margin between
+  // the largest and second largest raw score
+  double Largest = -std::numeric_limits<double>::infinity();
+  double SecondLargest = -std::numeric_limits<double>::infinity();
+  for (int k = 0; k < mNumberOfOutputs; ++k)
+  {
+    const double Value = pOutputs[k];
+    if (Value > Largest)
+    {
+      SecondLargest = Largest;
+      Largest = Value;
+    }
+    else if (Value > SecondLargest)
+    {
+      SecondLargest = Value;
+    }
+  }
+
+  return (Largest - SecondLargest) > mEarlyStopMargin;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TGbdtForest::ConvertOutputs(double* pOutputs) const
+{
+  if (mAverageOutput)
+  {
+    for (int k = 0; k < mNumberOfOutputs; ++k)
+    {
+      pOutputs[k] /= mNumberOfIterations;
+    }
+  }
+
+  switch (mObjective)
+  {
+  case kRawScore:
+    break;
+
+  case kSoftmax:
+  {
+    // mirrors LightGBM::Common::Softmax
+    double Max = pOutputs[0];
+    for (int k = 1; k < mNumberOfOutputs; ++k)
+    {
+      Max = std::max(pOutputs[k], Max);
+    }
+    double Sum = 0.0;
+    for (int k = 0; k < mNumberOfOutputs; ++k)
+    {
+      pOutputs[k] = std::exp(pOutputs[k] - Max);
+      Sum += pOutputs[k];
+    }
+    for (int k = 0; k < mNumberOfOutputs; ++k)
+    {
+      pOutputs[k] /= Sum;
+    }
+    break;
+  }
+
+  case kSigmoid:
+    // mirrors LightGBM::MulticlassOVA::ConvertOutput
+    for (int k = 0; k < mNumberOfOutputs; ++k)
+    {
+      pOutputs[k] = 1.0 / (1.0 + std::exp(-mSigmoid * pOutputs[k]));
+    }
+    break;
+
+  default:
+    MInvalid("Unexpected objective");
+  }
+}
+
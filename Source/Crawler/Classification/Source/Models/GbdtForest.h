@@ -0,0 +1,128 @@
+#pragma once
+
+#ifndef _GbdtForest_h_
+#define _GbdtForest_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/BaseTypes.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// =================================================================================================
+
+/*!
+ * Compiled, read-only representation of a trained LightGBM GBDT model, used by
+ * TGbdtClassificationModel to evaluate models.
+ *
+ * All trees of the model are flattened into contiguous structure-of-arrays node
+ * tables once, when compiling the model. Predictions then only read from the
+ * tables, so a single forest can be evaluated by any number of threads at once
+ * and does not allocate any memory.
+ *
+ * Predictions are bit-exact to LightGBM's Boosting::Predict with a "multiclass"
+ * prediction early stopping instance: trees are summed up in the same order,
+ * early stopping checks are done in the same rounds, and raw scores are converted
+ * just like LightGBM's objective functions do.
+!*/
+
+class TGbdtForest
+{
+public:
+  TGbdtForest();
+
+  //! Compile the given LightGBM text model (as written by Boosting::SaveModelToString).
+  //! \param EarlyStopMargin and \param EarlyStopRoundPeriod set up the prediction
+  //! early stopping, just like LightGBM's pred_early_stop_margin and _freq configs.
+  //! @throws TReadableException when the model can not be parsed or is not supported.
+  void Compile(
+    const char* pModelString,
+    size_t      ModelStringLength,
+    double      EarlyStopMargin,
+    int         EarlyStopRoundPeriod);
+
+  //! Release a compiled model.
+  void Clear();
+
+  //! True when no model got compiled yet.
+  bool IsEmpty() const;
+
+  //! Number of input features a single prediction reads.
+  int NumberOfFeatures() const;
+  //! Number of outputs a single prediction writes (number of classes).
+  int NumberOfOutputs() const;
+  //! Number of boosting iterations. Each iteration has NumberOfOutputs trees.
+  int NumberOfIterations() const;
+
+  //! Predict a single row of NumberOfFeatures features into NumberOfOutputs outputs.
+  void Predict(
+    const double* pFeatures,
+    double*       pOutputs) const;
+
+  //! Predict NumberOfRows rows of NumberOfFeatures features into NumberOfRows
+  //! rows of NumberOfOutputs outputs. Results are the same as predicting each row
+  //! separately, but trees get traversed for blocks of rows at once.
+  void Predict(
+    const double* pFeatureRows,
+    int           NumberOfRows,
+    double*       pOutputRows) const;
+
+private:
+  enum TObjective
+  {
+    kRawScore,
+    kSoftmax,
+    kSigmoid
+  };
+
+  //! Parse and append a single "Tree=" section of the model.
+  void AddTree(
+    const std::vector<std::pair<std::string, std::string>>& KeyValues);
+
+  //! Get leaf value of the given tree for the given features.
+  double PredictTree(int Tree, const double* pFeatures) const;
+  //! Index of the child node (or ~leaf index) the given node's split selects.
+  int NextNode(int Node, double FeatureValue) const;
+
+  //! True when the top two raw scores are far enough apart to stop predicting.
+  bool ShouldStopEarly(const double* pOutputs) const;
+  //! Convert raw scores into final outputs, as specified by the model's objective.
+  void ConvertOutputs(double* pOutputs) const;
+
+  int mNumberOfFeatures;
+  int mNumberOfOutputs;
+  int mNumberOfIterations;
+
+  TObjective mObjective;
+  double mSigmoid;
+  bool mAverageOutput;
+
+  double mEarlyStopMargin;
+  int mEarlyStopRoundPeriod;
+
+  // root node per tree: node index, or ~leaf index for single leaf trees
+  std::vector<int> mTreeRoots;
+
+  // split nodes of all trees. Children are node indices, or ~leaf indices:
+  // the left child of node n is mChilds[2*n], the right one mChilds[2*n + 1].
+  // For categorical splits, the threshold is the index into mCatBoundaries.
+  std::vector<int> mSplitFeatures;
+  std::vector<double> mThresholds;
+  std::vector<TUInt8> mDecisionTypes;
+  std::vector<int> mChilds;
+
+  // leaf values of all trees
+  std::vector<double> mLeafValues;
+
+  // bitsets of all categorical splits: bitset i is mCatThresholds
+  // [mCatBoundaries[i], mCatBoundaries[i + 1])
+  std::vector<int> mCatBoundaries;
+  std::vector<TUInt32> mCatThresholds;
+};
+
+
+#endif // _GbdtForest_h_
+
@@ -0,0 +1,280 @@
+#include "CoreTypes/Export/Directory.h"
+#include "CoreTypes/Export/Exception.h"
+#include "CoreTypes/Export/TestHelpers.h"
+
+#include "FeatureExtraction/Export/SampleClassificationDescriptors.h"
+
+#include "Classification/Export/ClassificationModel.h"
+#include "Classification/Export/DefaultClassificationModel.h"
+#include "Classification/Export/ClassificationTestDataSet.h"
+#include "Classification/Export/ClassificationTestDataItem.h"
+#include "Classification/Test/TestClassificationModel.h"
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+//! Model which only memorizes the normalizer and outlier limits of its train data.
+
+class TNormalizationTestModel : public TClassificationModel
+{
+private:
+  virtual TString OnName() const override
+  {
+    return "NormalizationTest";
+  }
+
+  virtual TClassificationTestResults OnTrain(
+    const TString&                      DatabaseFileName,
+    const shark::ClassificationDataset& TrainData,
+    const TList<TString>&               TrainSampleNames,
+    const shark::ClassificationDataset& TestData,
+    const TList<TString>                TestSampleNames,
+    const TPoint&                       InputFeaturesSize,
+    int                                 NumberOfClasses) override
+  {
+    return TClassificationTestResults();
+  }
+
+  virtual TList<float> OnEvaluate(
+    const TClassificationTestDataItem& Item) const override
+  {
+    return TList<float>();
+  }
+
+  virtual void OnLoadModel(eos::portable_iarchive& Archive) override { }
+  virtual void OnSaveModel(eos::portable_oarchive& Archive) const override { }
+};
+
+// -------------------------------------------------------------------------------------------------
+
+//! Create random, two class "Kicks" vs "Snares" classification descriptors, with
+//! features of very different scales and offsets, and some outliers.
+static TList<TSampleClassificationDescriptors> SCreateDescriptors(int NumberOfSamples)
+{
+  const int NumberOfFeatures = TSampleClassificationDescriptors::sNumberOfTimeFrames *
+    (TSampleClassificationDescriptors::sNumberOfSpectrumBands + 4);
+
+  const TString BasePath = gTempDir().Path();
+
+  TList<TSampleClassificationDescriptors> Descriptors;
+  for (int s = 0; s < NumberOfSamples; ++s)
+  {
+    const bool IsKick = (s % 2 == 0);
+
+    TSampleClassificationDescriptors Descriptor;
+    Descriptor.mFileName = BasePath + (IsKick ? "Kicks/Kick" : "Snares/Snare") + 
+      ToString(s) + ".wav";
+
+    Descriptor.mFeatures.resize(NumberOfFeatures);
+    for (int f = 0; f < NumberOfFeatures; ++f)
+    {
+      const double Scale = ::pow(10.0, f % 7 - 3);
+      const double Offset = (f % 5 - 2) * Scale + (IsKick ? 0.0 : Scale);
+
+      double Value = Offset + Scale * (TMath::RandFloat() - 0.5);
+      if (TRandom::Integer(50) == 0)
+      {
+        Value *= 100.0; // outlier
+      }
+
+      Descriptor.mFeatures[f] = Value;
+    }
+
+    Descriptors.Append(Descriptor);
+  }
+
+  return Descriptors;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Largest absolute difference of the fused feature normalization and the shark 
+//! Normalizer and Truncate transforms of a test data item for all \param Descriptors.
+static double SMaxNormalizationDifference(
+  const TClassificationModel&                     Model,
+  const TList<TSampleClassificationDescriptors>&  Descriptors)
+{
+  double MaxDifference = 0.0;
+
+  for (int s = 0; s < Descriptors.Size(); ++s)
+  {
+    const TClassificationTestDataItem Item(Descriptors[s],
+      *Model.Normalizer(), Model.OutlierLimits());
+
+    const shark::RealMatrix& Expected = Item.TestData().batch(0);
+
+    std::vector<double> Features = Descriptors[s].mFeatures;
+    Model.NormalizeFeatures(Features);
+
+    BOOST_REQUIRE_EQUAL(Expected.size2(), Features.size());
+    for (size_t f = 0; f < Features.size(); ++f)
+    {
+      MaxDifference = MMax(MaxDifference, TMathT<double>::Abs(Features[f] - Expected(0, f)));
+    }
+  }
+
+  return MaxDifference;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Evaluate the given trained model's normalized features of all \param Descriptors 
+//! at once and check that the results match evaluating each row on its own.
+static void SCheckFeatureRowEvaluation(
+  const TClassificationModel&                     Model,
+  const TList<TSampleClassificationDescriptors>&  Descriptors)
+{
+  std::vector<double> FeatureRows;
+  for (int s = 0; s < Descriptors.Size(); ++s)
+  {
+    FeatureRows.insert(FeatureRows.end(), 
+      Descriptors[s].mFeatures.begin(), Descriptors[s].mFeatures.end());
+  }
+  Model.NormalizeFeatureRows(FeatureRows, Descriptors.Size());
+
+  const TList< TList<float> > RowResults = 
+    Model.EvaluateFeatureRows(FeatureRows, Descriptors.Size());
+  BOOST_REQUIRE_EQUAL(RowResults.Size(), Descriptors.Size());
+
+  int Mismatches = 0;
+  for (int s = 0; s < Descriptors.Size(); ++s)
+  {
+    std::vector<double> Features = Descriptors[s].mFeatures;
+    Model.NormalizeFeatures(Features);
+
+    const TList<float> Expected = Model.EvaluateFeatures(Features);
+    BOOST_REQUIRE_EQUAL(RowResults[s].Size(), Expected.Size());
+
+    for (int c = 0; c < Expected.Size(); ++c)
+    {
+      if (TMathT<float>::Abs(RowResults[s][c] - Expected[c]) > 1e-6f)
+      {
+        ++Mismatches;
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TClassificationTest::FeatureNormalization()
+{
+  BOOST_TEST_MESSAGE("  Testing feature normalization...");
+
+  M__DisableFloatingPointAssertions
+
+  try
+  {
+    const TList<TSampleClassificationDescriptors> TrainDescriptors = SCreateDescriptors(60);
+    const TClassificationTestDataSet DataSet("NormalizationTest", TrainDescriptors);
+
+    TNormalizationTestModel Model;
+    Model.Train(DataSet);
+
+    // ... train and unseen features must match the shark transforms
+
+    const TList<TSampleClassificationDescriptors> TestDescriptors = SCreateDescriptors(20);
+    
+    BOOST_CHECK_SMALL(SMaxNormalizationDifference(Model, TrainDescriptors), 1e-12);
+    BOOST_CHECK_SMALL(SMaxNormalizationDifference(Model, TestDescriptors), 1e-12);
+
+    // ... loaded models must normalize the same way
+
+    std::stringstream Stream;
+    {
+      eos::portable_oarchive OutputArchive(Stream);
+      Model.Save(OutputArchive);
+    }
+    
+    TNormalizationTestModel LoadedModel;
+    {
+      eos::portable_iarchive InputArchive(Stream);
+      LoadedModel.Load(InputArchive);
+    }
+
+    BOOST_CHECK_SMALL(SMaxNormalizationDifference(LoadedModel, TestDescriptors), 1e-12);
+
+    // ... row wise normalization must match single sample normalization
+
+    const int NumberOfFeatures = (int)TestDescriptors.First().mFeatures.size();
+
+    std::vector<double> FeatureRows;
+    for (int s = 0; s < TestDescriptors.Size(); ++s)
+    {
+      FeatureRows.insert(FeatureRows.end(), 
+        TestDescriptors[s].mFeatures.begin(), TestDescriptors[s].mFeatures.end());
+    }
+    Model.NormalizeFeatureRows(FeatureRows, TestDescriptors.Size());
+
+    int Mismatches = 0;
+    for (int s = 0; s < TestDescriptors.Size(); ++s)
+    {
+      std::vector<double> Features = TestDescriptors[s].mFeatures;
+      Model.NormalizeFeatures(Features);
+
+      if (!std::equal(Features.begin(), Features.end(), 
+            FeatureRows.begin() + (size_t)s * NumberOfFeatures))
+      {
+        ++Mismatches;
+      }
+    }
+    BOOST_CHECK_EQUAL(Mismatches, 0);
+
+    // ... feature count mismatches must throw
+
+    std::vector<double> TooFewFeatures(NumberOfFeatures - 1, 0.0);
+    BOOST_CHECK_THROW(Model.NormalizeFeatures(TooFewFeatures), shark::Exception);
+    BOOST_CHECK_THROW(Model.NormalizeFeatureRows(FeatureRows, 1), shark::Exception);
+  }
+  catch (const shark::Exception& Exception)
+  {
+    BOOST_ERROR(Exception.what());
+  }
+
+  M__EnableFloatingPointAssertions
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TClassificationTest::FeatureRowEvaluation()
+{
+  BOOST_TEST_MESSAGE("  Testing feature row evaluation...");
+
+  M__DisableFloatingPointAssertions
+
+  try
+  {
+    const TList<TSampleClassificationDescriptors> TrainDescriptors = SCreateDescriptors(60);
+    const TClassificationTestDataSet DataSet("FeatureRowEvaluationTest", TrainDescriptors);
+
+    const TList<TSampleClassificationDescriptors> TestDescriptors = SCreateDescriptors(20);
+
+    // ... GBDT forest
+    {
+      TGbdtClassificationModel Model;
+      Model.Train(DataSet);
+
+      SCheckFeatureRowEvaluation(Model, TestDescriptors);
+    }
+
+    // ... bagged GBDT ensemble
+    {
+      TDefaultBaggingClassificationModel Model;
+      Model.Train(DataSet);
+
+      SCheckFeatureRowEvaluation(Model, TestDescriptors);
+    }
+  }
+  catch (const shark::Exception& Exception)
+  {
+    BOOST_ERROR(Exception.what());
+  }
+
+  M__EnableFloatingPointAssertions
+}
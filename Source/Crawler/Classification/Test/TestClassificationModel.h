@@ -0,0 +1,15 @@
+#pragma once
+
+#ifndef _TestClassificationModel_h_
+#define _TestClassificationModel_h_
+
+// =================================================================================================
+
+namespace TClassificationTest
+{
+  void FeatureNormalization();
+  void FeatureRowEvaluation();
+}
+
+
+#endif // _TestClassificationModel_h_
@@ -0,0 +1,236 @@
+#include "CoreTypes/Export/Exception.h"
+#include "CoreTypes/Export/TestHelpers.h"
+
+#include "Classification/Source/Models/GbdtForest.h"
+#include "Classification/Test/TestGbdt.h"
+
+#include "../../3rdParty/LightGBM/Export/LightGBM.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+// =================================================================================================
+
+// A small hand written 3 class LightGBM model with two iterations, which uses
+// all split types the compiled forest supports: numerical splits with no, zero
+// and NaN missing value handling, categorical splits with one and two word
+// bitsets, and a single leaf tree.
+
+static const char* sGbdtModelHeader =
+  "tree\n"
+  "version=v3\n"
+  "num_class=3\n"
+  "num_tree_per_iteration=3\n"
+  "label_index=0\n"
+  "max_feature_idx=2\n";
+
+static const char* sGbdtModelTrees =
+  "feature_names=Column_0 Column_1 Column_2\n"
+  "feature_infos=[-2:2] [-2:2] -1:0:1:2:3:32\n"
+  "\n"
+  "Tree=0\n"
+  "num_leaves=3\n"
+  "num_cat=0\n"
+  "split_feature=0 1\n"
+  "threshold=0.5 -1.25\n"
+  "decision_type=2 8\n"
+  "left_child=1 -1\n"
+  "right_child=-2 -3\n"
+  "leaf_value=0.10000000000000001 -0.20000000000000001 0.29999999999999999\n"
+  "is_linear=0\n"
+  "shrinkage=1\n"
+  "\n"
+  "\n"
+  "Tree=1\n"
+  "num_leaves=1\n"
+  "num_cat=0\n"
+  "split_feature=\n"
+  "threshold=\n"
+  "decision_type=\n"
+  "left_child=\n"
+  "right_child=\n"
+  "leaf_value=0.050000000000000003\n"
+  "is_linear=0\n"
+  "shrinkage=1\n"
+  "\n"
+  "\n"
+  "Tree=2\n"
+  "num_leaves=3\n"
+  "num_cat=1\n"
+  "split_feature=2 0\n"
+  "threshold=0 2.5\n"
+  "decision_type=1 6\n"
+  "left_child=-1 -2\n"
+  "right_child=1 -3\n"
+  "leaf_value=0.41999999999999998 -0.13 0.070000000000000007\n"
+  "cat_boundaries=0 1\n"
+  "cat_threshold=10\n"
+  "is_linear=0\n"
+  "shrinkage=1\n"
+  "\n"
+  "\n"
+  "Tree=3\n"
+  "num_leaves=3\n"
+  "num_cat=0\n"
+  "split_feature=2 1\n"
+  "threshold=1.5 0\n"
+  "decision_type=10 4\n"
+  "left_child=-1 -2\n"
+  "right_child=1 -3\n"
+  "leaf_value=-0.33000000000000002 0.20999999999999999 0.02\n"
+  "is_linear=0\n"
+  "shrinkage=0.5\n"
+  "\n"
+  "\n"
+  "Tree=4\n"
+  "num_leaves=2\n"
+  "num_cat=1\n"
+  "split_feature=2\n"
+  "threshold=0\n"
+  "decision_type=9\n"
+  "left_child=-1\n"
+  "right_child=-2\n"
+  "leaf_value=0.25 -0.14999999999999999\n"
+  "cat_boundaries=0 2\n"
+  "cat_threshold=5 1\n"
+  "is_linear=0\n"
+  "shrinkage=0.5\n"
+  "\n"
+  "\n"
+  "Tree=5\n"
+  "num_leaves=3\n"
+  "num_cat=0\n"
+  "split_feature=1 0\n"
+  "threshold=1.0000000180025095e-35 -0.75\n"
+  "decision_type=4 0\n"
+  "left_child=1 -2\n"
+  "right_child=-1 -3\n"
+  "leaf_value=0.16 -0.27000000000000002 0.11\n"
+  "is_linear=0\n"
+  "shrinkage=0.5\n"
+  "\n"
+  "\n"
+  "end of trees\n";
+
+// -------------------------------------------------------------------------------------------------
+
+static std::string SGbdtModel(const char* pObjective)
+{
+  return std::string(sGbdtModelHeader) + "objective=" + pObjective + "\n" + sGbdtModelTrees;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// Compare the compiled forest's single and batch predictions with LightGBM's
+// predictions for all combinations of some interesting feature values.
+
+static void SCheckGbdtForest(
+  const std::string&  Model,
+  double              EarlyStopMargin,
+  int                 EarlyStopRoundPeriod)
+{
+  std::unique_ptr<LightGBM::Boosting> pBoosting(
+    LightGBM::Boosting::CreateBoosting("gbdt", nullptr));
+  pBoosting->LoadModelFromString(Model.c_str(), Model.size());
+
+  const int StartIteration = 0;
+  const int NumberOfIterations = -1;
+  const bool PredictFeatureContribution = false;
+  pBoosting->InitPredict(StartIteration, NumberOfIterations, PredictFeatureContribution);
+
+  LightGBM::PredictionEarlyStopConfig EarlyStopConfig;
+  EarlyStopConfig.margin_threshold = EarlyStopMargin;
+  EarlyStopConfig.round_period = EarlyStopRoundPeriod;
+
+  const LightGBM::PredictionEarlyStopInstance EarlyStop =
+    LightGBM::CreatePredictionEarlyStopInstance("multiclass", EarlyStopConfig);
+
+  TGbdtForest Forest;
+  Forest.Compile(Model.c_str(), Model.size(), EarlyStopMargin, EarlyStopRoundPeriod);
+
+  BOOST_CHECK_EQUAL(Forest.NumberOfFeatures(), 3);
+  BOOST_CHECK_EQUAL(Forest.NumberOfOutputs(), 3);
+  BOOST_CHECK_EQUAL(Forest.NumberOfIterations(), 2);
+
+  const double NaN = std::numeric_limits<double>::quiet_NaN();
+  const double Values[] = {
+    NaN, -2.0, -1.25, -1.0, -1e-36, 0.0, 1e-36, 0.5, 1.0, 1.5, 2.0, 3.0, 32.0, 40.0
+  };
+
+  std::vector<double> FeatureRows;
+  for (double Value0 : Values)
+  {
+    for (double Value1 : Values)
+    {
+      for (double Value2 : Values)
+      {
+        FeatureRows.push_back(Value0);
+        FeatureRows.push_back(Value1);
+        FeatureRows.push_back(Value2);
+      }
+    }
+  }
+
+  const int NumberOfRows = (int)FeatureRows.size() / 3;
+
+  std::vector<double> BatchOutputs(NumberOfRows * 3);
+  Forest.Predict(FeatureRows.data(), NumberOfRows, BatchOutputs.data());
+
+  int Mismatches = 0;
+  for (int Row = 0; Row < NumberOfRows; ++Row)
+  {
+    double ExpectedOutputs[3], Outputs[3];
+    pBoosting->Predict(&FeatureRows[Row * 3], ExpectedOutputs, &EarlyStop);
+    Forest.Predict(&FeatureRows[Row * 3], Outputs);
+
+    // results must be bit-exact
+    if (::memcmp(ExpectedOutputs, Outputs, sizeof(Outputs)) != 0 ||
+        ::memcmp(ExpectedOutputs, &BatchOutputs[Row * 3], sizeof(Outputs)) != 0)
+    {
+      ++Mismatches;
+    }
+  }
+
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TClassificationTest::Gbdt()
+{
+  BOOST_TEST_MESSAGE("  Testing GBDT forest...");
+
+  M__DisableFloatingPointAssertions
+
+  const char* Objectives[] = {
+    "multiclass num_class:3", "multiclassova num_class:3 sigmoid:1.5"
+  };
+
+  for (const char* pObjective : Objectives)
+  {
+    const std::string Model = SGbdtModel(pObjective);
+
+    // default early stopping, early stopping after each round and none
+    SCheckGbdtForest(Model, 10.0, 10);
+    SCheckGbdtForest(Model, 0.25, 1);
+    SCheckGbdtForest(Model, 0.0, 0);
+  }
+
+  // unsupported objectives and broken models must throw
+  TGbdtForest Forest;
+
+  const std::string RegressionModel = SGbdtModel("regression");
+  BOOST_CHECK_THROW(Forest.Compile(RegressionModel.c_str(), RegressionModel.size(), 10.0, 10),
+    TReadableException);
+
+  const std::string BrokenModel = std::string(sGbdtModelHeader) + "Tree=0\nnum_leaves=3\n";
+  BOOST_CHECK_THROW(Forest.Compile(BrokenModel.c_str(), BrokenModel.size(), 10.0, 10),
+    TReadableException);
+  BOOST_CHECK(Forest.IsEmpty());
+
+  M__EnableFloatingPointAssertions
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#ifndef _TestGbdt_h_
+#define _TestGbdt_h_
+
+// =================================================================================================
+
+namespace TClassificationTest
+{
+  void Gbdt();
+}
+
+
+#endif // _TestGbdt_h_
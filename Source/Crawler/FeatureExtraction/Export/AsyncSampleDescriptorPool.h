@@ -0,0 +1,146 @@
+#pragma once
+
+#ifndef _AsyncSampleDescriptorPool_h_
+#define _AsyncSampleDescriptorPool_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/Str.h"
+#include "CoreTypes/Export/List.h"
+#include "CoreTypes/Export/Pointer.h"
+
+#include "FeatureExtraction/Export/SampleDescriptorPool.h"
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+// =================================================================================================
+
+/*!
+ * Decouples writes into a TSampleDescriptorPool from the callers: all insert
+ * and remove calls are queued, and written by a single writer thread into the
+ * wrapped pool in batches, so callers won't block on the underlying database.
+ *
+ * A batch is written as soon as \param BatchSize requests are pending or when
+ * \param BatchTimeInMs elapsed. When the queue holds more than \param MaxQueueSize
+ * requests, callers will block until the writer catched up.
+ *
+ * Read access is forwarded to the wrapped pool, after flushing pending writes.
+ * Write errors are rethrown as TReadableException in the next write or flush call.
+!*/
+
+class TAsyncSampleDescriptorPool : public TSampleDescriptorPool
+{
+public:
+  enum {
+    kDefaultBatchSize = 64,
+    kDefaultBatchTimeInMs = 2000,
+    kDefaultMaxQueueSize = 256
+  };
+
+  TAsyncSampleDescriptorPool(
+    TSampleDescriptorPool*  pPool,
+    int                     BatchSize = kDefaultBatchSize,
+    int                     BatchTimeInMs = kDefaultBatchTimeInMs,
+    int                     MaxQueueSize = kDefaultMaxQueueSize);
+
+  //! flushes all pending writes and stops the writer thread
+  virtual ~TAsyncSampleDescriptorPool();
+
+
+  //@{ ... TSampleDescriptorPool impl
+
+  virtual bool IsEmpty() const override;
+
+  virtual int NumberOfSamples() const override;
+  virtual TOwnerPtr<TSampleDescriptors> Sample(int Index) const override;
+  virtual void ForEachSample(const TForEachSampleFunc& Function) const override;
+
+  virtual TList<TSampleFileStat> SampleFileStats() const override;
+
+  virtual void InsertSample(
+    const TString&             FileName,
+    const TSampleDescriptors&  Results) override;
+
+  virtual void InsertFailedSample(
+    const TString& FileName,
+    const TString& Reason) override;
+
+  virtual void RemoveSample(const TString& FileNames) override;
+  virtual void RemoveSamples(const TList<TString>& FileNames) override;
+
+  virtual void RenameSamples(
+    const TList< TPair<TString, TString> >& OldAndNewFileNames) override;
+
+  virtual void InsertClassifier(
+    const TString&        ClassifierName,
+    const TList<TString>& Classes) override;
+  //@}
+
+
+  //@{ ... New interface
+
+  //! Block until all pending writes got written into the wrapped pool.
+  //! @throws TReadableException when writing failed
+  void Flush() const;
+  //@}
+
+private:
+  struct TWriteRequest
+  {
+    enum TType
+    {
+      kInsertSample,
+      kInsertFailedSample,
+      kRemoveSamples,
+      kRenameSamples,
+      kInsertClassifier
+    };
+
+    TType mType;
+    // sample filename or classifier name
+    TString mName;
+    // kInsertSample only
+    TOwnerPtr<TSampleDescriptors> mpResults;
+    // kInsertFailedSample only
+    TString mReason;
+    // sample filenames (kRemoveSamples) or classes (kInsertClassifier)
+    TList<TString> mNames;
+    // old and new sample filenames (kRenameSamples only)
+    TList< TPair<TString, TString> > mNamePairs;
+  };
+
+  void QueueRequest(const TWriteRequest& Request);
+  void WriteRequests(std::deque<TWriteRequest>& Requests);
+
+  void WriterThread();
+
+  TSampleDescriptorPool* mpPool;
+
+  const int mBatchSize;
+  const int mBatchTimeInMs;
+  const int mMaxQueueSize;
+
+  // serializes access to the wrapped pool
+  mutable std::mutex mPoolLock;
+
+  // guards all members below
+  mutable std::mutex mQueueLock;
+  // signals the writer thread that there's something to do
+  mutable std::condition_variable mWriterCondition;
+  // signals that the queue got drained by the writer thread
+  mutable std::condition_variable mQueueDrainedCondition;
+
+  std::deque<TWriteRequest> mQueue;
+  bool mWriting;
+  mutable int mPendingFlushes;
+  bool mStopWriter;
+  TString mWriteError;
+
+  std::thread mWriterThread;
+};
+
+
+#endif // _AsyncSampleDescriptorPool_h_
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef _MelCepstrum_h_
+#define _MelCepstrum_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/Array.h"
+
+// =================================================================================================
+
+/*!
+ * Mel frequency cepstral coefficients of magnitude spectrum frames, as calculated
+ * by libXtract's xtract_mfcc with XTRACT_EQUAL_GAIN filters.
+ *
+ * The triangular mel filters are created once by libXtract, but only their non
+ * zero weights are stored: each band is a span of weights starting at its first
+ * bin. The DCT-II of the band energies' logs is a precomputed cosine matrix.
+ *
+ * Calc is const and uses no temporary heap memory, so a single instance can be
+ * shared by all analysis threads.
+!*/
+
+class TMelCepstrum
+{
+public:
+  enum { kMaxNumberOfCoefficients = 64 };
+
+  //! \param SpectrumSize is the number of magnitude bins (FFT size / 2), and
+  //! \param NumberOfCoefficients the number of mel bands and resulting MFCCs.
+  TMelCepstrum(
+    int     SpectrumSize,
+    double  Nyquist,
+    double  MinFrequency,
+    double  MaxFrequency,
+    int     NumberOfCoefficients);
+
+  //! number of magnitude bins the filters got created for
+  int SpectrumSize() const { return mSpectrumSize; }
+  //! number of mel bands and MFCCs
+  int NumberOfCoefficients() const { return mNumberOfCoefficients; }
+
+  //! Calculate MFCCs from \param pMagnitudes with SpectrumSize() bins.
+  //! \param pCoefficients must have space for NumberOfCoefficients() values.
+  void Calc(const double* pMagnitudes, double* pCoefficients) const;
+
+private:
+  int mSpectrumSize;
+  int mNumberOfCoefficients;
+
+  // per band: first bin, number of weights and offset into mFilterWeights
+  TArray<int> mBandStartBins;
+  TArray<int> mBandSizes;
+  TArray<int> mBandWeightOffsets;
+  TArray<double> mFilterWeights;
+
+  // NumberOfCoefficients x NumberOfCoefficients DCT-II cosine matrix, row major
+  TArray<double> mDctMatrix;
+};
+
+
+#endif // _MelCepstrum_h_
+
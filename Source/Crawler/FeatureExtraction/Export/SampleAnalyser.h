@@ -8,14 +8,20 @@
 // =================================================================================================
 
 #include "CoreTypes/Export/Str.h"
+#include "CoreTypes/Export/ThreadLocalValue.h"
 #include "AudioTypes/Export/Envelopes.h"
+#include "AudioTypes/Export/Resampler.h"
 #include "FeatureExtraction/Export/SampleDescriptors.h"
 
 #include <mutex>
+#include <vector>
 
-struct xtract_mel_filter_;
-
+class TAudioFile;
 class TClassificationModel;
+class TMelCepstrum;
+class TSampleAnalysisWorkspace;
+class TSampleAnalysisCache;
+class TSampleClassificationStage;
 class TSampleDescriptorPool;
 
 // =================================================================================================
@@ -49,6 +55,51 @@ public:
   //! level category features.
   void SetOneShotCategorizationModel(const TString& ModelPath);
 
+  //! Fingerprint of all settings which affect analysis results: sample rate, FFT and 
+  //! hop sizes, resampler quality, the descriptor set and the content of the loaded 
+  //! model files. 
+  TString ConfigFingerprint(TDescriptorSet DescriptorSet) const;
+
+  //! Optional cache, which \function Extract consults before loading and analyzing 
+  //! files, and which receives all new results. The cache must have been opened 
+  //! with this analyser's \function ConfigFingerprint and must stay alive while 
+  //! extracting. Set to NULL to disable caching (the default).
+  TSampleAnalysisCache* AnalysisCache() const;
+  void SetAnalysisCache(TSampleAnalysisCache* pCache);
+
+  //! Optional classification stage, to which \function Extract hands over high level 
+  //! or classification results before evaluating the classification models. The stage then evaluates 
+  //! the models for many files at once, and caches and writes the results into its 
+  //! pool. The stage must stay alive while extracting. Set to NULL to evaluate the 
+  //! models for each file in \function Extract (the default).
+  TSampleClassificationStage* ClassificationStage() const;
+  void SetClassificationStage(TSampleClassificationStage* pStage);
+
+  //! When enabled (the default), frame-wise independent spectral features of 
+  //! long files are calculated in parallel, in case there are idle CPU cores. 
+  //! Results are the same as when calculating them in a single thread.
+  bool ParallelFrameAnalysis() const;
+  void SetParallelFrameAnalysis(bool Enable);
+
+  //! Quality preset of the resampler, which converts files into the analyser's 
+  //! sample rate while loading them. By default TResampler::kHighQuality.
+  TResampler::TQuality ResamplerQuality() const;
+  void SetResamplerQuality(TResampler::TQuality Quality);
+
+  //! Allocation counters of the analysis workspaces of all analysers. Each 
+  //! analysing thread uses its own workspace, which only reallocates FFTs, 
+  //! trackers and buffers when the analysis settings changed.
+  struct TWorkspaceCounters
+  {
+    TWorkspaceCounters();
+
+    int mWorkspaces;  // number of created workspaces
+    int mResets;      // number of workspace resets: one per analyzed file
+    int mAllocations; // number of FFT, tracker and buffer (re)allocations
+  };
+
+  static TWorkspaceCounters SWorkspaceCounters();
+
   //! Analyze a single audio file and return results
   //! @throws TReadableException on errors
   TSampleDescriptors Analyze(
@@ -62,6 +113,17 @@ public:
     TSampleDescriptorPool*  pPool, 
     std::mutex&             PoolLock) const;
 
+  //! Evaluate the classification and categorization models for the given high level
+  //! results and write the class and category descriptors into them. All results 
+  //! are evaluated at once, with a single call per model.
+  //! Returns an error for each result: results with invalid (e.g. NAN or INF) features
+  //! or which failed to evaluate get a non empty error and are left unclassified, 
+  //! without affecting the other results of the batch.
+  TList<TString> Classify(const TList<TSampleDescriptors*>& Results) const;
+  //! Evaluate the models for a single high level result.
+  //! @throws TReadableException on errors
+  void Classify(TSampleDescriptors& Results) const;
+
 private:
   // get a few consts from TSampleDescriptors
   enum {
@@ -87,6 +149,9 @@ private:
     TArray<double> mData;
     // how many samples got added or removed, comparing mData with the original
     int mDataOffset;
+    // true when mData only covers the analyzation time range of a long file.
+    // File wide features then are precalculated while loading the sample.
+    bool mDataIsTruncated;
 
     // original file info
     TString mOriginalFileName;
@@ -103,6 +168,11 @@ private:
     // peak and rms of the original sample buffer, calculated before normalizing
     float mPeakValue;
     float mRmsValue;
+
+    // file wide effective length in seconds: only valid when mDataIsTruncated
+    double mEffectiveLength48dB;
+    double mEffectiveLength24dB;
+    double mEffectiveLength12dB;
   };
 
   // Silence status, calculated in AnalyzeLowLevelDescriptors
@@ -112,6 +182,49 @@ private:
     TList<bool> mRhythmFrameIsAudible;
   };
 
+  // Low level features which get calculated in AnalyzeLowLevelDescriptors
+  struct TLowLevelFeatures
+  {
+    //! all features, as needed by the low and high level descriptor sets
+    TLowLevelFeatures();
+
+    //! features which are needed to write the given descriptor set. For 
+    //! kClassificationDescriptors those are derived from the low level descriptors 
+    //! which are read by the classification features and heuristics.
+    static const TLowLevelFeatures& SFeatures(TDescriptorSet DescriptorSet);
+
+    bool mAmplitudePeak;
+    bool mAmplitudeRms;
+    bool mAmplitudeEnvelope;
+    bool mAutoCorrelation;
+    bool mSpectralRms;
+    bool mSpectralCentroidAndSpread;
+    bool mSpectralSkewnessAndKurtosis;
+    bool mSpectralRolloff;
+    bool mSpectralFlatness;
+    bool mSpectralFlux;
+    bool mSpectralBandFeatures;
+    bool mSpectrumBands;
+    bool mCepstrumBands;
+    bool mSpectralComplexity;
+    bool mSpectralInharmonicity;
+    bool mTristimulus;
+    // F0 and F0 confidence
+    bool mPitch;
+    // F0 with spectral centroid fallbacks and the harmonic spectrum
+    bool mFailSafePitch;
+    // onsets, tempo and onset statistics
+    bool mRhythm;
+    // final tempo, which is calculated from the rhythm features with heuristics
+    bool mRhythmFinalTempo;
+
+    // number of leading frames for which spectrum bands get calculated
+    int mNumberOfSpectrumBandFrames;
+
+  private:
+    static TLowLevelFeatures SClassificationFeatures();
+  };
+
   // filter out non audible frames from the given descriptor values
   TList<double> AudibleSpectrumFrames(
     TSilenceStatus&      SilenceStatus, 
@@ -119,18 +232,47 @@ private:
 
   //! Load and normalize sample data.
   void LoadSample(const TString& FileName, TSampleData& Data) const;
+  //! Load and normalize all sample data at once. Used for short files.
+  void LoadSampleFully(
+    TAudioFile*   pAudioFile,
+    TSampleData&  Data) const;
+  //! Load and normalize the analyzed range of the sample only, calculating 
+  //! file wide stats in a separate, unbuffered pass. Used for long files.
+  void LoadSampleStreamed(
+    TAudioFile*   pAudioFile,
+    TSampleData&  Data) const;
   //! Analyze given file and put low level descriptor results into mpResults
   //! @throw TReadableException on Errors
   void AnalyzeLowLevelDescriptors(
-    const TSampleData&   RawSampleData, 
-    TSilenceStatus&      SilenceStatus,
-    TSampleDescriptors&  Results)  const;
+    const TSampleData&        RawSampleData, 
+    const TLowLevelFeatures&  Features,
+    TSilenceStatus&           SilenceStatus,
+    TSampleDescriptors&       Results)  const;
   //! Analyze high level descriptors from low level descriptor results
   void AnalyzeHighLevelDescriptors(
     const TSampleData&   RawSampleData,
     TSilenceStatus&      SilenceStatus,
     TSampleDescriptors&  Results) const;
 
+  //! Normalize and evaluate the \param FeatureRows of the given \param Rows with 
+  //! \param pModel. When evaluating the whole batch fails, rows are evaluated one by
+  //! one: rows which then still fail get an error in \param Errors and no weights.
+  TList< TList<float> > EvaluateFeatureRows(
+    const TClassificationModel*  pModel,
+    const std::vector<double>&   FeatureRows,
+    const TList<int>&            Rows,
+    TList<TString>&              Errors) const;
+
+  //! Write class descriptors from the given classification model weights
+  void ApplyClassificationWeights(
+    TSampleDescriptors& Results,
+    const TList<float>& ClassificationWeights) const;
+  //! Write category descriptors from the given categorization model weights.
+  //! Class descriptors must have been applied before.
+  void ApplyCategorizationWeights(
+    TSampleDescriptors& Results,
+    const TList<float>& CategoryWeights) const;
+
   void CalcEffectiveLength(
     TSampleDescriptors& Results, 
     const double*       pSampleData, 
@@ -149,30 +291,19 @@ private:
     const double*       pSampleData, 
     int                 NumberOfSamples) const;
 
-  void CalcSpectralRms(
-    TSampleDescriptors&   Results, 
-    const TArray<double>& MagnitudeSpectrum) const;
-  void CalcSpectralCentroidAndSpread(
-    TSampleDescriptors&   Results, 
-    const TArray<double>& MagnitudeSpectrum) const;
-  void CalcSpectralSkewnessAndKurtosis(
-    TSampleDescriptors&   Results, 
-    const TArray<double>& MagnitudeSpectrum) const;
-  void CalcSpectralRolloff(
-    TSampleDescriptors&   Results, 
-    const TArray<double>& MagnitudeSpectrum) const;
-  void CalcSpectralFlatness(
-    TSampleDescriptors&   Results,
-    const TArray<double>& MagnitudeSpectrum) const;
-  void CalcSpectralFlux(
-    TSampleDescriptors&   Results, 
-    const TArray<double>& MagnitudeSpectrum,
-    const TArray<double>& LastMagnitudeSpectrum) const;
+  //! Calculate spectral RMS, centroid, spread, skewness, kurtosis, rolloff, flatness 
+  //! and flux with a single fused kernel, appending the enabled \param Features only.
+  void CalcSpectralFeatures(
+    const TLowLevelFeatures&  Features,
+    TSampleDescriptors&       Results, 
+    const TArray<double>&     MagnitudeSpectrum,
+    const TArray<double>&     LastMagnitudeSpectrum) const;
 
   void CalcAutoCorrelation(
-    TSampleDescriptors& Results, 
-    const double*       pSampleData, 
-    int                 RemainingSamples) const;
+    TSampleAnalysisWorkspace& Workspace,
+    TSampleDescriptors&       Results, 
+    const double*             pSampleData, 
+    int                       RemainingSamples) const;
 
   void CalcSpectralComplexity(
     TSampleDescriptors&   Results, 
@@ -189,9 +320,10 @@ private:
     double                F0Confidence) const;
 
   void CalcSpectralBandFeatures(
-    TSampleDescriptors&   Results, 
-    const TArray<double>& MagnitudeSpectrum,
-    const TArray<double>& LastMagnitudeSpectrum) const;
+    TSampleAnalysisWorkspace& Workspace,
+    TSampleDescriptors&       Results, 
+    const TArray<double>&     MagnitudeSpectrum,
+    const TArray<double>&     LastMagnitudeSpectrum) const;
 
   void CalcSpectrumBands(
     TSampleDescriptors&   Results, 
@@ -200,6 +332,32 @@ private:
     TSampleDescriptors&   Results, 
     const TArray<double>& MagnitudeSpectrum) const;
 
+  //! Calculate windowed magnitude spectrum of the frame at \param pSampleData
+  void CalcMagnitudeSpectrum(
+    TSampleAnalysisWorkspace& Workspace,
+    const double*             pSampleData,
+    TArray<double>&           MagnitudeSpectrum) const;
+
+  //! Calculate all features which only depend on the current frame's sample 
+  //! data, its magnitude spectrum, and the previous frame's magnitude spectrum.
+  void CalcIndependentFrameFeatures(
+    TSampleAnalysisWorkspace& Workspace,
+    const TLowLevelFeatures&  Features,
+    TSampleDescriptors&       Results,
+    int                       FrameIndex,
+    const double*             pSampleData,
+    int                       RemainingSamples,
+    const TArray<double>&     MagnitudeSpectrum,
+    const TArray<double>&     LastMagnitudeSpectrum) const;
+  //! Calculate CalcIndependentFrameFeatures for the given number of spectrum 
+  //! frames in chunks, using \param NumberOfThreads threads.
+  void CalcIndependentFrameFeaturesInParallel(
+    const TLowLevelFeatures&  Features,
+    TSampleDescriptors&       Results,
+    const TSampleData&        SampleData,
+    int                       NumberOfFrames,
+    int                       NumberOfThreads) const;
+
   void CalcStatistics(TSampleDescriptors& Results) const;
 
   const int mSampleRate;
@@ -212,10 +370,24 @@ private:
 
   double* mpWindow;
 
-  TOwnerPtr<xtract_mel_filter_> mpXtractMelFilters;
+  bool mParallelFrameAnalysis;
+  TResampler::TQuality mResamplerQuality;
+
+  TOwnerPtr<TMelCepstrum> mpMelCepstrum;
 
   TOwnerPtr<TClassificationModel> mpClassificationModel;
   TOwnerPtr<TClassificationModel> mpOneShotCategorizationModel;
+  // content hashes of the loaded model files, for ConfigFingerprint
+  long long mClassificationModelHash;
+  long long mOneShotCategorizationModelHash;
+
+  TSampleAnalysisCache* mpAnalysisCache;
+  TSampleClassificationStage* mpClassificationStage;
+
+  // FFTs, trackers and buffers for AnalyzeLowLevelDescriptors, one per analysing 
+  // thread. Workspaces are released along with the analyser only, so analysers
+  // should be used from a fixed set of (worker) threads.
+  TThreadLocalValue<TSampleAnalysisWorkspace> mWorkspaces;
 };
 
 #endif //_SampleAnalyser_h_
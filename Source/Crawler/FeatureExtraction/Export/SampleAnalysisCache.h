@@ -0,0 +1,103 @@
+#pragma once
+
+#ifndef _SampleAnalysisCache_h_
+#define _SampleAnalysisCache_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/Str.h"
+
+#include "CoreFileFormats/Export/Database.h"
+
+#include "FeatureExtraction/Export/SampleDescriptors.h"
+
+#include <mutex>
+
+// =================================================================================================
+
+/*!
+ * Persistent, content addressed cache of analysis results: results are keyed by
+ * the content of the analyzed file and the analyser's configuration, so moved,
+ * renamed or duplicated files don't need to be decoded and analyzed again.
+ *
+ * Content keys are built from the file size and a hash of the first and last
+ * \enum kContentKeyBlockSize bytes of the file. Larger files are not fully covered
+ * by the key, so the file's modification time gets stored along with the results
+ * too. When the modification time of a hit differs, e.g. for copied files, the
+ * whole file content gets hashed to rule out collisions: the full content hash
+ * only is stored for entries which got such a key collision.
+ *
+ * Descriptors are stored losslessly in the machine's native byte order, so cached
+ * results are exactly the same as freshly analyzed ones.
+ *
+ * All functions are thread-safe.
+!*/
+
+class TSampleAnalysisCache
+{
+public:
+  enum {
+    // increase when analysis algorithms change, to invalidate all cached results
+    kVersion = 5,
+
+    kContentKeyBlockSize = 64 * 1024
+  };
+
+  //! 64 bit hash of the full content of the given file, e.g. to fingerprint model
+  //! files. @throws TReadableException when the file can't be read.
+  static long long SFileHash(const TString& FileName);
+
+  //! Cheap key of a file's content, as used to look up results.
+  struct TContentKey
+  {
+    TContentKey();
+
+    bool IsEmpty() const { return mKey.IsEmpty(); }
+    void Empty();
+
+    //! file size and hash of the first and last block of the file
+    TString mKey;
+    long long mFileSize;
+    int mModificationTime;
+  };
+
+  //! Create a content key for the given file, without reading all of its
+  //! content. @throws TReadableException when the file can't be read.
+  static TContentKey SContentKey(const TString& FileName);
+
+  TSampleAnalysisCache(TSampleDescriptors::TDescriptorSet DescriptorSet);
+  ~TSampleAnalysisCache();
+
+  //! Open or create the cache db. \param ConfigFingerprint identifies the
+  //! analyser settings (see \function TSampleAnalyser::ConfigFingerprint):
+  //! results of other configurations are ignored, but not removed.
+  bool Open(const TString& CacheFileName, const TString& ConfigFingerprint);
+
+  //! Look up results for the given file and its \param ContentKey.
+  //! @return false, when no results for the file's content are cached.
+  bool Lookup(
+    const TString&      FileName,
+    const TContentKey&  ContentKey,
+    TSampleDescriptors& Results) const;
+
+  //! Add or replace results for the given file and its \param ContentKey.
+  //! @throws TReadableException when the file can't be read or writing failed.
+  void Store(
+    const TString&            FileName,
+    const TContentKey&        ContentKey,
+    const TSampleDescriptors& Results);
+
+private:
+  //! true when the given key does not cover the whole file content
+  static bool SIsPartialContentKey(const TContentKey& ContentKey);
+
+  const TSampleDescriptors::TDescriptorSet mDescriptorSet;
+  TString mConfigFingerprint;
+
+  mutable std::mutex mLock;
+  mutable TDatabase mDatabase;
+};
+
+
+#endif // _SampleAnalysisCache_h_
+
@@ -0,0 +1,116 @@
+#pragma once
+
+#ifndef _SampleAnalysisScheduler_h_
+#define _SampleAnalysisScheduler_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/Str.h"
+#include "CoreTypes/Export/List.h"
+
+#include <functional>
+#include <mutex>
+
+class TSampleFileQueue;
+class TStamp;
+
+// =================================================================================================
+
+/*!
+ * Runs sample analysis tasks on a set of worker threads, ordered by their estimated
+ * costs: the most expensive files are analyzed first, so a few huge files at the end
+ * of a crawl don't leave all other workers idle.
+ *
+ * Tasks are distributed to per worker queues. Workers process their own queue first
+ * and steal the most expensive pending task from other workers when running idle.
+ *
+ * Files can also be analyzed while they still get discovered, by streaming them
+ * through a TSampleFileQueue. Costs then can't be sorted, so files are analyzed
+ * in the order they arrive, and audio durations in the statistics are estimated
+ * from the file sizes.
+ *
+ * While running, throughput statistics (files/s, audio seconds/s) are logged every
+ * \param ReportIntervalInMs.
+!*/
+
+class TSampleAnalysisScheduler
+{
+public:
+  //! function which analyzes a single file. \param FileIndex is the index of
+  //! the task in the scheduled order: 0 is the first started task.
+  typedef std::function<void(const TString& FileName, int FileIndex)> TAnalyzeFunction;
+
+  //! throughput statistics of a (running) Run call
+  struct TStatistics
+  {
+    TStatistics();
+
+    int mNumberOfFiles;
+    int mNumberOfProcessedFiles;
+    double mProcessedAudioSeconds;
+    double mElapsedSeconds;
+  };
+
+  enum { kDefaultReportIntervalInMs = 5000 };
+
+  TSampleAnalysisScheduler(
+    int NumberOfThreads,
+    int ReportIntervalInMs = kDefaultReportIntervalInMs);
+
+
+  //! Estimate costs of all files, then invoke \param Function for all files in
+  //! the worker threads, largest files first. Blocks until all tasks completed.
+  //! When a task throws, all pending tasks are skipped and the first exception
+  //! is rethrown here.
+  void Run(
+    const TList<TString>&   FileNames,
+    const TAnalyzeFunction& Function);
+
+  //! Invoke \param Function for all files which get pushed into \param Queue in
+  //! the worker threads, in the order they arrive. Blocks until the queue got
+  //! closed and all of its files got analyzed. When a task throws, the queue gets
+  //! aborted and the first exception is rethrown here.
+  void Run(
+    TSampleFileQueue&       Queue,
+    const TAnalyzeFunction& Function);
+
+  //! statistics of the last Run call
+  TStatistics Statistics()const;
+
+
+  //! estimate the analysis costs of the given file: uses the audio file's header
+  //! to get the audio duration (in seconds), or the file size as fallback when
+  //! the header can not be read.
+  static double SEstimatedCost(
+    const TString&  FileName,
+    double&         AudioSeconds);
+
+private:
+  struct TTask
+  {
+    TString mFileName;
+    double mCost;
+    double mAudioSeconds;
+  };
+
+  void EstimateCosts(TList<TTask>& Tasks);
+  void RunTasks(const TList<TTask>& Tasks, const TAnalyzeFunction& Function);
+
+  void TaskCompleted(
+    double        AudioSeconds,
+    int           NumberOfFiles,
+    const TStamp& RunTime,
+    TStamp&       ReportTime);
+
+  void LogStatistics(const TStatistics& Statistics);
+
+  const int mNumberOfThreads;
+  const int mReportIntervalInMs;
+
+  // guards mStatistics
+  mutable std::mutex mStatisticsLock;
+  TStatistics mStatistics;
+};
+
+
+#endif // _SampleAnalysisScheduler_h_
@@ -8,11 +8,11 @@
 #include "CoreTypes/Export/List.h"
 #include "CoreTypes/Export/Str.h"
 
+#include "FeatureExtraction/Export/SampleDescriptors.h"
+
 #include <vector>
 #include <string>
 
-class TSampleDescriptors;
-
 // =================================================================================================
 
 /*!
@@ -32,6 +32,13 @@ public:
   static void SInit();
   static void SExit();
 
+  //! Low level descriptors of \param Descriptors, which are read when creating 
+  //! the classification model features.
+  static TList<const TSampleDescriptors::TDescriptor*> SUsedDescriptors(
+    const TSampleDescriptors& Descriptors);
+  //! Index of the last time frame, which is read from framed descriptors.
+  static int SLastUsedTimeFrame();
+
   enum {
     // extract feature values 
     kExtractFeatureValues  = (1 << 0),
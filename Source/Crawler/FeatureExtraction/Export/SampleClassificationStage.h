@@ -0,0 +1,116 @@
+#pragma once
+
+#ifndef _SampleClassificationStage_h_
+#define _SampleClassificationStage_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/Str.h"
+#include "CoreTypes/Export/Pointer.h"
+
+#include "FeatureExtraction/Export/SampleAnalysisCache.h"
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+class TSampleAnalyser;
+class TSampleDescriptors;
+class TSampleDescriptorPool;
+
+// =================================================================================================
+
+/*!
+ * Evaluates the classification models of a TSampleAnalyser for many files at once:
+ * high level results of analyzed files are queued, and a single classifier thread
+ * evaluates the models for a whole batch of files with one call per model. Then
+ * the classified results get stored in the analyser's analysis cache and are
+ * written into the given pool.
+ *
+ * Batches are evaluated as soon as \param BatchSize files are pending or when
+ * \param BatchTimeInMs elapsed. When the queue holds more than \param MaxQueueSize
+ * files, callers will block until the classifier catched up.
+ *
+ * Files which fail to classify, e.g. because their features contain NAN or INF
+ * values, are written as failed samples without affecting the rest of the batch.
+ * Pool write errors are rethrown as TReadableException in the next push or flush.
+!*/
+
+class TSampleClassificationStage
+{
+public:
+  enum {
+    kDefaultBatchSize = 64,
+    kDefaultBatchTimeInMs = 2000,
+    kDefaultMaxQueueSize = 256
+  };
+
+  //! \param PoolLock serializes all writes into \param pPool, just like the
+  //! lock which is passed to TSampleAnalyser::Extract.
+  TSampleClassificationStage(
+    const TSampleAnalyser*  pAnalyser,
+    TSampleDescriptorPool*  pPool,
+    std::mutex&             PoolLock,
+    int                     BatchSize = kDefaultBatchSize,
+    int                     BatchTimeInMs = kDefaultBatchTimeInMs,
+    int                     MaxQueueSize = kDefaultMaxQueueSize);
+
+  //! classifies and writes all pending files and stops the classifier thread
+  ~TSampleClassificationStage();
+
+  //! Queue high level results of the given file, which still need to be classified.
+  //! \param ContentKey is the file's analysis cache key: empty when the results
+  //! should not be cached.
+  //! @throws TReadableException when writing previous results failed
+  void Push(
+    const TString&                            FileName,
+    const TSampleAnalysisCache::TContentKey&  ContentKey,
+    const TSampleDescriptors&                 Results);
+
+  //! Block until all pending files got classified and written into the pool.
+  //! @throws TReadableException when writing failed
+  void Flush() const;
+
+private:
+  struct TPendingSample
+  {
+    TString mFileName;
+    TSampleAnalysisCache::TContentKey mContentKey;
+    TOwnerPtr<TSampleDescriptors> mpResults;
+    // set by ClassifySamples when the sample failed to classify
+    TString mClassifyError;
+  };
+
+  void ClassifySamples(std::deque<TPendingSample>& Samples);
+  void WriteSamples(std::deque<TPendingSample>& Samples);
+
+  void ClassifierThread();
+
+  const TSampleAnalyser* mpAnalyser;
+
+  TSampleDescriptorPool* mpPool;
+  std::mutex& mPoolLock;
+
+  const int mBatchSize;
+  const int mBatchTimeInMs;
+  const int mMaxQueueSize;
+
+  // guards all members below
+  mutable std::mutex mQueueLock;
+  // signals the classifier thread that there's something to do
+  mutable std::condition_variable mClassifierCondition;
+  // signals that the queue got drained by the classifier thread
+  mutable std::condition_variable mQueueDrainedCondition;
+
+  std::deque<TPendingSample> mQueue;
+  bool mClassifying;
+  mutable int mPendingFlushes;
+  bool mStopClassifier;
+  TString mWriteError;
+
+  std::thread mClassifierThread;
+};
+
+
+#endif // _SampleClassificationStage_h_
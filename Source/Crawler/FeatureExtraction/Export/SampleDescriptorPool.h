@@ -7,9 +7,12 @@
 
 #include "CoreTypes/Export/Str.h"
 #include "CoreTypes/Export/Pointer.h"
+#include "CoreTypes/Export/File.h"
 
 #include "FeatureExtraction/Export/SampleDescriptors.h"
 
+#include <functional>
+
 // =================================================================================================
 
 /*!
@@ -33,6 +36,8 @@ public:
 
   //@{ ... Access existing sample descriptors
 
+  typedef std::function<void(const TSampleDescriptors&)> TForEachSampleFunc;
+
   // check if there is any asset present (failed or succeeded)
   virtual bool IsEmpty() const = 0;
 
@@ -40,8 +45,20 @@ public:
   virtual int NumberOfSamples() const = 0;
   virtual TOwnerPtr<TSampleDescriptors> Sample(int Index) const = 0;
 
-  // fetch abs path and modification stat time of all stored samples
-  virtual TList< TPair<TString, int> > SampleModificationDates() const = 0;
+  // fetch all samples (suceeded ones only) in one go. Way faster than 
+  // fetching samples by index, when iterating over all samples.
+  virtual void ForEachSample(const TForEachSampleFunc& Function) const = 0;
+
+  // abs path and file stats of a stored sample, as they were when the sample got 
+  // inserted. Size and file id are 0 for samples, which were stored without them.
+  struct TSampleFileStat
+  {
+    TString mFileName;
+    TFile::TStat mStat;
+  };
+
+  // fetch abs path and file stats of all stored samples
+  virtual TList<TSampleFileStat> SampleFileStats() const = 0;
   //@}
 
 
@@ -57,13 +74,29 @@ public:
 
   virtual void RemoveSample(const TString& FileName) = 0;
   virtual void RemoveSamples(const TList<TString>& FileNames) = 0;
+
+  // move stored samples to new file names (e.g. after the files got moved or 
+  // renamed), keeping their descriptors. Existing samples at the new names 
+  // get replaced.
+  virtual void RenameSamples(
+    const TList< TPair<TString, TString> >& OldAndNewFileNames) = 0;
+  //@}
+
+
+  //@{ ... Batched modifications
+
+  //! Group all following insert and remove calls, until \function CommitBatch 
+  //! gets called, so they can be written in one go. Not all pools may support 
+  //! this, so by default this does nothing.
+  virtual void BeginBatch() { }
+  virtual void CommitBatch() { }
   //@}
 
 
   //@{ ... Insert/replace class descriptors
 
   //! Set list classifier names (e.g. 'OneShot-Categories')
-  //! Available in high level high level descriptor dbs only.
+  //! Available in high level and classification descriptor dbs only.
   virtual void InsertClassifier(
     const TString&        ClassifierName,
     const TList<TString>& Classes) = 0;
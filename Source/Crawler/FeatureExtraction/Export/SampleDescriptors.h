@@ -60,6 +60,15 @@ public:
       return OnValues(); 
     };
 
+    // append all available descriptor values (as variant type) to the given list,
+    // in the same order as \function Values, but without creating their names
+    void AppendValues(TList<TValue>& Values) const { 
+      const_cast<TDescriptor*>(this)->OnAppendValues(Values); 
+    };
+    void AppendValues(TList<TValue>& Values) { 
+      OnAppendValues(Values); 
+    };
+
     // Calc initial set of statistics from the "main" vector value, if present
     // Only implemented for VR and VVR data.
     void CalcStatistics()
@@ -72,7 +81,10 @@ public:
       // allow binary instead of text storage, if suitable, for example for vector data 
       kAllowBinaryStorage                 = (1 << 0),
       // allow storing numbers in floating point precision instead of double precision 
-      kAllowFloatingPointPrecisionStorage = (1 << 1)
+      kAllowFloatingPointPrecisionStorage = (1 << 1),
+      // allow storing binary vector data as raw number arrays instead of msgpack 
+      // data, which is a lot faster to write and read. Needs kAllowBinaryStorage.
+      kAllowRawArrayStorage               = (1 << 2)
     }; 
     typedef int TExportFlags;
     const TExportFlags mExportFlags;
@@ -82,6 +94,7 @@ public:
 
   protected:
     virtual TList< TPair<TString, TValue> > OnValues() = 0;
+    virtual void OnAppendValues(TList<TValue>& Values) = 0;
     virtual void OnCalcStatistics() = 0;
 
     TDescriptor(const char* pName, TExportFlags ExportFlags)
@@ -112,6 +125,11 @@ public:
       );
     }
 
+    virtual void OnAppendValues(TList<TDescriptor::TValue>& Values)
+    {
+      Values.Append(TDescriptor::TValue(&mValue));
+    }
+
     virtual void OnCalcStatistics()
     {
       // nothing to do
@@ -139,6 +157,11 @@ public:
       );
     }
 
+    virtual void OnAppendValues(TList<TDescriptor::TValue>& Values)
+    {
+      Values.Append(TDescriptor::TValue(&mValues));
+    }
+
     virtual void OnCalcStatistics()
     {
       // nothing to do
@@ -209,6 +232,24 @@ public:
       );
     }
 
+    virtual void OnAppendValues(TList<TDescriptor::TValue>& Values)
+    {
+      Values.Append(TDescriptor::TValue(&mValues));
+      Values.Append(TDescriptor::TValue(&mMin));
+      Values.Append(TDescriptor::TValue(&mMax));
+      Values.Append(TDescriptor::TValue(&mMedian));
+      Values.Append(TDescriptor::TValue(&mMean));
+      Values.Append(TDescriptor::TValue(&mGeometricMean));
+      Values.Append(TDescriptor::TValue(&mVariance));
+      Values.Append(TDescriptor::TValue(&mCentroid));
+      Values.Append(TDescriptor::TValue(&mSpread));
+      Values.Append(TDescriptor::TValue(&mSkewness));
+      Values.Append(TDescriptor::TValue(&mKurtosis));
+      Values.Append(TDescriptor::TValue(&mFlatness));
+      Values.Append(TDescriptor::TValue(&mDMean));
+      Values.Append(TDescriptor::TValue(&mDVariance));
+    }
+
     virtual void OnCalcStatistics()
     {
       TStatistics::Calc(
@@ -251,6 +292,11 @@ public:
       );
     }
 
+    virtual void OnAppendValues(TList<TDescriptor::TValue>& Values)
+    {
+      Values.Append(TDescriptor::TValue(&mValues));
+    }
+
     virtual void OnCalcStatistics()
     {
       // nothing to do
@@ -324,6 +370,24 @@ public:
       );
     }
 
+    virtual void OnAppendValues(TList<TDescriptor::TValue>& Values)
+    {
+      Values.Append(TDescriptor::TValue(&mValues));
+      Values.Append(TDescriptor::TValue(&mMin));
+      Values.Append(TDescriptor::TValue(&mMax));
+      Values.Append(TDescriptor::TValue(&mMedian));
+      Values.Append(TDescriptor::TValue(&mMean));
+      Values.Append(TDescriptor::TValue(&mGeometricMean));
+      Values.Append(TDescriptor::TValue(&mVariance));
+      Values.Append(TDescriptor::TValue(&mCentroid));
+      Values.Append(TDescriptor::TValue(&mSpread));
+      Values.Append(TDescriptor::TValue(&mSkewness));
+      Values.Append(TDescriptor::TValue(&mKurtosis));
+      Values.Append(TDescriptor::TValue(&mFlatness));
+      Values.Append(TDescriptor::TValue(&mDMean));
+      Values.Append(TDescriptor::TValue(&mDVariance));
+    }
+
     virtual void OnCalcStatistics()
     {
       for (int BandIndex = 0; BandIndex < (int)sSize; ++BandIndex)
@@ -369,6 +433,11 @@ public:
     //! this is the descriptor set which is most useful for humans.
     kHighLevelDescriptors,
 
+    //! class and category descriptors only: a subset of the high level descriptors,
+    //! which can be analyzed a lot faster, as only the low level descriptors which are
+    //! used by the classification models get calculated.
+    kClassificationDescriptors,
+
     kNumberOfDescriptorSet
   };
 
@@ -0,0 +1,68 @@
+#pragma once
+
+#ifndef _SampleFileQueue_h_
+#define _SampleFileQueue_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/Str.h"
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+// =================================================================================================
+
+/*!
+ * Bounded, thread-safe FIFO queue of sample file names, which connects the
+ * stages of a pipelined crawl: directory walking, change detection and analysis.
+ *
+ * Producers block in \function Push when the queue holds \param MaxSize files, so
+ * a fast producer can't run away from slow consumers (backpressure). Consumers
+ * block in \function Pop until a file is available or the queue got closed.
+!*/
+
+class TSampleFileQueue
+{
+public:
+  enum { kDefaultMaxSize = 1024 };
+
+  TSampleFileQueue(int MaxSize = kDefaultMaxSize);
+
+  //! Append a file. Blocks while the queue is full. Returns false when the
+  //! queue got aborted: the file then is dropped.
+  bool Push(const TString& FileName);
+
+  //! Fetch the next file. Blocks while the queue is empty and not closed.
+  //! Returns false when the queue got closed and is drained, or got aborted.
+  bool Pop(TString& FileName);
+
+  //! Signal that no more files will be pushed: pending files still can be
+  //! popped, then \function Pop returns false.
+  void Close();
+  //! Drop all pending files and wake up all blocked producers and consumers.
+  void Abort();
+
+  //! true when \function Abort got called
+  bool IsAborted() const;
+
+  //! total number of files that got pushed so far
+  int NumberOfPushedFiles() const;
+
+private:
+  const int mMaxSize;
+
+  // guards all members below
+  mutable std::mutex mLock;
+  std::condition_variable mNotEmptyCondition;
+  std::condition_variable mNotFullCondition;
+
+  std::deque<TString> mFileNames;
+  int mNumberOfPushedFiles;
+  bool mClosed;
+  bool mAborted;
+};
+
+
+#endif // _SampleFileQueue_h_
+
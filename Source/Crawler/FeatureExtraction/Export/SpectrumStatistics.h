@@ -0,0 +1,65 @@
+#pragma once
+
+#ifndef _SpectrumStatistics_h_
+#define _SpectrumStatistics_h_
+
+// =================================================================================================
+
+/*!
+ * Fused statistics of magnitude spectrum frames, as used by TSampleAnalyser.
+ *
+ * Calculates the frame's moments, rolloff, flatness and flux in two passes over
+ * the magnitudes, and band features in a single pass over each band, instead of
+ * walking the spectrum once per feature. Loops accumulate into independent lanes,
+ * so compilers can vectorize them. Results match the per-feature TStatistics and
+ * libXtract functions up to rounding errors.
+!*/
+
+namespace TSpectrumStatistics
+{
+  // Features of a whole spectrum frame
+  struct TFrameFeatures
+  {
+    double mRms;      // root mean square of the magnitudes
+    double mCentroid; // centroid, in bins relative to the first bin
+    double mSpread;   // spread around the centroid, in squared bins
+    double mSkewness; // as TStatistics::Skewness
+    double mKurtosis; // as TStatistics::Kurtosis
+    double mRolloff;  // as xtract_rolloff: rolloff bin count * RolloffBinFrequency
+    double mFlatness; // geometric mean / arithmetic mean, not in dB
+    double mFlux;     // correlation with the last magnitudes, as TStatistics::Flux
+  };
+
+  // Features of a single spectrum band
+  struct TBandFeatures
+  {
+    double mMean;     // arithmetic mean of the magnitudes
+    double mMax;      // max magnitude
+    double mRms;      // root mean square of the magnitudes
+    double mFlatness; // geometric mean / arithmetic mean, not in dB
+    double mFlux;     // correlation with the last magnitudes, as TStatistics::Flux
+  };
+
+  // calculate all frame features of the given non empty magnitude spectrum
+  // and the previous frame's magnitude spectrum. \param RolloffPercentile is
+  // the rolloff's energy threshold in percent, e.g. 85.0.
+  void CalcFrameFeatures(
+    TFrameFeatures& Features,
+    const double*   pMagnitudes,
+    const double*   pLastMagnitudes,
+    int             Length,
+    double          RolloffPercentile,
+    double          RolloffBinFrequency);
+
+  // calculate all band features of the given non empty magnitude spectrum band
+  void CalcBandFeatures(
+    TBandFeatures&  Features,
+    const double*   pMagnitudes,
+    const double*   pLastMagnitudes,
+    int             Length);
+
+  // calculate the sum of all squared magnitudes of a spectrum band
+  double Power(const double* pMagnitudes, int Length);
+}
+
+#endif // _SpectrumStatistics_h_
@@ -31,8 +31,9 @@ public:
 
   virtual int NumberOfSamples() const override;
   virtual TOwnerPtr<TSampleDescriptors> Sample(int Index) const override;
+  virtual void ForEachSample(const TForEachSampleFunc& Function) const override;
 
-  virtual TList< TPair<TString, int> > SampleModificationDates() const override;
+  virtual TList<TSampleFileStat> SampleFileStats() const override;
 
   virtual void InsertSample(
     const TString&             FileName,
@@ -45,6 +46,12 @@ public:
   virtual void RemoveSample(const TString& FileNames) override;
   virtual void RemoveSamples(const TList<TString>& FileNames) override;
 
+  virtual void RenameSamples(
+    const TList< TPair<TString, TString> >& OldAndNewFileNames) override;
+
+  virtual void BeginBatch() override;
+  virtual void CommitBatch() override;
+
   virtual void InsertClassifier(
     const TString&        ClassifierName,
     const TList<TString>& Classes) override;
@@ -53,6 +60,17 @@ public:
 
   //@{ ... New interface
 
+  // check if the given VR or VVR BLOB column content is a raw number array, or
+  // old msgpack data (see TSampleDescriptor::kAllowRawArrayStorage).
+  static bool SIsRawArrayBlob(const void* pData, int DataSize);
+  // decode a raw number array BLOB into a list of rows: a single row for VR, 
+  // multiple rows for VVR values. Throws TReadableException on invalid data,
+  // mentioning the given \param ColumnName.
+  static TList< TList<double> > SDecodeRawArrayBlob(
+    const TString&  ColumnName, 
+    const void*     pData, 
+    int             DataSize);
+
   // db version: increase to force to recreate the database when running crawler on an 
   // existing db.
   enum { kCurrentVersion = 2 };
@@ -80,10 +98,40 @@ public:
 
 private:
   void InitializeDatabase();
+  // add file size and id columns to tables, which got created without them
+  void AddFileStatColumns();
   void ShutdownDatabase();
 
+  // column index and name of a descriptor value in a "SELECT * FROM assets" statement
+  struct TDescriptorColumn
+  {
+    int mIndex;
+    TString mName;
+  };
+
+  // validate layout and map all descriptor values to their columns
+  // in the given "SELECT * FROM assets" statement
+  TList<TDescriptorColumn> DescriptorColumns(TDatabase::TStatement& Statement) const;
+  // unserialize descriptors from the current row of the given statement
+  TOwnerPtr<TSampleDescriptors> SampleFromStatement(
+    TDatabase::TStatement&          Statement,
+    const TList<TDescriptorColumn>& DescriptorColumns) const;
+
+  // create the cached insert statement for \function InsertSample, if needed
+  void PrepareInsertStatement();
+
   mutable TDatabase mDatabase;
   TDirectory mBasePath;
+
+  // pending transaction, when running a batch
+  TOwnerPtr<TDatabase::TTransaction> mpBatchTransaction;
+
+  // assets column names, in the order of the descriptor values, and a precompiled
+  // statement which inserts all of them. Created once, then reused for all inserts.
+  TList<TString> mInsertKeys;
+  TOwnerPtr<TDatabase::TStatement> mpInsertStatement;
+  // reused temp buffer for the descriptor values in InsertSample
+  TList<TSampleDescriptors::TDescriptor::TValue> mInsertValues;
 };
 
 
@@ -43,6 +43,13 @@ namespace TStatistics
     const double* pArray,
     int           ArraySize,
     double        Threshold);
+  // same as above, but appends the peaks to the given, previously cleared list, 
+  // so the list's memory can be reused when finding peaks in a loop.
+  void Peaks(
+    TList< TPair<int, double> >&  Peaks,
+    const double*                 pArray,
+    int                           ArraySize,
+    double                        Threshold);
 
   // calculate sum of all elements in the given array
   double Sum(const double* pX, int Length);
@@ -0,0 +1,339 @@
+#include "CoreTypes/Export/Log.h"
+#include "CoreTypes/Export/Debug.h"
+#include "CoreTypes/Export/Exception.h"
+
+#include "FeatureExtraction/Export/AsyncSampleDescriptorPool.h"
+
+#include <chrono>
+
+// =================================================================================================
+
+// local log name prefix
+#define MLogPrefix "AsyncPool"
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+TAsyncSampleDescriptorPool::TAsyncSampleDescriptorPool(
+  TSampleDescriptorPool*  pPool,
+  int                     BatchSize,
+  int                     BatchTimeInMs,
+  int                     MaxQueueSize)
+  : TSampleDescriptorPool(pPool->DescriptorSet()),
+    mpPool(pPool),
+    mBatchSize(BatchSize),
+    mBatchTimeInMs(BatchTimeInMs),
+    mMaxQueueSize(MaxQueueSize),
+    mWriting(false),
+    mPendingFlushes(0),
+    mStopWriter(false)
+{
+  MAssert(mBatchSize > 0 && mBatchTimeInMs > 0, "Invalid batch settings");
+  MAssert(mMaxQueueSize >= mBatchSize, "Queue should be able to hold a batch");
+
+  mWriterThread = std::thread(&TAsyncSampleDescriptorPool::WriterThread, this);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TAsyncSampleDescriptorPool::~TAsyncSampleDescriptorPool()
+{
+  {
+    const std::lock_guard<std::mutex> Lock(mQueueLock);
+    mStopWriter = true;
+  }
+  mWriterCondition.notify_one();
+
+  // writer thread will drain the queue before it quits
+  mWriterThread.join();
+
+  if (!mWriteError.IsEmpty())
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Pending write errors: %s",
+      mWriteError.StdCString().c_str());
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TAsyncSampleDescriptorPool::IsEmpty() const
+{
+  Flush();
+
+  const std::lock_guard<std::mutex> Lock(mPoolLock);
+  return mpPool->IsEmpty();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TAsyncSampleDescriptorPool::NumberOfSamples() const
+{
+  Flush();
+
+  const std::lock_guard<std::mutex> Lock(mPoolLock);
+  return mpPool->NumberOfSamples();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TOwnerPtr<TSampleDescriptors> TAsyncSampleDescriptorPool::Sample(int Index) const
+{
+  Flush();
+
+  const std::lock_guard<std::mutex> Lock(mPoolLock);
+  return mpPool->Sample(Index);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::ForEachSample(const TForEachSampleFunc& Function) const
+{
+  Flush();
+
+  const std::lock_guard<std::mutex> Lock(mPoolLock);
+  mpPool->ForEachSample(Function);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TList<TSampleDescriptorPool::TSampleFileStat> TAsyncSampleDescriptorPool::SampleFileStats() const
+{
+  Flush();
+
+  const std::lock_guard<std::mutex> Lock(mPoolLock);
+  return mpPool->SampleFileStats();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::InsertSample(
+  const TString&             FileName,
+  const TSampleDescriptors&  Results)
+{
+  TWriteRequest Request;
+  Request.mType = TWriteRequest::kInsertSample;
+  Request.mName = FileName;
+  Request.mpResults = TOwnerPtr<TSampleDescriptors>(new TSampleDescriptors(Results));
+
+  QueueRequest(Request);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::InsertFailedSample(
+  const TString& FileName,
+  const TString& Reason)
+{
+  TWriteRequest Request;
+  Request.mType = TWriteRequest::kInsertFailedSample;
+  Request.mName = FileName;
+  Request.mReason = Reason;
+
+  QueueRequest(Request);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::RemoveSample(const TString& FileName)
+{
+  RemoveSamples(MakeList(FileName));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::RemoveSamples(const TList<TString>& FileNames)
+{
+  TWriteRequest Request;
+  Request.mType = TWriteRequest::kRemoveSamples;
+  Request.mNames = FileNames;
+
+  QueueRequest(Request);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::RenameSamples(
+  const TList< TPair<TString, TString> >& OldAndNewFileNames)
+{
+  TWriteRequest Request;
+  Request.mType = TWriteRequest::kRenameSamples;
+  Request.mNamePairs = OldAndNewFileNames;
+
+  QueueRequest(Request);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::InsertClassifier(
+  const TString&        ClassifierName,
+  const TList<TString>& Classes)
+{
+  TWriteRequest Request;
+  Request.mType = TWriteRequest::kInsertClassifier;
+  Request.mName = ClassifierName;
+  Request.mNames = Classes;
+
+  QueueRequest(Request);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::Flush() const
+{
+  std::unique_lock<std::mutex> Lock(mQueueLock);
+
+  ++mPendingFlushes;
+  mWriterCondition.notify_one();
+
+  mQueueDrainedCondition.wait(Lock, [this]() {
+    return mQueue.empty() && !mWriting;
+  });
+
+  --mPendingFlushes;
+
+  if (!mWriteError.IsEmpty())
+  {
+    throw TReadableException(mWriteError);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::QueueRequest(const TWriteRequest& Request)
+{
+  std::unique_lock<std::mutex> Lock(mQueueLock);
+
+  // block until the writer catched up
+  mQueueDrainedCondition.wait(Lock, [this]() {
+    return (int)mQueue.size() < mMaxQueueSize || !mWriteError.IsEmpty();
+  });
+
+  // don't queue more requests when the writer failed
+  if (!mWriteError.IsEmpty())
+  {
+    throw TReadableException(mWriteError);
+  }
+
+  mQueue.push_back(Request);
+
+  if ((int)mQueue.size() >= mBatchSize)
+  {
+    mWriterCondition.notify_one();
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::WriteRequests(std::deque<TWriteRequest>& Requests)
+{
+  const std::lock_guard<std::mutex> Lock(mPoolLock);
+
+  TString WriteError;
+
+  try
+  {
+    mpPool->BeginBatch();
+
+    for (auto& Request : Requests)
+    {
+      try
+      {
+        switch (Request.mType)
+        {
+        case TWriteRequest::kInsertSample:
+          mpPool->InsertSample(Request.mName, *Request.mpResults);
+          break;
+
+        case TWriteRequest::kInsertFailedSample:
+          mpPool->InsertFailedSample(Request.mName, Request.mReason);
+          break;
+
+        case TWriteRequest::kRemoveSamples:
+          mpPool->RemoveSamples(Request.mNames);
+          break;
+
+        case TWriteRequest::kRenameSamples:
+          mpPool->RenameSamples(Request.mNamePairs);
+          break;
+
+        case TWriteRequest::kInsertClassifier:
+          mpPool->InsertClassifier(Request.mName, Request.mNames);
+          break;
+
+        default:
+          MInvalid("Unknown request type");
+          break;
+        }
+      }
+      catch (const std::exception& Exception)
+      {
+        // memorize the first error, but try writing the remaining requests
+        if (WriteError.IsEmpty())
+        {
+          WriteError = Exception.what();
+        }
+      }
+    }
+
+    mpPool->CommitBatch();
+  }
+  catch (const std::exception& Exception)
+  {
+    if (WriteError.IsEmpty())
+    {
+      WriteError = Exception.what();
+    }
+  }
+
+  if (!WriteError.IsEmpty())
+  {
+    const std::lock_guard<std::mutex> QueueLock(mQueueLock);
+
+    if (mWriteError.IsEmpty())
+    {
+      mWriteError = WriteError;
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TAsyncSampleDescriptorPool::WriterThread()
+{
+  std::unique_lock<std::mutex> Lock(mQueueLock);
+
+  while (true)
+  {
+    // wait until a batch is complete, the batch time elapsed or we got stopped
+    mWriterCondition.wait_for(Lock, std::chrono::milliseconds(mBatchTimeInMs), [this]() {
+      return mStopWriter || ((int)mQueue.size() >= mBatchSize || 
+        (!mQueue.empty() && mPendingFlushes > 0));
+    });
+
+    if (mQueue.empty())
+    {
+      if (mStopWriter)
+      {
+        break;
+      }
+
+      continue;
+    }
+
+    // take over all pending requests and write them without holding the lock
+    std::deque<TWriteRequest> Requests;
+    Requests.swap(mQueue);
+    mWriting = true;
+
+    Lock.unlock();
+    mQueueDrainedCondition.notify_all();
+
+    WriteRequests(Requests);
+
+    Lock.lock();
+    mWriting = false;
+
+    mQueueDrainedCondition.notify_all();
+  }
+}
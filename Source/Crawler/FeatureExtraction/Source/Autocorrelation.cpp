@@ -1,11 +1,130 @@
 #include "FeatureExtraction/Source/Autocorrelation.h"
 
 #include "CoreTypes/Export/Array.h"
+#include "CoreTypes/Export/InlineMath.h"
+
+#include "AudioTypes/Export/AudioMath.h"
+#include "AudioTypes/Export/Fourier.h"
 
 #if defined(MHaveIntelIPP)
   #include "../../3rdParty/IPP/Export/IPPs.h"
 #endif
 
+#include <cmath>
+
+// =================================================================================================
+
+// relative costs of a real FFT per "N log2(N)" compared to a single multiply-add
+// in the direct autocorrelation loop. Used to choose between direct and FFT methods.
+static const double sFftCostFactor = 2.0;
+
+// below this order the direct method always wins
+static const int sMinFftOrder = 32;
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+//! padded FFT size for a linear (non circular) autocorrelation of the given size
+static int SFftSize(int NumSamples, int Order)
+{
+  return TMath::NextPow2(NumSamples + Order - 1);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! estimate if a FFT based autocorrelation is cheaper than the direct one
+static bool SUseFft(int NumSamples, int Order)
+{
+  if (Order < sMinFftOrder)
+  {
+    return false;
+  }
+
+  const double DirectCosts = (double)Order * NumSamples - 0.5 * (double)Order * Order;
+
+  // one forward and one inverse transform, plus the power spectrum
+  const int FftSize = SFftSize(NumSamples, Order);
+  const double FftCosts = 2.0 * sFftCostFactor * FftSize * TMath::Pow2Order(FftSize) + FftSize;
+
+  return FftCosts < DirectCosts;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Wiener-Khinchin: inverse transform of the input's power spectrum
+static void SCalcFftAutocorrelation(
+  TFftTransformReal&  FftTransform,
+  const double*       pSampleData,
+  int                 NumSamples,
+  double*             pCorrelationCoeffs,
+  int                 Order)
+{
+  const int FftSize = FftTransform.FftSize();
+  MAssert(FftSize >= NumSamples + Order - 1, "FFT is too small");
+
+  double* pData = FftTransform.Data();
+
+  // zero pad to avoid circular wrapping
+  TAudioMath::CopyBuffer(pSampleData, pData, NumSamples);
+  TAudioMath::ClearBuffer(pData + NumSamples, FftSize - NumSamples);
+
+  FftTransform.ForwardInplace();
+
+  // power spectrum of the packed half spectrum, in place
+  pData[0] = pData[0] * pData[0];
+  pData[1] = pData[1] * pData[1];
+
+  for (int i = 2; i < FftSize; i += 2)
+  {
+    pData[i] = pData[i] * pData[i] + pData[i + 1] * pData[i + 1];
+    pData[i + 1] = 0.0;
+  }
+
+  FftTransform.InverseInplace();
+
+  TAudioMath::CopyBuffer(pData, pCorrelationCoeffs, Order);
+}
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+TAutocorrelation::TWorkspace::TWorkspace()
+{
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TAutocorrelation::TWorkspace::~TWorkspace()
+{
+}
+
+// -------------------------------------------------------------------------------------------------
+
+double* TAutocorrelation::TWorkspace::CoeffsBuffer(int Order)
+{
+  if (mCoeffs.Size() < Order)
+  {
+    mCoeffs.SetSize(Order);
+  }
+
+  return mCoeffs.FirstWrite();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TFftTransformReal& TAutocorrelation::TWorkspace::FftTransform(int FftSize)
+{
+  if (!mpFftTransform || mpFftTransform->FftSize() != FftSize)
+  {
+    mpFftTransform = TOwnerPtr<TFftTransformReal>(new TFftTransformReal());
+    mpFftTransform->Initialize(FftSize, TFftTransformReal::kDivInvByN);
+  }
+
+  return *mpFftTransform;
+}
+
 // =================================================================================================
 
 // -------------------------------------------------------------------------------------------------
@@ -64,9 +183,22 @@ void TAutocorrelation::Calc(
   int           NumSamples,
   double*       pCorrelationCoeffs,
   int           Order)
+{
+  TWorkspace Workspace;
+  Calc(Workspace, pSampleData, NumSamples, pCorrelationCoeffs, Order);
+}
+
+void TAutocorrelation::Calc(
+  TWorkspace&   Workspace,
+  const double* pSampleData,
+  int           NumSamples,
+  double*       pCorrelationCoeffs,
+  int           Order)
 {
   // calc coeffs
 #if defined(MHaveIntelIPP)
+  MUnused(Workspace);
+
   IppEnum Algorithm = (IppEnum)(ippAlgAuto | ippsNormNone);
 
   int BufferSize = 0;
@@ -83,12 +215,29 @@ void TAutocorrelation::Calc(
   ::ippsFree(pTempBuffer);
 
 #else
-  for (int i = 0; i < Order; ++i)
+  // coefficients above NumSamples are always 0
+  const int CalcOrder = MMin(Order, NumSamples);
+
+  if (SUseFft(NumSamples, CalcOrder))
   {
-    pCorrelationCoeffs[i] = 0.0;
-    for (int j = 0, jEnd = (NumSamples - i); j < jEnd; ++j)
+    SCalcFftAutocorrelation(
+      Workspace.FftTransform(SFftSize(NumSamples, CalcOrder)),
+      pSampleData, NumSamples, pCorrelationCoeffs, CalcOrder);
+
+    for (int i = CalcOrder; i < Order; ++i)
+    {
+      pCorrelationCoeffs[i] = 0.0;
+    }
+  }
+  else
+  {
+    for (int i = 0; i < Order; ++i)
     {
-      pCorrelationCoeffs[i] += pSampleData[j] * pSampleData[j + i];
+      pCorrelationCoeffs[i] = 0.0;
+      for (int j = 0, jEnd = (NumSamples - i); j < jEnd; ++j)
+      {
+        pCorrelationCoeffs[i] += pSampleData[j] * pSampleData[j + i];
+      }
     }
   }
 #endif
@@ -5,9 +5,39 @@
 
 // =================================================================================================
 
-namespace TAutocorrelation 
+#include "CoreTypes/Export/Array.h"
+#include "CoreTypes/Export/Pointer.h"
+
+class TFftTransformReal;
+
+// =================================================================================================
+
+namespace TAutocorrelation
 {
-  // find the order-P autocorrelation array, R, for the sequence \param pSamples of 
+  /*!
+   * Reusable temporary buffers and FFT plan for \function Calc. Workspaces
+   * are not thread-safe: use one workspace per thread.
+  !*/
+
+  class TWorkspace
+  {
+  public:
+    TWorkspace();
+    ~TWorkspace();
+
+    //! temporary coefficient buffer with at least \param Order entries for callers.
+    //! Stays valid until the next call of this function.
+    double* CoeffsBuffer(int Order);
+
+    //! real FFT transform of the given size: reinitialized when the size changed
+    TFftTransformReal& FftTransform(int FftSize);
+
+  private:
+    TArray<double> mCoeffs;
+    TOwnerPtr<TFftTransformReal> mpFftTransform;
+  };
+
+  // find the order-P autocorrelation array, R, for the sequence \param pSamples of
   // length \param NumSamples and warping of lambda
   void CalcWarped(
     const double* pSampleData,
@@ -16,8 +46,18 @@ namespace TAutocorrelation
     int           Order,
     double        Lambda = 0.0);
 
-  //! Calculate Auto-Correlation coefficients - non warped
+  //! Calculate Auto-Correlation coefficients - non warped.
+  //! Picks the direct or FFT based (Wiener-Khinchin) method depending on the
+  //! input size and order.
+  void Calc(
+    const double* pSampleData,
+    int           NumSamples,
+    double*       pCorrelationCoeffs,
+    int           Order);
+  //! Calculate Auto-Correlation coefficients - non warped, using the given
+  //! workspace to avoid allocating and reinitializing FFTs on each call.
   void Calc(
+    TWorkspace&   Workspace,
     const double* pSampleData,
     int           NumSamples,
     double*       pCorrelationCoeffs,
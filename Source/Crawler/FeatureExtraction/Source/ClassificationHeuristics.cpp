@@ -148,3 +148,17 @@ bool TClassificationHeuristics::IsLoop(
   return (Confidence > 0.7);
 }
 
+// -------------------------------------------------------------------------------------------------
+
+TList<const TSampleDescriptors::TDescriptor*> TClassificationHeuristics::UsedDescriptors(
+  const TSampleDescriptors& LowLevelDescriptors)
+{
+  // NB: keep this in sync with the descriptors which are read in IsOneShot and IsLoop
+  return MakeList<const TSampleDescriptors::TDescriptor*>(
+    &LowLevelDescriptors.mEffectiveLength24dB,
+    &LowLevelDescriptors.mAmplitudePeak,
+    &LowLevelDescriptors.mSpectralFlux,
+    &LowLevelDescriptors.mRhythmComplexTempoConfidence,
+    &LowLevelDescriptors.mRhythmPercussiveTempoConfidence,
+    &LowLevelDescriptors.mRhythmPercussiveOnsetCount);
+}
@@ -3,7 +3,7 @@
 #ifndef _ClassificationHeuristics_h_
 #define _ClassificationHeuristics_h_
 
-class TSampleDescriptors;
+#include "FeatureExtraction/Export/SampleDescriptors.h"
 
 // =================================================================================================
 
@@ -32,6 +32,10 @@ namespace TClassificationHeuristics
   bool IsLoop(
     const TSampleDescriptors& LowLevelDescriptors,
     double&                   Confidence);
+
+  // Low level descriptors of the given sample, which are read by the heuristics
+  TList<const TSampleDescriptors::TDescriptor*> UsedDescriptors(
+    const TSampleDescriptors& LowLevelDescriptors);
 };
 
 
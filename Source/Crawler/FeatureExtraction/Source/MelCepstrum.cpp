@@ -0,0 +1,156 @@
+#include "CoreTypes/Export/InlineMath.h"
+#include "CoreTypes/Export/Debug.h"
+
+#include "FeatureExtraction/Export/MelCepstrum.h"
+
+#include "../../3rdParty/LibXtract/Export/LibXtract.h"
+
+#include <cmath>
+
+// =================================================================================================
+
+// number of independent accumulators in the filter loops
+#define MNumberOfLanes 4
+
+// lower limit for the band energies before taking the log, as in libXtract
+#define MLogLimit 2e-42
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+TMelCepstrum::TMelCepstrum(
+  int     SpectrumSize,
+  double  Nyquist,
+  double  MinFrequency,
+  double  MaxFrequency,
+  int     NumberOfCoefficients)
+  : mSpectrumSize(SpectrumSize),
+    mNumberOfCoefficients(NumberOfCoefficients)
+{
+  MAssert(NumberOfCoefficients > 1 &&
+    NumberOfCoefficients <= kMaxNumberOfCoefficients, "Invalid coefficient count");
+
+  // ... create dense filters with libXtract
+
+  TArray<double> DenseFilters(NumberOfCoefficients * SpectrumSize);
+  DenseFilters.Init(0.0);
+
+  TArray<double*> DenseFilterPointers(NumberOfCoefficients);
+  for (int b = 0; b < NumberOfCoefficients; ++b)
+  {
+    DenseFilterPointers[b] = DenseFilters.FirstWrite() + b * SpectrumSize;
+  }
+
+  ::xtract_init_mfcc(SpectrumSize, Nyquist, XTRACT_EQUAL_GAIN,
+    MinFrequency, MaxFrequency, NumberOfCoefficients, DenseFilterPointers.FirstWrite());
+
+  // ... memorize non zero spans only
+
+  mBandStartBins.SetSize(NumberOfCoefficients);
+  mBandSizes.SetSize(NumberOfCoefficients);
+  mBandWeightOffsets.SetSize(NumberOfCoefficients);
+
+  int NumberOfWeights = 0;
+  for (int b = 0; b < NumberOfCoefficients; ++b)
+  {
+    const double* pFilter = DenseFilterPointers[b];
+
+    int StartBin = 0;
+    while (StartBin < SpectrumSize && pFilter[StartBin] == 0.0)
+    {
+      ++StartBin;
+    }
+
+    int EndBin = SpectrumSize;
+    while (EndBin > StartBin && pFilter[EndBin - 1] == 0.0)
+    {
+      --EndBin;
+    }
+
+    mBandStartBins[b] = StartBin;
+    mBandSizes[b] = EndBin - StartBin;
+    mBandWeightOffsets[b] = NumberOfWeights;
+
+    NumberOfWeights += mBandSizes[b];
+  }
+
+  mFilterWeights.SetSize(NumberOfWeights);
+  for (int b = 0; b < NumberOfCoefficients; ++b)
+  {
+    for (int i = 0; i < mBandSizes[b]; ++i)
+    {
+      mFilterWeights[mBandWeightOffsets[b] + i] =
+        DenseFilterPointers[b][mBandStartBins[b] + i];
+    }
+  }
+
+  // ... precalculate the DCT-II matrix (same terms as xtract_dct)
+
+  mDctMatrix.SetSize(NumberOfCoefficients * NumberOfCoefficients);
+  for (int n = 0; n < NumberOfCoefficients; ++n)
+  {
+    for (int m = 0; m < NumberOfCoefficients; ++m)
+    {
+      mDctMatrix[n * NumberOfCoefficients + m] = ::cos(MPi *
+        (n / (double)NumberOfCoefficients) * ((double)(m + 1) - 0.5));
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TMelCepstrum::Calc(const double* pMagnitudes, double* pCoefficients) const
+{
+  // ... log band energies
+
+  double LogEnergies[kMaxNumberOfCoefficients];
+
+  for (int b = 0; b < mNumberOfCoefficients; ++b)
+  {
+    const double* pX = pMagnitudes + mBandStartBins[b];
+    const double* pWeights = mFilterWeights.FirstRead() + mBandWeightOffsets[b];
+
+    const int Length = mBandSizes[b];
+    const int VectorizedLength = Length - Length % MNumberOfLanes;
+
+    double Sum[MNumberOfLanes] = { 0.0 };
+
+    for (int i = 0; i < VectorizedLength; i += MNumberOfLanes)
+    {
+      for (int l = 0; l < MNumberOfLanes; ++l)
+      {
+        Sum[l] += pX[i + l] * pWeights[i + l];
+      }
+    }
+
+    for (int i = VectorizedLength; i < Length; ++i)
+    {
+      Sum[0] += pX[i] * pWeights[i];
+    }
+
+    double Energy = 0.0;
+    for (int l = 0; l < MNumberOfLanes; ++l)
+    {
+      Energy += Sum[l];
+    }
+
+    LogEnergies[b] = ::log((Energy < MLogLimit) ? MLogLimit : Energy);
+  }
+
+  // ... DCT-II
+
+  for (int n = 0; n < mNumberOfCoefficients; ++n)
+  {
+    const double* pCosines = mDctMatrix.FirstRead() + n * mNumberOfCoefficients;
+
+    double Sum = 0.0;
+    for (int m = 0; m < mNumberOfCoefficients; ++m)
+    {
+      Sum += LogEnergies[m] * pCosines[m];
+    }
+
+    pCoefficients[n] = Sum;
+  }
+}
+
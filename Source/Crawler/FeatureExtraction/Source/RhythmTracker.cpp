@@ -96,6 +96,21 @@ TRhythmTracker::~TRhythmTracker()
 
 // -------------------------------------------------------------------------------------------------
 
+void TRhythmTracker::Reset()
+{
+  mpOnsetFftProcessor->Reset();
+
+  for (int t = 0; t < kNumberOfOnsetTypes; ++t) 
+  {
+    mpOnsetDetectors[t]->Reset();
+
+    mOnsetValues[t].ClearEntries();
+    mSharpenedOnsetValues[t].ClearEntries();
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void TRhythmTracker::ProcessFrame(const fvec_t* SampleInput)
 {
   MAssert(SampleInput->length, "Expecting valid data here");
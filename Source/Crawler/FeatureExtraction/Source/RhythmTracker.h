@@ -28,6 +28,10 @@ public:
   TRhythmTracker(int SampleRate, int FftSize, int HopSize);
   virtual ~TRhythmTracker();
 
+  // Reset all onsets and onset processor states to process a new sample with
+  // the same settings: avoids reallocating the onset detectors for each sample.
+  void Reset();
+
   // Process a single FFT frame
   void ProcessFrame(const fvec_t* SampleInput);
 
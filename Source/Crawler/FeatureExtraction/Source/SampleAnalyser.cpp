@@ -1,19 +1,27 @@
 #include "CoreTypes/Export/Log.h"
 #include "CoreTypes/Export/Exception.h"
 #include "CoreTypes/Export/InlineMath.h"
+#include "CoreTypes/Export/Cpu.h"
 
 #include "AudioTypes/Export/AudioMath.h"
+#include "AudioTypes/Export/Fourier.h"
 #include "AudioTypes/Export/Envelopes.h"
+#include "AudioTypes/Export/Resampler.h"
 
 #include "CoreFileFormats/Export/AudioFile.h"
 
 #include "FeatureExtraction/Export/SampleAnalyser.h"
 #include "FeatureExtraction/Export/SampleDescriptorPool.h"
+#include "FeatureExtraction/Export/SampleAnalysisCache.h"
+#include "FeatureExtraction/Export/SampleClassificationStage.h"
 #include "FeatureExtraction/Export/SampleClassificationDescriptors.h"
 #include "FeatureExtraction/Export/Statistics.h"
+#include "FeatureExtraction/Export/SpectrumStatistics.h"
+#include "FeatureExtraction/Export/MelCepstrum.h"
 
 #include "FeatureExtraction/Source/Autocorrelation.h"
 #include "FeatureExtraction/Source/RhythmTracker.h"
+#include "FeatureExtraction/Source/SampleAnalysisWorkspace.h"
 #include "FeatureExtraction/Source/ClassificationTools.h"
 #include "FeatureExtraction/Source/ClassificationHeuristics.h"
 
@@ -21,10 +29,15 @@
 
 #include "../../3rdParty/Aubio/Export/Aubio.h"
 #include "../../3rdParty/LibXtract/Export/LibXtract.h"
-#include "../../3rdParty/Resample/Export/Resample.h"
 
 #include <vector>
 #include <algorithm>
+#include <utility> // std::swap
+#include <cstdio> // snprintf
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <limits>
 
 // =================================================================================================
 
@@ -68,6 +81,11 @@
 // envelope attack/release time
 #define MEnvelopeTimeInMs 8.0
 
+// minimum number of spectrum frames a file needs to have, to calculate frame
+// features in parallel, and number of spectrum frames per parallel task
+#define MParallelFrameAnalysisMinFrames 128
+#define MParallelFrameAnalysisChunkSize 32
+
 // when defined, "fix" class models with heuristics
 #define MUseClassificationHeuristics
 
@@ -93,10 +111,11 @@
 // Copy and isolate peaks in a spectrum.
 
 static void SCreatePeakSpectrum(
-  const TArray<double>& Spectrum,
-  TArray<double>&       PeakSpectrum,
-  int                   MagnitudeSize,
-  double                RelativeThreshold)
+  const TArray<double>&         Spectrum,
+  TArray<double>&               PeakSpectrum,
+  TList< TPair<int, double> >&  Peaks, // temp buffer
+  int                           MagnitudeSize,
+  double                        RelativeThreshold)
 {
   MAssert(RelativeThreshold >= 0.0 && RelativeThreshold <= 1.0, "");
 
@@ -105,8 +124,8 @@ static void SCreatePeakSpectrum(
   const double Threshold = RelativeThreshold * Max;
 
   // find peaks
-  const TList< TPair<int, double> > Peaks =
-    TStatistics::Peaks(Spectrum.FirstRead(), MagnitudeSize, Threshold);
+  Peaks.ClearEntries();
+  TStatistics::Peaks(Peaks, Spectrum.FirstRead(), MagnitudeSize, Threshold);
 
   // copy (second half frequencies) and clear magnitudes
   PeakSpectrum = Spectrum;
@@ -126,9 +145,8 @@ static void SCreatePeakSpectrum(
 
 // Calculate flatness, dB scaled
 
-static double SFlatnessDb(const double* pX, int Length)
+static double SFlatnessDb(double Flatness)
 {
-  const double Flatness = TStatistics::Flatness(pX, Length);
   return MMin(TAudioMath::LinToDb(Flatness) / -60.0, 1.0); // limit to -60 dB
 }
 
@@ -155,6 +173,504 @@ static double SInterpolateCubic(
   return a * ym1 + b * y0 + c * y1 + d * y2;
 }
 
+// -------------------------------------------------------------------------------------------------
+
+/*!
+ * Reads sample frames from an audio stream in the stream's prefered block 
+ * size and mixes them down to mono.
+!*/
+
+class TMonoStreamReader
+{
+public:
+  TMonoStreamReader(TAudioStream* pStream)
+    : mpStream(pStream),
+      mPosition(0)
+  {
+    const int BlockSize = mpStream->PreferedBlockSize();
+
+    // channel 0 is read directly into the dest buffer
+    mTempChannelBuffers.PreallocateSpace(mpStream->NumChannels() - 1);
+    for (int c = 1; c < mpStream->NumChannels(); ++c)
+    {
+      mTempChannelBuffers.Append(TArray<float>(BlockSize));
+    }
+
+    mChannelBufferPtrs.SetSize(mpStream->NumChannels());
+  }
+
+  //! the stream's prefered block size
+  int BlockSize() const
+  {
+    return mpStream->PreferedBlockSize();
+  }
+
+  //! current read position in sample frames
+  long long Position() const
+  {
+    return mPosition;
+  }
+
+  //! reposition the reader. Returns success.
+  bool SeekTo(long long SampleFrame)
+  {
+    if (mpStream->SeekTo(SampleFrame))
+    {
+      mPosition = SampleFrame;
+      return true;
+    }
+
+    return false;
+  }
+
+  //! read and mix down \param NumberOfFrames into \param pDestBuffer.
+  //! Blocks which fail to decode are logged and cleared, but won't abort the read.
+  void Read(float* pDestBuffer, int NumberOfFrames)
+  {
+    const int NumberOfChannels = mpStream->NumChannels();
+    const int BlockSize = mpStream->PreferedBlockSize();
+
+    int TotalFramesRead = 0;
+    while (TotalFramesRead < NumberOfFrames)
+    {
+      const int FramesToReadInThisBlock =
+        MMin(BlockSize, NumberOfFrames - TotalFramesRead);
+
+      mChannelBufferPtrs[0] = pDestBuffer + TotalFramesRead;
+      for (int c = 1; c < NumberOfChannels; ++c)
+      {
+        mChannelBufferPtrs[c] = mTempChannelBuffers[c - 1].FirstWrite();
+      }
+
+      try
+      {
+        mpStream->ReadSamples(mChannelBufferPtrs, FramesToReadInThisBlock);
+      }
+      catch (const TReadableException& Exception)
+      {
+        // don't abort loading, but zero out blocks which failed to load
+        TLog::SLog()->AddLine(MLogPrefix, "Decoder error at sample frame %d: %s",
+          (int)(mPosition + TotalFramesRead), Exception.what());
+
+        for (int c = 0; c < NumberOfChannels; ++c)
+        {
+          TAudioMath::ClearBuffer(mChannelBufferPtrs[c], FramesToReadInThisBlock);
+        }
+      }
+
+      if (NumberOfChannels > 1)
+      {
+        float* pDestMonoBuffer = mChannelBufferPtrs[0];
+
+        const float MixDownScaling = 1.0f / (float)NumberOfChannels;
+        for (int n = 0; n < FramesToReadInThisBlock; ++n)
+        {
+          for (int c = 1; c < NumberOfChannels; ++c)
+          {
+            pDestMonoBuffer[n] += mChannelBufferPtrs[c][n];
+          }
+          pDestMonoBuffer[n] *= MixDownScaling;
+        }
+      }
+
+      TotalFramesRead += FramesToReadInThisBlock;
+    }
+
+    mPosition += NumberOfFrames;
+  }
+
+private:
+  TAudioStream* mpStream;
+  long long mPosition;
+
+  TList< TArray<float> > mTempChannelBuffers;
+  TArray<float*> mChannelBufferPtrs;
+};
+
+// -------------------------------------------------------------------------------------------------
+
+/*!
+ * Memorizes the first and last index of fixed sized sample chunks for log2 
+ * quantized chunk peak levels. This way the audible range for a silence 
+ * threshold, which is only known after the whole file got read, can be 
+ * resolved afterwards without buffering the sample data.
+!*/
+
+class TLevelChunkHistogram
+{
+public:
+  enum {
+    kChunkSize = 256,
+
+    kBinsPerOctave = 16,
+    // range of absolute sample values (in TAudioStream's short sample range)
+    kMinOctave = -24,
+    kMaxOctave = 24,
+
+    kNumberOfBins = (kMaxOctave - kMinOctave) * kBinsPerOctave
+  };
+
+  TLevelChunkHistogram()
+    : mChunkIndex(0),
+      mChunkFrame(0),
+      mChunkPeak(0.0f)
+  {
+    mFirstChunks.SetSize(kNumberOfBins);
+    mFirstChunks.Init(-1);
+
+    mLastChunks.SetSize(kNumberOfBins);
+    mLastChunks.Init(-1);
+  }
+
+  //! add an absolute sample value
+  void AddValue(float AbsValue)
+  {
+    if (AbsValue > mChunkPeak)
+    {
+      mChunkPeak = AbsValue;
+    }
+
+    if (++mChunkFrame == kChunkSize)
+    {
+      FlushChunk();
+    }
+  }
+
+  //! flush the last, partially filled chunk. To be called after all values got added.
+  void Finalize()
+  {
+    if (mChunkFrame > 0)
+    {
+      FlushChunk();
+    }
+  }
+
+  //! get the first and last chunk which may contain values above the given 
+  //! threshold. The range is conservative: it may include a few chunks at the
+  //! edges which are slightly below the threshold, but never misses audible ones.
+  //! Returns false when all chunks are below the threshold.
+  bool AudibleChunkRange(float Threshold, int& FirstChunk, int& LastChunk) const
+  {
+    FirstChunk = -1;
+    LastChunk = -1;
+
+    for (int b = SBinIndex(Threshold); b < kNumberOfBins; ++b)
+    {
+      if (mFirstChunks[b] != -1)
+      {
+        if (FirstChunk == -1 || mFirstChunks[b] < FirstChunk)
+        {
+          FirstChunk = mFirstChunks[b];
+        }
+        if (mLastChunks[b] > LastChunk)
+        {
+          LastChunk = mLastChunks[b];
+        }
+      }
+    }
+
+    return (FirstChunk != -1);
+  }
+
+private:
+  static int SBinIndex(float AbsValue)
+  {
+    if (AbsValue <= 0.0f)
+    {
+      return 0;
+    }
+
+    const int Bin = (int)::floor(
+      (::log2(AbsValue) - kMinOctave) * kBinsPerOctave);
+
+    return MMax(0, MMin(kNumberOfBins - 1, Bin));
+  }
+
+  void FlushChunk()
+  {
+    const int Bin = SBinIndex(mChunkPeak);
+
+    if (mFirstChunks[Bin] == -1)
+    {
+      mFirstChunks[Bin] = mChunkIndex;
+    }
+    mLastChunks[Bin] = mChunkIndex;
+
+    ++mChunkIndex;
+    mChunkFrame = 0;
+    mChunkPeak = 0.0f;
+  }
+
+  TArray<int> mFirstChunks;
+  TArray<int> mLastChunks;
+
+  int mChunkIndex;
+  int mChunkFrame;
+  float mChunkPeak;
+};
+
+// -------------------------------------------------------------------------------------------------
+
+// Number of source sample frames which need to be loaded to fill the analyzation 
+// time range, including some space for the analyzer's look-ahead and the resampler.
+
+static long long SAnalyzationRangeInSourceFrames(
+  int SourceSampleRate,
+  int AnalyzationSampleRate,
+  int FftFrameSize)
+{
+  const int AnalyzationFrames = TAudioMath::MsToSamples(AnalyzationSampleRate,
+    MAnalyzationDurationMaxInMs) + 2 * FftFrameSize;
+
+  const double Speed = (double)SourceSampleRate / (double)AnalyzationSampleRate;
+
+  return (long long)::ceil(AnalyzationFrames * Speed) +
+    TLevelChunkHistogram::kChunkSize;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// Read \param NumberOfFrames from the given stream reader and resample them block
+// by block into \param SampleBuffer, without buffering the source sample frames.
+
+static void SReadResampledSampleBuffer(
+  TMonoStreamReader&  StreamReader,
+  long long           NumberOfFrames,
+  TResampler&         Resampler,
+  TArray<float>&      SampleBuffer)
+{
+  SampleBuffer.SetSize((int)Resampler.DestFrameCount(NumberOfFrames));
+
+  TArray<float> BlockBuffer(StreamReader.BlockSize());
+
+  int DestFramesWritten = 0;
+  for (long long FramesRead = 0; FramesRead < NumberOfFrames; )
+  {
+    const int FramesToReadInThisBlock = (int)MMin<long long>(
+      BlockBuffer.Size(), NumberOfFrames - FramesRead);
+
+    StreamReader.Read(BlockBuffer.FirstWrite(), FramesToReadInThisBlock);
+
+    DestFramesWritten += Resampler.Process(BlockBuffer.FirstRead(),
+      FramesToReadInThisBlock, SampleBuffer.FirstWrite() + DestFramesWritten);
+
+    FramesRead += FramesToReadInThisBlock;
+  }
+
+  DestFramesWritten += Resampler.Flush(SampleBuffer.FirstWrite() + DestFramesWritten);
+
+  MUnused(DestFramesWritten);
+  MAssert(DestFramesWritten == SampleBuffer.Size(), "Unexpected dest size");
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// Resample an already loaded mono sample buffer into \param SampleBuffer.
+
+static void SResampleSampleBuffer(
+  const float*    pSourceBuffer,
+  int             NumberOfFrames,
+  TResampler&     Resampler,
+  TArray<float>&  SampleBuffer)
+{
+  SampleBuffer.SetSize((int)Resampler.DestFrameCount(NumberOfFrames));
+
+  int DestFramesWritten = Resampler.Process(pSourceBuffer, NumberOfFrames, 
+    SampleBuffer.FirstWrite());
+  DestFramesWritten += Resampler.Flush(SampleBuffer.FirstWrite() + DestFramesWritten);
+
+  MUnused(DestFramesWritten);
+  MAssert(DestFramesWritten == SampleBuffer.Size(), "Unexpected dest size");
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// Trim silence, pad, normalize and convert the given mono, resampled sample buffer 
+// into the analyzers double data. \param SilentLeadingSamplesOffset are the number 
+// of samples which got skipped before the start of \param SampleBuffer.
+
+static void SConvertSampleData(
+  const TArray<float>&  SampleBuffer,
+  double                Amplification,
+  int                   SilentLeadingSamplesOffset,
+  bool                  TrimTrailingSilence,
+  int                   FftFrameSize,
+  TArray<double>&       Data,
+  int&                  DataOffset)
+{
+  static const float sScaleFactor = M16BitSampleRange / 2.0f;
+
+  const int NumberOfSampleFrames = SampleBuffer.Size();
+
+
+  // ... Check how many leading samples can be skipped
+
+  static const double sSilenceFloor = sScaleFactor * 
+    TAudioMath::DbToLin(MSilenceThresholdDb);
+
+  int SilentLeadingSamples = 0;
+  for (int f = 0; f < NumberOfSampleFrames; ++f, ++SilentLeadingSamples)
+  {
+    if (TMathT<double>::Abs(Amplification *
+          SampleBuffer[f]) > sSilenceFloor)
+    {
+      break;
+    }
+  }
+
+  int SilentTrailingSamples = 0;
+  if (TrimTrailingSilence)
+  {
+    for (int f = NumberOfSampleFrames - 1; f > SilentLeadingSamples; --f, ++SilentTrailingSamples)
+    {
+      if (TMathT<double>::Abs(Amplification * 
+            SampleBuffer[f]) > sSilenceFloor)
+      {
+        break;
+      }
+    }
+  }
+
+  if (SilentLeadingSamplesOffset + SilentLeadingSamples || SilentTrailingSamples)
+  {
+    TLog::SLog()->AddLine(MLogPrefix,
+      "Skipping %d silent leading and %d trailing samples...", 
+      SilentLeadingSamplesOffset + SilentLeadingSamples, SilentTrailingSamples);
+  }
+
+
+  // ... Finalize: convert to double, pad and scale
+
+  const int AudibleNumberOfSampleFrames = NumberOfSampleFrames - 
+    SilentLeadingSamples - SilentTrailingSamples;
+
+  // make sure we analyze at least half of the last frame
+  int EndFrameOffset = 0;
+  if ((AudibleNumberOfSampleFrames % FftFrameSize) < FftFrameSize / 2)
+  {
+    EndFrameOffset += FftFrameSize / 2;
+  }
+
+  // and ensure we analyze at least one full frame
+  int StartFrameOffset = 0;
+  if (AudibleNumberOfSampleFrames + EndFrameOffset < FftFrameSize)
+  {
+    StartFrameOffset = FftFrameSize - AudibleNumberOfSampleFrames - EndFrameOffset;
+  }
+  
+  Data.SetSize(AudibleNumberOfSampleFrames + 
+    StartFrameOffset + EndFrameOffset);
+  
+  DataOffset = -(SilentLeadingSamplesOffset + SilentLeadingSamples) + 
+    StartFrameOffset;
+
+  // clear padded start and end
+  double* pSampleBuffer = Data.FirstWrite();
+
+  TMemory::Zero(pSampleBuffer,
+    sizeof(double) * StartFrameOffset);
+  TMemory::Zero(pSampleBuffer + Data.Size() - EndFrameOffset,
+    sizeof(double) * EndFrameOffset);
+
+  // fill in the rest with the dest sample data and apply "Amplification"
+  const double FinalScaling = (double)Amplification / sScaleFactor;
+
+  for (int n = 0; n < AudibleNumberOfSampleFrames; ++n)
+  {
+    pSampleBuffer[n + StartFrameOffset] =
+      SampleBuffer[n + SilentLeadingSamples] * FinalScaling;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// Number of currently running Analyze or Extract calls in all TSampleAnalysers:
+// used to detect idle CPU cores for the parallel frame analysis.
+
+static std::atomic<int> sNumberOfRunningAnalyses(0);
+
+class TRunningAnalysisScope
+{
+public:
+  TRunningAnalysisScope() { ++sNumberOfRunningAnalyses; }
+  ~TRunningAnalysisScope() { --sNumberOfRunningAnalyses; }
+};
+
+// -------------------------------------------------------------------------------------------------
+
+// Number of threads which should be used to calculate frame features of a single 
+// file with the given number of spectrum frames. Idle cores are shared equally 
+// among all running analyses. Returns 1 when the file is too short or when all 
+// cores are busy.
+
+static int SParallelFrameAnalysisThreadCount(int NumberOfFrames)
+{
+  if (NumberOfFrames < MParallelFrameAnalysisMinFrames)
+  {
+    return 1;
+  }
+
+  const int NumberOfRunningAnalyses = MMax(1, sNumberOfRunningAnalyses.load());
+  const int NumberOfIdleThreads = 
+    TCpu::NumberOfConcurrentThreads() - NumberOfRunningAnalyses;
+
+  if (NumberOfIdleThreads <= 0)
+  {
+    return 1;
+  }
+
+  const int MaxThreads = NumberOfFrames / MParallelFrameAnalysisChunkSize;
+  return MMax(1, MMin(MaxThreads, 1 + NumberOfIdleThreads / NumberOfRunningAnalyses));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/*!
+ * Appends frame values of a descriptor value to the visited descriptor value: 
+ * used to merge descriptors of frame chunks.
+!*/
+
+class TAppendDescriptorFrameValues : public boost::static_visitor<>
+{
+public:
+  TAppendDescriptorFrameValues(const TSampleDescriptors::TDescriptor::TValue& Source)
+    : mSource(Source)
+  { }
+
+  template <typename T>
+  void operator()(TList<T>* pValues) const
+  {
+    pValues->Append(*boost::get<TList<T>*>(mSource));
+  }
+
+  template <typename T>
+  void operator()(T* pValue) const
+  {
+    // not a frame value: nothing to merge
+    MUnused(pValue);
+  }
+
+private:
+  const TSampleDescriptors::TDescriptor::TValue& mSource;
+};
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalyser::TWorkspaceCounters::TWorkspaceCounters()
+  : mWorkspaces(0),
+    mResets(0),
+    mAllocations(0)
+{ }
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalyser::TWorkspaceCounters TSampleAnalyser::SWorkspaceCounters()
+{
+  return TSampleAnalysisWorkspace::SCounters();
+}
+
 // =================================================================================================
 
 // -------------------------------------------------------------------------------------------------
@@ -165,7 +681,13 @@ TSampleAnalyser::TSampleAnalyser(
   int HopFrameSize)
   : mSampleRate(SampleRate),
     mFftFrameSize(FftFrameSize),
-    mHopFrameSize(HopFrameSize)
+    mHopFrameSize(HopFrameSize),
+    mParallelFrameAnalysis(true),
+    mResamplerQuality(TResampler::kHighQuality),
+    mClassificationModelHash(0),
+    mOneShotCategorizationModelHash(0),
+    mpAnalysisCache(NULL),
+    mpClassificationStage(NULL)
 {
   // analyzation bin area
   const double FrequenciesPerBin = mSampleRate / mFftFrameSize;
@@ -180,36 +702,16 @@ TSampleAnalyser::TSampleAnalyser(
   // the window by two. Otherwise a sinusoid at 0db will result in 0.5 in the spectrum.
   TAudioMath::ScaleBuffer(mpWindow, mFftFrameSize, 2.0);
 
-  // Allocate Mel filters
-  mpXtractMelFilters = TOwnerPtr<xtract_mel_filter>(new xtract_mel_filter_());
-  mpXtractMelFilters->n_filters = kNumberOfCepstrumCoefficients;
-  mpXtractMelFilters->filters = (double **)TMemory::Alloc(
-    "#libXtract", kNumberOfCepstrumCoefficients * sizeof(double*));
-
-  for (uint8_t k = 0; k < kNumberOfCepstrumCoefficients; ++k)
-  {
-    mpXtractMelFilters->filters[k] = (double*)TMemory::Alloc(
-      "#libXtract", (mFftFrameSize / 2) * sizeof(double));
-  }
-
-  ::xtract_init_mfcc(mFftFrameSize / 2, mSampleRate / 2, XTRACT_EQUAL_GAIN,
-    MAnalyzationFreqMin, MAnalyzationFreqMax,
-    mpXtractMelFilters->n_filters, mpXtractMelFilters->filters);
+  // create the sparse Mel filterbank and DCT
+  mpMelCepstrum = TOwnerPtr<TMelCepstrum>(new TMelCepstrum(mFftFrameSize / 2, 
+    mSampleRate / 2, MAnalyzationFreqMin, MAnalyzationFreqMax, 
+    kNumberOfCepstrumCoefficients));
 }
 
 // -------------------------------------------------------------------------------------------------
 
 TSampleAnalyser::~TSampleAnalyser()
 {
-  for (int n = 0; n < kNumberOfCepstrumCoefficients; ++n)
-  {
-    TMemory::Free(mpXtractMelFilters->filters[n]);
-  }
-
-  TMemory::Free(mpXtractMelFilters->filters);
-
-  mpXtractMelFilters.Delete();
-
   ::xtract_free_window(mpWindow);
 }
 
@@ -245,6 +747,7 @@ void TSampleAnalyser::SetClassificationModel(const TString& ModelPath)
       TOwnerPtr<TClassificationModel>(new TDefaultBaggingClassificationModel());
 
     mpClassificationModel->Load(ModelPath);
+    mClassificationModelHash = TSampleAnalysisCache::SFileHash(ModelPath);
   }
   catch (const std::exception& Exception)
   {
@@ -285,6 +788,7 @@ void TSampleAnalyser::SetOneShotCategorizationModel(const TString& ModelPath)
       TOwnerPtr<TClassificationModel>(new TDefaultBaggingClassificationModel());
 
     mpOneShotCategorizationModel->Load(ModelPath);
+    mOneShotCategorizationModelHash = TSampleAnalysisCache::SFileHash(ModelPath);
   }
   catch (const std::exception& Exception)
   {
@@ -295,10 +799,91 @@ void TSampleAnalyser::SetOneShotCategorizationModel(const TString& ModelPath)
 
 // -------------------------------------------------------------------------------------------------
 
+TString TSampleAnalyser::ConfigFingerprint(TDescriptorSet DescriptorSet) const
+{
+  TString Ret = ToString(mSampleRate) + "-" + ToString(mFftFrameSize) + "-" + 
+    ToString(mHopFrameSize) + "-" + ToString((int)mResamplerQuality) + "-" + 
+    ToString((int)DescriptorSet);
+
+  // models are used for high level and classification descriptors only
+  if (DescriptorSet != TSampleDescriptors::kLowLevelDescriptors)
+  {
+    char ModelHashes[64];
+    ::snprintf(ModelHashes, sizeof(ModelHashes), "-%016llx-%016llx",
+      mpClassificationModel ? (unsigned long long)mClassificationModelHash : 0ULL,
+      mpOneShotCategorizationModel ? (unsigned long long)mOneShotCategorizationModelHash : 0ULL);
+
+    Ret += ModelHashes;
+  }
+
+  return Ret;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalysisCache* TSampleAnalyser::AnalysisCache() const
+{
+  return mpAnalysisCache;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalyser::SetAnalysisCache(TSampleAnalysisCache* pCache)
+{
+  mpAnalysisCache = pCache;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleClassificationStage* TSampleAnalyser::ClassificationStage() const
+{
+  return mpClassificationStage;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalyser::SetClassificationStage(TSampleClassificationStage* pStage)
+{
+  mpClassificationStage = pStage;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TSampleAnalyser::ParallelFrameAnalysis() const
+{
+  return mParallelFrameAnalysis;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalyser::SetParallelFrameAnalysis(bool Enable)
+{
+  mParallelFrameAnalysis = Enable;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TResampler::TQuality TSampleAnalyser::ResamplerQuality() const
+{
+  return mResamplerQuality;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalyser::SetResamplerQuality(TResampler::TQuality Quality)
+{
+  MAssert(Quality >= 0 && Quality < TResampler::kNumberOfQualities, "Invalid quality");
+  mResamplerQuality = Quality;
+}
+
+// -------------------------------------------------------------------------------------------------
+
 TSampleDescriptors TSampleAnalyser::Analyze(
   const TString&                      FileName,
   TSampleDescriptors::TDescriptorSet  DescriptorSet) const
 {
+  const TRunningAnalysisScope RunningAnalysisScope;
+
   // create new analyzation status
   TSampleData SampleData;
   TSilenceStatus SilenceStatus;
@@ -321,12 +906,21 @@ TSampleDescriptors TSampleAnalyser::Analyze(
   try
   {
     // analyze low level descriptors
-    AnalyzeLowLevelDescriptors(SampleData, SilenceStatus, Results);
+    AnalyzeLowLevelDescriptors(SampleData, 
+      TLowLevelFeatures::SFeatures(DescriptorSet), SilenceStatus, Results);
 
     if (DescriptorSet == TSampleDescriptors::kHighLevelDescriptors) 
     {
-      // analyze high level descriptors
-      AnalyzeHighLevelDescriptors(SampleData, SilenceStatus, Results);
+      // analyze high level descriptors
+      AnalyzeHighLevelDescriptors(SampleData, SilenceStatus, Results);
+
+      // and evaluate the models
+      Classify(Results);
+    }
+    else if (DescriptorSet == TSampleDescriptors::kClassificationDescriptors)
+    {
+      // evaluate the models only
+      Classify(Results);
     }
   }
   catch (const std::exception& exception)
@@ -347,6 +941,8 @@ void TSampleAnalyser::Extract(
   TSampleDescriptorPool*  pPool, 
   std::mutex&             PoolLock) const
 {
+  const TRunningAnalysisScope RunningAnalysisScope;
+
   // create new analyzation status
   TSampleData SampleData;
   TSilenceStatus SilenceStatus;
@@ -363,6 +959,35 @@ void TSampleAnalyser::Extract(
   }
 #endif
 
+  // ... look up cached results
+
+  TSampleAnalysisCache::TContentKey ContentKey;
+
+  if (mpAnalysisCache)
+  {
+    try
+    {
+      ContentKey = TSampleAnalysisCache::SContentKey(FileName);
+
+      if (mpAnalysisCache->Lookup(FileName, ContentKey, Results))
+      {
+        const std::lock_guard<std::mutex> Lock(PoolLock);
+
+        pPool->InsertSample(FileName, Results);
+        return;
+      }
+    }
+    catch (const std::exception& exception)
+    {
+      // file can't be read or cache failed: let LoadSample handle the file
+      TLog::SLog()->AddLine(MLogPrefix, "Failed to look up cached results for '%s' - '%s'",
+        FileName.StdCString().c_str(), exception.what());
+
+      ContentKey.Empty();
+    }
+  }
+
+
   // ... load sample data 
 
   try
@@ -385,14 +1010,28 @@ void TSampleAnalyser::Extract(
 
   // ... analyze and write descriptors
 
+  const TDescriptorSet DescriptorSet = pPool->DescriptorSet();
+
+  const bool AnalyzeHighLevel = 
+    (DescriptorSet == TSampleDescriptors::kHighLevelDescriptors);
+  const bool EvaluateModels = 
+    (DescriptorSet != TSampleDescriptors::kLowLevelDescriptors);
+
   try
   {
-    AnalyzeLowLevelDescriptors(SampleData, SilenceStatus, Results);
+    AnalyzeLowLevelDescriptors(SampleData, 
+      TLowLevelFeatures::SFeatures(DescriptorSet), SilenceStatus, Results);
 
-    if (pPool->DescriptorSet() == TSampleDescriptors::kHighLevelDescriptors)
+    if (AnalyzeHighLevel)
     {
       AnalyzeHighLevelDescriptors(SampleData, SilenceStatus, Results);
     }
+
+    // evaluate models here, unless a classification stage batches them
+    if (EvaluateModels && !mpClassificationStage)
+    {
+      Classify(Results);
+    }
   }
   catch (const std::exception& exception)
   {
@@ -410,6 +1049,26 @@ void TSampleAnalyser::Extract(
 
   // ... save results
 
+  if (mpClassificationStage && EvaluateModels)
+  {
+    // stage classifies, caches and writes the results
+    mpClassificationStage->Push(FileName, ContentKey, Results);
+    return;
+  }
+
+  if (mpAnalysisCache && !ContentKey.IsEmpty())
+  {
+    try
+    {
+      mpAnalysisCache->Store(FileName, ContentKey, Results);
+    }
+    catch (const std::exception& exception)
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Failed to cache results for '%s' - '%s'",
+        FileName.StdCString().c_str(), exception.what());
+    }
+  }
+
   const std::lock_guard<std::mutex> Lock(PoolLock);
 
   pPool->InsertSample(FileName, Results);
@@ -417,6 +1076,134 @@ void TSampleAnalyser::Extract(
 
 // -------------------------------------------------------------------------------------------------
 
+TSampleAnalyser::TLowLevelFeatures::TLowLevelFeatures()
+  : mAmplitudePeak(true),
+    mAmplitudeRms(true),
+    mAmplitudeEnvelope(true),
+    mAutoCorrelation(true),
+    mSpectralRms(true),
+    mSpectralCentroidAndSpread(true),
+    mSpectralSkewnessAndKurtosis(true),
+    mSpectralRolloff(true),
+    mSpectralFlatness(true),
+    mSpectralFlux(true),
+    mSpectralBandFeatures(true),
+    mSpectrumBands(true),
+    mCepstrumBands(true),
+    mSpectralComplexity(true),
+    mSpectralInharmonicity(true),
+    mTristimulus(true),
+    mPitch(true),
+    mFailSafePitch(true),
+    mRhythm(true),
+    mRhythmFinalTempo(true),
+    mNumberOfSpectrumBandFrames(std::numeric_limits<int>::max())
+{
+  // nothing to do
+}
+
+// -------------------------------------------------------------------------------------------------
+
+const TSampleAnalyser::TLowLevelFeatures& TSampleAnalyser::TLowLevelFeatures::SFeatures(
+  TDescriptorSet DescriptorSet)
+{
+  if (DescriptorSet == TSampleDescriptors::kClassificationDescriptors)
+  {
+    static const TLowLevelFeatures sClassificationFeatures = SClassificationFeatures();
+    return sClassificationFeatures;
+  }
+  else
+  {
+    static const TLowLevelFeatures sAllFeatures;
+    return sAllFeatures;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalyser::TLowLevelFeatures TSampleAnalyser::TLowLevelFeatures::SClassificationFeatures()
+{
+  // collect descriptors which are read by the models and heuristics
+  const TSampleDescriptors Descriptors;
+
+  TList<const TSampleDescriptors::TDescriptor*> UsedDescriptors =
+    TSampleClassificationDescriptors::SUsedDescriptors(Descriptors);
+
+  #if defined(MUseClassificationHeuristics)
+    UsedDescriptors.Append(TClassificationHeuristics::UsedDescriptors(Descriptors));
+  #endif
+
+  auto IsUsed = [&](const TSampleDescriptors::TDescriptor& Descriptor) {
+    return UsedDescriptors.Contains(&Descriptor);
+  };
+
+  // and enable all features which calculate them
+  TLowLevelFeatures Ret;
+
+  Ret.mAmplitudePeak = IsUsed(Descriptors.mAmplitudePeak);
+  Ret.mAmplitudeRms = IsUsed(Descriptors.mAmplitudeRms);
+  Ret.mAmplitudeEnvelope = IsUsed(Descriptors.mAmplitudeEnvelope);
+
+  Ret.mAutoCorrelation = IsUsed(Descriptors.mAutoCorrelation);
+
+  Ret.mSpectralRms = IsUsed(Descriptors.mSpectralRms);
+  Ret.mSpectralCentroidAndSpread = IsUsed(Descriptors.mSpectralCentroid) ||
+    IsUsed(Descriptors.mSpectralSpread);
+  Ret.mSpectralSkewnessAndKurtosis = IsUsed(Descriptors.mSpectralSkewness) ||
+    IsUsed(Descriptors.mSpectralKurtosis);
+  Ret.mSpectralRolloff = IsUsed(Descriptors.mSpectralRolloff);
+  Ret.mSpectralFlatness = IsUsed(Descriptors.mSpectralFlatness);
+  Ret.mSpectralFlux = IsUsed(Descriptors.mSpectralFlux);
+
+  Ret.mSpectralBandFeatures = IsUsed(Descriptors.mSpectralRmsBands) ||
+    IsUsed(Descriptors.mSpectralFlatnessBands) ||
+    IsUsed(Descriptors.mSpectralFluxBands) ||
+    IsUsed(Descriptors.mSpectralComplexityBands) ||
+    IsUsed(Descriptors.mSpectralContrastBands) ||
+    IsUsed(Descriptors.mSpectralContrast);
+  Ret.mSpectrumBands = IsUsed(Descriptors.mSpectrumBands);
+  Ret.mCepstrumBands = IsUsed(Descriptors.mCepstrumBands);
+
+  Ret.mSpectralComplexity = IsUsed(Descriptors.mSpectralComplexity);
+  Ret.mSpectralInharmonicity = IsUsed(Descriptors.mSpectralInharmonicity);
+  Ret.mTristimulus = IsUsed(Descriptors.mTristimulus1) ||
+    IsUsed(Descriptors.mTristimulus2) ||
+    IsUsed(Descriptors.mTristimulus3);
+
+  // inharmonicity and tristimulus are calculated from the fail safe F0 
+  Ret.mFailSafePitch = IsUsed(Descriptors.mFailSafeF0) ||
+    Ret.mSpectralInharmonicity || Ret.mTristimulus;
+  Ret.mPitch = IsUsed(Descriptors.mF0) || IsUsed(Descriptors.mF0Confidence) ||
+    Ret.mFailSafePitch;
+
+  Ret.mRhythmFinalTempo = IsUsed(Descriptors.mRhythmFinalTempo) ||
+    IsUsed(Descriptors.mRhythmFinalTempoConfidence);
+  Ret.mRhythm = Ret.mRhythmFinalTempo ||
+    IsUsed(Descriptors.mRhythmComplexOnsets) ||
+    IsUsed(Descriptors.mRhythmComplexOnsetCount) ||
+    IsUsed(Descriptors.mRhythmComplexOnsetContrast) ||
+    IsUsed(Descriptors.mRhythmComplexOnsetFrequencyMean) ||
+    IsUsed(Descriptors.mRhythmComplexOnsetStrength) ||
+    IsUsed(Descriptors.mRhythmComplexTempo) ||
+    IsUsed(Descriptors.mRhythmComplexTempoConfidence) ||
+    IsUsed(Descriptors.mRhythmPercussiveOnsets) ||
+    IsUsed(Descriptors.mRhythmPercussiveOnsetCount) ||
+    IsUsed(Descriptors.mRhythmPercussiveOnsetContrast) ||
+    IsUsed(Descriptors.mRhythmPercussiveOnsetFrequencyMean) ||
+    IsUsed(Descriptors.mRhythmPercussiveOnsetStrength) ||
+    IsUsed(Descriptors.mRhythmPercussiveTempo) ||
+    IsUsed(Descriptors.mRhythmPercussiveTempoConfidence);
+
+  // models only read a few time frames from the spectrum bands: all other 
+  // framed descriptors are also used via their statistics, so need all frames
+  Ret.mNumberOfSpectrumBandFrames = Ret.mSpectrumBands ?
+    TSampleClassificationDescriptors::SLastUsedTimeFrame() + 1 : 0;
+
+  return Ret;
+}
+
+// -------------------------------------------------------------------------------------------------
+
 TList<double> TSampleAnalyser::AudibleSpectrumFrames(
   TSilenceStatus&      SilenceStatus, 
   const TList<double>& SpectrumDescriptor)const
@@ -480,155 +1267,182 @@ void TSampleAnalyser::LoadSample(
   {
     throw TReadableException("Sample file is empty, probably failed to read.");
   }
-    
-  int NumberOfSampleFrames = (int)pAudioFile->Stream()->NumSamples();
-  int NumberOfSampleChannels = pAudioFile->Stream()->NumChannels();
 
-  TList< TArray<float> > TempSampleBuffers;
-  TempSampleBuffers.PreallocateSpace(NumberOfSampleChannels);
-  for (int c = 0; c < NumberOfSampleChannels; ++c)
+  // stream files which are a lot longer than the analyzed range: avoids buffering, 
+  // resampling and normalizing audio which won't be analyzed anyway
+  const long long AnalyzationRangeInFrames = SAnalyzationRangeInSourceFrames(
+    pAudioFile->SamplingRate(), mSampleRate, mFftFrameSize);
+
+  if (pAudioFile->Stream()->NumSamples() > 2 * AnalyzationRangeInFrames)
   {
-    TempSampleBuffers.Append(TArray<float>(NumberOfSampleFrames));
+    LoadSampleStreamed(pAudioFile, SampleData);
   }
-
-  // read samples into TempSampleBuffers in blocks of the stream's prefered blocksize
+  else
   {
-    const int BlockSize = pAudioFile->Stream()->PreferedBlockSize();
+    LoadSampleFully(pAudioFile, SampleData);
+  }
+}
 
-    int TotalSamplesRead = 0;
-    while (TotalSamplesRead < NumberOfSampleFrames)
-    {
-      const int SamplesToReadInThisBlock = 
-        MMin(BlockSize, NumberOfSampleFrames - TotalSamplesRead);
+// -------------------------------------------------------------------------------------------------
 
-      TArray<float*> SampleBufferPtrs(NumberOfSampleChannels);
-      for (int c = 0; c < NumberOfSampleChannels; ++c)
-      {
-        SampleBufferPtrs[c] = TempSampleBuffers[c].FirstWrite() + TotalSamplesRead;
-      }
+void TSampleAnalyser::LoadSampleFully(
+  TAudioFile*   pAudioFile,
+  TSampleData&  SampleData) const
+{
+  int NumberOfSampleFrames = (int)pAudioFile->Stream()->NumSamples();
 
-      try
-      {
-        pAudioFile->Stream()->ReadSamples(SampleBufferPtrs, SamplesToReadInThisBlock);
-      }
-      catch (const TReadableException& Exception)
-      {
-        // don't abort loading, but zero out blocks which failed to load
-        TLog::SLog()->AddLine(MLogPrefix, "Decoder error at sample frame %d: %s",
-          TotalSamplesRead, Exception.what());
+  // ... Read and mix down to mono (to ease and speed up following processing), 
+  // resampling block by block (when necessary)
 
-        for (int c = 0; c < NumberOfSampleChannels; ++c)
-        {
-          TAudioMath::ClearBuffer(SampleBufferPtrs[c], SamplesToReadInThisBlock);
-        }
-      }
+  TArray<float> AnalyzationSampleBuffer;
 
-      TotalSamplesRead += SamplesToReadInThisBlock;
-    }
+  TMonoStreamReader StreamReader(pAudioFile->Stream());
+
+  if (pAudioFile->SamplingRate() != mSampleRate)
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Resampling from %d Hz to %d Hz...",
+      (int)pAudioFile->SamplingRate(), (int)mSampleRate);
+
+    TResampler Resampler((int)pAudioFile->SamplingRate(), mSampleRate, 
+      mResamplerQuality);
+
+    SReadResampledSampleBuffer(StreamReader, NumberOfSampleFrames, 
+      Resampler, AnalyzationSampleBuffer);
+
+    // update sample count
+    NumberOfSampleFrames = AnalyzationSampleBuffer.Size();
+  }
+  else
+  {
+    AnalyzationSampleBuffer.SetSize(NumberOfSampleFrames);
+    StreamReader.Read(AnalyzationSampleBuffer.FirstWrite(), NumberOfSampleFrames);
   }
 
 
-  // ... Mix down to mono (to ease and speed up following processing)
+  // ... Calc RMS 
 
   static const float sScaleFactor = M16BitSampleRange / 2.0f;
 
-  if (NumberOfSampleChannels > 1)
+  double RmsValue = 0.0;
+  for (int n = 0; n < NumberOfSampleFrames; ++n)
   {
-    // use first channel as dest channel
-    float* pDestMonoBuffer = TempSampleBuffers[0].FirstWrite();
+    RmsValue += TMathT<double>::Square(AnalyzationSampleBuffer[n] / sScaleFactor);
+  }
 
-    const float MixDownScaling = 1.0f / (float)NumberOfSampleChannels;
-    for (int n = 0; n < NumberOfSampleFrames; ++n)
-    {
-      for (int c = 1; c < NumberOfSampleChannels; ++c)
-      {
-        pDestMonoBuffer[n] += TempSampleBuffers[c][n];
-      }
-      pDestMonoBuffer[n] *= MixDownScaling;
-    }
+  SampleData.mRmsValue = (float)MMin(1.0,
+    ::sqrt(RmsValue / NumberOfSampleFrames));
 
-    // all mono now
-    NumberOfSampleChannels = 1;
-    while (TempSampleBuffers.Size() > 1)
-    {
-      TempSampleBuffers.DeleteLast();
-    }
-  }
 
-  TArray<float>& AnalyzationSampleBuffer = TempSampleBuffers[0];
+  // ... Calc peak and normalization factor
+
+  float Min = AnalyzationSampleBuffer[0];
+  float Max = AnalyzationSampleBuffer[0];
+
+  TMathT<float>::GetMinMax(Min, Max,
+    0, AnalyzationSampleBuffer.Size(), AnalyzationSampleBuffer.FirstRead());
 
+  const double MaxAmplitude = (double)MMax(
+    TMathT<float>::Abs(Min), TMathT<float>::Abs(Max));
 
-  // ... Resample (when necessary)
+  // assign normalized peak value
+  SampleData.mPeakValue = (float)MMin(1.0, MaxAmplitude / sScaleFactor);
 
-  const double Speed = (double)pAudioFile->SamplingRate() / (double)mSampleRate;
+  const double Amplification = (MaxAmplitude > MEpsilon) ?
+    sScaleFactor / MaxAmplitude : 1.0;
 
-  if (Speed != 1.0)
+  if (Amplification > 1.1)
   {
-    TLog::SLog()->AddLine(MLogPrefix, "Resampling from %d Hz to %d Hz...",
-      (int)pAudioFile->SamplingRate(), (int)mSampleRate);
+    TLog::SLog()->AddLine(MLogPrefix,
+      "Normalizing sample with factor: %g ...", Amplification);
+  }
 
-    const unsigned int OldSizeInSamples = NumberOfSampleFrames;
 
-    const unsigned int NewSizeInSamples = (unsigned int)
-      MMax(1, TMath::d2iRound(NumberOfSampleFrames / Speed));
+  // ... Trim silence, convert to double, pad and scale
 
-    const float* pSrcSamples = AnalyzationSampleBuffer.FirstWrite();
+  const int SilentLeadingSamplesOffset = 0;
+  const bool TrimTrailingSilence = true;
 
-    // create resampled dest sample buffer
-    TArray<float> ResampledSampleBuffer;
-    ResampledSampleBuffer.SetSize(NewSizeInSamples);
+  SConvertSampleData(AnalyzationSampleBuffer, Amplification,
+    SilentLeadingSamplesOffset, TrimTrailingSilence, mFftFrameSize,
+    SampleData.mData, SampleData.mDataOffset);
 
-    // resample
-    const int HighQuality = 1;
-    void* pResampler = ::resample_open(HighQuality, 1.0 / Speed, 1.0 / Speed);
+  // all data got loaded: effective lengths are calculated from mData
+  SampleData.mDataIsTruncated = false;
+  SampleData.mEffectiveLength48dB = 0.0;
+  SampleData.mEffectiveLength24dB = 0.0;
+  SampleData.mEffectiveLength12dB = 0.0;
+}
 
-    const int LastFlag = 1;
-    int SrcSamplesUsed = 0;
+// -------------------------------------------------------------------------------------------------
 
-    const int DestSamplesWritten = ::resample_process(
-      pResampler, 1.0 / Speed,
-      const_cast<float*>(pSrcSamples), OldSizeInSamples, LastFlag, &SrcSamplesUsed,
-      ResampledSampleBuffer.FirstWrite(), NewSizeInSamples);
+void TSampleAnalyser::LoadSampleStreamed(
+  TAudioFile*   pAudioFile,
+  TSampleData&  SampleData) const
+{
+  const long long NumberOfSampleFrames = pAudioFile->Stream()->NumSamples();
+  const int SourceSampleRate = pAudioFile->SamplingRate();
 
-    MUnused(DestSamplesWritten);
+  const long long AnalyzationRangeInFrames = SAnalyzationRangeInSourceFrames(
+    SourceSampleRate, mSampleRate, mFftFrameSize);
 
-    MAssert(SrcSamplesUsed == (int)OldSizeInSamples,
-      "Expected all input samples to be used");
-    MAssert(DestSamplesWritten == (int)NewSizeInSamples,
-      "Unexpected dest size");
+  // the leading part of the file is memorized while calculating the file stats, 
+  // so we don't need to seek and decode it again when the sample starts audible
+  const int CapturedFrames = (int)(AnalyzationRangeInFrames + 
+    AnalyzationRangeInFrames / 2);
 
-    ::resample_close(pResampler);
+  TLog::SLog()->AddLine(MLogPrefix, "Streaming first %d of %d sample frames...",
+    (int)AnalyzationRangeInFrames, (int)NumberOfSampleFrames);
 
-    // assign resampled dest
-    AnalyzationSampleBuffer = std::move(ResampledSampleBuffer);
 
-    // update sample count
-    NumberOfSampleFrames = NewSizeInSamples;
-  }
+  // ... Calc file wide peak, RMS and levels in a single unbuffered pass
 
+  static const float sScaleFactor = M16BitSampleRange / 2.0f;
 
-  // ... Calc RMS 
+  TMonoStreamReader StreamReader(pAudioFile->Stream());
+  TLevelChunkHistogram LevelHistogram;
+
+  TArray<float> CapturedSampleBuffer(CapturedFrames);
+  TArray<float> BlockBuffer(StreamReader.BlockSize());
 
   double RmsValue = 0.0;
-  for (int n = 0; n < NumberOfSampleFrames; ++n)
+  float MaxAbsValue = 0.0f;
+
+  while (StreamReader.Position() < NumberOfSampleFrames)
   {
-    RmsValue += TMathT<double>::Square(AnalyzationSampleBuffer[n] / sScaleFactor);
-  }
+    const long long BlockPosition = StreamReader.Position();
 
-  SampleData.mRmsValue = (float)MMin(1.0,
-    ::sqrt(RmsValue / (NumberOfSampleChannels * NumberOfSampleFrames)));
+    const int FramesToReadInThisBlock = (int)MMin<long long>(
+      BlockBuffer.Size(), NumberOfSampleFrames - BlockPosition);
 
+    StreamReader.Read(BlockBuffer.FirstWrite(), FramesToReadInThisBlock);
 
-  // ... Calc peak and normalization factor
+    const float* pBlockBuffer = BlockBuffer.FirstRead();
+    for (int n = 0; n < FramesToReadInThisBlock; ++n)
+    {
+      const float AbsValue = TMathT<float>::Abs(pBlockBuffer[n]);
 
-  float Min = AnalyzationSampleBuffer[0];
-  float Max = AnalyzationSampleBuffer[0];
+      RmsValue += TMathT<double>::Square(pBlockBuffer[n] / sScaleFactor);
+      MaxAbsValue = MMax(MaxAbsValue, AbsValue);
 
-  TMathT<float>::GetMinMax(Min, Max,
-    0, AnalyzationSampleBuffer.Size(), AnalyzationSampleBuffer.FirstRead());
+      LevelHistogram.AddValue(AbsValue);
+    }
 
-  const double MaxAmplitude = (double)MMax(
-    TMathT<float>::Abs(Min), TMathT<float>::Abs(Max));
+    if (BlockPosition < CapturedFrames)
+    {
+      const int FramesToCapture = MMin(FramesToReadInThisBlock,
+        CapturedFrames - (int)BlockPosition);
+
+      TMemory::Copy(CapturedSampleBuffer.FirstWrite() + BlockPosition,
+        pBlockBuffer, sizeof(float) * FramesToCapture);
+    }
+  }
+
+  LevelHistogram.Finalize();
+
+  SampleData.mRmsValue = (float)MMin(1.0,
+    ::sqrt(RmsValue / NumberOfSampleFrames));
+
+  const double MaxAmplitude = (double)MaxAbsValue;
 
   // assign normalized peak value
   SampleData.mPeakValue = (float)MMin(1.0, MaxAmplitude / sScaleFactor);
@@ -643,87 +1457,145 @@ void TSampleAnalyser::LoadSample(
   }
 
 
-  // ... Check how many leading samples can be skipped
+  // ... Calc file wide effective lengths (with chunk resolution)
 
-  static const double sSilenceFloor = sScaleFactor * 
-    TAudioMath::DbToLin(MSilenceThresholdDb);
+  const TPair<double, double*> EffectiveLengthRuns[] = {
+    MakePair(TAudioMath::DbToLin(-48.0), &SampleData.mEffectiveLength48dB),
+    MakePair(TAudioMath::DbToLin(-24.0), &SampleData.mEffectiveLength24dB),
+    MakePair(TAudioMath::DbToLin(-12.0), &SampleData.mEffectiveLength12dB),
+  };
 
-  int SilentLeadingSamples = 0;
-  for (int f = 0; f < NumberOfSampleFrames; ++f, ++SilentLeadingSamples)
+  for (size_t s = 0; s < MCountOf(EffectiveLengthRuns); ++s) 
   {
-    if (TMathT<double>::Abs(Amplification *
-          AnalyzationSampleBuffer[f]) > sSilenceFloor)
+    // thresholds are relative to the normalized sample
+    const float Threshold = (float)(
+      EffectiveLengthRuns[s].First() * sScaleFactor / Amplification);
+
+    int FirstChunk, LastChunk;
+    if (LevelHistogram.AudibleChunkRange(Threshold, FirstChunk, LastChunk))
     {
-      break;
-    }
-  }
+      const long long StartFrame = 
+        (long long)FirstChunk * TLevelChunkHistogram::kChunkSize;
+      const long long EndFrame = MMin(NumberOfSampleFrames,
+        (long long)(LastChunk + 1) * TLevelChunkHistogram::kChunkSize);
 
-  int SilentTrailingSamples = 0;
-  for (int f = NumberOfSampleFrames - 1; f > SilentLeadingSamples; --f, ++SilentTrailingSamples)
-  {
-    if (TMathT<double>::Abs(Amplification * 
-          AnalyzationSampleBuffer[f]) > sSilenceFloor)
+      *EffectiveLengthRuns[s].Second() = 
+        (double)(EndFrame - StartFrame) / SourceSampleRate;
+    }
+    else
     {
-      break;
+      *EffectiveLengthRuns[s].Second() = 0.0;
     }
   }
 
-  if (SilentLeadingSamples || SilentTrailingSamples)
+
+  // ... Find the audible analyzation range
+
+  const double Speed = (double)SourceSampleRate / (double)mSampleRate;
+
+  const float SilenceThreshold = (float)(sScaleFactor * 
+    TAudioMath::DbToLin(MSilenceThresholdDb) / Amplification);
+
+  long long AudibleStartFrame = NumberOfSampleFrames;
+  long long AudibleEndFrame = NumberOfSampleFrames;
+
+  int FirstAudibleChunk, LastAudibleChunk;
+  if (LevelHistogram.AudibleChunkRange(SilenceThreshold, 
+        FirstAudibleChunk, LastAudibleChunk))
   {
-    TLog::SLog()->AddLine(MLogPrefix,
-      "Skipping %d silent leading and %d trailing samples...", 
-      SilentLeadingSamples, SilentTrailingSamples);
+    AudibleStartFrame = 
+      (long long)FirstAudibleChunk * TLevelChunkHistogram::kChunkSize;
+    AudibleEndFrame = MMin(NumberOfSampleFrames,
+      (long long)(LastAudibleChunk + 1) * TLevelChunkHistogram::kChunkSize);
   }
 
+  // when resampling, start a bit earlier to let the resampler settle in silence
+  const long long PreRollFrames = (Speed != 1.0) ? 
+    TLevelChunkHistogram::kChunkSize : 0;
 
-  // ... Finalize: convert to double, pad and scale
+  const long long RangeStartFrame = MMax(0LL, AudibleStartFrame - PreRollFrames);
+  const long long RangeEndFrame = MMin(NumberOfSampleFrames, 
+    RangeStartFrame + AnalyzationRangeInFrames);
 
-  const int AudibleNumberOfSampleFrames = NumberOfSampleFrames - 
-    SilentLeadingSamples - SilentTrailingSamples;
+  SampleData.mDataIsTruncated = (AudibleEndFrame > RangeEndFrame);
 
-  // make sure we analyze at least half of the last frame
-  int EndFrameOffset = 0;
-  if ((AudibleNumberOfSampleFrames % mFftFrameSize) < mFftFrameSize / 2)
+
+  // ... Fetch sample data of the analyzation range, resampling it (when necessary)
+
+  const int RangeFrames = (int)(RangeEndFrame - RangeStartFrame);
+  const bool Resample = (SourceSampleRate != mSampleRate);
+
+  TArray<float> AnalyzationSampleBuffer;
+
+  if (RangeFrames == 0)
   {
-    EndFrameOffset += mFftFrameSize / 2;
+    // sample is completely silent: nothing to fetch
   }
+  else if (RangeEndFrame <= CapturedFrames)
+  {
+    const float* pRangeBuffer = CapturedSampleBuffer.FirstRead() + RangeStartFrame;
 
-  // and ensure we analyze at least one full frame
-  int StartFrameOffset = 0;
-  if (AudibleNumberOfSampleFrames + EndFrameOffset < mFftFrameSize)
+    if (Resample)
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Resampling from %d Hz to %d Hz...",
+        (int)SourceSampleRate, (int)mSampleRate);
+
+      TResampler Resampler(SourceSampleRate, mSampleRate, mResamplerQuality);
+      SResampleSampleBuffer(pRangeBuffer, RangeFrames, 
+        Resampler, AnalyzationSampleBuffer);
+    }
+    else
+    {
+      AnalyzationSampleBuffer.SetSize(RangeFrames);
+      TMemory::Copy(AnalyzationSampleBuffer.FirstWrite(), pRangeBuffer,
+        sizeof(float) * RangeFrames);
+    }
+  }
+  else
   {
-    StartFrameOffset = mFftFrameSize - AudibleNumberOfSampleFrames - EndFrameOffset;
+    // release memory before reading again
+    CapturedSampleBuffer.Empty();
+
+    if (! StreamReader.SeekTo(RangeStartFrame))
+    {
+      throw TReadableException(MText("Failed to seek to sample frame %s.",
+        ToString((int)RangeStartFrame)));
+    }
+
+    if (Resample)
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Resampling from %d Hz to %d Hz...",
+        (int)SourceSampleRate, (int)mSampleRate);
+
+      TResampler Resampler(SourceSampleRate, mSampleRate, mResamplerQuality);
+      SReadResampledSampleBuffer(StreamReader, RangeFrames, 
+        Resampler, AnalyzationSampleBuffer);
+    }
+    else
+    {
+      AnalyzationSampleBuffer.SetSize(RangeFrames);
+      StreamReader.Read(AnalyzationSampleBuffer.FirstWrite(), RangeFrames);
+    }
   }
-  
-  SampleData.mData.SetSize(AudibleNumberOfSampleFrames + 
-    StartFrameOffset + EndFrameOffset);
-  
-  SampleData.mDataOffset = -SilentLeadingSamples + StartFrameOffset;
 
-  // clear padded start and end
-  double* pSampleBuffer = SampleData.mData.FirstWrite();
 
-  TMemory::Zero(pSampleBuffer,
-    sizeof(double) * StartFrameOffset);
-  TMemory::Zero(pSampleBuffer + SampleData.mData.Size() - EndFrameOffset,
-    sizeof(double) * EndFrameOffset);
+  // ... Trim silence, convert to double, pad and scale
 
-  // fill in the rest with the dest sample data and apply "Amplification"
-  const double FinalScaling = (double)Amplification / sScaleFactor;
+  const int SilentLeadingSamplesOffset = TMath::d2iRound(RangeStartFrame / Speed);
+  const bool TrimTrailingSilence = ! SampleData.mDataIsTruncated;
 
-  for (int n = 0; n < NumberOfSampleFrames - SilentLeadingSamples - SilentTrailingSamples; ++n)
-  {
-    pSampleBuffer[n + StartFrameOffset] =
-      AnalyzationSampleBuffer[n + SilentLeadingSamples] * FinalScaling;
-  }
+  SConvertSampleData(AnalyzationSampleBuffer, Amplification,
+    SilentLeadingSamplesOffset, TrimTrailingSilence, mFftFrameSize,
+    SampleData.mData, SampleData.mDataOffset);
 }
 
 // -------------------------------------------------------------------------------------------------
 
 void TSampleAnalyser::AnalyzeLowLevelDescriptors(
-  const TSampleData&  SampleData, 
-  TSilenceStatus&     SilenceStatus,
-  TSampleDescriptors& Results) const
+  const TSampleData&        SampleData, 
+  const TLowLevelFeatures&  Features,
+  TSilenceStatus&           SilenceStatus,
+  TSampleDescriptors&       Results) const
 {
   MAssert(SampleData.mData.Size() >= mHopFrameSize,
     "Data should be valid and padded here");
@@ -751,7 +1623,17 @@ void TSampleAnalyser::AnalyzeLowLevelDescriptors(
 
   // ... Effective length
 
-  CalcEffectiveLength(Results, SampleData.mData.FirstRead(), SampleData.mData.Size());
+  if (SampleData.mDataIsTruncated)
+  {
+    // mData does not cover the whole file: use precalculated file wide lengths
+    Results.mEffectiveLength48dB.mValue = SampleData.mEffectiveLength48dB;
+    Results.mEffectiveLength24dB.mValue = SampleData.mEffectiveLength24dB;
+    Results.mEffectiveLength12dB.mValue = SampleData.mEffectiveLength12dB;
+  }
+  else
+  {
+    CalcEffectiveLength(Results, SampleData.mData.FirstRead(), SampleData.mData.Size());
+  }
 
 
   // ... Spectral features
@@ -763,55 +1645,57 @@ void TSampleAnalyser::AnalyzeLowLevelDescriptors(
   const int SampleDataAnalyzationLength = MMin(MaxAnalyzationTimeInSamples,
     SampleData.mData.Size());
 
+  const int NumberOfSpectrumFrames = (SampleDataAnalyzationLength >= mFftFrameSize) ?
+    (SampleDataAnalyzationLength - mFftFrameSize) / mHopFrameSize + 1 : 0;
+
   #if defined(MWritePgmSpectrum)
     std::vector<double> PmgSpectrum;
   #endif
 
-  TArray<double> WindowedSampleFrame(mFftFrameSize);
-  WindowedSampleFrame.Init(0.0);
-
-  TArray<double> MagnitudeSpectrum(mFftFrameSize);
-  MagnitudeSpectrum.Init(0.0);
-  TArray<double> LastMagnitudeSpectrum(mFftFrameSize);
-  LastMagnitudeSpectrum.Init(0.0);
-
-  TArray<double> WhitenedSpectrum(mFftFrameSize);
-  WhitenedSpectrum.Init(0.0);
-
-  TArray<double> PeakSpectrum(mFftFrameSize);
-  PeakSpectrum.Init(0.0);
-
-  TArray<double> HarmonicSpectrum(mFftFrameSize);
-  HarmonicSpectrum.Init(0.0);
-
   // init silence state
   SilenceStatus.mSpectrumFrameIsAudible.Empty();
   SilenceStatus.mSpectrumFrameIsAudible.PreallocateSpace(
     SampleDataAnalyzationLength / mHopFrameSize);
 
-  // init fft transform
-  TFftTransformComplex FftTransform;
-  const bool HighQuality = true;
-  FftTransform.Initialize(mFftFrameSize, HighQuality, 
-    TFftTransformComplex::kDivFwdByN);
+  // reuse this thread's FFT, trackers and spectrum buffers
+  TSampleAnalysisWorkspace& Workspace = *mWorkspaces.Object();
+  Workspace.Reset(mSampleRate, mFftFrameSize, mHopFrameSize);
+
+  TArray<double>& MagnitudeSpectrum = Workspace.mMagnitudeSpectrum;
+  TArray<double>& LastMagnitudeSpectrum = Workspace.mLastMagnitudeSpectrum;
+  TArray<double>& WhitenedSpectrum = Workspace.mWhitenedSpectrum;
+  TArray<double>& PeakSpectrum = Workspace.mPeakSpectrum;
+  TArray<double>& HarmonicSpectrum = Workspace.mHarmonicSpectrum;
 
   // init Aubio pitch tracker
-  aubio_pitch_t* pAubioPitchTracker = ::new_aubio_pitch(MPitchDetectionAlgorithm,
-    mFftFrameSize, mHopFrameSize, mSampleRate);
-  ::aubio_pitch_set_tolerance(pAubioPitchTracker, MPitchTolerance);
-  ::aubio_pitch_set_silence(pAubioPitchTracker, MSilenceThresholdDb);
-  ::aubio_pitch_set_unit(pAubioPitchTracker, "freq");
+  aubio_pitch_t* pAubioPitchTracker = Workspace.PitchTracker(
+    MPitchDetectionAlgorithm, MPitchTolerance, MSilenceThresholdDb);
 
   // init Aubio spectral whitening
   aubio_spectral_whitening_t* pAubioSpectralWhitening =
-    ::new_aubio_spectral_whitening(mFftFrameSize, mHopFrameSize, mSampleRate);
-  ::aubio_spectral_whitening_set_relax_time(
-    pAubioSpectralWhitening, MSpectralWhiteningDecay);
+    Workspace.SpectralWhitening(MSpectralWhiteningDecay);
 
   // ignore FPU exceptions from aubio and libXtract
   M__DisableFloatingPointAssertions
 
-  for (int n = 0; (n + mFftFrameSize - 1) < SampleDataAnalyzationLength; n += mHopFrameSize)
+  // calc features which don't depend on previous frame states in parallel when 
+  // possible. Else calc them along with the stateful features below.
+  const int NumberOfFrameAnalysisThreads = (mParallelFrameAnalysis) ?
+    SParallelFrameAnalysisThreadCount(NumberOfSpectrumFrames) : 1;
+
+  const bool CalcIndependentFeaturesInParallel = (NumberOfFrameAnalysisThreads > 1);
+  if (CalcIndependentFeaturesInParallel)
+  {
+    CalcIndependentFrameFeaturesInParallel(Features, Results, SampleData,
+      NumberOfSpectrumFrames, NumberOfFrameAnalysisThreads);
+  }
+
+  // whitened peak spectrum is needed for complexity, inharmonicity and harmonic spectrum
+  const bool CalcPeakSpectrum = Features.mSpectralComplexity || 
+    Features.mSpectralInharmonicity || Features.mFailSafePitch;
+
+  for (int n = 0, FrameIndex = 0; (n + mFftFrameSize - 1) < SampleDataAnalyzationLength; 
+        n += mHopFrameSize, ++FrameIndex)
   {
     // fvec_t input for aubio 
     fvec_t SampleInputHopSize;
@@ -822,60 +1706,39 @@ void TSampleAnalyser::AnalyzeLowLevelDescriptors(
     SampleInputFrameSize.length = mFftFrameSize;
     SampleInputFrameSize.data = SampleData.mData.FirstWrite() + n;
 
-    // Apply window to sample frame
-    ::xtract_windowed(SampleData.mData.FirstRead() + n,
-      mFftFrameSize, mpWindow, WindowedSampleFrame.FirstWrite());
+    // Magnitude spectrum of the windowed input
+    CalcMagnitudeSpectrum(Workspace, SampleData.mData.FirstRead() + n,
+      MagnitudeSpectrum);
 
-    // Apply FFT on windowed input
+    if (CalcPeakSpectrum)
     {
-      TAudioMath::CopyBuffer(WindowedSampleFrame.FirstRead(),
-        FftTransform.Re(), mFftFrameSize);
-      TAudioMath::ClearBuffer(FftTransform.Im(), mFftFrameSize);
-
-      FftTransform.ForwardInplace();
-
-      TAudioMath::Magnitude(FftTransform.Re(), FftTransform.Im(), 
-        MagnitudeSpectrum.FirstWrite(), mFftFrameSize / 2);
-
-      #if 0 // phase is currently not used: avoid wasting processing time
-        TAudioMath::Phase(FftTransform.Re(), FftTransform.Im(),
-          MagnitudeSpectrum.FirstWrite() + mFftFrameSize / 2, mFftFrameSize / 2);
-      #else
-        TAudioMath::ClearBuffer(
-          MagnitudeSpectrum.FirstWrite() + mFftFrameSize / 2, mFftFrameSize / 2);
-      #endif
-    }
+      // Whitened spectrum 
+      {
+        cvec_t WhitenedFftgrain;
+        WhitenedFftgrain.length = mFftFrameSize / 2;
+        WhitenedFftgrain.norm = WhitenedSpectrum.FirstWrite();
+        WhitenedFftgrain.phas = NULL; // unused
 
-    // Whitened spectrum 
-    {
-      cvec_t WhitenedFftgrain;
-      WhitenedFftgrain.length = mFftFrameSize / 2;
-      WhitenedFftgrain.norm = WhitenedSpectrum.FirstWrite();
-      WhitenedFftgrain.phas = NULL; // unused
+        WhitenedSpectrum = MagnitudeSpectrum;
+        ::aubio_spectral_whitening_do(pAubioSpectralWhitening, &WhitenedFftgrain);
+      }
 
-      WhitenedSpectrum = MagnitudeSpectrum;
-      ::aubio_spectral_whitening_do(pAubioSpectralWhitening, &WhitenedFftgrain);
+      // Peak spectrum (from whitened spectrum)
+      SCreatePeakSpectrum(WhitenedSpectrum,
+        PeakSpectrum, Workspace.mPeaks, mFftFrameSize / 2, MPeakThreshold);
     }
 
-    // Peak spectrum (from whitened spectrum)
-    SCreatePeakSpectrum(WhitenedSpectrum,
-      PeakSpectrum, mFftFrameSize / 2, MPeakThreshold);
-
     // Silence detection
     const bool IsSilentFrame =
       (::aubio_silence_detection(&SampleInputHopSize, MSilenceThresholdDb) == 1);
     SilenceStatus.mSpectrumFrameIsAudible.Append(!IsSilentFrame);
     Results.mAmplitudeSilence.mValues.Append(IsSilentFrame ? 1.0 : 0.0);
 
-    // Amplitude Peak and RMS
-    CalcAmplitudePeak(Results, SampleInputHopSize.data, SampleInputHopSize.length);
-    CalcAmplitudeRms(Results, SampleInputHopSize.data, SampleInputHopSize.length);
-    CalcAmplitudeEnvelope(Results, SampleInputHopSize.data, SampleInputHopSize.length);
-
     // F0 (fundamental frequency)
     double F0 = 0.0;
     double F0Confidence = 0.0;
     double F0FailSafe = 0.0;
+    if (Features.mPitch)
     {
       fvec_t PitchOut;
       PitchOut.length = 1;
@@ -893,7 +1756,10 @@ void TSampleAnalyser::AnalyzeLowLevelDescriptors(
 
       Results.mF0.mValues.Append(F0);
       Results.mF0Confidence.mValues.Append(F0Confidence);
+    }
 
+    if (Features.mFailSafePitch)
+    {
       if (F0 > 0.0 && F0Confidence > MLowPitchConfidenceValue)
       {
         // low confident F0 by default
@@ -917,6 +1783,7 @@ void TSampleAnalyser::AnalyzeLowLevelDescriptors(
     }
 
     // Harmonic spectrum  (from whitened peak spectrum & F0)
+    if (Features.mFailSafePitch)
     {
       double Arguments[4] = { 0 };
       Arguments[0] = F0FailSafe;
@@ -939,112 +1806,107 @@ void TSampleAnalyser::AnalyzeLowLevelDescriptors(
       LastMagnitudeSpectrum = MagnitudeSpectrum;
     }
 
-    // Autocorrelation
-    const int RemainingSamples = SampleData.mData.Size() - n;
-    CalcAutoCorrelation(Results, SampleData.mData.FirstRead() + n, RemainingSamples);
-
-    // Spectral RMS
-    CalcSpectralRms(Results, MagnitudeSpectrum);
-    // Spectral Centroid & Spread
-    CalcSpectralCentroidAndSpread(Results, MagnitudeSpectrum);
-    // Spectral Skewness and Kurtosis
-    CalcSpectralSkewnessAndKurtosis(Results, MagnitudeSpectrum);
-    // Spectral Rolloff
-    CalcSpectralRolloff(Results, MagnitudeSpectrum);
-    // Spectral Flatness
-    CalcSpectralFlatness(Results, MagnitudeSpectrum);
-    // Spectral Flux
-    CalcSpectralFlux(Results, MagnitudeSpectrum, LastMagnitudeSpectrum);
+    // Amplitude, autocorrelation, spectral and band features
+    if (!CalcIndependentFeaturesInParallel)
+    {
+      const int RemainingSamples = SampleData.mData.Size() - n;
+      CalcIndependentFrameFeatures(Workspace, Features, Results, FrameIndex,
+        SampleData.mData.FirstRead() + n, RemainingSamples, 
+        MagnitudeSpectrum, LastMagnitudeSpectrum);
+    }
 
     // Spectral Complexity
-    CalcSpectralComplexity(Results, PeakSpectrum); // Yup, peaks
+    if (Features.mSpectralComplexity)
+    {
+      CalcSpectralComplexity(Results, PeakSpectrum); // Yup, peaks
+    }
     // Spectral Inharmonicity
-    CalcSpectralInharmonicity(Results, PeakSpectrum, F0FailSafe, F0Confidence); // Yup, peaks
+    if (Features.mSpectralInharmonicity)
+    {
+      CalcSpectralInharmonicity(Results, PeakSpectrum, F0FailSafe, F0Confidence); // Yup, peaks
+    }
     // Tristimulus
-    CalcTristimulus(Results, HarmonicSpectrum, F0FailSafe, F0Confidence); // Yup, harmonics
-
-    // Spectral RMS, flux and contrast band features
-    CalcSpectralBandFeatures(Results, MagnitudeSpectrum, LastMagnitudeSpectrum);
-
-    // Spectrum Bands
-    CalcSpectrumBands(Results, MagnitudeSpectrum);
-    // Cepstrum Bands
-    CalcCepstrumBands(Results, MagnitudeSpectrum);
+    if (Features.mTristimulus)
+    {
+      CalcTristimulus(Results, HarmonicSpectrum, F0FailSafe, F0Confidence); // Yup, harmonics
+    }
 
-    // memorize last spectrum
-    LastMagnitudeSpectrum = MagnitudeSpectrum;
+    // memorize last spectrum: swap buffers, as the next frame overwrites the spectrum
+    std::swap(LastMagnitudeSpectrum, MagnitudeSpectrum);
   }
 
-  // cleanup
-  ::del_aubio_pitch(pAubioPitchTracker);
-  ::del_aubio_spectral_whitening(pAubioSpectralWhitening);
-
 
   // ... Rhythm features (with smaller FFT and hop sizes)
 
-  const int TempoFftSize = 512;
-  const int TempoHopSize = 128;
-
-  // init rhythm tracker
-  TRhythmTracker RhythmTracker(mSampleRate, TempoFftSize, TempoHopSize);
-
-  for (int n = 0; (n + TempoFftSize - 1) < SampleDataAnalyzationLength; n += TempoHopSize)
-  {
-    fvec_t SampleInput;
-    SampleInput.length = TempoFftSize;
-    SampleInput.data = SampleData.mData.FirstWrite() + n;
-
-    RhythmTracker.ProcessFrame(&SampleInput);
-  }
-
-  // add ryhthm stats
-  const double SampleDurationInSeconds = TAudioMath::SamplesToMs(
-    SampleData.mOriginalSampleRate, SampleData.mOriginalNumberOfSamples) / 1000;
-  const double OnsetOffsetInSeconds = TAudioMath::SamplesToMs(
-    SampleData.mOriginalSampleRate, SampleData.mDataOffset) / 1000;
-
-  Results.mRhythmComplexOnsets.mValues = RhythmTracker.Onsets(TRhythmTracker::kComplex);
-  Results.mRhythmComplexOnsetCount.mValue = RhythmTracker.OnsetCount(TRhythmTracker::kComplex);
-  Results.mRhythmComplexTempo.mValue = RhythmTracker.CalculateTempo(
-    Results.mRhythmComplexTempoConfidence.mValue, TRhythmTracker::kComplex);
-  Results.mRhythmComplexOnsetFrequencyMean.mValue = 
-    RhythmTracker.CalculateRhythmFrequencyMean(TRhythmTracker::kComplex);
-  Results.mRhythmComplexOnsetStrength.mValue = 
-    RhythmTracker.CalculateRhythmStrength(TRhythmTracker::kComplex);
-  Results.mRhythmComplexOnsetContrast.mValue = 
-    RhythmTracker.CalculateRhythmContrast(TRhythmTracker::kComplex);
-
-  Results.mRhythmPercussiveOnsets.mValues = RhythmTracker.Onsets(TRhythmTracker::kPercussive);
-  Results.mRhythmPercussiveOnsetCount.mValue = RhythmTracker.OnsetCount(TRhythmTracker::kPercussive);
-  Results.mRhythmPercussiveTempo.mValue = RhythmTracker.CalculateTempo(
-    Results.mRhythmPercussiveTempoConfidence.mValue, TRhythmTracker::kPercussive);
-  Results.mRhythmPercussiveOnsetFrequencyMean.mValue = 
-    RhythmTracker.CalculateRhythmFrequencyMean(TRhythmTracker::kPercussive);
-  Results.mRhythmPercussiveOnsetStrength.mValue = 
-    RhythmTracker.CalculateRhythmStrength(TRhythmTracker::kPercussive);
-  Results.mRhythmPercussiveOnsetContrast.mValue = 
-    RhythmTracker.CalculateRhythmContrast(TRhythmTracker::kPercussive);
-
-  // calculate "final" tempo from the one which seems more confident
-  if (Results.mRhythmPercussiveTempoConfidence.mValue > Results.mRhythmComplexTempoConfidence.mValue) 
-  {
-    Results.mRhythmFinalTempo.mValue = RhythmTracker.CalculateTempoWithHeuristics(
-      Results.mRhythmFinalTempoConfidence.mValue, // out
-      Results.mRhythmPercussiveTempo.mValue, // in
-      Results.mRhythmPercussiveTempoConfidence.mValue, // in
-      SampleDurationInSeconds, 
-      OnsetOffsetInSeconds,
-      TRhythmTracker::kPercussive);
-  }
-  else 
+  if (Features.mRhythm)
   {
-    Results.mRhythmFinalTempo.mValue = RhythmTracker.CalculateTempoWithHeuristics(
-      Results.mRhythmFinalTempoConfidence.mValue, // out
-      Results.mRhythmComplexTempo.mValue, // in
-      Results.mRhythmComplexTempoConfidence.mValue, // in
-      SampleDurationInSeconds, 
-      OnsetOffsetInSeconds,
-      TRhythmTracker::kComplex);
+    const int TempoFftSize = 512;
+    const int TempoHopSize = 128;
+
+    // init rhythm tracker
+    TRhythmTracker& RhythmTracker = Workspace.RhythmTracker(TempoFftSize, TempoHopSize);
+
+    for (int n = 0; (n + TempoFftSize - 1) < SampleDataAnalyzationLength; n += TempoHopSize)
+    {
+      fvec_t SampleInput;
+      SampleInput.length = TempoFftSize;
+      SampleInput.data = SampleData.mData.FirstWrite() + n;
+
+      RhythmTracker.ProcessFrame(&SampleInput);
+    }
+
+    // add ryhthm stats
+    const double SampleDurationInSeconds = TAudioMath::SamplesToMs(
+      SampleData.mOriginalSampleRate, SampleData.mOriginalNumberOfSamples) / 1000;
+    const double OnsetOffsetInSeconds = TAudioMath::SamplesToMs(
+      SampleData.mOriginalSampleRate, SampleData.mDataOffset) / 1000;
+
+    Results.mRhythmComplexOnsets.mValues = RhythmTracker.Onsets(TRhythmTracker::kComplex);
+    Results.mRhythmComplexOnsetCount.mValue = RhythmTracker.OnsetCount(TRhythmTracker::kComplex);
+    Results.mRhythmComplexTempo.mValue = RhythmTracker.CalculateTempo(
+      Results.mRhythmComplexTempoConfidence.mValue, TRhythmTracker::kComplex);
+    Results.mRhythmComplexOnsetFrequencyMean.mValue = 
+      RhythmTracker.CalculateRhythmFrequencyMean(TRhythmTracker::kComplex);
+    Results.mRhythmComplexOnsetStrength.mValue = 
+      RhythmTracker.CalculateRhythmStrength(TRhythmTracker::kComplex);
+    Results.mRhythmComplexOnsetContrast.mValue = 
+      RhythmTracker.CalculateRhythmContrast(TRhythmTracker::kComplex);
+
+    Results.mRhythmPercussiveOnsets.mValues = RhythmTracker.Onsets(TRhythmTracker::kPercussive);
+    Results.mRhythmPercussiveOnsetCount.mValue = RhythmTracker.OnsetCount(TRhythmTracker::kPercussive);
+    Results.mRhythmPercussiveTempo.mValue = RhythmTracker.CalculateTempo(
+      Results.mRhythmPercussiveTempoConfidence.mValue, TRhythmTracker::kPercussive);
+    Results.mRhythmPercussiveOnsetFrequencyMean.mValue = 
+      RhythmTracker.CalculateRhythmFrequencyMean(TRhythmTracker::kPercussive);
+    Results.mRhythmPercussiveOnsetStrength.mValue = 
+      RhythmTracker.CalculateRhythmStrength(TRhythmTracker::kPercussive);
+    Results.mRhythmPercussiveOnsetContrast.mValue = 
+      RhythmTracker.CalculateRhythmContrast(TRhythmTracker::kPercussive);
+
+    if (Features.mRhythmFinalTempo)
+    {
+      // calculate "final" tempo from the one which seems more confident
+      if (Results.mRhythmPercussiveTempoConfidence.mValue > Results.mRhythmComplexTempoConfidence.mValue) 
+      {
+        Results.mRhythmFinalTempo.mValue = RhythmTracker.CalculateTempoWithHeuristics(
+          Results.mRhythmFinalTempoConfidence.mValue, // out
+          Results.mRhythmPercussiveTempo.mValue, // in
+          Results.mRhythmPercussiveTempoConfidence.mValue, // in
+          SampleDurationInSeconds, 
+          OnsetOffsetInSeconds,
+          TRhythmTracker::kPercussive);
+      }
+      else 
+      {
+        Results.mRhythmFinalTempo.mValue = RhythmTracker.CalculateTempoWithHeuristics(
+          Results.mRhythmFinalTempoConfidence.mValue, // out
+          Results.mRhythmComplexTempo.mValue, // in
+          Results.mRhythmComplexTempoConfidence.mValue, // in
+          SampleDurationInSeconds, 
+          OnsetOffsetInSeconds,
+          TRhythmTracker::kComplex);
+      }
+    }
   }
 
 
@@ -1072,165 +1934,6 @@ void TSampleAnalyser::AnalyzeHighLevelDescriptors(
   TSilenceStatus&     SilenceStatus,
   TSampleDescriptors& Results) const
 {
-  // extract classification features
-  const TSampleClassificationDescriptors ModelDescriptors(Results);
-
-
-  // ... Classes
-
-  if (mpClassificationModel)
-  {
-    // create single test item 
-    const TClassificationTestDataItem ClassificationTestItem(
-      ModelDescriptors,
-      *mpClassificationModel->Normalizer(),
-      mpClassificationModel->OutlierLimits());
-
-    // . Evaluate model
-    
-    TList<float> ClassificationWeights =
-      mpClassificationModel->Evaluate(ClassificationTestItem);
-
-    
-    // . ClassSignature
-
-    Results.mClassSignature.mValues = ClassificationWeights;
-
-
-    // . Class & ClassStrengths
-
-    const double MinWeight = 0.0; // include all
-    Results.mClassStrengths.mValues = TClassificationTools::CategoryStrengths(
-      Results.mClassSignature.mValues, MinWeight);
-
-
-    // . Apply Heuristics
-
-    MAssert(mpClassificationModel->OutputClasses() == std::vector<TString>({"Loop", "OneShot"}), 
-      "Expecting a OneShotVsLoop model as 'mpClassificationModel' here");
-
-    #if defined(MUseClassificationHeuristics)
-      if (mpClassificationModel->OutputClasses() == std::vector<TString>({"Loop", "OneShot"})) 
-      {
-        static const int kLoopClassIndex = 0;
-        static const int kOneShotClassIndex = 1;
-
-        double IsOneShotConfidence = -1.0;
-        double IsLoopConfidence = -1.0;
-
-        if (TClassificationHeuristics::IsOneShot(Results, IsOneShotConfidence)) 
-        {
-          if (Results.mClassStrengths.mValues[kLoopClassIndex] > 
-                Results.mClassStrengths.mValues[kOneShotClassIndex]) 
-          {
-            TLog::SLog()->AddLine(MLogPrefix, 
-              "NB: Overriding model's 'IsOneShot' result with heuristics (confidence: %g)",
-              IsOneShotConfidence);
-
-            Results.mClassStrengths.mValues[kLoopClassIndex] = MMin(IsOneShotConfidence / 2,
-              Results.mClassStrengths.mValues[kLoopClassIndex]);
-            Results.mClassStrengths.mValues[kOneShotClassIndex] = IsOneShotConfidence;
-          }
-        }
-        else if (TClassificationHeuristics::IsLoop(Results, IsLoopConfidence))
-        {
-          if (Results.mClassStrengths.mValues[kLoopClassIndex] < 
-                Results.mClassStrengths.mValues[kOneShotClassIndex]) 
-          {
-            TLog::SLog()->AddLine(MLogPrefix, 
-              "NB: Overriding model's 'IsLoop' result with heuristics (confidence: %g)",
-              IsLoopConfidence);
-
-            Results.mClassStrengths.mValues[kLoopClassIndex] = IsLoopConfidence;
-            Results.mClassStrengths.mValues[kOneShotClassIndex] = MMin(IsLoopConfidence / 2, 
-              Results.mClassStrengths.mValues[kOneShotClassIndex]);
-          }
-        }
-      }
-    #endif
-
-
-    // . Class List
-
-    // collect class list from class strength
-    const double MinDefaultWeight = 0.2;
-    const double MinFallbackWeight = 0.01;
-    Results.mClasses.mValues = TClassificationTools::PickAllStrongCategories(
-      mpClassificationModel->OutputClasses(),
-      Results.mClassStrengths.mValues,
-      MinDefaultWeight,
-      MinFallbackWeight);
-  }
-  else // ! mpClassificationModel
-  {
-    Results.mClassSignature.mValues.Empty();
-    Results.mClasses.mValues = TList<TString>();
-    Results.mClassStrengths.mValues.Empty();
-  }
-
-
-  // ... One-Shot Categories
-
-  // NB: also for loops - we're using the categories for general similarity checks
-
-  if (mpOneShotCategorizationModel)
-  {
-    // . CategoryWeights
-
-    // create single test item 
-    const TClassificationTestDataItem CategorizationTestItem(
-      ModelDescriptors,
-      *mpOneShotCategorizationModel->Normalizer(),
-      mpOneShotCategorizationModel->OutlierLimits());
-
-    // evaluate item with the model
-    const TList<float> CategoryWeights =
-      mpOneShotCategorizationModel->Evaluate(CategorizationTestItem);
-
-    Results.mCategorySignature.mValues = CategoryWeights;
-
-    // . Categories & CategoryStrengths (for OneShots only)
-
-    if (!Results.mClasses.mValues.IsEmpty() &&
-        !Results.mClasses.mValues.Contains("OneShot") &&
-        !Results.mClasses.mValues.Contains("Loop"))
-    {
-      throw TReadableException("Unexpected classification model class: "
-        "expecting 'OneShot' or 'Loop' for now...");
-    }
-
-    if (Results.mClasses.mValues.IsEmpty() ||
-        Results.mClasses.mValues.Contains("OneShot"))
-    {
-      // calculate relative strength from absolute weights
-      const double MinWeight = 0.0; // include all
-      Results.mCategoryStrengths.mValues = TClassificationTools::CategoryStrengths(
-        Results.mCategorySignature.mValues, MinWeight);
-      
-      // collect category list from relative strength
-      const double MinDefaultWeight = 0.2;
-      const double MinFallbackWeight = 0.01;
-      Results.mCategories.mValues = TClassificationTools::PickAllStrongCategories(
-        mpOneShotCategorizationModel->OutputClasses(),
-        Results.mCategoryStrengths.mValues,
-        MinDefaultWeight,
-        MinFallbackWeight);
-    }
-    else // Results.mClass.mValue == "Loop"
-    {
-      // NB: keep mCategorySignature - it's used by the general similarity aspect
-      Results.mCategoryStrengths.mValues.Init(0.0);
-      Results.mCategories.mValues = TList<TString>();
-    }
-  }
-  else // ! mpOneShotCategorizationModel
-  {
-    Results.mCategorySignature.mValues.Empty();
-    Results.mCategoryStrengths.mValues.Empty();
-    Results.mCategories.mValues = TList<TString>();
-  }
-
-
   // ... BaseNote 
 
   auto IsHighConfidentPitch = [=] (double PitchHzValue, double PitchConfidence) {
@@ -1646,68 +2349,366 @@ void TSampleAnalyser::AnalyzeHighLevelDescriptors(
           gTraceVar(">>>>> Wrong BPM %d: %.2f -> %.2f ", sNumberOfWrongBpms + 1,
             FileBpm, Results.mHighLevelBpm.mValue);
 
-          ++sNumberOfWrongBpms;
-        }
-      }
+          ++sNumberOfWrongBpms;
+        }
+      }
+    }
+  #endif
+
+  
+  // trace wrong root keys - assumes that files are in a sub folder which denotes the root key
+  #if defined(MDebugTracePitch)
+    static int sNumberOfWrongPitches = 0;
+    static std::vector<double> sPitchOffsets;
+
+    static std::vector<double> sPitchStdDevs;
+
+    static std::map<std::string, int> sRootKeysMap = {
+      { "c", 0 }, { "c#", 1 }, { "d", 2}, { "d#", 3}, { "e", 4 }, { "f", 5 }, 
+      { "f#", 6 }, { "g", 7 }, { "g#", 8 }, { "a", 9 }, { "a#", 10 }, { "b", 11 }
+    };
+
+    const TDirectory FullPath = gExtractPath(SampleData.mOriginalFileName);
+    const TString Filename = gCutPath(SampleData.mOriginalFileName);
+
+    const TString RootKeyFolderName = FullPath.ParentDirCount() > 0 ?
+      FullPath.SplitPathComponents().Last() : "";
+
+    sPitchStdDevs.push_back(TStatistics::StandardDeviation(
+      Results.mHighLevelPitch.mValues.FirstRead(),
+      Results.mHighLevelPitch.mValues.Size()));
+
+    const double TotalPitchStdDevMean = TStatistics::Mean(
+      sPitchStdDevs.data(), (int)sPitchStdDevs.size());
+
+    gTraceVar("> Total pitch stddev mean: %.2f", TotalPitchStdDevMean);
+
+    auto Iter = sRootKeysMap.find(TString(RootKeyFolderName).ToLower().StdCString());
+    if (Iter != sRootKeysMap.end())
+    {
+      const float ExpectedRootKey = (float)Iter->second;
+      const float DetectedRootKey = (float)::fmod(Results.mHighLevelBaseNote.mValue, 12.0);
+
+      const float Min = MMin(DetectedRootKey, ExpectedRootKey);
+      const float Max = MMax(DetectedRootKey, ExpectedRootKey);
+
+      const float Distance = MMin(Max - Min, (Min + 12.0f) - Max); // wrap around edges (> 12)
+      sPitchOffsets.push_back(Distance);
+
+      if (Distance > 0.5f) // > 0.5f results into a wrong displayed root key, ignoring cents
+      {
+        const float PitchDistanceMean = (float)TStatistics::Mean(
+          sPitchOffsets.data(), (int)sPitchOffsets.size());
+
+        gTraceVar(">>>>> Wrong Detected Root-Key #%d: %.2f -> %.2f - total distance mean: %.2f",
+          sNumberOfWrongPitches + 1, DetectedRootKey, ExpectedRootKey, PitchDistanceMean);
+
+        ++sNumberOfWrongPitches;
+      }
+    }
+    else
+    {
+      MInvalid("");
+    }
+  #endif
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TList<TString> TSampleAnalyser::Classify(const TList<TSampleDescriptors*>& Results) const
+{
+  const int NumberOfRows = Results.Size();
+
+  TList<TString> Errors;
+  Errors.PreallocateSpace(NumberOfRows);
+  for (int Row = 0; Row < NumberOfRows; ++Row)
+  {
+    Errors.Append(TString());
+  }
+
+  if (NumberOfRows == 0)
+  {
+    return Errors;
+  }
+
+  // extract classification features of all valid results, row after row. 
+  // rows with invalid features (NAN or INF values) fail on their own.
+  std::vector<double> FeatureRows;
+  TList<int> ValidRows;
+
+  if (mpClassificationModel || mpOneShotCategorizationModel)
+  {
+    size_t NumberOfFeatures = 0;
+    for (int Row = 0; Row < NumberOfRows; ++Row)
+    {
+      try
+      {
+        const TSampleClassificationDescriptors ModelDescriptors(*Results[Row]);
+
+        if (ValidRows.IsEmpty())
+        {
+          NumberOfFeatures = ModelDescriptors.mFeatures.size();
+          FeatureRows.reserve(NumberOfRows * NumberOfFeatures);
+        }
+        else if (ModelDescriptors.mFeatures.size() != NumberOfFeatures)
+        {
+          throw TReadableException("Unexpected number of classification features");
+        }
+
+        FeatureRows.insert(FeatureRows.end(), 
+          ModelDescriptors.mFeatures.begin(), ModelDescriptors.mFeatures.end());
+        ValidRows.Append(Row);
+      }
+      catch (const std::exception& Exception)
+      {
+        Errors[Row] = Exception.what();
+      }
+    }
+  }
+
+
+  // ... Classes
+
+  if (mpClassificationModel)
+  {
+    const TList< TList<float> > ClassificationWeights = EvaluateFeatureRows(
+      mpClassificationModel, FeatureRows, ValidRows, Errors);
+
+    for (int i = 0; i < ValidRows.Size(); ++i)
+    {
+      if (Errors[ValidRows[i]].IsEmpty())
+      {
+        ApplyClassificationWeights(*Results[ValidRows[i]], ClassificationWeights[i]);
+      }
+    }
+  }
+  else // ! mpClassificationModel
+  {
+    for (int Row = 0; Row < NumberOfRows; ++Row)
+    {
+      Results[Row]->mClassSignature.mValues.Empty();
+      Results[Row]->mClasses.mValues = TList<TString>();
+      Results[Row]->mClassStrengths.mValues.Empty();
+    }
+  }
+
+
+  // ... One-Shot Categories
+
+  // NB: also for loops - we're using the categories for general similarity checks
+
+  if (mpOneShotCategorizationModel)
+  {
+    const TList< TList<float> > CategoryWeights = EvaluateFeatureRows(
+      mpOneShotCategorizationModel, FeatureRows, ValidRows, Errors);
+
+    for (int i = 0; i < ValidRows.Size(); ++i)
+    {
+      if (Errors[ValidRows[i]].IsEmpty())
+      {
+        ApplyCategorizationWeights(*Results[ValidRows[i]], CategoryWeights[i]);
+      }
+    }
+  }
+  else // ! mpOneShotCategorizationModel
+  {
+    for (int Row = 0; Row < NumberOfRows; ++Row)
+    {
+      Results[Row]->mCategorySignature.mValues.Empty();
+      Results[Row]->mCategoryStrengths.mValues.Empty();
+      Results[Row]->mCategories.mValues = TList<TString>();
+    }
+  }
+
+  return Errors;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalyser::Classify(TSampleDescriptors& Results) const
+{
+  const TList<TString> Errors = Classify(MakeList(&Results));
+
+  if (!Errors[0].IsEmpty())
+  {
+    throw TReadableException(Errors[0]);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TList< TList<float> > TSampleAnalyser::EvaluateFeatureRows(
+  const TClassificationModel*  pModel,
+  const std::vector<double>&   FeatureRows,
+  const TList<int>&            Rows,
+  TList<TString>&              Errors) const
+{
+  const int NumberOfRows = Rows.Size();
+  if (NumberOfRows == 0)
+  {
+    return TList< TList<float> >();
+  }
+
+  // evaluate all rows at once
+  try
+  {
+    std::vector<double> NormalizedFeatureRows = FeatureRows;
+    pModel->NormalizeFeatureRows(NormalizedFeatureRows, NumberOfRows);
+
+    return pModel->EvaluateFeatureRows(NormalizedFeatureRows, NumberOfRows);
+  }
+  catch (const std::exception& Exception)
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Failed to classify %d samples at once - '%s'. "
+      "Evaluating samples one by one...", NumberOfRows, Exception.what());
+  }
+
+  // evaluate row by row, so only the failing rows fail
+  const size_t NumberOfFeatures = FeatureRows.size() / NumberOfRows;
+
+  TList< TList<float> > Weights;
+  Weights.PreallocateSpace(NumberOfRows);
+
+  for (int i = 0; i < NumberOfRows; ++i)
+  {
+    try
+    {
+      std::vector<double> NormalizedFeatures(
+        FeatureRows.begin() + i * NumberOfFeatures, 
+        FeatureRows.begin() + (i + 1) * NumberOfFeatures);
+      pModel->NormalizeFeatures(NormalizedFeatures);
+
+      Weights.Append(pModel->EvaluateFeatures(NormalizedFeatures));
     }
-  #endif
+    catch (const std::exception& Exception)
+    {
+      Errors[Rows[i]] = Exception.what();
+      Weights.Append(TList<float>());
+    }
+  }
 
-  
-  // trace wrong root keys - assumes that files are in a sub folder which denotes the root key
-  #if defined(MDebugTracePitch)
-    static int sNumberOfWrongPitches = 0;
-    static std::vector<double> sPitchOffsets;
+  return Weights;
+}
 
-    static std::vector<double> sPitchStdDevs;
+// -------------------------------------------------------------------------------------------------
 
-    static std::map<std::string, int> sRootKeysMap = {
-      { "c", 0 }, { "c#", 1 }, { "d", 2}, { "d#", 3}, { "e", 4 }, { "f", 5 }, 
-      { "f#", 6 }, { "g", 7 }, { "g#", 8 }, { "a", 9 }, { "a#", 10 }, { "b", 11 }
-    };
+void TSampleAnalyser::ApplyClassificationWeights(
+  TSampleDescriptors& Results,
+  const TList<float>& ClassificationWeights) const
+{
+  // . ClassSignature
 
-    const TDirectory FullPath = gExtractPath(SampleData.mOriginalFileName);
-    const TString Filename = gCutPath(SampleData.mOriginalFileName);
+  Results.mClassSignature.mValues = ClassificationWeights;
 
-    const TString RootKeyFolderName = FullPath.ParentDirCount() > 0 ?
-      FullPath.SplitPathComponents().Last() : "";
 
-    sPitchStdDevs.push_back(TStatistics::StandardDeviation(
-      Results.mHighLevelPitch.mValues.FirstRead(),
-      Results.mHighLevelPitch.mValues.Size()));
+  // . Class & ClassStrengths
 
-    const double TotalPitchStdDevMean = TStatistics::Mean(
-      sPitchStdDevs.data(), (int)sPitchStdDevs.size());
+  const double MinWeight = 0.0; // include all
+  Results.mClassStrengths.mValues = TClassificationTools::CategoryStrengths(
+    Results.mClassSignature.mValues, MinWeight);
 
-    gTraceVar("> Total pitch stddev mean: %.2f", TotalPitchStdDevMean);
 
-    auto Iter = sRootKeysMap.find(TString(RootKeyFolderName).ToLower().StdCString());
-    if (Iter != sRootKeysMap.end())
-    {
-      const float ExpectedRootKey = (float)Iter->second;
-      const float DetectedRootKey = (float)::fmod(Results.mHighLevelBaseNote.mValue, 12.0);
+  // . Apply Heuristics
 
-      const float Min = MMin(DetectedRootKey, ExpectedRootKey);
-      const float Max = MMax(DetectedRootKey, ExpectedRootKey);
+  MAssert(mpClassificationModel->OutputClasses() == std::vector<TString>({"Loop", "OneShot"}), 
+    "Expecting a OneShotVsLoop model as 'mpClassificationModel' here");
 
-      const float Distance = MMin(Max - Min, (Min + 12.0f) - Max); // wrap around edges (> 12)
-      sPitchOffsets.push_back(Distance);
+  #if defined(MUseClassificationHeuristics)
+    if (mpClassificationModel->OutputClasses() == std::vector<TString>({"Loop", "OneShot"})) 
+    {
+      static const int kLoopClassIndex = 0;
+      static const int kOneShotClassIndex = 1;
 
-      if (Distance > 0.5f) // > 0.5f results into a wrong displayed root key, ignoring cents
+      double IsOneShotConfidence = -1.0;
+      double IsLoopConfidence = -1.0;
+
+      if (TClassificationHeuristics::IsOneShot(Results, IsOneShotConfidence)) 
       {
-        const float PitchDistanceMean = (float)TStatistics::Mean(
-          sPitchOffsets.data(), (int)sPitchOffsets.size());
+        if (Results.mClassStrengths.mValues[kLoopClassIndex] > 
+              Results.mClassStrengths.mValues[kOneShotClassIndex]) 
+        {
+          TLog::SLog()->AddLine(MLogPrefix, 
+            "NB: Overriding model's 'IsOneShot' result with heuristics (confidence: %g)",
+            IsOneShotConfidence);
 
-        gTraceVar(">>>>> Wrong Detected Root-Key #%d: %.2f -> %.2f - total distance mean: %.2f",
-          sNumberOfWrongPitches + 1, DetectedRootKey, ExpectedRootKey, PitchDistanceMean);
+          Results.mClassStrengths.mValues[kLoopClassIndex] = MMin(IsOneShotConfidence / 2,
+            Results.mClassStrengths.mValues[kLoopClassIndex]);
+          Results.mClassStrengths.mValues[kOneShotClassIndex] = IsOneShotConfidence;
+        }
+      }
+      else if (TClassificationHeuristics::IsLoop(Results, IsLoopConfidence))
+      {
+        if (Results.mClassStrengths.mValues[kLoopClassIndex] < 
+              Results.mClassStrengths.mValues[kOneShotClassIndex]) 
+        {
+          TLog::SLog()->AddLine(MLogPrefix, 
+            "NB: Overriding model's 'IsLoop' result with heuristics (confidence: %g)",
+            IsLoopConfidence);
 
-        ++sNumberOfWrongPitches;
+          Results.mClassStrengths.mValues[kLoopClassIndex] = IsLoopConfidence;
+          Results.mClassStrengths.mValues[kOneShotClassIndex] = MMin(IsLoopConfidence / 2, 
+            Results.mClassStrengths.mValues[kOneShotClassIndex]);
+        }
       }
     }
-    else
-    {
-      MInvalid("");
-    }
   #endif
+
+
+  // . Class List
+
+  // collect class list from class strength
+  const double MinDefaultWeight = 0.2;
+  const double MinFallbackWeight = 0.01;
+  Results.mClasses.mValues = TClassificationTools::PickAllStrongCategories(
+    mpClassificationModel->OutputClasses(),
+    Results.mClassStrengths.mValues,
+    MinDefaultWeight,
+    MinFallbackWeight);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalyser::ApplyCategorizationWeights(
+  TSampleDescriptors& Results,
+  const TList<float>& CategoryWeights) const
+{
+  // . CategorySignature
+
+  Results.mCategorySignature.mValues = CategoryWeights;
+
+  // . Categories & CategoryStrengths (for OneShots only)
+
+  if (!Results.mClasses.mValues.IsEmpty() &&
+      !Results.mClasses.mValues.Contains("OneShot") &&
+      !Results.mClasses.mValues.Contains("Loop"))
+  {
+    throw TReadableException("Unexpected classification model class: "
+      "expecting 'OneShot' or 'Loop' for now...");
+  }
+
+  if (Results.mClasses.mValues.IsEmpty() ||
+      Results.mClasses.mValues.Contains("OneShot"))
+  {
+    // calculate relative strength from absolute weights
+    const double MinWeight = 0.0; // include all
+    Results.mCategoryStrengths.mValues = TClassificationTools::CategoryStrengths(
+      Results.mCategorySignature.mValues, MinWeight);
+    
+    // collect category list from relative strength
+    const double MinDefaultWeight = 0.2;
+    const double MinFallbackWeight = 0.01;
+    Results.mCategories.mValues = TClassificationTools::PickAllStrongCategories(
+      mpOneShotCategorizationModel->OutputClasses(),
+      Results.mCategoryStrengths.mValues,
+      MinDefaultWeight,
+      MinFallbackWeight);
+  }
+  else // Results.mClass.mValue == "Loop"
+  {
+    // NB: keep mCategorySignature - it's used by the general similarity aspect
+    Results.mCategoryStrengths.mValues.Init(0.0);
+    Results.mCategories.mValues = TList<TString>();
+  }
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -1805,131 +2806,63 @@ void TSampleAnalyser::CalcAmplitudeEnvelope(
 
 // -------------------------------------------------------------------------------------------------
 
-void TSampleAnalyser::CalcSpectralRms(
-  TSampleDescriptors&   Results, 
-  const TArray<double>& MagnitudeSpectrum) const
-{
-  double Rms = 0.0;
-  ::xtract_rms_amplitude(MagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin, 
-    mAnalyzationBinCount, NULL, &Rms);
-
-  Results.mSpectralRms.mValues.Append(
-    TMath::IsNaN(Rms) ? 0.0 : Rms);
-}
-
-// -------------------------------------------------------------------------------------------------
-
-void TSampleAnalyser::CalcSpectralCentroidAndSpread(
-  TSampleDescriptors&   Results, 
-  const TArray<double>& MagnitudeSpectrum) const
-{
-  const double Centroid = TStatistics::Centroid(
-    MagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin, 
-    mAnalyzationBinCount);
-
-  Results.mSpectralCentroid.mValues.Append(Centroid);
-
-  const double Spread = TStatistics::Spread(
-    MagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin, 
-    mAnalyzationBinCount, 
-    Centroid);
-
-  Results.mSpectralSpread.mValues.Append(Spread);
-
-  #if 0 // libXtract's impl - mean and variance
-    double Mean = 0.0;
-    ::xtract_spectral_mean(MagnitudeSpectrum.FirstRead(),
-      mFftFrameSize, NULL, &Mean);
-
-    Results.mSpectralCentroid.mValues.Append(
-      TMath::IsNaN(Mean) ? 0.0 : Mean);
-
-    double Variance = 0.0;
-    ::xtract_spectral_variance(MagnitudeSpectrum.FirstRead(),
-      mFftFrameSize, &Mean, &Variance);
-
-    Results.mSpectralSpread.mValues.Append(
-      TMath::IsNaN(Variance) ? 0.0 : Variance);
-  #endif
-}
-
-// -------------------------------------------------------------------------------------------------
-
-void TSampleAnalyser::CalcSpectralSkewnessAndKurtosis(
-  TSampleDescriptors&   Results, 
-  const TArray<double>& MagnitudeSpectrum) const
-{
-  const double Centroid = TStatistics::Centroid(
-    MagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin, 
-    mAnalyzationBinCount);
-
-  const double Spread = TStatistics::Spread(
-    MagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin, 
-    mAnalyzationBinCount, 
-    Centroid);
-
-  double Skewness = TStatistics::Skewness(
-    MagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin, 
-    mAnalyzationBinCount, Centroid, Spread);
-
-  double Kurtosis = TStatistics::Kurtosis(
-    MagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin, 
-    mAnalyzationBinCount, 
-    Centroid, 
-    Spread);
-
-  Results.mSpectralSkewness.mValues.Append(Skewness);
-  Results.mSpectralKurtosis.mValues.Append(Kurtosis);
-}
-
-// -------------------------------------------------------------------------------------------------
-
-void TSampleAnalyser::CalcSpectralRolloff(
-  TSampleDescriptors&   Results, 
-  const TArray<double>& MagnitudeSpectrum) const
-{
-  double Arguments[4] = { 0 };
-  Arguments[0] = mSampleRate / (mFftFrameSize / 2);
-  Arguments[1] = 85.0f;
-
-  double Rolloff = 0.0;
-  ::xtract_rolloff(MagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin, 
-    mAnalyzationBinCount, Arguments, &Rolloff);
-
-  Results.mSpectralRolloff.mValues.Append(
-    TMath::IsNaN(Rolloff) ? 0.0 : Rolloff);
-}
-
-// -------------------------------------------------------------------------------------------------
-
-void TSampleAnalyser::CalcSpectralFlatness(
-  TSampleDescriptors&   Results, 
-  const TArray<double>& MagnitudeSpectrum) const
-{
-  const double Flatness = SFlatnessDb(
-    MagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin, 
-    mAnalyzationBinCount);
-
-  Results.mSpectralFlatness.mValues.Append(
-    TMath::IsNaN(Flatness) ? 0.0 : Flatness);
-}
-
-// -------------------------------------------------------------------------------------------------
-
-void TSampleAnalyser::CalcSpectralFlux(
-  TSampleDescriptors&   Results, 
-  const TArray<double>& MagnitudeSpectrum,
-  const TArray<double>& LastMagnitudeSpectrum) const
+void TSampleAnalyser::CalcSpectralFeatures(
+  const TLowLevelFeatures&  Features,
+  TSampleDescriptors&       Results, 
+  const TArray<double>&     MagnitudeSpectrum,
+  const TArray<double>&     LastMagnitudeSpectrum) const
 {
   MAssert(LastMagnitudeSpectrum.Size() == mFftFrameSize &&
     MagnitudeSpectrum.Size() == mFftFrameSize, "");
 
-  const double Flux = TStatistics::Flux(
+  // libXtract's rolloff arguments
+  const double RolloffBinFrequency = mSampleRate / (mFftFrameSize / 2);
+  const double RolloffPercentile = 85.0;
+
+  TSpectrumStatistics::TFrameFeatures FrameFeatures;
+  TSpectrumStatistics::CalcFrameFeatures(FrameFeatures,
     MagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin,
-    LastMagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin, 
-    mAnalyzationBinCount);
+    LastMagnitudeSpectrum.FirstRead() + mFirstAnalyzationBin,
+    mAnalyzationBinCount, 
+    RolloffPercentile, 
+    RolloffBinFrequency);
 
-  Results.mSpectralFlux.mValues.Append(Flux);
+  // Spectral RMS
+  if (Features.mSpectralRms)
+  {
+    Results.mSpectralRms.mValues.Append(
+      TMath::IsNaN(FrameFeatures.mRms) ? 0.0 : FrameFeatures.mRms);
+  }
+  // Spectral Centroid & Spread
+  if (Features.mSpectralCentroidAndSpread)
+  {
+    Results.mSpectralCentroid.mValues.Append(FrameFeatures.mCentroid);
+    Results.mSpectralSpread.mValues.Append(FrameFeatures.mSpread);
+  }
+  // Spectral Skewness and Kurtosis
+  if (Features.mSpectralSkewnessAndKurtosis)
+  {
+    Results.mSpectralSkewness.mValues.Append(FrameFeatures.mSkewness);
+    Results.mSpectralKurtosis.mValues.Append(FrameFeatures.mKurtosis);
+  }
+  // Spectral Rolloff
+  if (Features.mSpectralRolloff)
+  {
+    Results.mSpectralRolloff.mValues.Append(
+      TMath::IsNaN(FrameFeatures.mRolloff) ? 0.0 : FrameFeatures.mRolloff);
+  }
+  // Spectral Flatness
+  if (Features.mSpectralFlatness)
+  {
+    const double Flatness = SFlatnessDb(FrameFeatures.mFlatness);
+    Results.mSpectralFlatness.mValues.Append(
+      TMath::IsNaN(Flatness) ? 0.0 : Flatness);
+  }
+  // Spectral Flux
+  if (Features.mSpectralFlux)
+  {
+    Results.mSpectralFlux.mValues.Append(FrameFeatures.mFlux);
+  }
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -2038,9 +2971,10 @@ void TSampleAnalyser::CalcSpectrumBands(
     int EndBin = TMath::d2iRound(sBandFrequencies[b] / FrequenciesPerBin);
     EndBin = MMin(mFftFrameSize / 2, EndBin);
 
-    for (int s = StartBin; s < EndBin; s++)
+    if (EndBin > StartBin)
     {
-      FrequencyBands[b] += TMathT<double>::Square(MagnitudeSpectrum[s]);
+      FrequencyBands[b] = TSpectrumStatistics::Power(
+        MagnitudeSpectrum.FirstRead() + StartBin, EndBin - StartBin);
     }
   }
 
@@ -2056,8 +2990,8 @@ void TSampleAnalyser::CalcCepstrumBands(
   TStaticArray<double, kNumberOfCepstrumCoefficients> MFCCs;
   MFCCs.Init(0.0);
 
-  ::xtract_mfcc(MagnitudeSpectrum.FirstRead(),
-    mFftFrameSize / 2, mpXtractMelFilters, MFCCs.FirstWrite());
+  MAssert(mpMelCepstrum->SpectrumSize() <= MagnitudeSpectrum.Size(), "");
+  mpMelCepstrum->Calc(MagnitudeSpectrum.FirstRead(), MFCCs.FirstWrite());
 
   Results.mCepstrumBands.mValues.Append(MFCCs);
 }
@@ -2065,9 +2999,10 @@ void TSampleAnalyser::CalcCepstrumBands(
 // -------------------------------------------------------------------------------------------------
 
 void TSampleAnalyser::CalcSpectralBandFeatures(
-  TSampleDescriptors&   Results, 
-  const TArray<double>& MagnitudeSpectrum,
-  const TArray<double>& LastMagnitudeSpectrum) const
+  TSampleAnalysisWorkspace& Workspace,
+  TSampleDescriptors&       Results, 
+  const TArray<double>&     MagnitudeSpectrum,
+  const TArray<double>&     LastMagnitudeSpectrum) const
 {
   // Setup analysation consts/ranges
   const double NeighbourRatio = 0.3; // Neighbours per band to take mean of
@@ -2100,17 +3035,10 @@ void TSampleAnalyser::CalcSpectralBandFeatures(
   }
 
   // make a copy of the spectrums, because we'll transform (sort) them
-  std::vector<double> Magnitudes(mFftFrameSize / 2);
-  for (int i = 0; i < mFftFrameSize / 2; ++i)
-  {
-    Magnitudes[i] = MagnitudeSpectrum[i];
-  }
-
-  std::vector<double> LastMagnitudes(mFftFrameSize / 2);
-  for (int i = 0; i < mFftFrameSize / 2; ++i)
-  {
-    LastMagnitudes[i] = LastMagnitudeSpectrum[i];
-  }
+  TArray<double>& Magnitudes = Workspace.mSortedMagnitudes;
+  MAssert(Magnitudes.Size() == mFftFrameSize / 2, "Unexpected workspace size");
+  TAudioMath::CopyBuffer(MagnitudeSpectrum.FirstRead(),
+    Magnitudes.FirstWrite(), mFftFrameSize / 2);
 
   const double Epsilon = 1e-30;
 
@@ -2136,45 +3064,28 @@ void TSampleAnalyser::CalcSpectralBandFeatures(
        ++BandIndex)
   {
     const int NumBinsInBand = MMin(NumberOfBinsInBands[BandIndex],
-      (int)Magnitudes.size() - CurrentBin);
+      Magnitudes.Size() - CurrentBin);
 
     MAssert(NumBinsInBand  > 0, "");
 
-    // get the mean and max of the band
-    const double BandMean = TStatistics::Mean(
-      Magnitudes.data() + CurrentBin, NumBinsInBand);
-    // const double BandMax = TStatistics::Max(
-    //   Magnitudes.data() + CurrentBin, NumBinsInBand);
+    // get the mean, max, rms, flatness and flux of the band in one go
+    TSpectrumStatistics::TBandFeatures BandFeatures;
+    TSpectrumStatistics::CalcBandFeatures(BandFeatures, 
+      Magnitudes.FirstRead() + CurrentBin, 
+      LastMagnitudeSpectrum.FirstRead() + CurrentBin, 
+      NumBinsInBand);
 
     // gTraceVar("Computing Band Features for band %d: From %g Hz to %g Hz", 
     //   BandIndex, CurrentBin * FrequenciesPerBin,
     //   (CurrentBin + NumBinsInBand) * FrequenciesPerBin);
 
-    // calc rms 
-    double Rms = 0.0;
-    for (int i = 0; i < NumBinsInBand; ++i)
-    {
-      Rms += TMathT<double>::Square(Magnitudes[CurrentBin + i]);
-    }
-    Rms = ::sqrt(Rms / (double)NumBinsInBand);
-    
-    // calc flatness
-    const double Flatness = SFlatnessDb(
-      Magnitudes.data() + CurrentBin, NumBinsInBand);
-
-    // calc flux
-    MAssert(Magnitudes.size() == LastMagnitudes.size(), "");
-    const double Flux = TStatistics::Flux(Magnitudes.data() + CurrentBin,
-      LastMagnitudes.data() + CurrentBin, NumBinsInBand);
+    const double BandMean = BandFeatures.mMean;
+    const double Rms = BandFeatures.mRms;
+    const double Flatness = SFlatnessDb(BandFeatures.mFlatness);
+    const double Flux = BandFeatures.mFlux;
 
     // calc complexity
-    double ComplexityThreshold = 0.0;
-    for (int i = 0; i < NumBinsInBand; ++i)
-    {
-      ComplexityThreshold = MMax(ComplexityThreshold,
-        Magnitudes[CurrentBin + i]);
-    }
-    ComplexityThreshold *= MPeakThreshold;
+    const double ComplexityThreshold = BandFeatures.mMax * MPeakThreshold;
 
     double Complexity = 0;
     if (ComplexityThreshold > 0.0)
@@ -2186,7 +3097,7 @@ void TSampleAnalyser::CalcSpectralBandFeatures(
         // NB: use unsorted MagnitudeSpectrum here, so we can reach into next bands
         if (MagnitudeSpectrum[b] > ComplexityThreshold)
         {
-          if (b > 0 && b < (int)Magnitudes.size() - 1 &&
+          if (b > 0 && b < Magnitudes.Size() - 1 &&
               MagnitudeSpectrum[b] > MagnitudeSpectrum[b - 1] &&
               MagnitudeSpectrum[b] > MagnitudeSpectrum[b + 1])
           {
@@ -2197,8 +3108,8 @@ void TSampleAnalyser::CalcSpectralBandFeatures(
     }
 
     // sort the subbands (ascending order)
-    std::sort(Magnitudes.begin() + CurrentBin,
-      Magnitudes.begin() + CurrentBin + NumBinsInBand);
+    std::sort(Magnitudes.FirstWrite() + CurrentBin,
+      Magnitudes.FirstWrite() + CurrentBin + NumBinsInBand);
 
     // number of bins to take the mean of
     const int NeighbourBins = MMax(1, (int)(NeighbourRatio * NumBinsInBand));
@@ -2208,7 +3119,7 @@ void TSampleAnalyser::CalcSpectralBandFeatures(
     for (int i = 0; i < NeighbourBins && i < NumBinsInBand; ++i)
     {
       MAssert(CurrentBin + i >= 0 &&
-        CurrentBin + i < (int)Magnitudes.size(), "");
+        CurrentBin + i < Magnitudes.Size(), "");
 
       Sum += Magnitudes[CurrentBin + i];
     }
@@ -2220,7 +3131,7 @@ void TSampleAnalyser::CalcSpectralBandFeatures(
     for (int i = NumBinsInBand; i > NumBinsInBand - NeighbourBins; --i)
     {
       MAssert(CurrentBin + i - 1 >= 0 &&
-        CurrentBin + i - 1 < (int)Magnitudes.size(), "");
+        CurrentBin + i - 1 < Magnitudes.Size(), "");
 
       Sum += Magnitudes[CurrentBin + i - 1];
     }
@@ -2310,9 +3221,10 @@ void TSampleAnalyser::CalcSpectralBandFeatures(
 // -------------------------------------------------------------------------------------------------
 
 void TSampleAnalyser::CalcAutoCorrelation(
-  TSampleDescriptors& Results, 
-  const double*       pSampleData,
-  int                 RemainingSamples) const
+  TSampleAnalysisWorkspace& Workspace,
+  TSampleDescriptors&       Results, 
+  const double*             pSampleData,
+  int                       RemainingSamples) const
 {
   // consts
   const float MinPeriodLengthInMs = 0.8f; // ~1250 Hz 
@@ -2367,8 +3279,10 @@ void TSampleAnalyser::CalcAutoCorrelation(
   const int CorrelationSeekWidth =
     MMin(RemainingSamples, SeekWidthInSamples);
 
-  TArray<double> AutoCorrelation(CorrelationSeekWidth);
-  AutoCorrelation.Init(0.0);
+  TAutocorrelation::TWorkspace& AutocorrelationWorkspace =
+    Workspace.AutocorrelationWorkspace();
+
+  double* pAutoCorrelation = AutocorrelationWorkspace.CoeffsBuffer(CorrelationSeekWidth);
 
   #if 0 // use warped correlation (makes things worse)
 
@@ -2379,19 +3293,19 @@ void TSampleAnalyser::CalcAutoCorrelation(
     MAssert(lambda < 1.0, "");
 
     SWarpedAutoCorrelation(pSampleDataStart, CorrelationSeekWidth,
-      AutoCorrelation.FirstWrite(), AutoCorrelation.Size(), lambda);
+      pAutoCorrelation, CorrelationSeekWidth, lambda);
 
   #else // simple correlation
 
-    TAutocorrelation::Calc(pSampleDataStart, CorrelationSeekWidth,
-      AutoCorrelation.FirstWrite(), AutoCorrelation.Size());
+    TAutocorrelation::Calc(AutocorrelationWorkspace, pSampleDataStart, CorrelationSeekWidth,
+      pAutoCorrelation, CorrelationSeekWidth);
   #endif
 
   // skip self correlation by skipping half of the PeriodLength coeffs
   double BestResult = 0.0;
-  for (int i = PeriodLength / 2; i < AutoCorrelation.Size(); ++i)
+  for (int i = PeriodLength / 2; i < CorrelationSeekWidth; ++i)
   {
-    BestResult = MMax(BestResult, AutoCorrelation[i]);
+    BestResult = MMax(BestResult, pAutoCorrelation[i]);
   }
 
   Results.mAutoCorrelation.mValues.Append(BestResult);
@@ -2399,6 +3313,228 @@ void TSampleAnalyser::CalcAutoCorrelation(
 
 // -------------------------------------------------------------------------------------------------
 
+void TSampleAnalyser::CalcMagnitudeSpectrum(
+  TSampleAnalysisWorkspace& Workspace,
+  const double*             pSampleData,
+  TArray<double>&           MagnitudeSpectrum) const
+{
+  // TODO: optional float32 precision mode for the frame loops, with a tolerance
+  // checked suite against the double results. Ooura's real FFT, aubio (built with
+  // HAVE_AUBIO_DOUBLE) and libXtract only process doubles, so it needs float
+  // versions of those first: with float lanes in our own spectrum kernels only,
+  // frames were not analyzed any faster.
+
+  TFftTransformReal& FftTransform = Workspace.FftTransform();
+
+  // Apply window to sample frame, directly into the FFT buffer
+  TAudioMath::MultiplyBuffers(pSampleData, mpWindow, 
+    FftTransform.Data(), mFftFrameSize);
+
+  // Apply FFT on windowed input
+  FftTransform.ForwardInplace();
+
+  TAudioMath::PackedMagnitude(FftTransform.Data(), mFftFrameSize,
+    MagnitudeSpectrum.FirstWrite(), mFftFrameSize / 2);
+
+  #if 0 // phase is currently not used: avoid wasting processing time
+    TAudioMath::PackedPhase(FftTransform.Data(), mFftFrameSize,
+      MagnitudeSpectrum.FirstWrite() + mFftFrameSize / 2, mFftFrameSize / 2);
+  #else
+    TAudioMath::ClearBuffer(
+      MagnitudeSpectrum.FirstWrite() + mFftFrameSize / 2, mFftFrameSize / 2);
+  #endif
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalyser::CalcIndependentFrameFeatures(
+  TSampleAnalysisWorkspace& Workspace,
+  const TLowLevelFeatures&  Features,
+  TSampleDescriptors&       Results,
+  int                       FrameIndex,
+  const double*             pSampleData,
+  int                       RemainingSamples,
+  const TArray<double>&     MagnitudeSpectrum,
+  const TArray<double>&     LastMagnitudeSpectrum) const
+{
+  // Amplitude Peak and RMS
+  if (Features.mAmplitudePeak)
+  {
+    CalcAmplitudePeak(Results, pSampleData, mHopFrameSize);
+  }
+  if (Features.mAmplitudeRms)
+  {
+    CalcAmplitudeRms(Results, pSampleData, mHopFrameSize);
+  }
+  if (Features.mAmplitudeEnvelope)
+  {
+    CalcAmplitudeEnvelope(Results, pSampleData, mHopFrameSize);
+  }
+
+  // Autocorrelation
+  if (Features.mAutoCorrelation)
+  {
+    CalcAutoCorrelation(Workspace, Results, pSampleData, RemainingSamples);
+  }
+
+  // Spectral RMS, centroid, spread, skewness, kurtosis, rolloff, flatness and flux
+  if (Features.mSpectralRms || 
+      Features.mSpectralCentroidAndSpread || 
+      Features.mSpectralSkewnessAndKurtosis || 
+      Features.mSpectralRolloff || 
+      Features.mSpectralFlatness || 
+      Features.mSpectralFlux)
+  {
+    CalcSpectralFeatures(Features, Results, MagnitudeSpectrum, LastMagnitudeSpectrum);
+  }
+
+  // Spectral RMS, flux and contrast band features
+  if (Features.mSpectralBandFeatures)
+  {
+    CalcSpectralBandFeatures(Workspace, Results, MagnitudeSpectrum, LastMagnitudeSpectrum);
+  }
+
+  // Spectrum Bands
+  if (Features.mSpectrumBands && FrameIndex < Features.mNumberOfSpectrumBandFrames)
+  {
+    CalcSpectrumBands(Results, MagnitudeSpectrum);
+  }
+  // Cepstrum Bands
+  if (Features.mCepstrumBands)
+  {
+    CalcCepstrumBands(Results, MagnitudeSpectrum);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalyser::CalcIndependentFrameFeaturesInParallel(
+  const TLowLevelFeatures&  Features,
+  TSampleDescriptors&       Results,
+  const TSampleData&        SampleData,
+  int                       NumberOfFrames,
+  int                       NumberOfThreads) const
+{
+  const int NumberOfChunks = (NumberOfFrames + MParallelFrameAnalysisChunkSize - 1) / 
+    MParallelFrameAnalysisChunkSize;
+
+  // each chunk writes into its own results, which get merged in frame order below
+  std::vector<TSampleDescriptors> ChunkResults(NumberOfChunks);
+
+  std::atomic<int> NextChunkIndex(0);
+
+  std::mutex ErrorLock;
+  std::exception_ptr pError;
+
+  auto CalcChunks = [&]() {
+    // ignore FPU exceptions from aubio and libXtract
+    M__DisableFloatingPointAssertions
+
+    try
+    {
+      // NB: chunk threads are short-lived, so they don't use the thread local 
+      // workspaces: those would only be released along with the analyser.
+      // Trackers are created on demand only, so this only sets up the FFT.
+      TSampleAnalysisWorkspace Workspace;
+      Workspace.Reset(mSampleRate, mFftFrameSize, mHopFrameSize);
+
+      TArray<double>& MagnitudeSpectrum = Workspace.mMagnitudeSpectrum;
+      TArray<double>& LastMagnitudeSpectrum = Workspace.mLastMagnitudeSpectrum;
+
+      int ChunkIndex;
+      while ((ChunkIndex = NextChunkIndex++) < NumberOfChunks)
+      {
+        const int FirstFrame = ChunkIndex * MParallelFrameAnalysisChunkSize;
+        const int LastFrame = MMin(NumberOfFrames, 
+          FirstFrame + MParallelFrameAnalysisChunkSize);
+
+        // recalc the previous chunk's last spectrum, as needed by the flux features
+        if (FirstFrame > 0)
+        {
+          CalcMagnitudeSpectrum(Workspace, 
+            SampleData.mData.FirstRead() + (FirstFrame - 1) * mHopFrameSize,
+            LastMagnitudeSpectrum);
+        }
+
+        for (int Frame = FirstFrame; Frame < LastFrame; ++Frame)
+        {
+          const int n = Frame * mHopFrameSize;
+
+          CalcMagnitudeSpectrum(Workspace, SampleData.mData.FirstRead() + n,
+            MagnitudeSpectrum);
+
+          if (Frame == 0)
+          {
+            LastMagnitudeSpectrum = MagnitudeSpectrum;
+          }
+
+          const int RemainingSamples = SampleData.mData.Size() - n;
+          CalcIndependentFrameFeatures(Workspace, Features, ChunkResults[ChunkIndex], Frame,
+            SampleData.mData.FirstRead() + n, RemainingSamples, 
+            MagnitudeSpectrum, LastMagnitudeSpectrum);
+
+          std::swap(LastMagnitudeSpectrum, MagnitudeSpectrum);
+        }
+      }
+    }
+    catch (...)
+    {
+      const std::lock_guard<std::mutex> Lock(ErrorLock);
+      if (!pError)
+      {
+        pError = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> Threads;
+  for (int i = 1; i < NumberOfThreads; ++i)
+  {
+    Threads.push_back(std::thread(CalcChunks));
+  }
+
+  CalcChunks();
+
+  for (auto& Thread : Threads)
+  {
+    Thread.join();
+  }
+
+  if (pError)
+  {
+    std::rethrow_exception(pError);
+  }
+
+  // merge chunk results
+  const TList<TSampleDescriptors::TDescriptor*> Descriptors =
+    Results.Descriptors(TSampleDescriptors::kLowLevelDescriptors);
+
+  TList<TSampleDescriptors::TDescriptor::TValue> Values;
+  TList<TSampleDescriptors::TDescriptor::TValue> ChunkValues;
+
+  for (int c = 0; c < NumberOfChunks; ++c)
+  {
+    const TList<TSampleDescriptors::TDescriptor*> ChunkDescriptors =
+      ChunkResults[c].Descriptors(TSampleDescriptors::kLowLevelDescriptors);
+
+    for (int d = 0; d < Descriptors.Size(); ++d)
+    {
+      Values.ClearEntries();
+      Descriptors[d]->AppendValues(Values);
+
+      ChunkValues.ClearEntries();
+      ChunkDescriptors[d]->AppendValues(ChunkValues);
+
+      for (int v = 0; v < Values.Size(); ++v)
+      {
+        boost::apply_visitor(TAppendDescriptorFrameValues(ChunkValues[v]), Values[v]);
+      }
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void TSampleAnalyser::CalcStatistics(TSampleDescriptors& Results) const
 {
   // calculate all low level statistics from the VR or VVR values 
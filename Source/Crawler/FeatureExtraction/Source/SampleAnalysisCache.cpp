@@ -0,0 +1,516 @@
+#include "CoreTypes/Export/Log.h"
+#include "CoreTypes/Export/Debug.h"
+#include "CoreTypes/Export/Str.h"
+#include "CoreTypes/Export/File.h"
+#include "CoreTypes/Export/Array.h"
+#include "CoreTypes/Export/Exception.h"
+
+#include "FeatureExtraction/Export/SampleAnalysisCache.h"
+#include "FeatureExtraction/Source/XXHash64.h"
+
+#include <cstring> // memcpy
+#include <cstdio> // snprintf
+#include <vector>
+
+typedef TSampleDescriptors::TDescriptor TSampleDescriptor;
+
+// =================================================================================================
+
+// local log name prefix
+#define MLogPrefix "AnalysisCache"
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+//! Read \param Size bytes from the current position of the given file
+
+static void SReadBlock(TFile& File, TArray<char>& Buffer, size_t Size)
+{
+  Buffer.SetSize((int)Size);
+
+  size_t BytesRead = Size;
+  if (!File.ReadBytes(Buffer.FirstWrite(), &BytesRead) || BytesRead != Size)
+  {
+    throw TReadableException(
+      MText("Failed to read file: '%s'", File.FileName()));
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Serialize descriptor values into a plain byte buffer
+
+class TSerializeDescriptorValue : public boost::static_visitor<void>
+{
+public:
+  TSerializeDescriptorValue(std::vector<char>& Buffer)
+    : mBuffer(Buffer) { }
+
+  template <typename T>
+  void operator()(T* pValue) const
+  {
+    Write(*pValue);
+  }
+
+private:
+  template <typename T>
+  void Write(const T& Value) const
+  {
+    const char* pValue = reinterpret_cast<const char*>(&Value);
+    mBuffer.insert(mBuffer.end(), pValue, pValue + sizeof(T));
+  }
+
+  void Write(const TString& Value) const
+  {
+    const std::string CString = Value.StdCString(TString::kUtf8);
+    Write((int)CString.size());
+    mBuffer.insert(mBuffer.end(), CString.begin(), CString.end());
+  }
+
+  template <typename T>
+  void Write(const TList<T>& Values) const
+  {
+    Write(Values.Size());
+    for (int i = 0; i < Values.Size(); ++i)
+    {
+      Write(Values[i]);
+    }
+  }
+
+  template <typename T, size_t sSize>
+  void Write(const TStaticArray<T, sSize>& Values) const
+  {
+    for (int i = 0; i < Values.Size(); ++i)
+    {
+      Write(Values[i]);
+    }
+  }
+
+  std::vector<char>& mBuffer;
+};
+
+// -------------------------------------------------------------------------------------------------
+
+//! Unserialize descriptor values from a TSerializeDescriptorValue byte buffer
+
+class TUnserializeDescriptorValue : public boost::static_visitor<void>
+{
+public:
+  TUnserializeDescriptorValue(const char*& pData, const char* pDataEnd)
+    : mpData(pData), mpDataEnd(pDataEnd) { }
+
+  template <typename T>
+  void operator()(T* pValue) const
+  {
+    Read(*pValue);
+  }
+
+private:
+  void CheckSize(size_t Size) const
+  {
+    if ((size_t)(mpDataEnd - mpData) < Size)
+    {
+      throw TReadableException("Unexpected end of cached descriptor data");
+    }
+  }
+
+  template <typename T>
+  void Read(T& Value) const
+  {
+    CheckSize(sizeof(T));
+    ::memcpy(&Value, mpData, sizeof(T));
+    mpData += sizeof(T);
+  }
+
+  void Read(TString& Value) const
+  {
+    int Size; Read(Size);
+    CheckSize(Size);
+    Value = TString(std::string(mpData, mpData + Size).c_str(), TString::kUtf8);
+    mpData += Size;
+  }
+
+  template <typename T>
+  void Read(TList<T>& Values) const
+  {
+    int Size; Read(Size);
+    CheckSize(Size); // each value has at least one byte
+
+    Values.Empty();
+    Values.PreallocateSpace(Size);
+    for (int i = 0; i < Size; ++i)
+    {
+      T Value; Read(Value);
+      Values.Append(Value);
+    }
+  }
+
+  template <typename T, size_t sSize>
+  void Read(TStaticArray<T, sSize>& Values) const
+  {
+    for (int i = 0; i < Values.Size(); ++i)
+    {
+      Read(Values[i]);
+    }
+  }
+
+  const char*& mpData;
+  const char* mpDataEnd;
+};
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+long long TSampleAnalysisCache::SFileHash(const TString& FileName)
+{
+  TFile File(FileName);
+  if (!File.Open(TFile::kRead))
+  {
+    throw TReadableException(
+      MText("Failed to open file: '%s'", FileName));
+  }
+
+  const size_t FileSize = File.SizeInBytes();
+
+  // hash in blocks, seeding each block with the previous block's hash
+  const size_t BlockSize = 1024 * 1024;
+  TArray<char> Buffer;
+
+  TUInt64 Hash = (TUInt64)FileSize;
+  for (size_t Position = 0; Position < FileSize; Position += BlockSize)
+  {
+    const size_t Size = std::min(BlockSize, FileSize - Position);
+    SReadBlock(File, Buffer, Size);
+
+    Hash = TXXHash64::Hash(Buffer.FirstRead(), Size, Hash);
+  }
+
+  return (long long)Hash;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalysisCache::TContentKey::TContentKey()
+  : mFileSize(0),
+    mModificationTime(0)
+{
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalysisCache::TContentKey::Empty()
+{
+  mKey.Empty();
+  mFileSize = 0;
+  mModificationTime = 0;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalysisCache::TContentKey TSampleAnalysisCache::SContentKey(
+  const TString& FileName)
+{
+  TFile File(FileName);
+
+  TFile::TStat Stat;
+  if (!File.Stat(Stat) || !File.Open(TFile::kRead))
+  {
+    throw TReadableException(
+      MText("Failed to open file: '%s'", FileName));
+  }
+
+  const size_t FileSize = (size_t)Stat.mSizeInBytes;
+  TArray<char> Buffer;
+
+  // hash first block
+  const size_t HeadSize = std::min((size_t)kContentKeyBlockSize, FileSize);
+  SReadBlock(File, Buffer, HeadSize);
+
+  TUInt64 Hash = TXXHash64::Hash(Buffer.FirstRead(), HeadSize, (TUInt64)FileSize);
+
+  // hash last block, without overlapping the first one
+  if (FileSize > HeadSize)
+  {
+    const size_t TailPosition = std::max(HeadSize, FileSize - kContentKeyBlockSize);
+    const size_t TailSize = FileSize - TailPosition;
+
+    if (!File.SetPosition(TailPosition))
+    {
+      throw TReadableException(
+        MText("Failed to read file: '%s'", FileName));
+    }
+
+    SReadBlock(File, Buffer, TailSize);
+
+    Hash = TXXHash64::Hash(Buffer.FirstRead(), TailSize, Hash);
+  }
+
+  char KeyString[64];
+  ::snprintf(KeyString, sizeof(KeyString), "%lld-%016llx",
+    (long long)FileSize, (unsigned long long)Hash);
+
+  TContentKey ContentKey;
+  ContentKey.mKey = TString(KeyString);
+  ContentKey.mFileSize = Stat.mSizeInBytes;
+  ContentKey.mModificationTime = Stat.mModificationStatTime;
+
+  return ContentKey;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TSampleAnalysisCache::SIsPartialContentKey(const TContentKey& ContentKey)
+{
+  return ContentKey.mFileSize > 2 * (long long)kContentKeyBlockSize;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalysisCache::TSampleAnalysisCache(
+  TSampleDescriptors::TDescriptorSet DescriptorSet)
+  : mDescriptorSet(DescriptorSet)
+{
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalysisCache::~TSampleAnalysisCache()
+{
+  if (mDatabase.IsOpen())
+  {
+    try
+    {
+      mDatabase.Close();
+    }
+    catch (const TReadableException& Exception)
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Closing the cache failed: %s",
+        Exception.what());
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TSampleAnalysisCache::Open(
+  const TString& CacheFileName,
+  const TString& ConfigFingerprint)
+{
+  const std::lock_guard<std::mutex> Lock(mLock);
+
+  MAssert(!mDatabase.IsOpen(), "Cache is already open");
+
+  if (!mDatabase.Open(CacheFileName))
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Failed to open cache: '%s'",
+      CacheFileName.StdCString().c_str());
+    return false;
+  }
+
+  mConfigFingerprint = ConfigFingerprint;
+
+  try
+  {
+    // drop results from other cache versions
+    if (mDatabase.ExecuteScalarInt("PRAGMA user_version") != kVersion)
+    {
+      TDatabase::TTransaction Transaction(mDatabase);
+      {
+        mDatabase.Execute("DROP TABLE IF EXISTS results");
+        mDatabase.Execute("PRAGMA user_version = '" + ToString(kVersion) + "'");
+      }
+      Transaction.Commit();
+    }
+
+    mDatabase.Execute(
+      "CREATE TABLE IF NOT EXISTS results (config TEXT, contentkey TEXT, "
+        "modtime INTEGER, contenthash INTEGER, descriptors BLOB, "
+        "PRIMARY KEY (config, contentkey))");
+  }
+  catch (const TReadableException& Exception)
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Cache initialization failed: %s",
+      Exception.what());
+
+    mDatabase.Close();
+    return false;
+  }
+
+  return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TSampleAnalysisCache::Lookup(
+  const TString&      FileName,
+  const TContentKey&  ContentKey,
+  TSampleDescriptors& Results) const
+{
+  std::vector<char> Data;
+  int ModificationTime = 0;
+  bool HasContentHash = false;
+  long long ContentHash = 0;
+
+  {
+    const std::lock_guard<std::mutex> Lock(mLock);
+
+    MAssert(mDatabase.IsOpen(), "Cache is not open");
+
+    TDatabase::TStatement Statement(mDatabase,
+      "SELECT modtime, contenthash, descriptors FROM results "
+        "WHERE config = ? AND contentkey = ?");
+
+    Statement.BindText(1, mConfigFingerprint);
+    Statement.BindText(2, ContentKey.mKey);
+
+    if (!Statement.Step())
+    {
+      return false;
+    }
+
+    ModificationTime = Statement.ColumnInt(0);
+    HasContentHash = !Statement.IsColumnNull(1);
+    ContentHash = HasContentHash ? Statement.ColumnInt64(1) : 0;
+
+    int DataSize = 0;
+    const char* pData = (const char*)Statement.ColumnBlob(2, DataSize);
+    Data.assign(pData, pData + DataSize);
+  }
+
+  // verify the content of files which are not fully covered by the content key,
+  // when the modification time differs too
+  if (SIsPartialContentKey(ContentKey) &&
+      ContentKey.mModificationTime != ModificationTime)
+  {
+    if (!HasContentHash)
+    {
+      // can't verify: let Store hash the content of both files
+      return false;
+    }
+    else if (SFileHash(FileName) != ContentHash)
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Content key collision for '%s'",
+        FileName.StdCString().c_str());
+      return false;
+    }
+  }
+
+  // unserialize descriptors
+  const char* pData = Data.data();
+  const char* pDataEnd = pData + Data.size();
+
+  try
+  {
+    const TList<TSampleDescriptor*> Descriptors = Results.Descriptors(mDescriptorSet);
+
+    TList<TSampleDescriptor::TValue> Values;
+    for (int i = 0; i < Descriptors.Size(); ++i)
+    {
+      Descriptors[i]->AppendValues(Values);
+    }
+
+    const TUnserializeDescriptorValue Unserializer(pData, pDataEnd);
+
+    int NumberOfValues = 0;
+    Unserializer(&NumberOfValues);
+    if (NumberOfValues != Values.Size())
+    {
+      // descriptor layout changed
+      return false;
+    }
+
+    for (int i = 0; i < Values.Size(); ++i)
+    {
+      boost::apply_visitor(Unserializer, Values[i]);
+    }
+  }
+  catch (const TReadableException& Exception)
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Invalid cache entry for '%s': %s",
+      FileName.StdCString().c_str(), Exception.what());
+    return false;
+  }
+
+  Results.mFileName = FileName;
+
+  return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalysisCache::Store(
+  const TString&            FileName,
+  const TContentKey&        ContentKey,
+  const TSampleDescriptors& Results)
+{
+  // serialize descriptors
+  std::vector<char> Data;
+
+  const TList<const TSampleDescriptor*> Descriptors = Results.Descriptors(mDescriptorSet);
+
+  TList<TSampleDescriptor::TValue> Values;
+  for (int i = 0; i < Descriptors.Size(); ++i)
+  {
+    Descriptors[i]->AppendValues(Values);
+  }
+
+  const TSerializeDescriptorValue Serializer(Data);
+
+  int NumberOfValues = Values.Size();
+  Serializer(&NumberOfValues);
+
+  for (int i = 0; i < Values.Size(); ++i)
+  {
+    boost::apply_visitor(Serializer, Values[i]);
+  }
+
+  // hash the whole content of files which are not fully covered by the content 
+  // key, only when the key collides with an entry of some other file, or to keep
+  // the content hash of an entry which already got such a collision
+  bool NeedsContentHash = false;
+
+  if (SIsPartialContentKey(ContentKey))
+  {
+    const std::lock_guard<std::mutex> Lock(mLock);
+
+    MAssert(mDatabase.IsOpen(), "Cache is not open");
+
+    TDatabase::TStatement Statement(mDatabase,
+      "SELECT modtime, contenthash FROM results WHERE config = ? AND contentkey = ?");
+
+    Statement.BindText(1, mConfigFingerprint);
+    Statement.BindText(2, ContentKey.mKey);
+
+    NeedsContentHash = Statement.Step() && 
+      (Statement.ColumnInt(0) != ContentKey.mModificationTime ||
+       !Statement.IsColumnNull(1));
+  }
+
+  const long long ContentHash = NeedsContentHash ? SFileHash(FileName) : 0;
+
+  // write
+  const std::lock_guard<std::mutex> Lock(mLock);
+
+  MAssert(mDatabase.IsOpen(), "Cache is not open");
+
+  TDatabase::TStatement Statement(mDatabase,
+    "INSERT OR REPLACE INTO results "
+      "(config, contentkey, modtime, contenthash, descriptors) VALUES (?,?,?,?,?)");
+
+  Statement.BindText(1, mConfigFingerprint);
+  Statement.BindText(2, ContentKey.mKey);
+  Statement.BindInt(3, ContentKey.mModificationTime);
+  if (NeedsContentHash)
+  {
+    Statement.BindInt64(4, ContentHash);
+  }
+  else
+  {
+    Statement.BindNull(4);
+  }
+  Statement.BindBlob(5, Data.data(), (int)Data.size());
+
+  Statement.Execute();
+}
@@ -0,0 +1,447 @@
+#include "CoreTypes/Export/Log.h"
+#include "CoreTypes/Export/Debug.h"
+#include "CoreTypes/Export/File.h"
+#include "CoreTypes/Export/Timer.h"
+#include "CoreTypes/Export/Exception.h"
+#include "CoreTypes/Export/InlineMath.h"
+
+#include "CoreFileFormats/Export/AudioFile.h"
+
+#include "FeatureExtraction/Export/SampleAnalysisScheduler.h"
+#include "FeatureExtraction/Export/SampleFileQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// =================================================================================================
+
+// local log name prefix
+#define MLogPrefix "Scheduler"
+
+// =================================================================================================
+
+// fixed costs for opening a file and setting up the analysis, in audio seconds
+static const double sCostPerFile = 0.5;
+
+// bytes per second of a 16bit stereo 44100Hz file: used to estimate the
+// audio duration of files when their headers can not be read
+static const double sFallbackBytesPerAudioSecond = 44100.0 * 2.0 * 2.0;
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+//! guess the audio duration of a file from its size, without opening it
+
+static double SEstimatedAudioSecondsFromFileSize(const TString& FileName)
+{
+  return (double)TFile(FileName).SizeInBytes() / sFallbackBytesPerAudioSecond;
+}
+
+// =================================================================================================
+
+/*!
+ * Queue of task indices, owned by a single worker. The task indices are sorted
+ * by costs, so the front always holds the most expensive pending task.
+!*/
+
+class TWorkQueue
+{
+public:
+  void Append(int TaskIndex)
+  {
+    const std::lock_guard<std::mutex> Lock(mLock);
+    mTaskIndices.push_back(TaskIndex);
+  }
+
+  // peek the front task index without removing it. returns -1 when empty.
+  int PeekFront()
+  {
+    const std::lock_guard<std::mutex> Lock(mLock);
+    return mTaskIndices.empty() ? -1 : mTaskIndices.front();
+  }
+
+  // pop the front task index. returns -1 when empty.
+  int PopFront()
+  {
+    const std::lock_guard<std::mutex> Lock(mLock);
+
+    if (mTaskIndices.empty())
+    {
+      return -1;
+    }
+
+    const int TaskIndex = mTaskIndices.front();
+    mTaskIndices.pop_front();
+
+    return TaskIndex;
+  }
+
+private:
+  std::mutex mLock;
+  std::deque<int> mTaskIndices;
+};
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalysisScheduler::TStatistics::TStatistics()
+  : mNumberOfFiles(0),
+    mNumberOfProcessedFiles(0),
+    mProcessedAudioSeconds(0.0),
+    mElapsedSeconds(0.0)
+{ }
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+double TSampleAnalysisScheduler::SEstimatedCost(
+  const TString&  FileName,
+  double&         AudioSeconds)
+{
+  AudioSeconds = 0.0;
+  double Cost = 0.0;
+
+  // decoding and analyzing costs grow linearly with the number of samples
+  try
+  {
+    TPtr<TAudioFile> pAudioFile; TString FileLoadError;
+    if (TAudioFile::SCreateFromFile(pAudioFile, FileName, FileLoadError) &&
+        pAudioFile->SamplingRate() > 0)
+    {
+      AudioSeconds = (double)pAudioFile->NumSamples() / pAudioFile->SamplingRate();
+      Cost = AudioSeconds * MMax(1, pAudioFile->NumChannels());
+    }
+  }
+  catch (const TReadableException&)
+  {
+    // ignore: use fallback below
+  }
+
+  // guess costs from the file size
+  if (AudioSeconds <= 0.0)
+  {
+    AudioSeconds = SEstimatedAudioSecondsFromFileSize(FileName);
+    Cost = AudioSeconds * 2.0;
+  }
+
+  return sCostPerFile + Cost;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalysisScheduler::TSampleAnalysisScheduler(
+  int NumberOfThreads,
+  int ReportIntervalInMs)
+  : mNumberOfThreads(MMax(1, NumberOfThreads)),
+    mReportIntervalInMs(ReportIntervalInMs)
+{ }
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalysisScheduler::TStatistics TSampleAnalysisScheduler::Statistics()const
+{
+  const std::lock_guard<std::mutex> Lock(mStatisticsLock);
+  return mStatistics;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalysisScheduler::Run(
+  const TList<TString>&   FileNames,
+  const TAnalyzeFunction& Function)
+{
+  {
+    const std::lock_guard<std::mutex> Lock(mStatisticsLock);
+    mStatistics = TStatistics();
+    mStatistics.mNumberOfFiles = FileNames.Size();
+  }
+
+  if (FileNames.IsEmpty())
+  {
+    return;
+  }
+
+  TList<TTask> Tasks;
+  Tasks.PreallocateSpace(FileNames.Size());
+
+  for (int i = 0; i < FileNames.Size(); ++i)
+  {
+    TTask Task;
+    Task.mFileName = FileNames[i];
+    Task.mCost = 0.0;
+    Task.mAudioSeconds = 0.0;
+
+    Tasks.Append(Task);
+  }
+
+  TLog::SLog()->AddLine(MLogPrefix, "Estimating analysis costs of %d files...",
+    FileNames.Size());
+
+  EstimateCosts(Tasks);
+
+  // schedule largest files first
+  Tasks.StableSort([](const TTask& First, const TTask& Second) {
+    return First.mCost > Second.mCost;
+  });
+
+  RunTasks(Tasks, Function);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalysisScheduler::EstimateCosts(TList<TTask>& Tasks)
+{
+  // opening file headers is mostly IO bound: estimate in parallel too
+  const int NumberOfThreads = MMin(mNumberOfThreads, Tasks.Size());
+
+  std::atomic<int> NextTaskIndex(0);
+
+  auto EstimateTasks = [&]() {
+    int TaskIndex;
+    while ((TaskIndex = NextTaskIndex++) < Tasks.Size())
+    {
+      TTask& Task = Tasks[TaskIndex];
+      Task.mCost = SEstimatedCost(Task.mFileName, Task.mAudioSeconds);
+    }
+  };
+
+  std::vector<std::thread> Threads;
+  for (int i = 1; i < NumberOfThreads; ++i)
+  {
+    Threads.push_back(std::thread(EstimateTasks));
+  }
+
+  EstimateTasks();
+
+  for (auto& Thread : Threads)
+  {
+    Thread.join();
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalysisScheduler::RunTasks(
+  const TList<TTask>&     Tasks,
+  const TAnalyzeFunction& Function)
+{
+  const int NumberOfThreads = MMin(mNumberOfThreads, Tasks.Size());
+
+  // distribute the sorted tasks round-robin, so each queue is sorted by costs
+  // and all workers start with the same share of large files
+  std::vector<TWorkQueue> Queues(NumberOfThreads);
+  for (int i = 0; i < Tasks.Size(); ++i)
+  {
+    Queues[i % NumberOfThreads].Append(i);
+  }
+
+  std::atomic<int> NextFileIndex(0);
+  std::atomic<bool> Failed(false);
+
+  std::mutex ErrorLock;
+  std::exception_ptr pFirstError;
+
+  TStamp RunTime;
+  TStamp ReportTime;
+
+  auto RunWorker = [&](int WorkerIndex) {
+    while (!Failed)
+    {
+      // take own work first, then steal the most expensive task of other workers
+      int TaskIndex = Queues[WorkerIndex].PopFront();
+
+      while (TaskIndex == -1)
+      {
+        int VictimIndex = -1, VictimTaskIndex = -1;
+        for (int i = 1; i < NumberOfThreads; ++i)
+        {
+          const int QueueIndex = (WorkerIndex + i) % NumberOfThreads;
+          const int FrontTaskIndex = Queues[QueueIndex].PeekFront();
+
+          // smaller task indices are more expensive
+          if (FrontTaskIndex != -1 &&
+              (VictimTaskIndex == -1 || FrontTaskIndex < VictimTaskIndex))
+          {
+            VictimIndex = QueueIndex;
+            VictimTaskIndex = FrontTaskIndex;
+          }
+        }
+
+        if (VictimIndex == -1)
+        {
+          // all queues are drained
+          return;
+        }
+
+        // may fail when the task got taken by its owner or some other thief
+        // in the meantime: then retry...
+        TaskIndex = Queues[VictimIndex].PopFront();
+      }
+
+      const TTask& Task = Tasks[TaskIndex];
+
+      try
+      {
+        Function(Task.mFileName, NextFileIndex++);
+      }
+      catch (...)
+      {
+        const std::lock_guard<std::mutex> Lock(ErrorLock);
+        if (!pFirstError)
+        {
+          pFirstError = std::current_exception();
+        }
+
+        Failed = true;
+        return;
+      }
+
+      TaskCompleted(Task.mAudioSeconds, Tasks.Size(), RunTime, ReportTime);
+    }
+  };
+
+  std::vector<std::thread> Threads;
+  for (int i = 1; i < NumberOfThreads; ++i)
+  {
+    Threads.push_back(std::thread(RunWorker, i));
+  }
+
+  RunWorker(0);
+
+  for (auto& Thread : Threads)
+  {
+    Thread.join();
+  }
+
+  if (pFirstError)
+  {
+    std::rethrow_exception(pFirstError);
+  }
+
+  LogStatistics(Statistics());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalysisScheduler::Run(
+  TSampleFileQueue&       Queue,
+  const TAnalyzeFunction& Function)
+{
+  {
+    const std::lock_guard<std::mutex> Lock(mStatisticsLock);
+    mStatistics = TStatistics();
+  }
+
+  std::atomic<int> NextFileIndex(0);
+  std::atomic<bool> Failed(false);
+
+  std::mutex ErrorLock;
+  std::exception_ptr pFirstError;
+
+  TStamp RunTime;
+  TStamp ReportTime;
+
+  auto RunWorker = [&]() {
+    TString FileName;
+    while (!Failed && Queue.Pop(FileName))
+    {
+      try
+      {
+        Function(FileName, NextFileIndex++);
+      }
+      catch (...)
+      {
+        const std::lock_guard<std::mutex> Lock(ErrorLock);
+        if (!pFirstError)
+        {
+          pFirstError = std::current_exception();
+        }
+
+        // unblock producers and all other workers
+        Failed = true;
+        Queue.Abort();
+        return;
+      }
+
+      // only used for the throughput statistics here: don't open the file's
+      // header again, but guess the duration from its size
+      const double AudioSeconds = SEstimatedAudioSecondsFromFileSize(FileName);
+
+      TaskCompleted(AudioSeconds, Queue.NumberOfPushedFiles(), RunTime, ReportTime);
+    }
+  };
+
+  std::vector<std::thread> Threads;
+  for (int i = 1; i < mNumberOfThreads; ++i)
+  {
+    Threads.push_back(std::thread(RunWorker));
+  }
+
+  RunWorker();
+
+  for (auto& Thread : Threads)
+  {
+    Thread.join();
+  }
+
+  if (pFirstError)
+  {
+    std::rethrow_exception(pFirstError);
+  }
+
+  LogStatistics(Statistics());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalysisScheduler::TaskCompleted(
+  double        AudioSeconds,
+  int           NumberOfFiles,
+  const TStamp& RunTime,
+  TStamp&       ReportTime)
+{
+  // update and report throughput
+  TStatistics Statistics;
+  bool ReportStatistics = false;
+  {
+    const std::lock_guard<std::mutex> Lock(mStatisticsLock);
+
+    ++mStatistics.mNumberOfProcessedFiles;
+    mStatistics.mNumberOfFiles = NumberOfFiles;
+    mStatistics.mProcessedAudioSeconds += AudioSeconds;
+    mStatistics.mElapsedSeconds = RunTime.DiffInMs() / 1000.0;
+
+    if (ReportTime.DiffInMs() >= mReportIntervalInMs)
+    {
+      ReportTime.Start();
+      ReportStatistics = true;
+      Statistics = mStatistics;
+    }
+  }
+
+  if (ReportStatistics)
+  {
+    LogStatistics(Statistics);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalysisScheduler::LogStatistics(const TStatistics& Statistics)
+{
+  const double ElapsedSeconds = MMax(Statistics.mElapsedSeconds, 0.001);
+
+  TLog::SLog()->AddLine(MLogPrefix,
+    "Analyzed %d of %d files in %.1f s: %.2f files/s, %.2f audio-seconds/s",
+    Statistics.mNumberOfProcessedFiles, Statistics.mNumberOfFiles,
+    Statistics.mElapsedSeconds,
+    Statistics.mNumberOfProcessedFiles / ElapsedSeconds,
+    Statistics.mProcessedAudioSeconds / ElapsedSeconds);
+}
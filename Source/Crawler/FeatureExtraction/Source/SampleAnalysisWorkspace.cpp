@@ -0,0 +1,200 @@
+#include "FeatureExtraction/Source/SampleAnalysisWorkspace.h"
+
+#include "AudioTypes/Export/Fourier.h"
+
+#include "FeatureExtraction/Source/Autocorrelation.h"
+#include "FeatureExtraction/Source/RhythmTracker.h"
+
+#include <atomic>
+
+// =================================================================================================
+
+static std::atomic<int> sCreatedWorkspaces(0);
+static std::atomic<int> sWorkspaceResets(0);
+static std::atomic<int> sWorkspaceAllocations(0);
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalyser::TWorkspaceCounters TSampleAnalysisWorkspace::SCounters()
+{
+  TSampleAnalyser::TWorkspaceCounters Counters;
+  Counters.mWorkspaces = sCreatedWorkspaces;
+  Counters.mResets = sWorkspaceResets;
+  Counters.mAllocations = sWorkspaceAllocations;
+
+  return Counters;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalysisWorkspace::TSampleAnalysisWorkspace()
+  : mSampleRate(0),
+    mFftFrameSize(0),
+    mHopFrameSize(0),
+    mpAutocorrelationWorkspace(new TAutocorrelation::TWorkspace()),
+    mpPitchTracker(NULL),
+    mpSpectralWhitening(NULL),
+    mRhythmFftSize(0),
+    mRhythmHopSize(0)
+{
+  ++sCreatedWorkspaces;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleAnalysisWorkspace::~TSampleAnalysisWorkspace()
+{
+  ReleaseAubioObjects();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalysisWorkspace::Reset(int SampleRate, int FftFrameSize, int HopFrameSize)
+{
+  ++sWorkspaceResets;
+
+  if (SampleRate != mSampleRate ||
+      FftFrameSize != mFftFrameSize ||
+      HopFrameSize != mHopFrameSize)
+  {
+    mSampleRate = SampleRate;
+    mFftFrameSize = FftFrameSize;
+    mHopFrameSize = HopFrameSize;
+
+    // all trackers depend on the settings: recreate them on first use
+    ReleaseAubioObjects();
+    mpRhythmTracker.Delete();
+
+    mpFftTransform = TOwnerPtr<TFftTransformReal>(new TFftTransformReal());
+    mpFftTransform->Initialize(mFftFrameSize, TFftTransformReal::kDivFwdByN);
+    ++sWorkspaceAllocations;
+
+    mMagnitudeSpectrum.SetSize(mFftFrameSize);
+    mLastMagnitudeSpectrum.SetSize(mFftFrameSize);
+    mWhitenedSpectrum.SetSize(mFftFrameSize);
+    mPeakSpectrum.SetSize(mFftFrameSize);
+    mHarmonicSpectrum.SetSize(mFftFrameSize);
+
+    mSortedMagnitudes.SetSize(mFftFrameSize / 2);
+    ++sWorkspaceAllocations;
+  }
+  else
+  {
+    // NB: aubio's pitch tracker has no reset function. It only memorizes the last
+    // input frame, which gets fully overwritten when feeding it with whole frames.
+    if (mpSpectralWhitening)
+    {
+      ::aubio_spectral_whitening_reset(mpSpectralWhitening);
+    }
+
+    if (mpRhythmTracker)
+    {
+      mpRhythmTracker->Reset();
+    }
+  }
+
+  mMagnitudeSpectrum.Init(0.0);
+  mLastMagnitudeSpectrum.Init(0.0);
+  mWhitenedSpectrum.Init(0.0);
+  mPeakSpectrum.Init(0.0);
+  mHarmonicSpectrum.Init(0.0);
+
+  mPeaks.ClearEntries();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TFftTransformReal& TSampleAnalysisWorkspace::FftTransform()
+{
+  MAssert(mpFftTransform, "Workspace is not yet initialized: call 'Reset' first");
+
+  return *mpFftTransform;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TAutocorrelation::TWorkspace& TSampleAnalysisWorkspace::AutocorrelationWorkspace()
+{
+  return *mpAutocorrelationWorkspace;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+aubio_pitch_t* TSampleAnalysisWorkspace::PitchTracker(
+  const char* pMethod,
+  double      Tolerance,
+  double      SilenceThresholdDb)
+{
+  MAssert(mFftFrameSize > 0, "Workspace is not yet initialized: call 'Reset' first");
+
+  if (mpPitchTracker == NULL)
+  {
+    mpPitchTracker = ::new_aubio_pitch(pMethod,
+      mFftFrameSize, mHopFrameSize, mSampleRate);
+    ::aubio_pitch_set_tolerance(mpPitchTracker, Tolerance);
+    ::aubio_pitch_set_silence(mpPitchTracker, SilenceThresholdDb);
+    ::aubio_pitch_set_unit(mpPitchTracker, "freq");
+
+    ++sWorkspaceAllocations;
+  }
+
+  return mpPitchTracker;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+aubio_spectral_whitening_t* TSampleAnalysisWorkspace::SpectralWhitening(double RelaxTime)
+{
+  MAssert(mFftFrameSize > 0, "Workspace is not yet initialized: call 'Reset' first");
+
+  if (mpSpectralWhitening == NULL)
+  {
+    mpSpectralWhitening = ::new_aubio_spectral_whitening(
+      mFftFrameSize, mHopFrameSize, mSampleRate);
+    ::aubio_spectral_whitening_set_relax_time(mpSpectralWhitening, RelaxTime);
+
+    ++sWorkspaceAllocations;
+  }
+
+  return mpSpectralWhitening;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TRhythmTracker& TSampleAnalysisWorkspace::RhythmTracker(int FftSize, int HopSize)
+{
+  MAssert(mSampleRate > 0, "Workspace is not yet initialized: call 'Reset' first");
+
+  if (!mpRhythmTracker || FftSize != mRhythmFftSize || HopSize != mRhythmHopSize)
+  {
+    mRhythmFftSize = FftSize;
+    mRhythmHopSize = HopSize;
+
+    mpRhythmTracker = TOwnerPtr<TRhythmTracker>(
+      new TRhythmTracker(mSampleRate, FftSize, HopSize));
+
+    ++sWorkspaceAllocations;
+  }
+
+  return *mpRhythmTracker;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleAnalysisWorkspace::ReleaseAubioObjects()
+{
+  if (mpPitchTracker)
+  {
+    ::del_aubio_pitch(mpPitchTracker);
+    mpPitchTracker = NULL;
+  }
+
+  if (mpSpectralWhitening)
+  {
+    ::del_aubio_spectral_whitening(mpSpectralWhitening);
+    mpSpectralWhitening = NULL;
+  }
+}
+
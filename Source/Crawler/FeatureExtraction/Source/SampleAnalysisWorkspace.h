@@ -0,0 +1,95 @@
+#pragma once
+
+#ifndef _SampleAnalysisWorkspace_h_
+#define _SampleAnalysisWorkspace_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/Array.h"
+#include "CoreTypes/Export/List.h"
+#include "CoreTypes/Export/Pair.h"
+#include "CoreTypes/Export/Pointer.h"
+
+#include "FeatureExtraction/Export/SampleAnalyser.h"
+
+#include "../../3rdParty/Aubio/Export/Aubio.h"
+
+class TFftTransformReal;
+class TRhythmTracker;
+namespace TAutocorrelation { class TWorkspace; }
+
+// =================================================================================================
+
+/*!
+ * Reusable FFTs, pitch and rhythm trackers and frame buffers for TSampleAnalyser.
+ *
+ * A workspace is reset for each analyzed sample. Objects and buffers only get
+ * (re)allocated when the analysis settings changed, else their states are cleared.
+ * Workspaces are not thread-safe: TSampleAnalyser keeps one workspace per thread.
+!*/
+
+class TSampleAnalysisWorkspace
+{
+public:
+  //! allocation counters of all workspaces (see TSampleAnalyser::SWorkspaceCounters)
+  static TSampleAnalyser::TWorkspaceCounters SCounters();
+
+  TSampleAnalysisWorkspace();
+  ~TSampleAnalysisWorkspace();
+
+  //! Prepare the workspace for a new sample with the given settings.
+  void Reset(int SampleRate, int FftFrameSize, int HopFrameSize);
+
+  //! real FFT with FftFrameSize, dividing forward transforms by N
+  TFftTransformReal& FftTransform();
+
+  //! autocorrelation buffers and FFTs
+  TAutocorrelation::TWorkspace& AutocorrelationWorkspace();
+
+  //! aubio pitch tracker with FftFrameSize and HopFrameSize. Settings are
+  //! applied when the tracker gets created on first use only.
+  aubio_pitch_t* PitchTracker(
+    const char* pMethod,
+    double      Tolerance,
+    double      SilenceThresholdDb);
+  //! aubio spectral whitening with FftFrameSize and HopFrameSize. Settings are
+  //! applied when the whitening gets created on first use only.
+  aubio_spectral_whitening_t* SpectralWhitening(double RelaxTime);
+
+  //! rhythm tracker with the given FFT and hop size
+  TRhythmTracker& RhythmTracker(int FftSize, int HopSize);
+
+  //! frame spectrum buffers with FftFrameSize entries
+  TArray<double> mMagnitudeSpectrum;
+  TArray<double> mLastMagnitudeSpectrum;
+  TArray<double> mWhitenedSpectrum;
+  TArray<double> mPeakSpectrum;
+  TArray<double> mHarmonicSpectrum;
+
+  //! magnitude buffer with FftFrameSize / 2 entries, which can be sorted
+  TArray<double> mSortedMagnitudes;
+
+  //! peak list buffer for TStatistics::Peaks
+  TList< TPair<int, double> > mPeaks;
+
+private:
+  void ReleaseAubioObjects();
+
+  int mSampleRate;
+  int mFftFrameSize;
+  int mHopFrameSize;
+
+  TOwnerPtr<TFftTransformReal> mpFftTransform;
+  TOwnerPtr<TAutocorrelation::TWorkspace> mpAutocorrelationWorkspace;
+
+  aubio_pitch_t* mpPitchTracker;
+  aubio_spectral_whitening_t* mpSpectralWhitening;
+
+  TOwnerPtr<TRhythmTracker> mpRhythmTracker;
+  int mRhythmFftSize;
+  int mRhythmHopSize;
+};
+
+
+#endif // _SampleAnalysisWorkspace_h_
+
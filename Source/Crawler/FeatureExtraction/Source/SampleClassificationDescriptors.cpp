@@ -383,6 +383,57 @@ void TSampleClassificationDescriptors::SExit()
 
 // -------------------------------------------------------------------------------------------------
 
+TList<const TSampleDescriptors::TDescriptor*> TSampleClassificationDescriptors::SUsedDescriptors(
+  const TSampleDescriptors& Descriptors)
+{
+  // NB: keep this in sync with the features which are added in the constructor below
+  TList<const TSampleDescriptors::TDescriptor*> Ret;
+
+  Ret.Append(&Descriptors.mSpectrumBands);
+
+  Ret.Append(&Descriptors.mSpectralRms);
+  Ret.Append(&Descriptors.mSpectralFlatness);
+  Ret.Append(&Descriptors.mSpectralFlux);
+  Ret.Append(&Descriptors.mSpectralContrast);
+  Ret.Append(&Descriptors.mSpectralComplexity);
+  Ret.Append(&Descriptors.mF0Confidence);
+
+  Ret.Append(&Descriptors.mSpectralRmsBands);
+  Ret.Append(&Descriptors.mSpectralFlatnessBands);
+  Ret.Append(&Descriptors.mSpectralFluxBands);
+  Ret.Append(&Descriptors.mSpectralComplexityBands);
+  Ret.Append(&Descriptors.mSpectralContrastBands);
+  Ret.Append(&Descriptors.mCepstrumBands);
+
+  Ret.Append(&Descriptors.mAmplitudeRms);
+  Ret.Append(&Descriptors.mAmplitudeSilence);
+
+  Ret.Append(&Descriptors.mRhythmComplexTempoConfidence);
+  Ret.Append(&Descriptors.mRhythmPercussiveTempoConfidence);
+  Ret.Append(&Descriptors.mRhythmComplexOnsetContrast);
+  Ret.Append(&Descriptors.mRhythmPercussiveOnsetContrast);
+  Ret.Append(&Descriptors.mRhythmComplexOnsetStrength);
+  Ret.Append(&Descriptors.mRhythmPercussiveOnsetStrength);
+
+  Ret.Append(&Descriptors.mEffectiveLength12dB);
+
+  return Ret;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TSampleClassificationDescriptors::SLastUsedTimeFrame()
+{
+  int Ret = 0;
+  for (int i = 0; i < sTimeSeriesLength; ++i)
+  {
+    Ret = MMax(Ret, sTimeSeries[i]);
+  }
+  return Ret;
+}
+
+// -------------------------------------------------------------------------------------------------
+
 TSampleClassificationDescriptors::TSampleClassificationDescriptors()
   : mFeatures(),
     mFileName()
@@ -0,0 +1,260 @@
+#include "CoreTypes/Export/Log.h"
+#include "CoreTypes/Export/Debug.h"
+#include "CoreTypes/Export/Exception.h"
+
+#include "FeatureExtraction/Export/SampleClassificationStage.h"
+#include "FeatureExtraction/Export/SampleAnalyser.h"
+#include "FeatureExtraction/Export/SampleAnalysisCache.h"
+#include "FeatureExtraction/Export/SampleDescriptorPool.h"
+
+#include <chrono>
+
+// =================================================================================================
+
+// local log name prefix
+#define MLogPrefix "Classifier"
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleClassificationStage::TSampleClassificationStage(
+  const TSampleAnalyser*  pAnalyser,
+  TSampleDescriptorPool*  pPool,
+  std::mutex&             PoolLock,
+  int                     BatchSize,
+  int                     BatchTimeInMs,
+  int                     MaxQueueSize)
+  : mpAnalyser(pAnalyser),
+    mpPool(pPool),
+    mPoolLock(PoolLock),
+    mBatchSize(BatchSize),
+    mBatchTimeInMs(BatchTimeInMs),
+    mMaxQueueSize(MaxQueueSize),
+    mClassifying(false),
+    mPendingFlushes(0),
+    mStopClassifier(false)
+{
+  MAssert(mBatchSize > 0 && mBatchTimeInMs > 0, "Invalid batch settings");
+  MAssert(mMaxQueueSize >= mBatchSize, "Queue should be able to hold a batch");
+
+  mClassifierThread = std::thread(&TSampleClassificationStage::ClassifierThread, this);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleClassificationStage::~TSampleClassificationStage()
+{
+  {
+    const std::lock_guard<std::mutex> Lock(mQueueLock);
+    mStopClassifier = true;
+  }
+  mClassifierCondition.notify_one();
+
+  // classifier thread will drain the queue before it quits
+  mClassifierThread.join();
+
+  if (!mWriteError.IsEmpty())
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Pending write errors: %s",
+      mWriteError.StdCString().c_str());
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleClassificationStage::Push(
+  const TString&                            FileName,
+  const TSampleAnalysisCache::TContentKey&  ContentKey,
+  const TSampleDescriptors&                 Results)
+{
+  TPendingSample Sample;
+  Sample.mFileName = FileName;
+  Sample.mContentKey = ContentKey;
+  Sample.mpResults = TOwnerPtr<TSampleDescriptors>(new TSampleDescriptors(Results));
+
+  std::unique_lock<std::mutex> Lock(mQueueLock);
+
+  // block until the classifier catched up
+  mQueueDrainedCondition.wait(Lock, [this]() {
+    return (int)mQueue.size() < mMaxQueueSize || !mWriteError.IsEmpty();
+  });
+
+  // don't queue more samples when writing failed
+  if (!mWriteError.IsEmpty())
+  {
+    throw TReadableException(mWriteError);
+  }
+
+  mQueue.push_back(Sample);
+
+  if ((int)mQueue.size() >= mBatchSize)
+  {
+    mClassifierCondition.notify_one();
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleClassificationStage::Flush() const
+{
+  std::unique_lock<std::mutex> Lock(mQueueLock);
+
+  ++mPendingFlushes;
+  mClassifierCondition.notify_one();
+
+  mQueueDrainedCondition.wait(Lock, [this]() {
+    return mQueue.empty() && !mClassifying;
+  });
+
+  --mPendingFlushes;
+
+  if (!mWriteError.IsEmpty())
+  {
+    throw TReadableException(mWriteError);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleClassificationStage::ClassifySamples(std::deque<TPendingSample>& Samples)
+{
+  // evaluate the models for the whole batch: samples which fail to classify
+  // get an error, but don't affect the other samples in the batch
+  try
+  {
+    TList<TSampleDescriptors*> Results;
+    Results.PreallocateSpace((int)Samples.size());
+
+    for (auto& Sample : Samples)
+    {
+      Results.Append(Sample.mpResults.Object());
+    }
+
+    const TList<TString> Errors = mpAnalyser->Classify(Results);
+
+    for (size_t i = 0; i < Samples.size(); ++i)
+    {
+      Samples[i].mClassifyError = Errors[(int)i];
+    }
+  }
+  catch (const std::exception& Exception)
+  {
+    for (auto& Sample : Samples)
+    {
+      Sample.mClassifyError = Exception.what();
+    }
+  }
+
+  // cache successfully classified results
+  TSampleAnalysisCache* pAnalysisCache = mpAnalyser->AnalysisCache();
+
+  for (auto& Sample : Samples)
+  {
+    if (!Sample.mClassifyError.IsEmpty())
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Failed to classify '%s' - '%s'",
+        Sample.mFileName.StdCString().c_str(), Sample.mClassifyError.StdCString().c_str());
+    }
+    else if (pAnalysisCache && !Sample.mContentKey.IsEmpty())
+    {
+      try
+      {
+        pAnalysisCache->Store(Sample.mFileName, Sample.mContentKey, *Sample.mpResults);
+      }
+      catch (const std::exception& Exception)
+      {
+        TLog::SLog()->AddLine(MLogPrefix, "Failed to cache results for '%s' - '%s'",
+          Sample.mFileName.StdCString().c_str(), Exception.what());
+      }
+    }
+  }
+
+  WriteSamples(Samples);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleClassificationStage::WriteSamples(std::deque<TPendingSample>& Samples)
+{
+  TString WriteError;
+
+  {
+    const std::lock_guard<std::mutex> Lock(mPoolLock);
+
+    for (auto& Sample : Samples)
+    {
+      try
+      {
+        if (Sample.mClassifyError.IsEmpty())
+        {
+          mpPool->InsertSample(Sample.mFileName, *Sample.mpResults);
+        }
+        else
+        {
+          mpPool->InsertFailedSample(Sample.mFileName,
+            TString() + "Sample failed to analyse: " + Sample.mClassifyError);
+        }
+      }
+      catch (const std::exception& Exception)
+      {
+        // memorize the first error, but try writing the remaining samples
+        if (WriteError.IsEmpty())
+        {
+          WriteError = Exception.what();
+        }
+      }
+    }
+  }
+
+  if (!WriteError.IsEmpty())
+  {
+    const std::lock_guard<std::mutex> QueueLock(mQueueLock);
+
+    if (mWriteError.IsEmpty())
+    {
+      mWriteError = WriteError;
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleClassificationStage::ClassifierThread()
+{
+  std::unique_lock<std::mutex> Lock(mQueueLock);
+
+  while (true)
+  {
+    // wait until a batch is complete, the batch time elapsed or we got stopped
+    mClassifierCondition.wait_for(Lock, std::chrono::milliseconds(mBatchTimeInMs), [this]() {
+      return mStopClassifier || ((int)mQueue.size() >= mBatchSize ||
+        (!mQueue.empty() && mPendingFlushes > 0));
+    });
+
+    if (mQueue.empty())
+    {
+      if (mStopClassifier)
+      {
+        break;
+      }
+
+      continue;
+    }
+
+    // take over all pending samples and classify them without holding the lock
+    std::deque<TPendingSample> Samples;
+    Samples.swap(mQueue);
+    mClassifying = true;
+
+    Lock.unlock();
+    mQueueDrainedCondition.notify_all();
+
+    ClassifySamples(Samples);
+
+    Lock.lock();
+    mClassifying = false;
+
+    mQueueDrainedCondition.notify_all();
+  }
+}
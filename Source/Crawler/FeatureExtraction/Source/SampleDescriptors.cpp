@@ -16,8 +16,9 @@ typedef TSampleDescriptors::TDescriptor TDescriptor;
 const TDescriptor::TExportFlags SharedDescriptorFlags = 0;
 
 // low-level descrotors, used for model generation: use doubles but allow compression
+// and fast raw binary arrays
 const TDescriptor::TExportFlags LowLevelDescriptorFlags =
-  TDescriptor::kAllowBinaryStorage;
+  TDescriptor::kAllowBinaryStorage | TDescriptor::kAllowRawArrayStorage;
 
 // high-level features: can use floating points to save space and want 
 // readable text (non binary) data
@@ -235,6 +236,17 @@ TList<TSampleDescriptors::TDescriptor*>
       Ret.Append(&mHighLevelDebugVectorVectorValue);
     #endif
   }
+
+  // classification only
+  else if (DescriptorSet == kClassificationDescriptors)
+  {
+    Ret.Append(&mClassSignature);
+    Ret.Append(&mClasses);
+    Ret.Append(&mClassStrengths);
+    Ret.Append(&mCategorySignature);
+    Ret.Append(&mCategories);
+    Ret.Append(&mCategoryStrengths);
+  }
   else
   {
     MInvalid("Unknown descriptor set");
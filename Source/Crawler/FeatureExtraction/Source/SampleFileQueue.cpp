@@ -0,0 +1,108 @@
+#include "CoreTypes/Export/Debug.h"
+
+#include "FeatureExtraction/Export/SampleFileQueue.h"
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+TSampleFileQueue::TSampleFileQueue(int MaxSize)
+  : mMaxSize(MaxSize),
+    mNumberOfPushedFiles(0),
+    mClosed(false),
+    mAborted(false)
+{
+  MAssert(mMaxSize > 0, "Invalid queue size");
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TSampleFileQueue::Push(const TString& FileName)
+{
+  {
+    std::unique_lock<std::mutex> Lock(mLock);
+    MAssert(!mClosed, "Pushing into a closed queue");
+
+    mNotFullCondition.wait(Lock, [this]() {
+      return mAborted || (int)mFileNames.size() < mMaxSize;
+    });
+
+    if (mAborted)
+    {
+      return false;
+    }
+
+    mFileNames.push_back(FileName);
+    ++mNumberOfPushedFiles;
+  }
+
+  mNotEmptyCondition.notify_one();
+  return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TSampleFileQueue::Pop(TString& FileName)
+{
+  {
+    std::unique_lock<std::mutex> Lock(mLock);
+
+    mNotEmptyCondition.wait(Lock, [this]() {
+      return mAborted || mClosed || !mFileNames.empty();
+    });
+
+    if (mAborted || mFileNames.empty())
+    {
+      return false;
+    }
+
+    FileName = mFileNames.front();
+    mFileNames.pop_front();
+  }
+
+  mNotFullCondition.notify_one();
+  return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleFileQueue::Close()
+{
+  {
+    const std::lock_guard<std::mutex> Lock(mLock);
+    mClosed = true;
+  }
+
+  mNotEmptyCondition.notify_all();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSampleFileQueue::Abort()
+{
+  {
+    const std::lock_guard<std::mutex> Lock(mLock);
+    mAborted = true;
+    mFileNames.clear();
+  }
+
+  mNotEmptyCondition.notify_all();
+  mNotFullCondition.notify_all();
+}
+
+// -------------------------------------------------------------------------------------------------
+
+bool TSampleFileQueue::IsAborted() const
+{
+  const std::lock_guard<std::mutex> Lock(mLock);
+  return mAborted;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+int TSampleFileQueue::NumberOfPushedFiles() const
+{
+  const std::lock_guard<std::mutex> Lock(mLock);
+  return mNumberOfPushedFiles;
+}
+
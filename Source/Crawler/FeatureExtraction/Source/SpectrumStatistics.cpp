@@ -0,0 +1,361 @@
+#include "CoreTypes/Export/InlineMath.h"
+
+#include "FeatureExtraction/Export/SpectrumStatistics.h"
+
+#include <cmath>
+
+// =================================================================================================
+
+// number of independent accumulators in the fused loops
+#define MNumberOfLanes 4
+
+// -------------------------------------------------------------------------------------------------
+
+// Product of magnitudes for the geometric mean, which is kept in range by moving
+// it into a sum of logs when it gets too large or small, like TStatistics does.
+
+class TGeometricMeanAccumulator
+{
+public:
+  TGeometricMeanAccumulator()
+    : mSumLog(0.0),
+      mProduct(1.0)
+  { }
+
+  void Add(double Value)
+  {
+    // prevent under and overflows
+    const double too_large = 1.e64;
+    const double too_small = 1.e-64;
+
+    mProduct *= (TMathT<double>::Abs(Value) + 1e-20); // avoid taking log(0.0)
+
+    if (mProduct > too_large || mProduct < too_small)
+    {
+      mSumLog += ::log(mProduct);
+      mProduct = 1.0;
+    }
+  }
+
+  double SumLog() const
+  {
+    return mSumLog + ::log(mProduct);
+  }
+
+private:
+  double mSumLog;
+  double mProduct;
+};
+
+// -------------------------------------------------------------------------------------------------
+
+// Sum up all lanes of an accumulator.
+
+static double SSumLanes(const double* pLanes)
+{
+  double Sum = 0.0;
+  for (int l = 0; l < MNumberOfLanes; ++l)
+  {
+    Sum += pLanes[l];
+  }
+  return Sum;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// Geometric / arithmetic mean ratio from the given sums, as TStatistics::Flatness.
+
+static double SFlatness(
+  const TGeometricMeanAccumulator*  pGeometricMeans,
+  const double*                     pFirstValue,
+  double                            Sum,
+  int                               Length)
+{
+  if (Length < 2)
+  {
+    // single value: arithmetic and geometric mean are the value itself
+    return (*pFirstValue == 0.0) ? 0.0 : 1.0;
+  }
+
+  const double ArithmeticMean = Sum / (double)Length;
+  if (ArithmeticMean == 0.0)
+  {
+    return 0.0; // silence
+  }
+
+  double SumLog = 0.0;
+  for (int l = 0; l < MNumberOfLanes; ++l)
+  {
+    SumLog += pGeometricMeans[l].SumLog();
+  }
+
+  const double GeometricMean = ::exp(SumLog / (double)Length);
+  return GeometricMean / ArithmeticMean;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// Pearson correlation from the given sums, as TStatistics::Correlation.
+
+static double SCorrelation(
+  double  Sum1,
+  double  Sum2,
+  double  SquaredSum1,
+  double  SquaredSum2,
+  double  ProductSum,
+  int     Length)
+{
+  const double Mean1 = Sum1 / Length;
+  const double Mean2 = Sum2 / Length;
+
+  const double denom2 = (SquaredSum1 - Mean1 * Mean1 * Length) *
+    (SquaredSum2 - Mean2 * Mean2 * Length);
+  const double num = ProductSum - (Mean1 * Mean2 * Length);
+
+  if (TMathT<double>::Abs(denom2) > MEpsilon)
+  {
+    return num / ::sqrt(denom2);
+  }
+
+  return 0.0;
+}
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+void TSpectrumStatistics::CalcFrameFeatures(
+  TFrameFeatures& Features,
+  const double*   pX,
+  const double*   pLastX,
+  int             Length,
+  double          RolloffPercentile,
+  double          RolloffBinFrequency)
+{
+  MAssert(Length > 0, "Expecting a non empty spectrum");
+
+  const int VectorizedLength = Length - Length % MNumberOfLanes;
+
+  // ... Pass 1: sums, weighted sums and the last spectrum's sums
+
+  double Sum[MNumberOfLanes] = { 0.0 };
+  double WeightedSum[MNumberOfLanes] = { 0.0 };
+  double SquaredSum[MNumberOfLanes] = { 0.0 };
+  double LastSum[MNumberOfLanes] = { 0.0 };
+  double LastSquaredSum[MNumberOfLanes] = { 0.0 };
+  double ProductSum[MNumberOfLanes] = { 0.0 };
+
+  for (int i = 0; i < VectorizedLength; i += MNumberOfLanes)
+  {
+    for (int l = 0; l < MNumberOfLanes; ++l)
+    {
+      const double x = pX[i + l];
+      const double y = pLastX[i + l];
+
+      Sum[l] += x;
+      WeightedSum[l] += (double)(i + l) * x;
+      SquaredSum[l] += x * x;
+      LastSum[l] += y;
+      LastSquaredSum[l] += y * y;
+      ProductSum[l] += x * y;
+    }
+  }
+
+  for (int i = VectorizedLength; i < Length; ++i)
+  {
+    const double x = pX[i];
+    const double y = pLastX[i];
+
+    Sum[0] += x;
+    WeightedSum[0] += (double)i * x;
+    SquaredSum[0] += x * x;
+    LastSum[0] += y;
+    LastSquaredSum[0] += y * y;
+    ProductSum[0] += x * y;
+  }
+
+  const double TotalSum = SSumLanes(Sum);
+  const double TotalSquaredSum = SSumLanes(SquaredSum);
+
+  const double Centroid = (TotalSum == 0.0) ? 0.0 : SSumLanes(WeightedSum) / TotalSum;
+
+
+  // ... Pass 2: central moments, geometric mean and rolloff
+
+  double SpreadSum[MNumberOfLanes] = { 0.0 };
+  double CubicSum[MNumberOfLanes] = { 0.0 };
+  double QuarticSum[MNumberOfLanes] = { 0.0 };
+  TGeometricMeanAccumulator GeometricMeans[MNumberOfLanes];
+
+  // rolloff bin: number of bins until the cumulated magnitudes reach the pivot
+  const double RolloffPivot = TotalSum * RolloffPercentile / 100.0;
+  double RolloffSum = 0.0;
+  int RolloffBins = 0;
+
+  for (int i = 0; i < VectorizedLength; i += MNumberOfLanes)
+  {
+    for (int l = 0; l < MNumberOfLanes; ++l)
+    {
+      const double x = pX[i + l];
+
+      const double BinDistance = (double)(i + l) - Centroid;
+      SpreadSum[l] += BinDistance * BinDistance * x;
+
+      const double ValueDistance = x - Centroid;
+      const double SquaredValueDistance = ValueDistance * ValueDistance;
+      CubicSum[l] += SquaredValueDistance * ValueDistance;
+      QuarticSum[l] += SquaredValueDistance * SquaredValueDistance;
+
+      GeometricMeans[l].Add(x);
+
+      RolloffBins += (RolloffSum < RolloffPivot) ? 1 : 0;
+      RolloffSum += x;
+    }
+  }
+
+  for (int i = VectorizedLength; i < Length; ++i)
+  {
+    const double x = pX[i];
+
+    const double BinDistance = (double)i - Centroid;
+    SpreadSum[0] += BinDistance * BinDistance * x;
+
+    const double ValueDistance = x - Centroid;
+    const double SquaredValueDistance = ValueDistance * ValueDistance;
+    CubicSum[0] += SquaredValueDistance * ValueDistance;
+    QuarticSum[0] += SquaredValueDistance * SquaredValueDistance;
+
+    GeometricMeans[0].Add(x);
+
+    RolloffBins += (RolloffSum < RolloffPivot) ? 1 : 0;
+    RolloffSum += x;
+  }
+
+  const double Spread = (TotalSum == 0.0) ? 0.0 : SSumLanes(SpreadSum) / TotalSum;
+
+
+  // ... Features
+
+  Features.mRms = ::sqrt(TotalSquaredSum / (double)Length);
+
+  Features.mCentroid = Centroid;
+  Features.mSpread = Spread;
+
+  if (TMathT<double>::Abs(Spread) <= MEpsilon)
+  {
+    Features.mSkewness = 0.0;
+    Features.mKurtosis = 0.0;
+  }
+  else
+  {
+    const double SquaredSpread = Spread * Spread;
+
+    Features.mSkewness = SSumLanes(CubicSum) /
+      (SquaredSpread * Spread) / (double)Length;
+    Features.mKurtosis = SSumLanes(QuarticSum) /
+      (SquaredSpread * SquaredSpread) / (double)Length - 3.0;
+  }
+
+  Features.mRolloff = RolloffBins * RolloffBinFrequency;
+
+  Features.mFlatness = SFlatness(GeometricMeans, pX, TotalSum, Length);
+
+  Features.mFlux = SCorrelation(TotalSum, SSumLanes(LastSum),
+    TotalSquaredSum, SSumLanes(LastSquaredSum), SSumLanes(ProductSum), Length);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSpectrumStatistics::CalcBandFeatures(
+  TBandFeatures&  Features,
+  const double*   pX,
+  const double*   pLastX,
+  int             Length)
+{
+  MAssert(Length > 0, "Expecting a non empty band");
+
+  const int VectorizedLength = Length - Length % MNumberOfLanes;
+
+  double Sum[MNumberOfLanes] = { 0.0 };
+  double SquaredSum[MNumberOfLanes] = { 0.0 };
+  double LastSum[MNumberOfLanes] = { 0.0 };
+  double LastSquaredSum[MNumberOfLanes] = { 0.0 };
+  double ProductSum[MNumberOfLanes] = { 0.0 };
+  double Max[MNumberOfLanes] = { 0.0 };
+  TGeometricMeanAccumulator GeometricMeans[MNumberOfLanes];
+
+  for (int i = 0; i < VectorizedLength; i += MNumberOfLanes)
+  {
+    for (int l = 0; l < MNumberOfLanes; ++l)
+    {
+      const double x = pX[i + l];
+      const double y = pLastX[i + l];
+
+      Sum[l] += x;
+      SquaredSum[l] += x * x;
+      LastSum[l] += y;
+      LastSquaredSum[l] += y * y;
+      ProductSum[l] += x * y;
+      Max[l] = MMax(Max[l], x);
+
+      GeometricMeans[l].Add(x);
+    }
+  }
+
+  for (int i = VectorizedLength; i < Length; ++i)
+  {
+    const double x = pX[i];
+    const double y = pLastX[i];
+
+    Sum[0] += x;
+    SquaredSum[0] += x * x;
+    LastSum[0] += y;
+    LastSquaredSum[0] += y * y;
+    ProductSum[0] += x * y;
+    Max[0] = MMax(Max[0], x);
+
+    GeometricMeans[0].Add(x);
+  }
+
+  const double TotalSum = SSumLanes(Sum);
+  const double TotalSquaredSum = SSumLanes(SquaredSum);
+
+  Features.mMean = (Length < 2) ? pX[0] : TotalSum / (double)Length;
+
+  Features.mMax = Max[0];
+  for (int l = 1; l < MNumberOfLanes; ++l)
+  {
+    Features.mMax = MMax(Features.mMax, Max[l]);
+  }
+
+  Features.mRms = ::sqrt(TotalSquaredSum / (double)Length);
+
+  Features.mFlatness = SFlatness(GeometricMeans, pX, TotalSum, Length);
+
+  Features.mFlux = SCorrelation(TotalSum, SSumLanes(LastSum),
+    TotalSquaredSum, SSumLanes(LastSquaredSum), SSumLanes(ProductSum), Length);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+double TSpectrumStatistics::Power(const double* pX, int Length)
+{
+  const int VectorizedLength = Length - Length % MNumberOfLanes;
+
+  double SquaredSum[MNumberOfLanes] = { 0.0 };
+
+  for (int i = 0; i < VectorizedLength; i += MNumberOfLanes)
+  {
+    for (int l = 0; l < MNumberOfLanes; ++l)
+    {
+      SquaredSum[l] += pX[i + l] * pX[i + l];
+    }
+  }
+
+  for (int i = VectorizedLength; i < Length; ++i)
+  {
+    SquaredSum[0] += pX[i] * pX[i];
+  }
+
+  return SSumLanes(SquaredSum);
+}
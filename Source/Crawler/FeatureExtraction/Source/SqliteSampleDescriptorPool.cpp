@@ -4,12 +4,16 @@
 #include "CoreTypes/Export/List.h"
 #include "CoreTypes/Export/Array.h"
 #include "CoreTypes/Export/Exception.h"
+#include "CoreTypes/Export/ByteOrder.h"
+#include "CoreTypes/Export/Memory.h"
 
 #include "FeatureExtraction/Export/SampleDescriptors.h"
 #include "FeatureExtraction/Export/SqliteSampleDescriptorPool.h"
 
 #include "../../../Msgpack/Export/Msgpack.h"
 
+#include <cstring> // memcmp
+
 typedef TSampleDescriptors::TDescriptor TSampleDescriptor;
 
 // =================================================================================================
@@ -64,6 +68,25 @@ static TString SJoinStrings(
 
 // -------------------------------------------------------------------------------------------------
 
+//! Start a new transaction, unless there's a pending batch transaction
+
+static TOwnerPtr<TDatabase::TTransaction> STransactionIfNotInBatch(
+  TDatabase&                                Database,
+  const TOwnerPtr<TDatabase::TTransaction>& pBatchTransaction)
+{
+  if (pBatchTransaction)
+  {
+    return TOwnerPtr<TDatabase::TTransaction>();
+  }
+  else
+  {
+    return TOwnerPtr<TDatabase::TTransaction>(
+      new TDatabase::TTransaction(Database));
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
 //! Raw character search to avoid TString's FindChar overhead when searching 
 //! repedeately on the same string
 
@@ -712,6 +735,466 @@ msgpack::sbuffer SToMsgpack(
   return Buffer;
 }
 
+// -------------------------------------------------------------------------------------------------
+
+/*!
+ * Raw number array BLOB encoding for VR and VVR descriptor values.
+ *
+ * Layout (all values little endian):
+ *   char[4]  magic "AFRA"
+ *   uint8    version (1)
+ *   uint8    element size: 4 = float32, 8 = float64
+ *   uint8    number of dimensions: 1 = VR, 2 = VVR
+ *   uint8    reserved (0)
+ *   uint32   number of rows (VR: number of values)
+ *   uint32   number of columns (VR: 1)
+ *   followed by rows * columns packed float32 or float64 values, row by row.
+ *
+ * The magic never is a valid msgpack array start (0x41 is a positive fixint), so 
+ * old msgpack and new raw BLOBs can be distinguished by peeking at the first byte.
+!*/
+
+#define MRawArrayMagic "AFRA"
+#define MRawArrayVersion 1
+
+enum { kRawArrayHeaderSize = 16 };
+
+// -------------------------------------------------------------------------------------------------
+
+//! Write a raw array header for the given dimensions and return the data start
+
+static char* SWriteRawArrayHeader(
+  TArray<char>&                   Buffer,
+  int                             Dimensions,
+  int                             Rows,
+  int                             Columns,
+  TSampleDescriptor::TExportFlags ExportFlags)
+{
+  const int ElementSize = (ExportFlags & 
+    TSampleDescriptor::kAllowFloatingPointPrecisionStorage) ? 4 : 8;
+
+  Buffer.SetSize(kRawArrayHeaderSize + Rows * Columns * ElementSize);
+  
+  char* pHeader = Buffer.FirstWrite();
+  TMemory::Copy(pHeader, MRawArrayMagic, 4);
+  pHeader[4] = (char)MRawArrayVersion;
+  pHeader[5] = (char)ElementSize;
+  pHeader[6] = (char)Dimensions;
+  pHeader[7] = 0;
+
+  TUInt32 Sizes[2] = { (TUInt32)Rows, (TUInt32)Columns };
+  if (TByteOrder::kSystemByteOrder != TByteOrder::kIntel)
+  {
+    TByteOrder::Swap(Sizes, 2);
+  }
+  TMemory::Copy(pHeader + 8, Sizes, sizeof(Sizes));
+
+  return pHeader + kRawArrayHeaderSize;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Write \param Count values into the raw array data and return the next write pos
+
+static char* SWriteRawArrayValues(
+  char*                           pDest,
+  const double*                   pValues,
+  int                             Count,
+  TSampleDescriptor::TExportFlags ExportFlags)
+{
+  if (ExportFlags & TSampleDescriptor::kAllowFloatingPointPrecisionStorage)
+  {
+    for (int i = 0; i < Count; ++i)
+    {
+      float Value = (float)pValues[i];
+      if (TByteOrder::kSystemByteOrder != TByteOrder::kIntel)
+      {
+        TByteOrder::Swap(Value);
+      }
+      TMemory::Copy(pDest, &Value, sizeof(float));
+      pDest += sizeof(float);
+    }
+  }
+  else if (TByteOrder::kSystemByteOrder == TByteOrder::kIntel)
+  {
+    TMemory::Copy(pDest, pValues, Count * sizeof(double));
+    pDest += Count * sizeof(double);
+  }
+  else
+  {
+    for (int i = 0; i < Count; ++i)
+    {
+      double Value = pValues[i];
+      TByteOrder::Swap(Value);
+      TMemory::Copy(pDest, &Value, sizeof(double));
+      pDest += sizeof(double);
+    }
+  }
+
+  return pDest;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Serialize VR or VVR descriptor values to raw number arrays
+
+static void SToRawArray(
+  TArray<char>&                   Buffer,
+  const TList<double>&            Value,
+  TSampleDescriptor::TExportFlags ExportFlags)
+{
+  char* pData = SWriteRawArrayHeader(Buffer, 1, Value.Size(), 1, ExportFlags);
+  SWriteRawArrayValues(pData, Value.FirstRead(), Value.Size(), ExportFlags);
+}
+
+template <size_t sSize>
+static void SToRawArray(
+  TArray<char>&                       Buffer,
+  const TStaticArray<double, sSize>&  Value,
+  TSampleDescriptor::TExportFlags     ExportFlags)
+{
+  char* pData = SWriteRawArrayHeader(Buffer, 1, (int)sSize, 1, ExportFlags);
+  SWriteRawArrayValues(pData, Value.FirstRead(), (int)sSize, ExportFlags);
+}
+
+static void SToRawArray(
+  TArray<char>&                   Buffer,
+  const TList<TList<double>>&     Value,
+  TSampleDescriptor::TExportFlags ExportFlags)
+{
+  const int Columns = Value.IsEmpty() ? 0 : Value.First().Size();
+
+  char* pData = SWriteRawArrayHeader(Buffer, 2, Value.Size(), Columns, ExportFlags);
+  for (int i = 0; i < Value.Size(); ++i)
+  {
+    MAssert(Value[i].Size() == Columns, "Expecting equally sized rows");
+    pData = SWriteRawArrayValues(pData, Value[i].FirstRead(), Columns, ExportFlags);
+  }
+}
+
+template <size_t sSize>
+static void SToRawArray(
+  TArray<char>&                             Buffer,
+  const TList<TStaticArray<double, sSize>>& Value,
+  TSampleDescriptor::TExportFlags           ExportFlags)
+{
+  char* pData = SWriteRawArrayHeader(Buffer, 2, Value.Size(), (int)sSize, ExportFlags);
+  for (int i = 0; i < Value.Size(); ++i)
+  {
+    pData = SWriteRawArrayValues(pData, Value[i].FirstRead(), (int)sSize, ExportFlags);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Check if the given VR or VVR values can be stored as raw number arrays:
+//! ragged vectors of vectors can't and need to be stored as msgpack data.
+
+static bool SCanStoreAsRawArray(const TList<double>&)
+{
+  return true;
+}
+
+template <size_t sSize>
+static bool SCanStoreAsRawArray(const TStaticArray<double, sSize>&)
+{
+  return true;
+}
+
+static bool SCanStoreAsRawArray(const TList<TList<double>>& Value)
+{
+  for (int i = 1; i < Value.Size(); ++i)
+  {
+    if (Value[i].Size() != Value[0].Size())
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template <size_t sSize>
+static bool SCanStoreAsRawArray(const TList<TStaticArray<double, sSize>>&)
+{
+  return true;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+/*!
+ * Parsed raw number array header, pointing to the BLOBs value data.
+!*/
+
+struct TRawArray
+{
+  int mDimensions;
+  int mRows;
+  int mColumns;
+  int mElementSize;
+  const char* mpData;
+};
+
+//! Parse a raw number array header. Throws TReadableException on errors.
+
+static TRawArray SParseRawArray(
+  const TString&  ColumnName,
+  const void*     pData,
+  int             DataSize)
+{
+  MAssert(TSqliteSampleDescriptorPool::SIsRawArrayBlob(pData, DataSize), 
+    "Expecting a raw array blob");
+
+  const char* pHeader = (const char*)pData;
+
+  TUInt32 Sizes[2];
+  TMemory::Copy(Sizes, pHeader + 8, sizeof(Sizes));
+  if (TByteOrder::kSystemByteOrder != TByteOrder::kIntel)
+  {
+    TByteOrder::Swap(Sizes, 2);
+  }
+
+  TRawArray Array;
+  Array.mElementSize = (int)(unsigned char)pHeader[5];
+  Array.mDimensions = (int)(unsigned char)pHeader[6];
+  Array.mRows = (int)Sizes[0];
+  Array.mColumns = (int)Sizes[1];
+  Array.mpData = pHeader + kRawArrayHeaderSize;
+
+  const char* pError = NULL;
+  if (pHeader[4] != MRawArrayVersion)
+  {
+    pError = "Unsupported raw array version";
+  }
+  else if (Array.mElementSize != 4 && Array.mElementSize != 8)
+  {
+    pError = "Unsupported raw array element size";
+  }
+  else if (Array.mDimensions != 1 && Array.mDimensions != 2)
+  {
+    pError = "Unsupported raw array dimensions";
+  }
+  else if (Array.mRows < 0 || Array.mColumns < 0 || 
+      (long long)kRawArrayHeaderSize + (long long)Array.mRows * 
+        (long long)Array.mColumns * Array.mElementSize != (long long)DataSize)
+  {
+    pError = "Raw array size mismatch";
+  }
+
+  if (pError != NULL)
+  {
+    throw TReadableException(
+      MText("Invalid binary descriptor data in column '%s': %s",
+        ColumnName, TString(pError)));
+  }
+
+  return Array;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Read \param Count values from the raw array's data, starting at \param Offset.
+
+static void SReadRawArrayValues(
+  double*           pDest,
+  const TRawArray&  Array,
+  int               Offset,
+  int               Count)
+{
+  const char* pSource = Array.mpData + Offset * Array.mElementSize;
+
+  if (Array.mElementSize == 8 && TByteOrder::kSystemByteOrder == TByteOrder::kIntel)
+  {
+    TMemory::Copy(pDest, pSource, Count * sizeof(double));
+  }
+  else if (Array.mElementSize == 8)
+  {
+    for (int i = 0; i < Count; ++i)
+    {
+      TMemory::Copy(&pDest[i], pSource + i * sizeof(double), sizeof(double));
+      TByteOrder::Swap(pDest[i]);
+    }
+  }
+  else
+  {
+    for (int i = 0; i < Count; ++i)
+    {
+      float Value;
+      TMemory::Copy(&Value, pSource + i * sizeof(float), sizeof(float));
+      if (TByteOrder::kSystemByteOrder != TByteOrder::kIntel)
+      {
+        TByteOrder::Swap(Value);
+      }
+      pDest[i] = (double)Value;
+    }
+  }
+}
+
+//! Append \param Count values from the raw array's data to the given list.
+
+static void SAppendRawArrayValues(
+  TList<double>&    List,
+  const TRawArray&  Array,
+  int               Offset,
+  int               Count)
+{
+  List.PreallocateSpace(List.Size() + Count);
+
+  double Values[256];
+  for (int i = 0; i < Count; i += (int)MCountOf(Values))
+  {
+    const int ChunkSize = MMin(Count - i, (int)MCountOf(Values));
+    SReadRawArrayValues(Values, Array, Offset + i, ChunkSize);
+    
+    for (int j = 0; j < ChunkSize; ++j)
+    {
+      List.Append(Values[j]);
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Unserialize VR or VVR descriptor values from raw number array data
+
+static void SFromRawArray(
+  const TString&  ColumnName,
+  TList<double>&  Vector,
+  const void*     pData,
+  int             DataSize)
+{
+  const TRawArray Array = SParseRawArray(ColumnName, pData, DataSize);
+  
+  if (Array.mDimensions != 1)
+  {
+    throw TReadableException(
+      MText("Invalid binary descriptor data in column '%s': %s",
+        ColumnName, TString("Expected a one dimensional raw array")));
+  }
+
+  Vector.ClearEntries();
+  SAppendRawArrayValues(Vector, Array, 0, Array.mRows);
+}
+
+static void SFromRawArray(
+  const TString&          ColumnName,
+  TList< TList<double> >& VectorOfVectors,
+  const void*             pData,
+  int                     DataSize)
+{
+  const TRawArray Array = SParseRawArray(ColumnName, pData, DataSize);
+  
+  if (Array.mDimensions != 2)
+  {
+    throw TReadableException(
+      MText("Invalid binary descriptor data in column '%s': %s",
+        ColumnName, TString("Expected a two dimensional raw array")));
+  }
+
+  VectorOfVectors.ClearEntries();
+  VectorOfVectors.PreallocateSpace(Array.mRows);
+  
+  for (int i = 0; i < Array.mRows; ++i)
+  {
+    VectorOfVectors.Append(TList<double>());
+    SAppendRawArrayValues(VectorOfVectors.Last(), 
+      Array, i * Array.mColumns, Array.mColumns);
+  }
+}
+
+template <size_t sSize>
+static void SFromRawArray(
+  const TString&                ColumnName,
+  TStaticArray<double, sSize>&  StaticArray,
+  const void*                   pData,
+  int                           DataSize)
+{
+  const TRawArray Array = SParseRawArray(ColumnName, pData, DataSize);
+  
+  if (Array.mDimensions != 1 || Array.mRows != (int)sSize)
+  {
+    throw TReadableException(
+      MText("Invalid binary descriptor data in column '%s': %s",
+        ColumnName, TString("Static array size mismatch")));
+  }
+
+  SReadRawArrayValues(StaticArray.FirstWrite(), Array, 0, (int)sSize);
+}
+
+template <size_t sSize>
+static void SFromRawArray(
+  const TString&                        ColumnName,
+  TList< TStaticArray<double, sSize> >& VectorOfArrays,
+  const void*                           pData,
+  int                                   DataSize)
+{
+  const TRawArray Array = SParseRawArray(ColumnName, pData, DataSize);
+  
+  if (Array.mDimensions != 2 || 
+      (Array.mRows > 0 && Array.mColumns != (int)sSize))
+  {
+    throw TReadableException(
+      MText("Invalid binary descriptor data in column '%s': %s",
+        ColumnName, TString("Static nested array size mismatch")));
+  }
+
+  VectorOfArrays.ClearEntries();
+  VectorOfArrays.PreallocateSpace(Array.mRows);
+  
+  for (int i = 0; i < Array.mRows; ++i)
+  {
+    VectorOfArrays.Append(TStaticArray<double, sSize>());
+    SReadRawArrayValues(VectorOfArrays.Last().FirstWrite(), 
+      Array, i * (int)sSize, (int)sSize);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+//! Serialize VR or VVR descriptor values to a BLOB: either raw array or msgpack data
+
+template <typename T>
+static void SBindBlob(
+  TDatabase::TStatement&          Statement,
+  int                             ParameterIndex,
+  const T&                        Value,
+  TSampleDescriptor::TExportFlags ExportFlags)
+{
+  if ((ExportFlags & TSampleDescriptor::kAllowRawArrayStorage) && 
+      SCanStoreAsRawArray(Value))
+  {
+    TArray<char> Buffer;
+    SToRawArray(Buffer, Value, ExportFlags);
+
+    Statement.BindBlob(ParameterIndex, Buffer.FirstRead(), Buffer.Size());
+  }
+  else
+  {
+    const msgpack::sbuffer Buffer = SToMsgpack(Value, ExportFlags);
+
+    Statement.BindBlob(ParameterIndex, Buffer.data(), (int)Buffer.size());
+  }
+}
+
+//! Unserialize VR or VVR descriptor values from raw array or msgpack BLOBs
+
+template <typename T>
+static void SFromBlob(
+  const TString&  ColumnName,
+  T&              Value,
+  const void*     pData,
+  int             DataSize)
+{
+  if (TSqliteSampleDescriptorPool::SIsRawArrayBlob(pData, DataSize))
+  {
+    SFromRawArray(ColumnName, Value, pData, DataSize);
+  }
+  else
+  {
+    SFromMsgpack(ColumnName, Value, pData, DataSize);
+  }
+}
+
 // =================================================================================================
 
 /*!
@@ -783,7 +1266,7 @@ private:
  * Visitor for the TSampleDescriptors::TDescriptor::TValue variant:
  * Get a sqlite column type for the variants actual type.
  * 
- * BLOBS are always encoded with msgpack, TEXT as JSON.
+ * BLOBS are encoded as raw number arrays or msgpack, TEXT as JSON.
  * INTEGERS or REAL are raw integers or doubles.
 !*/
 
@@ -891,10 +1374,7 @@ public:
   {
     if (mDescriptor.mExportFlags & TSampleDescriptor::kAllowBinaryStorage)
     {
-      const msgpack::sbuffer Buffer = 
-        SToMsgpack(*pValue, mDescriptor.mExportFlags);
-      
-      mStatement.BindBlob(mParameterIndex, Buffer.data(), (int)Buffer.size());
+      SBindBlob(mStatement, mParameterIndex, *pValue, mDescriptor.mExportFlags);
     }
     else
     {
@@ -908,10 +1388,7 @@ public:
   {
     if (mDescriptor.mExportFlags & TSampleDescriptor::kAllowBinaryStorage)
     {
-      const msgpack::sbuffer Buffer = 
-        SToMsgpack(*pValue, mDescriptor.mExportFlags);
-
-      mStatement.BindBlob(mParameterIndex, Buffer.data(), (int)Buffer.size());
+      SBindBlob(mStatement, mParameterIndex, *pValue, mDescriptor.mExportFlags);
     }
     else
     {
@@ -924,10 +1401,7 @@ public:
   {
     if (mDescriptor.mExportFlags & TSampleDescriptor::kAllowBinaryStorage)
     {
-      const msgpack::sbuffer Buffer = 
-        SToMsgpack(*pValue, mDescriptor.mExportFlags);
-
-      mStatement.BindBlob(mParameterIndex, Buffer.data(), (int)Buffer.size());
+      SBindBlob(mStatement, mParameterIndex, *pValue, mDescriptor.mExportFlags);
     }
     else
     {
@@ -941,10 +1415,7 @@ public:
   {
     if (mDescriptor.mExportFlags & TSampleDescriptor::kAllowBinaryStorage)
     {
-      const msgpack::sbuffer Buffer = 
-        SToMsgpack(*pValue, mDescriptor.mExportFlags);
-      
-      mStatement.BindBlob(mParameterIndex, Buffer.data(), (int)Buffer.size());
+      SBindBlob(mStatement, mParameterIndex, *pValue, mDescriptor.mExportFlags);
     }
     else
     {
@@ -976,7 +1447,8 @@ public:
     const TString&            ColumnName)
     : mDescriptor(Descriptor),
       mStatement(Statement),
-      mColumnIndex(ColumnIndex)
+      mColumnIndex(ColumnIndex),
+      mColumnName(ColumnName)
   { }
 
   void operator()(int* pValue) const
@@ -1010,7 +1482,7 @@ public:
       const void* pRawColumnContent = mStatement.ColumnBlob(
         mColumnIndex, RawColumnContentSize);
 
-      SFromMsgpack(mColumnName, *pValue, 
+      SFromBlob(mColumnName, *pValue, 
         pRawColumnContent, RawColumnContentSize);
     }
     else
@@ -1032,7 +1504,7 @@ public:
       const void* pRawColumnContent = mStatement.ColumnBlob(
         mColumnIndex, RawColumnContentSize);
 
-      SFromMsgpack(mColumnName, *pValue,
+      SFromBlob(mColumnName, *pValue,
         pRawColumnContent, RawColumnContentSize);
     }
     else
@@ -1053,7 +1525,7 @@ public:
       const void* pRawColumnContent = mStatement.ColumnBlob(
         mColumnIndex, RawColumnContentSize);
 
-      SFromMsgpack(mColumnName, *pValue,
+      SFromBlob(mColumnName, *pValue,
         pRawColumnContent, RawColumnContentSize);
     }
     else
@@ -1075,7 +1547,7 @@ public:
       const void* pRawColumnContent = mStatement.ColumnBlob(
         mColumnIndex, RawColumnContentSize);
 
-      SFromMsgpack(mColumnName, *pValue,
+      SFromBlob(mColumnName, *pValue,
         pRawColumnContent, RawColumnContentSize);
     }
     else
@@ -1099,6 +1571,44 @@ private:
 
 // -------------------------------------------------------------------------------------------------
 
+bool TSqliteSampleDescriptorPool::SIsRawArrayBlob(const void* pData, int DataSize)
+{
+  return (pData != NULL && DataSize >= kRawArrayHeaderSize &&
+    ::memcmp(pData, MRawArrayMagic, 4) == 0);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TList< TList<double> > TSqliteSampleDescriptorPool::SDecodeRawArrayBlob(
+  const TString&  ColumnName,
+  const void*     pData,
+  int             DataSize)
+{
+  TList< TList<double> > Rows;
+
+  if (!SIsRawArrayBlob(pData, DataSize))
+  {
+    throw TReadableException(
+      MText("Invalid binary descriptor data in column '%s': Missing raw array header",
+        ColumnName));
+  }
+
+  const TRawArray Array = SParseRawArray(ColumnName, pData, DataSize);
+  if (Array.mDimensions == 1)
+  {
+    Rows.Append(TList<double>());
+    SAppendRawArrayValues(Rows.Last(), Array, 0, Array.mRows);
+  }
+  else
+  {
+    SFromRawArray(ColumnName, Rows, pData, DataSize);
+  }
+
+  return Rows;
+}
+
+// -------------------------------------------------------------------------------------------------
+
 TSqliteSampleDescriptorPool::TSqliteSampleDescriptorPool(
   TSampleDescriptors::TDescriptorSet DescriptorSet)
   : TSampleDescriptorPool(DescriptorSet)
@@ -1117,6 +1627,10 @@ bool TSqliteSampleDescriptorPool::Open(
   const TString& DatabaseName,
   bool           ReadOnly)
 {
+  // statements must be released before the previous database gets closed
+  mpInsertStatement.Delete();
+  mInsertKeys.Empty();
+
   if (!mDatabase.Open(DatabaseName))
   {
     TLog::SLog()->AddLine(MLogPrefix, "Failed to open database");
@@ -1213,6 +1727,12 @@ TString TSqliteSampleDescriptorPool::AbsFilenamePath(
 
 void TSqliteSampleDescriptorPool::ShutdownDatabase()
 {
+  // roll back unfinished batches
+  mpBatchTransaction.Delete();
+
+  // release cached statements
+  mpInsertStatement.Delete();
+
   if (mDatabase.IsOpen())
   {
     mDatabase.Close();
@@ -1221,6 +1741,50 @@ void TSqliteSampleDescriptorPool::ShutdownDatabase()
 
 // -------------------------------------------------------------------------------------------------
 
+void TSqliteSampleDescriptorPool::PrepareInsertStatement()
+{
+  if (mpInsertStatement)
+  {
+    return;
+  }
+
+  // get keys from a dummy descriptor: names do not depend on the descriptor values
+  if (mInsertKeys.IsEmpty())
+  {
+    TList<TString> Keys = MakeList<TString>(
+      "filename", "modtime", "status", "filesize", "fileid");
+
+    const TSampleDescriptors ExampleDescriptors;
+
+    const TList<const TSampleDescriptor*> Descriptors =
+      ExampleDescriptors.Descriptors(mDescriptorSet);
+    for (int i = 0; i < Descriptors.Size(); ++i)
+    {
+      const TList<TPair<TString, TSampleDescriptor::TValue>>
+        DescriptorValues(Descriptors[i]->Values());
+      for (int j = 0; j < DescriptorValues.Size(); ++j)
+      {
+        const TString BaseName = DescriptorValues[j].First();
+
+        const TString NamePostfix = boost::apply_visitor(
+          TDescriptorValueNamePostfix(*Descriptors[i]),
+          DescriptorValues[j].Second());
+
+        Keys.Append(BaseName + "_" + NamePostfix);
+      }
+    }
+
+    mInsertKeys = Keys;
+  }
+
+  mpInsertStatement = TOwnerPtr<TDatabase::TStatement>(
+    new TDatabase::TStatement(mDatabase, TString() +
+      "INSERT OR REPLACE into " + MAssetsTableName + "(" + SJoinStrings(mInsertKeys, ",") + ") " +
+      "values(" + (TString("?,") * mInsertKeys.Size()).RemoveLast(",") + ")"));
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void TSqliteSampleDescriptorPool::InitializeDatabase()
 {
   bool CreateNewTables = false;
@@ -1281,7 +1845,7 @@ void TSqliteSampleDescriptorPool::InitializeDatabase()
           {
             mDatabase.Execute("DROP table 'assets'");
 
-            if (mDescriptorSet == TSampleDescriptors::kHighLevelDescriptors)
+            if (mDescriptorSet != TSampleDescriptors::kLowLevelDescriptors)
             {
               mDatabase.Execute("DROP table 'classes'");
             }
@@ -1344,6 +1908,10 @@ void TSqliteSampleDescriptorPool::InitializeDatabase()
             }
           }
 
+          // file stats got added later on: see \function AddFileStatColumns
+          ColumnNameAndTypes.Append("filesize INTEGER");
+          ColumnNameAndTypes.Append("fileid INTEGER");
+
           mDatabase.Execute(TString() +
             "CREATE TABLE " + MAssetsTableName + 
               "(" + SJoinStrings(ColumnNameAndTypes, ",") + ")");
@@ -1351,7 +1919,7 @@ void TSqliteSampleDescriptorPool::InitializeDatabase()
 
         // . create classes table
 
-        if (mDescriptorSet == TSampleDescriptors::kHighLevelDescriptors)
+        if (mDescriptorSet != TSampleDescriptors::kLowLevelDescriptors)
         {
           mDatabase.Execute(TString() + 
             "CREATE TABLE classes (classifier TEXT PRIMARY KEY, classes BLOB)");
@@ -1364,9 +1932,57 @@ void TSqliteSampleDescriptorPool::InitializeDatabase()
       TLog::SLog()->AddLine(MLogPrefix, "Table initialization failed: %s",
         Exception.what());
 
-      throw Exception;
+      throw;
+    }
+  }
+  else
+  {
+    AddFileStatColumns();
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSqliteSampleDescriptorPool::AddFileStatColumns()
+{
+  // file size and id columns are optional: add them to existing tables, instead
+  // of bumping the db version, so existing descriptors don't need to be recreated.
+  // Samples without file stats will be compared via their modification time only.
+  try
+  {
+    TDatabase::TStatement Statement(mDatabase, 
+      TString() + "SELECT * FROM " + MAssetsTableName + " LIMIT 0");
+
+    TList<TString> MissingColumns = MakeList<TString>("filesize", "fileid");
+    for (int i = 0; i < Statement.ColumnCount(); ++i)
+    {
+      const int MissingColumnIndex = MissingColumns.Find(Statement.ColumnName(i));
+      if (MissingColumnIndex != -1)
+      {
+        MissingColumns.Delete(MissingColumnIndex);
+      }
+    }
+
+    if (!MissingColumns.IsEmpty())
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Adding file stat columns...");
+
+      TDatabase::TTransaction Transaction(mDatabase);
+      for (int i = 0; i < MissingColumns.Size(); ++i)
+      {
+        mDatabase.Execute(TString() + "ALTER TABLE " + MAssetsTableName + 
+          " ADD COLUMN " + MissingColumns[i] + " INTEGER");
+      }
+      Transaction.Commit();
     }
   }
+  catch (const TReadableException& Exception)
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Table upgrade failed: %s",
+      Exception.what());
+
+    throw;
+  }
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -1454,117 +2070,215 @@ TOwnerPtr<TSampleDescriptors> TSqliteSampleDescriptorPool::Sample(int Index) con
 
       if (Statement.Step())
       {
-        if (Statement.ColumnName(0) != "filename")
-        {
-          throw TReadableException(
-            "Unexpected table layout - expected a 'filename' column as primary column");
-        }
+        const TList<TDescriptorColumn> Columns = DescriptorColumns(Statement);
+
+        return SampleFromStatement(Statement, Columns);
+      }
+    }
+    catch (const TReadableException& Exception)
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Unexpected DB error: %s",
+        Exception.what());
+      throw;
+    }
+  }
 
-        const TString FileName = Statement.ColumnText(0);
+  return TOwnerPtr<TSampleDescriptors>();
+}
 
-        if (Statement.ColumnName(1) != "modtime")
-        {
-          throw TReadableException(
-            "Unexpected table layout - expected a 'modtime' column as second column");
-        }
-        else if (Statement.ColumnName(2) != "status")
+// -------------------------------------------------------------------------------------------------
+
+void TSqliteSampleDescriptorPool::ForEachSample(const TForEachSampleFunc& Function) const
+{
+  if (mDatabase.IsOpen())
+  {
+    try
+    {
+      TSqliteSampleDescriptorPool* pMutableThis =
+        const_cast<TSqliteSampleDescriptorPool*>(this);
+
+      TDatabase::TStatement Statement(pMutableThis->mDatabase,
+        TString() + "SELECT * FROM " + MAssetsTableName + " " +
+        "WHERE status='succeeded';");
+
+      // column layout is the same for all rows: resolve it with the first row only
+      TList<TDescriptorColumn> Columns;
+      bool ResolvedColumns = false;
+
+      while (Statement.Step())
+      {
+        if (!ResolvedColumns)
         {
-          throw TReadableException(
-            "Unexpected table layout - expected a 'status' column as third column");
+          Columns = DescriptorColumns(Statement);
+          ResolvedColumns = true;
         }
 
-        MAssert(Statement.ColumnText(2) == "succeeded",
-          "Expecting to extract succeeded samples only");
+        const TOwnerPtr<TSampleDescriptors> pSample = 
+          SampleFromStatement(Statement, Columns);
+
+        Function(*pSample);
+      }
+    }
+    catch (const TReadableException& Exception)
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Unexpected DB error: %s",
+        Exception.what());
+      throw;
+    }
+  }
+}
 
-        const TString NormalizedFileName = RelativeFilenamePath(FileName);
+// -------------------------------------------------------------------------------------------------
 
-        // create new sample and unserialize all descriptors
-        TOwnerPtr<TSampleDescriptors> pResults(new TSampleDescriptors);
-        pResults->mFileName = NormalizedFileName;
+TList<TSqliteSampleDescriptorPool::TDescriptorColumn> 
+TSqliteSampleDescriptorPool::DescriptorColumns(TDatabase::TStatement& Statement) const
+{
+  if (Statement.ColumnName(0) != "filename")
+  {
+    throw TReadableException(
+      "Unexpected table layout - expected a 'filename' column as primary column");
+  }
+  else if (Statement.ColumnName(1) != "modtime")
+  {
+    throw TReadableException(
+      "Unexpected table layout - expected a 'modtime' column as second column");
+  }
+  else if (Statement.ColumnName(2) != "status")
+  {
+    throw TReadableException(
+      "Unexpected table layout - expected a 'status' column as third column");
+  }
 
-        // unserialize all descriptor values
-        const TList<TSampleDescriptor*> Descriptors =
-          pResults->Descriptors(mDescriptorSet);
+  // use a temporary sample to resolve descriptor value names
+  const TSampleDescriptors Sample;
+  const TList<const TSampleDescriptor*> Descriptors =
+    Sample.Descriptors(mDescriptorSet);
 
-        int ColumnIndexOffset = 3;
-        for (int i = 0; i < Descriptors.Size(); ++i)
-        {
-          const TList<TPair<TString, TSampleDescriptor::TValue>>
-            DescriptorValues(Descriptors[i]->Values());
+  TList<TDescriptorColumn> Ret;
 
-          for (int j = 0; j < DescriptorValues.Size(); ++j)
-          {
-            const TString BaseName = DescriptorValues[j].First();
+  int ColumnIndexOffset = 3;
+  for (int i = 0; i < Descriptors.Size(); ++i)
+  {
+    const TList<TPair<TString, TSampleDescriptor::TValue>>
+      DescriptorValues(Descriptors[i]->Values());
 
-            const TString NamePostfix = boost::apply_visitor(
-              TDescriptorValueNamePostfix(*Descriptors[i]),
-              DescriptorValues[j].Second());
+    for (int j = 0; j < DescriptorValues.Size(); ++j)
+    {
+      const TString BaseName = DescriptorValues[j].First();
 
-            const TString ColumnName = BaseName + "_" + NamePostfix;
+      const TString NamePostfix = boost::apply_visitor(
+        TDescriptorValueNamePostfix(*Descriptors[i]),
+        DescriptorValues[j].Second());
 
-            // search column from the descriptor's name and postfix
-            bool FoundColumn = false;
-            
-            const int ColumnCount = Statement.ColumnCount();
-            for (int c = 0; c < ColumnCount; ++c)
-            {
-              const int ColumnIndex = (ColumnIndexOffset + c) % ColumnCount;
-              if (Statement.ColumnName(ColumnIndex) == ColumnName)
-              {
-                // unserialize contents
-                boost::apply_visitor(
-                  TUnserializeDescriptorValueFromStatement(
-                    *Descriptors[i], Statement, ColumnIndex, ColumnName),
-                  DescriptorValues[j].Second());
-
-                // start searching the next descriptor from the next column
-                ColumnIndexOffset = ColumnIndex + 1;
-                FoundColumn = true;
-                break;
-              }
-            }
+      const TString ColumnName = BaseName + "_" + NamePostfix;
 
-            if (!FoundColumn)
-            {
-              throw TReadableException(
-                "Could not find required column '" + ColumnName + "'");
-            }
-          }
+      // search column from the descriptor's name and postfix
+      bool FoundColumn = false;
+      
+      const int ColumnCount = Statement.ColumnCount();
+      for (int c = 0; c < ColumnCount; ++c)
+      {
+        const int ColumnIndex = (ColumnIndexOffset + c) % ColumnCount;
+        if (Statement.ColumnName(ColumnIndex) == ColumnName)
+        {
+          TDescriptorColumn Column;
+          Column.mIndex = ColumnIndex;
+          Column.mName = ColumnName;
+          Ret.Append(Column);
+
+          // start searching the next descriptor from the next column
+          ColumnIndexOffset = ColumnIndex + 1;
+          FoundColumn = true;
+          break;
         }
+      }
 
-        return pResults;
+      if (!FoundColumn)
+      {
+        throw TReadableException(
+          "Could not find required column '" + ColumnName + "'");
       }
     }
-    catch (const TReadableException& Exception)
+  }
+
+  return Ret;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TOwnerPtr<TSampleDescriptors> TSqliteSampleDescriptorPool::SampleFromStatement(
+  TDatabase::TStatement&          Statement,
+  const TList<TDescriptorColumn>& DescriptorColumns) const
+{
+  MAssert(Statement.ColumnText(2) == "succeeded",
+    "Expecting to extract succeeded samples only");
+
+  const TString FileName = Statement.ColumnText(0);
+  const TString NormalizedFileName = RelativeFilenamePath(FileName);
+
+  // create new sample and unserialize all descriptors
+  TOwnerPtr<TSampleDescriptors> pResults(new TSampleDescriptors);
+  pResults->mFileName = NormalizedFileName;
+
+  // unserialize all descriptor values
+  const TList<TSampleDescriptor*> Descriptors =
+    pResults->Descriptors(mDescriptorSet);
+
+  TList<TSampleDescriptor::TValue> DescriptorValues;
+  DescriptorValues.PreallocateSpace(DescriptorColumns.Size());
+
+  int ValueIndex = 0;
+  for (int i = 0; i < Descriptors.Size(); ++i)
+  {
+    DescriptorValues.ClearEntries();
+    Descriptors[i]->AppendValues(DescriptorValues);
+
+    for (int j = 0; j < DescriptorValues.Size(); ++j, ++ValueIndex)
     {
-      TLog::SLog()->AddLine(MLogPrefix, "Unexpected DB error: %s",
-        Exception.what());
-      throw;
+      const TDescriptorColumn& Column = DescriptorColumns[ValueIndex];
+
+      boost::apply_visitor(
+        TUnserializeDescriptorValueFromStatement(
+          *Descriptors[i], Statement, Column.mIndex, Column.mName),
+        DescriptorValues[j]);
     }
   }
 
-  return TOwnerPtr<TSampleDescriptors>();
+  MAssert(ValueIndex == DescriptorColumns.Size(), 
+    "Unexpected column mapping");
+
+  return pResults;
 }
 
 // -------------------------------------------------------------------------------------------------
 
-TList<TPair<TString, int>> TSqliteSampleDescriptorPool::SampleModificationDates() const
+TList<TSampleDescriptorPool::TSampleFileStat> TSqliteSampleDescriptorPool::SampleFileStats() const
 {
-  TList<TPair<TString, int>> Ret;
+  TList<TSampleFileStat> Ret;
 
   try
   {
     TSqliteSampleDescriptorPool* pMutableThis =
       const_cast<TSqliteSampleDescriptorPool*>(this);
 
+    Ret.PreallocateSpace(mDatabase.ExecuteScalarInt(
+      TString() + "SELECT COUNT(*) FROM " + MAssetsTableName));
+
     TDatabase::TStatement Statement(pMutableThis->mDatabase,
-      TString() + "SELECT filename, modtime FROM " + MAssetsTableName);
+      TString() + "SELECT filename, modtime, filesize, fileid FROM " + MAssetsTableName);
 
     while (Statement.Step())
     {
-      const TString AbsFileName = AbsFilenamePath(Statement.ColumnText(0));
-      const int ModTime = Statement.ColumnInt(1);
-      Ret.Append(MakePair(AbsFileName, ModTime));
+      TSampleFileStat SampleFileStat;
+      SampleFileStat.mFileName = AbsFilenamePath(Statement.ColumnText(0));
+      SampleFileStat.mStat.mModificationStatTime = Statement.ColumnInt(1);
+      // NULL for samples which got inserted before file stats got recorded
+      SampleFileStat.mStat.mSizeInBytes = Statement.IsColumnNull(2) ? 
+        0 : Statement.ColumnInt64(2);
+      SampleFileStat.mStat.mFileId = Statement.IsColumnNull(3) ? 
+        0 : Statement.ColumnInt64(3);
+      
+      Ret.Append(SampleFileStat);
     }
   }
   catch (const TReadableException& Exception)
@@ -1584,69 +2298,63 @@ void TSqliteSampleDescriptorPool::InsertSample(
   const TSampleDescriptors&  Results)
 {
   const TString RelFilename = RelativeFilenamePath(FileName);
-  const int ModificationStatTime = TFile(FileName).ModificationStatTime();
+
+  TFile::TStat FileStat;
+  TFile(FileName).Stat(FileStat);
 
   try
   {
-    TDatabase::TTransaction Transaction(mDatabase);
+    TOwnerPtr<TDatabase::TTransaction> pTransaction = STransactionIfNotInBatch(
+      mDatabase, mpBatchTransaction);
     {
-      // get keys from results
-      TList<TString> Keys = MakeList<TString>("filename", "modtime", "status");
-
-      const TList<const TSampleDescriptor*> Descriptors =
-        Results.Descriptors(mDescriptorSet);
-      for (int i = 0; i < Descriptors.Size(); ++i)
-      {
-        const TList<TPair<TString, TSampleDescriptor::TValue>>
-          DescriptorValues(Descriptors[i]->Values());
-        for (int j = 0; j < DescriptorValues.Size(); ++j)
-        {
-          const TString BaseName = DescriptorValues[j].First();
-
-          const TString NamePostfix = boost::apply_visitor(
-            TDescriptorValueNamePostfix(*Descriptors[i]),
-            DescriptorValues[j].Second());
-
-          Keys.Append(BaseName + "_" + NamePostfix);
-        }
-      }
+      PrepareInsertStatement();
 
-      // create statement
-      TDatabase::TStatement InsertStatement(mDatabase, TString() +
-        "INSERT OR REPLACE into " + MAssetsTableName + "(" + SJoinStrings(Keys, ",") + ") " +
-        "values(" + (TString("?,") * Keys.Size()).RemoveLast(",") + ")");
+      TDatabase::TStatement& InsertStatement = *mpInsertStatement;
+      InsertStatement.Reset();
+      InsertStatement.ClearBindings();
 
       // bind values to the statement
-      InsertStatement.BindText(1, RelFilename);
-      InsertStatement.BindInt (2, ModificationStatTime);
-      InsertStatement.BindText(3, "succeeded");
+      InsertStatement.BindText (1, RelFilename);
+      InsertStatement.BindInt  (2, FileStat.mModificationStatTime);
+      InsertStatement.BindText (3, "succeeded");
+      InsertStatement.BindInt64(4, FileStat.mSizeInBytes);
+      InsertStatement.BindInt64(5, FileStat.mFileId);
 
-      int ParameterIndex = 4;
+      int ParameterIndex = 6;
 
+      const TList<const TSampleDescriptor*> Descriptors =
+        Results.Descriptors(mDescriptorSet);
       for (int i = 0; i < Descriptors.Size(); ++i)
       {
-        const TList<TPair<TString, TSampleDescriptor::TValue>>
-          DescriptorValues(Descriptors[i]->Values());
-        for (int j = 0; j < DescriptorValues.Size(); ++j)
+        mInsertValues.ClearEntries();
+        Descriptors[i]->AppendValues(mInsertValues);
+
+        for (int j = 0; j < mInsertValues.Size(); ++j)
         {
           boost::apply_visitor(
             TBindDescriptorValueToStatement(
               *Descriptors[i], InsertStatement, ParameterIndex),
-            DescriptorValues[j].Second());
+            mInsertValues[j]);
           ++ParameterIndex;
         }
       }
 
+      MAssert(ParameterIndex == mInsertKeys.Size() + 1, 
+        "Descriptor values and insert keys are out of sync");
+
       InsertStatement.Execute();
     }
-    Transaction.Commit();
+    if (pTransaction)
+    {
+      pTransaction->Commit();
+    }
   }
   catch (const TReadableException& Exception)
   {
     TLog::SLog()->AddLine(MLogPrefix, "Inserting %s failed: %s",
       RelFilename.StdCString().c_str(), Exception.what());
 
-    throw Exception;
+    throw;
   }
 }
 
@@ -1657,30 +2365,38 @@ void TSqliteSampleDescriptorPool::InsertFailedSample(
   const TString& Reason)
 {
   const TString RelFilename = RelativeFilenamePath(FileName);
-  const int ModificationStatTime = TFile(FileName).ModificationStatTime();
+
+  TFile::TStat FileStat;
+  TFile(FileName).Stat(FileStat);
 
   try
   {
-    TDatabase::TTransaction Transaction(mDatabase);
+    TOwnerPtr<TDatabase::TTransaction> pTransaction = STransactionIfNotInBatch(
+      mDatabase, mpBatchTransaction);
     {
       TDatabase::TStatement InsertStatement(mDatabase, TString() +
-        "INSERT OR REPLACE into " + MAssetsTableName + "(filename, modtime, status) "
-          "values (?,?,?)");
+        "INSERT OR REPLACE into " + MAssetsTableName + 
+          "(filename, modtime, status, filesize, fileid) values (?,?,?,?,?)");
       
-      InsertStatement.BindText(1, RelFilename);
-      InsertStatement.BindInt (2, ModificationStatTime);
-      InsertStatement.BindText(3, "error: " + Reason);
+      InsertStatement.BindText (1, RelFilename);
+      InsertStatement.BindInt  (2, FileStat.mModificationStatTime);
+      InsertStatement.BindText (3, "error: " + Reason);
+      InsertStatement.BindInt64(4, FileStat.mSizeInBytes);
+      InsertStatement.BindInt64(5, FileStat.mFileId);
 
       InsertStatement.Execute();
     }
-    Transaction.Commit();
+    if (pTransaction)
+    {
+      pTransaction->Commit();
+    }
   }
   catch (const TReadableException& Exception)
   {
     TLog::SLog()->AddLine(MLogPrefix, "Inserting %s as failed, failed: %s",
       RelFilename.StdCString().c_str(), Exception.what());
 
-    throw Exception;
+    throw;
   }
 }
 
@@ -1705,30 +2421,121 @@ void TSqliteSampleDescriptorPool::RemoveSamples(const TList<TString>& FileNames)
 
   try
   {
-    // delete samples in batches: this is more efficient than trying to delete 
-    // all in one go (when there are thousands to delete) and also one by one.
-    const int NumberOfSamplesPerDeleteBatch = 100;
+    // collect all names in a temp table and delete them in one go: a per name 
+    // 'MATCH' can't use the filename index and would scan the table for each name.
+    TOwnerPtr<TDatabase::TTransaction> pTransaction = STransactionIfNotInBatch(
+      mDatabase, mpBatchTransaction);
+    {
+      #if defined(MLinux)
+        // be case sensitive on Linux (see SFileNameMatchOperator)
+        const TString Collation = "";
+      #else
+        const TString Collation = " COLLATE NOCASE";
+      #endif
+
+      mDatabase.Execute(
+        "CREATE TEMP TABLE IF NOT EXISTS removed_assets(filename TEXT PRIMARY KEY)");
+      mDatabase.Execute("DELETE FROM temp.removed_assets");
+
+      TDatabase::TStatement InsertStatement(mDatabase, 
+        "INSERT OR IGNORE INTO temp.removed_assets(filename) values(?)");
+      for (int i = 0; i < RelFilenames.Size(); ++i)
+      {
+        InsertStatement.BindText(1, RelFilenames[i]);
+        InsertStatement.Execute();
+      }
+
+      mDatabase.Execute(TString() + "DELETE FROM " + MAssetsTableName + 
+        " WHERE filename" + Collation + " IN (SELECT filename FROM temp.removed_assets)");
+      mDatabase.Execute("DELETE FROM temp.removed_assets");
+    }
+    if (pTransaction)
+    {
+      pTransaction->Commit();
+    }
+  }
+  catch (const TReadableException& Exception)
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Removing samples failed: %s",
+      Exception.what());
 
-    TDatabase::TStatement RemoveStatement(mDatabase, TString() +
-      "DELETE from " + MAssetsTableName + " WHERE filename MATCH ?");
+    throw;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
 
-    while (!RelFilenames.IsEmpty()) 
+void TSqliteSampleDescriptorPool::RenameSamples(
+  const TList< TPair<TString, TString> >& OldAndNewFileNames)
+{
+  try
+  {
+    TOwnerPtr<TDatabase::TTransaction> pTransaction = STransactionIfNotInBatch(
+      mDatabase, mpBatchTransaction);
     {
-      TDatabase::TTransaction Transaction(mDatabase);
-      for (int i = 0; i < NumberOfSamplesPerDeleteBatch && !RelFilenames.IsEmpty(); ++i)
+      TDatabase::TStatement RenameStatement(mDatabase, TString() +
+        "UPDATE OR REPLACE " + MAssetsTableName + " SET filename = ? WHERE filename = ?");
+
+      for (int i = 0; i < OldAndNewFileNames.Size(); ++i)
       {
-        RemoveStatement.BindText(1, RelFilenames.GetAndDeleteLast());
-        RemoveStatement.Execute();
+        RenameStatement.BindText(1, RelativeFilenamePath(OldAndNewFileNames[i].Second()));
+        RenameStatement.BindText(2, RelativeFilenamePath(OldAndNewFileNames[i].First()));
+        RenameStatement.Execute();
       }
-      Transaction.Commit();
+    }
+    if (pTransaction)
+    {
+      pTransaction->Commit();
     }
   }
   catch (const TReadableException& Exception)
   {
-    TLog::SLog()->AddLine(MLogPrefix, "Removing samples failed: %s",
+    TLog::SLog()->AddLine(MLogPrefix, "Renaming samples failed: %s",
+      Exception.what());
+
+    throw;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSqliteSampleDescriptorPool::BeginBatch()
+{
+  MAssert(!mpBatchTransaction, "Batches can not be nested");
+
+  try
+  {
+    mpBatchTransaction = TOwnerPtr<TDatabase::TTransaction>(
+      new TDatabase::TTransaction(mDatabase));
+  }
+  catch (const TReadableException& Exception)
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Starting batch failed: %s",
+      Exception.what());
+
+    throw;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TSqliteSampleDescriptorPool::CommitBatch()
+{
+  MAssert(mpBatchTransaction, "Expected a pending batch");
+
+  try
+  {
+    // release batch before committing: when committing fails, 
+    // the transaction will be rolled back
+    TOwnerPtr<TDatabase::TTransaction> pTransaction(mpBatchTransaction);
+    pTransaction->Commit();
+  }
+  catch (const TReadableException& Exception)
+  {
+    TLog::SLog()->AddLine(MLogPrefix, "Committing batch failed: %s",
       Exception.what());
 
-    throw Exception;
+    throw;
   }
 }
 
@@ -1738,12 +2545,13 @@ void TSqliteSampleDescriptorPool::InsertClassifier(
   const TString&        ClassifierName,
   const TList<TString>& Classes)
 {
-  MAssert(mDescriptorSet == TSampleDescriptors::kHighLevelDescriptors,
-    "Available for high level dbs only");
+  MAssert(mDescriptorSet != TSampleDescriptors::kLowLevelDescriptors,
+    "Available for high level and classification dbs only");
 
   try
   {
-    TDatabase::TTransaction Transaction(mDatabase);
+    TOwnerPtr<TDatabase::TTransaction> pTransaction = STransactionIfNotInBatch(
+      mDatabase, mpBatchTransaction);
     {
       TDatabase::TStatement InsertStatement(mDatabase, TString() +
         "INSERT OR REPLACE into " + MClassesTableName + "(classifier, classes) "
@@ -1755,14 +2563,17 @@ void TSqliteSampleDescriptorPool::InsertClassifier(
 
       InsertStatement.Execute();
     }
-    Transaction.Commit();
+    if (pTransaction)
+    {
+      pTransaction->Commit();
+    }
   }
   catch (const TReadableException& Exception)
   {
     TLog::SLog()->AddLine(MLogPrefix, "Inserting classifier %s failed : %s",
       ClassifierName.StdCString().c_str(), Exception.what());
 
-    throw Exception;
+    throw;
   }
 }
 
@@ -143,11 +143,21 @@ TList< TPair<int, double> > TStatistics::Peaks(
   double        Threshold)
 {
   TList< TPair<int, double> > Peaks;
+  TStatistics::Peaks(Peaks, pArray, ArraySize, Threshold);
 
+  return Peaks;
+}
+
+void TStatistics::Peaks(
+  TList< TPair<int, double> >&  Peaks,
+  const double*                 pArray,
+  int                           ArraySize,
+  double                        Threshold)
+{
   // return empty handed when the array is too small
   if (ArraySize <= 2)
   {
-    return Peaks;
+    return;
   }
 
   int i = 0;
@@ -227,8 +237,6 @@ TList< TPair<int, double> > TStatistics::Peaks(
       Peaks.Append(MakePair(ArraySize - 1, pArray[ArraySize - 1]));
     }
   }
-
-  return Peaks;
 }
 
 // -------------------------------------------------------------------------------------------------
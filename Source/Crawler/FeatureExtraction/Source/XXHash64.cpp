@@ -0,0 +1,124 @@
+#include "FeatureExtraction/Source/XXHash64.h"
+
+#include <cstring> // memcpy
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+//! XXH64 primes, see https://github.com/Cyan4973/xxHash
+
+static const TUInt64 skPrime1 = 11400714785074694791ULL;
+static const TUInt64 skPrime2 = 14029467366897019727ULL;
+static const TUInt64 skPrime3 = 1609587929392839161ULL;
+static const TUInt64 skPrime4 = 9650029242287828579ULL;
+static const TUInt64 skPrime5 = 2870177450012600261ULL;
+
+// -------------------------------------------------------------------------------------------------
+
+static TUInt64 SRotateLeft(TUInt64 Value, int Bits)
+{
+  return (Value << Bits) | (Value >> (64 - Bits));
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static TUInt64 SRead64(const char* pData)
+{
+  TUInt64 Value;
+  ::memcpy(&Value, pData, sizeof(Value));
+  return Value;
+}
+
+static TUInt32 SRead32(const char* pData)
+{
+  TUInt32 Value;
+  ::memcpy(&Value, pData, sizeof(Value));
+  return Value;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static TUInt64 SRound(TUInt64 Accumulator, TUInt64 Input)
+{
+  Accumulator += Input * skPrime2;
+  Accumulator = SRotateLeft(Accumulator, 31);
+  return Accumulator * skPrime1;
+}
+
+static TUInt64 SMergeRound(TUInt64 Accumulator, TUInt64 Value)
+{
+  Accumulator ^= SRound(0, Value);
+  return Accumulator * skPrime1 + skPrime4;
+}
+
+// -------------------------------------------------------------------------------------------------
+
+TUInt64 TXXHash64::Hash(const char* pData, size_t Size, TUInt64 Seed)
+{
+  const char* pEnd = pData + Size;
+
+  TUInt64 Hash;
+
+  if (Size >= 32)
+  {
+    TUInt64 V1 = Seed + skPrime1 + skPrime2;
+    TUInt64 V2 = Seed + skPrime2;
+    TUInt64 V3 = Seed;
+    TUInt64 V4 = Seed - skPrime1;
+
+    const char* pLimit = pEnd - 32;
+    do
+    {
+      V1 = SRound(V1, SRead64(pData)); pData += 8;
+      V2 = SRound(V2, SRead64(pData)); pData += 8;
+      V3 = SRound(V3, SRead64(pData)); pData += 8;
+      V4 = SRound(V4, SRead64(pData)); pData += 8;
+    }
+    while (pData <= pLimit);
+
+    Hash = SRotateLeft(V1, 1) + SRotateLeft(V2, 7) +
+      SRotateLeft(V3, 12) + SRotateLeft(V4, 18);
+
+    Hash = SMergeRound(Hash, V1);
+    Hash = SMergeRound(Hash, V2);
+    Hash = SMergeRound(Hash, V3);
+    Hash = SMergeRound(Hash, V4);
+  }
+  else
+  {
+    Hash = Seed + skPrime5;
+  }
+
+  Hash += (TUInt64)Size;
+
+  while (pData + 8 <= pEnd)
+  {
+    Hash ^= SRound(0, SRead64(pData));
+    Hash = SRotateLeft(Hash, 27) * skPrime1 + skPrime4;
+    pData += 8;
+  }
+
+  if (pData + 4 <= pEnd)
+  {
+    Hash ^= (TUInt64)SRead32(pData) * skPrime1;
+    Hash = SRotateLeft(Hash, 23) * skPrime2 + skPrime3;
+    pData += 4;
+  }
+
+  while (pData < pEnd)
+  {
+    Hash ^= (TUInt64)(unsigned char)(*pData) * skPrime5;
+    Hash = SRotateLeft(Hash, 11) * skPrime1;
+    ++pData;
+  }
+
+  Hash ^= Hash >> 33;
+  Hash *= skPrime2;
+  Hash ^= Hash >> 29;
+  Hash *= skPrime3;
+  Hash ^= Hash >> 32;
+
+  return Hash;
+}
+
@@ -0,0 +1,23 @@
+#pragma once
+
+#ifndef _XXHash64_h_
+#define _XXHash64_h_
+
+// =================================================================================================
+
+#include "CoreTypes/Export/BaseTypes.h"
+
+#include <cstddef> // size_t
+
+// =================================================================================================
+
+namespace TXXHash64
+{
+  //! XXH64 hash of the given buffer, see https://github.com/Cyan4973/xxHash.
+  //! Words are read in the native byte order, so hashes are only comparable 
+  //! on machines with the same byte order.
+  TUInt64 Hash(const char* pData, size_t Size, TUInt64 Seed = 0);
+}
+
+#endif // _XXHash64_h_
+
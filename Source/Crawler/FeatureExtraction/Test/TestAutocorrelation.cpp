@@ -0,0 +1,119 @@
+#include "FeatureExtraction/Test/TestAutocorrelation.h"
+
+#include "FeatureExtraction/Source/Autocorrelation.h"
+
+#include "CoreTypes/Export/Array.h"
+#include "CoreTypes/Export/InlineMath.h"
+#include "CoreTypes/Export/TestHelpers.h"
+
+#include <cmath>
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+//! Reference: direct O(N*Order) autocorrelation, normalized by coefficient 0
+//! as in TAutocorrelation::Calc.
+
+static void SCalcDirectAutocorrelation(
+  const TArray<double>& SampleData,
+  TArray<double>&       Coeffs)
+{
+  for (int i = 0; i < Coeffs.Size(); ++i)
+  {
+    Coeffs[i] = 0.0;
+    for (int j = 0, jEnd = SampleData.Size() - i; j < jEnd; ++j)
+    {
+      Coeffs[i] += SampleData[j] * SampleData[j + i];
+    }
+  }
+
+  if (Coeffs[0] != 0.0)
+  {
+    for (int i = Coeffs.Size() - 1; i >= 0; --i)
+    {
+      Coeffs[i] /= Coeffs[0];
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void STestAutocorrelation(
+  TAutocorrelation::TWorkspace& Workspace,
+  const TArray<double>&         SampleData,
+  int                           Order)
+{
+  TArray<double> Expected(Order);
+  SCalcDirectAutocorrelation(SampleData, Expected);
+
+  // ... shared and temporary workspaces
+  TArray<double> Coeffs(Order);
+  TArray<double> TempWorkspaceCoeffs(Order);
+
+  TAutocorrelation::Calc(Workspace, SampleData.FirstRead(), SampleData.Size(),
+    Coeffs.FirstWrite(), Order);
+  TAutocorrelation::Calc(SampleData.FirstRead(), SampleData.Size(),
+    TempWorkspaceCoeffs.FirstWrite(), Order);
+
+  // coefficients are normalized, so FFT rounding errors are relative to the
+  // signal's energy
+  const double Tolerance = 1e-9;
+
+  for (int i = 0; i < Order; ++i)
+  {
+    BOOST_CHECK_EQUAL_EPSILON(Coeffs[i], Expected[i], Tolerance);
+    BOOST_CHECK_EQUAL(TempWorkspaceCoeffs[i], Coeffs[i]);
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFeatureExtractionTest::Autocorrelation()
+{
+  BOOST_TEST_MESSAGE("  Testing Autocorrelation...");
+
+  // small orders use the direct method, large ones the FFT method. Orders above
+  // the number of samples must give zeros.
+  static const int sNumSamples[] = { 64, 1000, 2048 };
+  static const int sOrders[] = { 8, 31, 32, 100, 512, 1024, 1500 };
+
+  TAutocorrelation::TWorkspace Workspace;
+
+  for (int n = 0; n < (int)MCountOf(sNumSamples); ++n)
+  {
+    TArray<double> SampleData(sNumSamples[n]);
+
+    for (int o = 0; o < (int)MCountOf(sOrders); ++o)
+    {
+      const int Order = sOrders[o];
+
+      // ... random noise
+      for (int i = 0; i < SampleData.Size(); ++i)
+      {
+        SampleData[i] = TMath::RandFloat() * 2.0 - 1.0;
+      }
+      STestAutocorrelation(Workspace, SampleData, Order);
+
+      // ... periodic: sine with a square wave on top
+      for (int i = 0; i < SampleData.Size(); ++i)
+      {
+        SampleData[i] = 0.5 * ::sin(2.0 * MPi * i / 44.1) +
+          (((i / 25) % 2) ? 0.25 : -0.25);
+      }
+      STestAutocorrelation(Workspace, SampleData, Order);
+
+      // periodic signals must peak at the period of the sine
+      if (SampleData.Size() >= 1000 && Order >= 100)
+      {
+        TArray<double> Coeffs(Order);
+        TAutocorrelation::Calc(Workspace, SampleData.FirstRead(),
+          SampleData.Size(), Coeffs.FirstWrite(), Order);
+
+        BOOST_CHECK(Coeffs[44] > Coeffs[22]);
+        BOOST_CHECK(Coeffs[44] > 0.0 && Coeffs[22] < 0.0);
+      }
+    }
+  }
+}
+
@@ -0,0 +1,14 @@
+#pragma once
+
+#ifndef _TestAutocorrelation_h_
+#define _TestAutocorrelation_h_
+
+// =================================================================================================
+
+namespace TFeatureExtractionTest
+{
+  void Autocorrelation();
+}
+
+#endif // _TestAutocorrelation_h_
+
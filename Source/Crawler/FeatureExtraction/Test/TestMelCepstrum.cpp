@@ -0,0 +1,164 @@
+#include "FeatureExtraction/Test/TestMelCepstrum.h"
+
+#include "FeatureExtraction/Export/MelCepstrum.h"
+
+#include "CoreTypes/Export/Array.h"
+#include "CoreTypes/Export/InlineMath.h"
+#include "CoreTypes/Export/TestHelpers.h"
+#include "CoreTypes/Export/Timer.h"
+
+#include "../../3rdParty/LibXtract/Export/LibXtract.h"
+
+#include <sstream>
+
+// =================================================================================================
+
+// TSampleAnalyser's default MFCC setup
+static const int sSpectrumSize = 2048 / 2;
+static const double sNyquist = 44100.0 / 2.0;
+static const double sMinFrequency = 20.0;
+static const double sMaxFrequency = 15500.0;
+static const int sNumberOfCoefficients = 14;
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+//! Dense libXtract filters, as used by TSampleAnalyser before TMelCepstrum.
+
+class TXtractMelFilters
+{
+public:
+  TXtractMelFilters()
+    : mFilters(sNumberOfCoefficients * sSpectrumSize),
+      mFilterPointers(sNumberOfCoefficients)
+  {
+    mFilters.Init(0.0);
+
+    for (int b = 0; b < sNumberOfCoefficients; ++b)
+    {
+      mFilterPointers[b] = mFilters.FirstWrite() + b * sSpectrumSize;
+    }
+
+    ::xtract_init_mfcc(sSpectrumSize, sNyquist, XTRACT_EQUAL_GAIN,
+      sMinFrequency, sMaxFrequency, sNumberOfCoefficients, mFilterPointers.FirstWrite());
+
+    mMelFilter.n_filters = sNumberOfCoefficients;
+    mMelFilter.filters = mFilterPointers.FirstWrite();
+  }
+
+  void Calc(const double* pMagnitudes, double* pCoefficients) const
+  {
+    ::xtract_mfcc(pMagnitudes, sSpectrumSize, &mMelFilter, pCoefficients);
+  }
+
+private:
+  TArray<double> mFilters;
+  TArray<double*> mFilterPointers;
+  xtract_mel_filter mMelFilter;
+};
+
+// -------------------------------------------------------------------------------------------------
+
+static void SFillRandom(TArray<double>& Magnitudes, double Scale)
+{
+  for (int i = 0; i < Magnitudes.Size(); ++i)
+  {
+    Magnitudes[i] = TMath::RandFloat() * Scale;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFeatureExtractionTest::MelCepstrum()
+{
+  BOOST_TEST_MESSAGE("  Testing MelCepstrum...");
+
+  const TXtractMelFilters XtractFilters;
+  const TMelCepstrum MelCepstrum(sSpectrumSize, sNyquist,
+    sMinFrequency, sMaxFrequency, sNumberOfCoefficients);
+
+  BOOST_CHECK_EQUAL(MelCepstrum.SpectrumSize(), sSpectrumSize);
+  BOOST_CHECK_EQUAL(MelCepstrum.NumberOfCoefficients(), sNumberOfCoefficients);
+
+  TArray<double> Magnitudes(sSpectrumSize);
+
+  double Expected[sNumberOfCoefficients];
+  double Coefficients[sNumberOfCoefficients];
+
+  // ... must match xtract_mfcc up to rounding errors: loud, quiet, silent
+  // and single peak spectra
+  for (int Run = 0; Run < 12; ++Run)
+  {
+    if (Run < 8)
+    {
+      SFillRandom(Magnitudes, (Run % 2) ? 1.0 : 1e-6);
+    }
+    else if (Run == 8)
+    {
+      Magnitudes.Init(0.0);
+    }
+    else
+    {
+      Magnitudes.Init(0.0);
+      Magnitudes[Run * 37] = 1.0;
+    }
+
+    XtractFilters.Calc(Magnitudes.FirstRead(), Expected);
+    MelCepstrum.Calc(Magnitudes.FirstRead(), Coefficients);
+
+    for (int c = 0; c < sNumberOfCoefficients; ++c)
+    {
+      BOOST_CHECK_EQUAL_EPSILON(Coefficients[c], Expected[c],
+        1e-9 * MMax(1.0, TMathT<double>::Abs(Expected[c])));
+    }
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFeatureExtractionTest::MelCepstrumBenchmark()
+{
+  // ... Compare per-frame speed against libXtract's dense filters
+
+  const int NumberOfFrames = 20000;
+
+  const TXtractMelFilters XtractFilters;
+  const TMelCepstrum MelCepstrum(sSpectrumSize, sNyquist,
+    sMinFrequency, sMaxFrequency, sNumberOfCoefficients);
+
+  TArray<double> Magnitudes(sSpectrumSize);
+  SFillRandom(Magnitudes, 1.0);
+
+  double Coefficients[sNumberOfCoefficients];
+  double CoefficientsSum = 0.0;
+
+  TStamp XtractTime;
+  for (int n = 0; n < NumberOfFrames; ++n)
+  {
+    XtractFilters.Calc(Magnitudes.FirstRead(), Coefficients);
+    CoefficientsSum += Coefficients[0];
+  }
+  const double XtractTimeInMs = XtractTime.DiffInMs();
+
+  TStamp MelCepstrumTime;
+  for (int n = 0; n < NumberOfFrames; ++n)
+  {
+    MelCepstrum.Calc(Magnitudes.FirstRead(), Coefficients);
+    CoefficientsSum -= Coefficients[0];
+  }
+  const double MelCepstrumTimeInMs = MelCepstrumTime.DiffInMs();
+
+  std::stringstream Message;
+  Message.precision(3);
+  Message << std::fixed << "    MFCCs per frame: " <<
+    "libXtract " << 1000.0 * XtractTimeInMs / NumberOfFrames << " us, " <<
+    "TMelCepstrum " << 1000.0 * MelCepstrumTimeInMs / NumberOfFrames << " us (x" <<
+      XtractTimeInMs / MMax(MelCepstrumTimeInMs, 0.001) << ")";
+
+  BOOST_TEST_MESSAGE(Message.str());
+
+  // both loops calculated the same frames
+  BOOST_CHECK_SMALL(CoefficientsSum, 1e-6 * NumberOfFrames);
+}
+
@@ -0,0 +1,15 @@
+#pragma once
+
+#ifndef _TestMelCepstrum_h_
+#define _TestMelCepstrum_h_
+
+// =================================================================================================
+
+namespace TFeatureExtractionTest
+{
+  void MelCepstrum();
+  void MelCepstrumBenchmark();
+}
+
+#endif // _TestMelCepstrum_h_
+
@@ -0,0 +1,227 @@
+#include "FeatureExtraction/Test/TestSampleAnalysisCache.h"
+
+#include "FeatureExtraction/Export/SampleAnalysisCache.h"
+#include "FeatureExtraction/Source/XXHash64.h"
+
+#include "CoreTypes/Export/Array.h"
+#include "CoreTypes/Export/ByteOrder.h"
+#include "CoreTypes/Export/Directory.h"
+#include "CoreTypes/Export/File.h"
+#include "CoreTypes/Export/TestHelpers.h"
+
+#include <cstring> // strlen
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+static void SWriteFile(const TString& FileName, const TArray<char>& Content)
+{
+  TFile File(FileName);
+  BOOST_REQUIRE(File.Open(TFile::kWrite));
+
+  size_t BytesWritten = (size_t)Content.Size();
+  BOOST_CHECK(File.WriteBytes(Content.FirstRead(), &BytesWritten));
+  BOOST_CHECK_EQUAL(BytesWritten, (size_t)Content.Size());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+static void STestXXHash64()
+{
+  // reference vectors from the xxHash reference implementation. words are
+  // read in native byte order, so they only match on little endian machines.
+  if (TByteOrder::kSystemByteOrder != TByteOrder::kIntel)
+  {
+    return;
+  }
+
+  struct TTestVector
+  {
+    const char* pString;
+    TUInt64 Seed;
+    TUInt64 Hash;
+  };
+
+  static const TTestVector sTestVectors[] = {
+    { "", 0, 0xef46db3751d8e999ULL },
+    { "", 1, 0xd5afba1336a3be4bULL },
+    { "a", 0, 0xd24ec4f1a98c6e5bULL },
+    { "abc", 0, 0x44bc2cf5ad770999ULL },
+    { "abc", 0x9e3779b97f4a7c15ULL, 0x2ed0f59d6b43ac8bULL },
+    { "Nobody inspects the spammish repetition", 0, 0xfbcea83c8a378bf1ULL }
+  };
+
+  for (int i = 0; i < (int)MCountOf(sTestVectors); ++i)
+  {
+    const char* pString = sTestVectors[i].pString;
+    BOOST_CHECK_EQUAL(TXXHash64::Hash(pString, ::strlen(pString), sTestVectors[i].Seed),
+      sTestVectors[i].Hash);
+  }
+
+  // ... multiple stripes and all tail sizes
+  TArray<char> Buffer(1000);
+  for (int i = 0; i < Buffer.Size(); ++i)
+  {
+    Buffer[i] = (char)((i * 7 + 3) & 0xff);
+  }
+
+  BOOST_CHECK_EQUAL(TXXHash64::Hash(Buffer.FirstRead(), Buffer.Size(), 0),
+    0x5f235fa033f1a3fbULL);
+  BOOST_CHECK_EQUAL(TXXHash64::Hash(Buffer.FirstRead(), Buffer.Size(), 2654435761ULL),
+    0x83080310ee83cc20ULL);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFeatureExtractionTest::SampleAnalysisCache()
+{
+  BOOST_TEST_MESSAGE("  Testing SampleAnalysisCache...");
+
+  // ... XXH64
+
+  STestXXHash64();
+
+  // ... test files and results
+
+  const TDirectory TempDir = gTempDir();
+
+  const TString CacheFileName = TempDir.Path() + "TestSampleAnalysisCache.db";
+  if (TFile(CacheFileName).Exists())
+  {
+    BOOST_CHECK(TFile(CacheFileName).Unlink());
+  }
+
+  // small files are fully covered by the content key, large ones are not
+  TArray<char> SmallContent(1000);
+  TArray<char> LargeContent(5 * TSampleAnalysisCache::kContentKeyBlockSize);
+  for (int i = 0; i < SmallContent.Size(); ++i)
+  {
+    SmallContent[i] = (char)TRandom::Integer(256);
+  }
+  for (int i = 0; i < LargeContent.Size(); ++i)
+  {
+    LargeContent[i] = (char)TRandom::Integer(256);
+  }
+
+  const TString SmallFileName = TempDir.Path() + "TestSampleAnalysisCache-Small.bin";
+  const TString SmallCopyFileName = TempDir.Path() + "TestSampleAnalysisCache-SmallCopy.bin";
+  const TString LargeFileName = TempDir.Path() + "TestSampleAnalysisCache-Large.bin";
+  const TString LargeChangedFileName = TempDir.Path() + "TestSampleAnalysisCache-LargeChanged.bin";
+  const TString LargeCopyFileName = TempDir.Path() + "TestSampleAnalysisCache-LargeCopy.bin";
+
+  SWriteFile(SmallFileName, SmallContent);
+  SWriteFile(SmallCopyFileName, SmallContent);
+  SWriteFile(LargeFileName, LargeContent);
+
+  TSampleDescriptors Results;
+  Results.mFileType.mValue = "wav";
+  Results.mFileSize.mValue = SmallContent.Size();
+  Results.mAmplitudePeak.mValues = MakeList<double>(0.25, 1.0, 0.5);
+
+  auto CheckResults = [&](const TSampleDescriptors& CachedResults) {
+    BOOST_CHECK_EQUAL(CachedResults.mFileType.mValue, Results.mFileType.mValue);
+    BOOST_CHECK_EQUAL(CachedResults.mFileSize.mValue, Results.mFileSize.mValue);
+    BOOST_CHECK(CachedResults.mAmplitudePeak.mValues == Results.mAmplitudePeak.mValues);
+  };
+
+  const TSampleDescriptors::TDescriptorSet DescriptorSet =
+    TSampleDescriptors::kLowLevelDescriptors;
+
+  const TSampleAnalysisCache::TContentKey SmallKey =
+    TSampleAnalysisCache::SContentKey(SmallFileName);
+  const TSampleAnalysisCache::TContentKey LargeKey =
+    TSampleAnalysisCache::SContentKey(LargeFileName);
+
+  BOOST_CHECK_EQUAL(SmallKey.mFileSize, SmallContent.Size());
+  BOOST_CHECK_EQUAL(LargeKey.mFileSize, LargeContent.Size());
+
+  // ... hits and misses
+  {
+    TSampleAnalysisCache Cache(DescriptorSet);
+    BOOST_REQUIRE(Cache.Open(CacheFileName, "config-a"));
+
+    TSampleDescriptors CachedResults;
+    BOOST_CHECK(!Cache.Lookup(SmallFileName, SmallKey, CachedResults));
+
+    Cache.Store(SmallFileName, SmallKey, Results);
+    BOOST_CHECK(Cache.Lookup(SmallFileName, SmallKey, CachedResults));
+    CheckResults(CachedResults);
+
+    // same content in another file: hit
+    const TSampleAnalysisCache::TContentKey SmallCopyKey =
+      TSampleAnalysisCache::SContentKey(SmallCopyFileName);
+    BOOST_CHECK(SmallCopyKey.mKey == SmallKey.mKey);
+
+    TSampleDescriptors CachedCopyResults;
+    BOOST_CHECK(Cache.Lookup(SmallCopyFileName, SmallCopyKey, CachedCopyResults));
+    BOOST_CHECK_EQUAL(CachedCopyResults.mFileName, SmallCopyFileName);
+    CheckResults(CachedCopyResults);
+
+    // changed content: miss
+    SmallContent[SmallContent.Size() / 2] ^= 1;
+    SWriteFile(SmallCopyFileName, SmallContent);
+
+    const TSampleAnalysisCache::TContentKey SmallChangedKey =
+      TSampleAnalysisCache::SContentKey(SmallCopyFileName);
+    BOOST_CHECK(SmallChangedKey.mKey != SmallKey.mKey);
+    BOOST_CHECK(!Cache.Lookup(SmallCopyFileName, SmallChangedKey, CachedResults));
+  }
+
+  // ... partial content keys of large files
+  {
+    TSampleAnalysisCache Cache(DescriptorSet);
+    BOOST_REQUIRE(Cache.Open(CacheFileName, "config-a"));
+
+    TSampleDescriptors CachedResults;
+    Cache.Store(LargeFileName, LargeKey, Results);
+    BOOST_CHECK(Cache.Lookup(LargeFileName, LargeKey, CachedResults));
+
+    // same first and last blocks, but different content in between and
+    // another modification time: can't be verified, so must miss
+    LargeContent[LargeContent.Size() / 2] ^= 1;
+    SWriteFile(LargeChangedFileName, LargeContent);
+
+    TSampleAnalysisCache::TContentKey LargeChangedKey =
+      TSampleAnalysisCache::SContentKey(LargeChangedFileName);
+    BOOST_CHECK(LargeChangedKey.mKey == LargeKey.mKey);
+    LargeChangedKey.mModificationTime = LargeKey.mModificationTime + 10;
+
+    BOOST_CHECK(!Cache.Lookup(LargeChangedFileName, LargeChangedKey, CachedResults));
+
+    // storing the colliding file stores its full content hash: the first file
+    // now gets verified by its content and must miss
+    Cache.Store(LargeChangedFileName, LargeChangedKey, Results);
+    BOOST_CHECK(Cache.Lookup(LargeChangedFileName, LargeChangedKey, CachedResults));
+    BOOST_CHECK(!Cache.Lookup(LargeFileName, LargeKey, CachedResults));
+
+    // copies with other modification times hit, when their content matches
+    SWriteFile(LargeCopyFileName, LargeContent);
+
+    TSampleAnalysisCache::TContentKey LargeCopyKey =
+      TSampleAnalysisCache::SContentKey(LargeCopyFileName);
+    LargeCopyKey.mModificationTime = LargeChangedKey.mModificationTime + 10;
+
+    BOOST_CHECK(Cache.Lookup(LargeCopyFileName, LargeCopyKey, CachedResults));
+    CheckResults(CachedResults);
+  }
+
+  // ... invalidation by configuration changes
+  {
+    TSampleAnalysisCache Cache(DescriptorSet);
+    BOOST_REQUIRE(Cache.Open(CacheFileName, "config-b"));
+
+    TSampleDescriptors CachedResults;
+    BOOST_CHECK(!Cache.Lookup(SmallFileName, SmallKey, CachedResults));
+  }
+  {
+    // results of other configurations are kept
+    TSampleAnalysisCache Cache(DescriptorSet);
+    BOOST_REQUIRE(Cache.Open(CacheFileName, "config-a"));
+
+    TSampleDescriptors CachedResults;
+    BOOST_CHECK(Cache.Lookup(SmallFileName, SmallKey, CachedResults));
+    CheckResults(CachedResults);
+  }
+}
+
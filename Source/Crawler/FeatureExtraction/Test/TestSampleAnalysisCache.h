@@ -0,0 +1,14 @@
+#pragma once
+
+#ifndef _TestSampleAnalysisCache_h_
+#define _TestSampleAnalysisCache_h_
+
+// =================================================================================================
+
+namespace TFeatureExtractionTest
+{
+  void SampleAnalysisCache();
+}
+
+#endif // _TestSampleAnalysisCache_h_
+
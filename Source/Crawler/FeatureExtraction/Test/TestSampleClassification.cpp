@@ -0,0 +1,149 @@
+#include "CoreTypes/Export/Directory.h"
+#include "CoreTypes/Export/File.h"
+#include "CoreTypes/Export/Exception.h"
+#include "CoreTypes/Export/TestHelpers.h"
+
+#include "FeatureExtraction/Test/TestSampleClassification.h"
+
+#include "FeatureExtraction/Export/SampleAnalyser.h"
+#include "FeatureExtraction/Export/SampleClassificationDescriptors.h"
+
+#include "Classification/Export/DefaultClassificationModel.h"
+#include "Classification/Export/ClassificationTestDataSet.h"
+
+#include <limits>
+#include <vector>
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+//! Analyze high level descriptors of the first \param NumberOfFiles wave files
+//! in the given folder.
+static void SAnalyzeFiles(
+  const TSampleAnalyser&            Analyser,
+  const TDirectory&                 Folder,
+  int                               NumberOfFiles,
+  std::vector<TSampleDescriptors>&  Results)
+{
+  TList<TString> FileNames = Folder.FindFileNames(MakeList<TString>("*.wav"));
+  FileNames.Sort();
+
+  int AnalyzedFiles = 0;
+  for (int i = 0; i < FileNames.Size() && AnalyzedFiles < NumberOfFiles; ++i)
+  {
+    // skip invalid files and OSX resource forks
+    if (FileNames[i].StartsWith("_") || FileNames[i].StartsWith("._"))
+    {
+      continue;
+    }
+
+    Results.push_back(Analyser.Analyze(Folder.Path() + FileNames[i],
+      TSampleDescriptors::kHighLevelDescriptors));
+
+    ++AnalyzedFiles;
+  }
+
+  BOOST_REQUIRE_EQUAL(AnalyzedFiles, NumberOfFiles);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFeatureExtractionTest::SampleClassification()
+{
+  BOOST_TEST_MESSAGE("  Testing SampleClassification...");
+
+  M__DisableFloatingPointAssertions
+
+  try
+  {
+    TSampleAnalyser Analyser(44100, 2048, 2048 / 2);
+
+    // ... analyze a few kicks and snares without models
+
+    const TDirectory SampleFolder =
+      gApplicationResourceDir().Descend("Kicks-vs-Snare-Train");
+    BOOST_REQUIRE(SampleFolder.ExistsIgnoreCase());
+
+    std::vector<TSampleDescriptors> Results;
+    SAnalyzeFiles(Analyser, TDirectory(SampleFolder).Descend("Kicks"), 8, Results);
+    SAnalyzeFiles(Analyser, TDirectory(SampleFolder).Descend("Snares"), 8, Results);
+
+    // ... train a categorization model from them
+
+    TList<TSampleClassificationDescriptors> TrainDescriptors;
+    for (size_t r = 0; r < Results.size(); ++r)
+    {
+      TrainDescriptors.Append(TSampleClassificationDescriptors(Results[r]));
+    }
+
+    const TClassificationTestDataSet DataSet("SampleClassificationTest", TrainDescriptors);
+
+    const TString ModelFileName = gGenerateTempFileName(gTempDir(), ".model");
+    {
+      TDefaultBaggingClassificationModel Model;
+      Model.Train(DataSet);
+      Model.Save(ModelFileName);
+    }
+
+    Analyser.SetOneShotCategorizationModel(ModelFileName);
+
+    // ... classify sample by sample
+
+    std::vector<TSampleDescriptors> ExpectedResults = Results;
+    for (size_t r = 0; r < ExpectedResults.size(); ++r)
+    {
+      Analyser.Classify(ExpectedResults[r]);
+      BOOST_CHECK(!ExpectedResults[r].mCategories.mValues.IsEmpty());
+    }
+
+    // ... classify all at once, with a poisoned row: must only fail that row
+
+    const int PoisonedRow = 3;
+
+    std::vector<TSampleDescriptors> BatchResults = Results;
+    BatchResults[PoisonedRow].mEffectiveLength12dB.mValue =
+      std::numeric_limits<double>::quiet_NaN();
+
+    TList<TSampleDescriptors*> BatchResultPointers;
+    for (size_t r = 0; r < BatchResults.size(); ++r)
+    {
+      BatchResultPointers.Append(&BatchResults[r]);
+    }
+
+    const TList<TString> Errors = Analyser.Classify(BatchResultPointers);
+    BOOST_REQUIRE_EQUAL(Errors.Size(), (int)BatchResults.size());
+
+    for (int r = 0; r < Errors.Size(); ++r)
+    {
+      if (r == PoisonedRow)
+      {
+        BOOST_CHECK(!Errors[r].IsEmpty());
+        BOOST_CHECK(BatchResults[r].mCategoryStrengths.mValues.IsEmpty());
+      }
+      else
+      {
+        BOOST_CHECK(Errors[r].IsEmpty());
+        BOOST_CHECK(BatchResults[r].mCategories.mValues ==
+          ExpectedResults[r].mCategories.mValues);
+
+        const TList<double>& Strengths = BatchResults[r].mCategoryStrengths.mValues;
+        const TList<double>& ExpectedStrengths = ExpectedResults[r].mCategoryStrengths.mValues;
+        BOOST_CHECK_ARRAYS_EQUAL_EPSILON(Strengths, Strengths.Size(),
+          ExpectedStrengths, ExpectedStrengths.Size(), 1e-6);
+      }
+    }
+
+    // ... single samples still fail with an exception
+    BOOST_CHECK_THROW(Analyser.Classify(BatchResults[PoisonedRow]), TReadableException);
+
+    BOOST_CHECK(TFile(ModelFileName).Unlink());
+  }
+  catch (const std::exception& Exception)
+  {
+    BOOST_ERROR(Exception.what());
+  }
+
+  M__EnableFloatingPointAssertions
+}
+
@@ -0,0 +1,14 @@
+#pragma once
+
+#ifndef _TestSampleClassification_h_
+#define _TestSampleClassification_h_
+
+// =================================================================================================
+
+namespace TFeatureExtractionTest
+{
+  void SampleClassification();
+}
+
+#endif // _TestSampleClassification_h_
+
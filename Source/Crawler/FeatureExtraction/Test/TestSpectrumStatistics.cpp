@@ -0,0 +1,153 @@
+#include "FeatureExtraction/Test/TestSpectrumStatistics.h"
+
+#include "FeatureExtraction/Export/SpectrumStatistics.h"
+#include "FeatureExtraction/Export/Statistics.h"
+
+#include "CoreTypes/Export/Array.h"
+#include "CoreTypes/Export/TestHelpers.h"
+
+#include "../../3rdParty/LibXtract/Export/LibXtract.h"
+
+// =================================================================================================
+
+// -------------------------------------------------------------------------------------------------
+
+// Check that the fused kernels match the per-feature TStatistics and libXtract
+// functions, which got used by TSampleAnalyser before, up to rounding errors.
+
+static void STestSpectrum(
+  const TArray<double>& Magnitudes,
+  const TArray<double>& LastMagnitudes)
+{
+  const double* pX = Magnitudes.FirstRead();
+  const double* pLastX = LastMagnitudes.FirstRead();
+  const int Length = Magnitudes.Size();
+
+  const double Tolerance = 1e-9;
+
+  // scale tolerances by the magnitude of the expected value
+  #define MCheckClose(Value, Expected) \
+    BOOST_CHECK_EQUAL_EPSILON(Value, Expected, \
+      Tolerance * MMax(1.0, TMathT<double>::Abs(Expected)))
+
+  // ... frame features
+
+  const double RolloffPercentile = 85.0;
+  const double RolloffBinFrequency = 44100.0 / 1024.0;
+
+  TSpectrumStatistics::TFrameFeatures Features;
+  TSpectrumStatistics::CalcFrameFeatures(Features,
+    pX, pLastX, Length, RolloffPercentile, RolloffBinFrequency);
+
+  double ExpectedRms = 0.0;
+  ::xtract_rms_amplitude(pX, Length, NULL, &ExpectedRms);
+  MCheckClose(Features.mRms, ExpectedRms);
+
+  const double ExpectedCentroid = TStatistics::Centroid(pX, Length);
+  const double ExpectedSpread = TStatistics::Spread(pX, Length, ExpectedCentroid);
+  MCheckClose(Features.mCentroid, ExpectedCentroid);
+  MCheckClose(Features.mSpread, ExpectedSpread);
+
+  MCheckClose(Features.mSkewness,
+    TStatistics::Skewness(pX, Length, ExpectedCentroid, ExpectedSpread));
+  MCheckClose(Features.mKurtosis,
+    TStatistics::Kurtosis(pX, Length, ExpectedCentroid, ExpectedSpread));
+
+  double RolloffArguments[4] = { RolloffBinFrequency, RolloffPercentile, 0, 0 };
+  double ExpectedRolloff = 0.0;
+  ::xtract_rolloff(pX, Length, RolloffArguments, &ExpectedRolloff);
+  // summation order may move the threshold crossing by at most one bin
+  BOOST_CHECK_EQUAL_EPSILON(Features.mRolloff, ExpectedRolloff,
+    RolloffBinFrequency + Tolerance);
+
+  MCheckClose(Features.mFlatness, TStatistics::Flatness(pX, Length));
+  MCheckClose(Features.mFlux, TStatistics::Flux(pX, pLastX, Length));
+
+  // ... band features
+
+  const int sBandLengths[] = { 1, 2, 3, 5, 8, 13, 64 };
+  for (int b = 0; b < (int)MCountOf(sBandLengths); ++b)
+  {
+    const int BandLength = MMin(sBandLengths[b], Length);
+
+    TSpectrumStatistics::TBandFeatures BandFeatures;
+    TSpectrumStatistics::CalcBandFeatures(BandFeatures, pX, pLastX, BandLength);
+
+    MCheckClose(BandFeatures.mMean, TStatistics::Mean(pX, BandLength));
+    MCheckClose(BandFeatures.mMax, TStatistics::Max(pX, BandLength));
+
+    double ExpectedPower = 0.0;
+    for (int i = 0; i < BandLength; ++i)
+    {
+      ExpectedPower += pX[i] * pX[i];
+    }
+    MCheckClose(TSpectrumStatistics::Power(pX, BandLength), ExpectedPower);
+    MCheckClose(BandFeatures.mRms, ::sqrt(ExpectedPower / BandLength));
+
+    MCheckClose(BandFeatures.mFlatness, TStatistics::Flatness(pX, BandLength));
+    MCheckClose(BandFeatures.mFlux, TStatistics::Flux(pX, pLastX, BandLength));
+  }
+
+  #undef MCheckClose
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TFeatureExtractionTest::SpectrumStatistics()
+{
+  BOOST_TEST_MESSAGE("  Testing SpectrumStatistics...");
+
+  // odd length, so the lane remainder loops get tested too
+  const int Length = 715;
+
+  TArray<double> Magnitudes(Length);
+  TArray<double> LastMagnitudes(Length);
+
+  // ... random spectra
+  for (int Run = 0; Run < 8; ++Run)
+  {
+    for (int i = 0; i < Length; ++i)
+    {
+      Magnitudes[i] = TRandom::Integer(10000) / 1000.0;
+      LastMagnitudes[i] = TRandom::Integer(10000) / 1000.0;
+    }
+
+    STestSpectrum(Magnitudes, LastMagnitudes);
+  }
+
+  // ... silence
+  {
+    Magnitudes.Init(0.0);
+    LastMagnitudes.Init(0.0);
+
+    STestSpectrum(Magnitudes, LastMagnitudes);
+
+    TSpectrumStatistics::TFrameFeatures Features;
+    TSpectrumStatistics::CalcFrameFeatures(Features,
+      Magnitudes.FirstRead(), LastMagnitudes.FirstRead(), Length, 85.0, 1.0);
+
+    BOOST_CHECK_EQUAL(Features.mRms, 0.0);
+    BOOST_CHECK_EQUAL(Features.mCentroid, 0.0);
+    BOOST_CHECK_EQUAL(Features.mFlatness, 0.0);
+    BOOST_CHECK_EQUAL(Features.mFlux, 0.0);
+  }
+
+  // ... single peak
+  {
+    Magnitudes.Init(0.0);
+    Magnitudes[100] = 1.0;
+    LastMagnitudes.Init(0.0);
+    LastMagnitudes[101] = 0.5;
+
+    STestSpectrum(Magnitudes, LastMagnitudes);
+
+    TSpectrumStatistics::TFrameFeatures Features;
+    TSpectrumStatistics::CalcFrameFeatures(Features,
+      Magnitudes.FirstRead(), LastMagnitudes.FirstRead(), Length, 85.0, 1.0);
+
+    BOOST_CHECK_EQUAL(Features.mCentroid, 100.0);
+    BOOST_CHECK_EQUAL(Features.mSpread, 0.0);
+    BOOST_CHECK_EQUAL(Features.mRolloff, 101.0);
+  }
+}
+
@@ -0,0 +1,14 @@
+#pragma once
+
+#ifndef _TestSpectrumStatistics_h_
+#define _TestSpectrumStatistics_h_
+
+// =================================================================================================
+
+namespace TFeatureExtractionTest
+{
+  void SpectrumStatistics();
+}
+
+#endif // _TestSpectrumStatistics_h_
+
@@ -30,6 +30,14 @@ void TFeatureExtractionTest::Statistics()
 
     BOOST_CHECK_EQUAL(Peaks1, MakeList(MakePair(2, 2.0), MakePair(6, 6.0)));
     BOOST_CHECK_EQUAL(Peaks2, MakeList(MakePair(6, 6.0)));
+
+    // reused peak lists must give the same results
+    TList<TPair<int, double>> ReusedPeaks;
+    TStatistics::Peaks(ReusedPeaks, sTestSequence, sTestSequenceLength, 0);
+    BOOST_CHECK_EQUAL(ReusedPeaks, Peaks1);
+    ReusedPeaks.ClearEntries();
+    TStatistics::Peaks(ReusedPeaks, sTestSequence, sTestSequenceLength, 2);
+    BOOST_CHECK_EQUAL(ReusedPeaks, Peaks2);
   }
 
   // ... test sum, variance, stddev, mean and median
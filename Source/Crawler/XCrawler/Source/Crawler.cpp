@@ -15,16 +15,26 @@
 #include "FeatureExtraction/Export/FeatureExtractionInit.h"
 #include "FeatureExtraction/Export/SampleAnalyser.h"
 #include "FeatureExtraction/Export/SqliteSampleDescriptorPool.h"
+#include "FeatureExtraction/Export/AsyncSampleDescriptorPool.h"
+#include "FeatureExtraction/Export/SampleAnalysisScheduler.h"
+#include "FeatureExtraction/Export/SampleClassificationStage.h"
+#include "FeatureExtraction/Export/SampleFileQueue.h"
+#include "FeatureExtraction/Export/SampleAnalysisCache.h"
 
 #include "Classification/Export/ClassificationInit.h"
 
 #include "../../3rdParty/Boost/Export/BoostProgramOptions.h"
-#include "../../3rdParty/Ctpl/Export/Ctpl.h"
 
 #include <string>
 #include <iostream>
-#include <set>
-#include <list>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <exception>
 #include <stdexcept>
 #include <cstdlib>
 
@@ -44,10 +54,17 @@
 
 #define MDefaultLowLevelDatabaseName "afec-ll.db"
 #define MDefaultHighLevelDatabaseName "afec.db"
+#define MDefaultClassificationDatabaseName "afec-classes.db"
 
 #define MDefaultClassificationModelName "OneShot-vs-Loops.model"
 #define MDefaultOneShotCategorizationModelName "OneShot-Categories.model"
 
+// number of threads which walk directories: mostly IO bound, so independent 
+// from the number of CPU cores
+#define MCollectFilesThreads 8
+// number of threads which stat collected files to detect changes: IO bound too
+#define MDetectChangesThreads 8
+
 #define MLogPrefix "Crawler"
 
 // =================================================================================================
@@ -103,6 +120,9 @@ namespace TProductDescription
 
 static void SShowVersionInfo();
 
+static const char* SDefaultDatabaseName(
+  TSampleDescriptors::TDescriptorSet  DescriptorSet);
+
 static int SRunExtractor(
   const TList<TString>&               DirectoriesOrFiles,
   const TString&                      DbNameAndPath,
@@ -110,6 +130,7 @@ static int SRunExtractor(
   const TString&                      ClassificationModelNameAndPath,
   const TString&                      OneShotCategorizationModelNameAndPath,
   TSampleDescriptors::TDescriptorSet  DescriptorSet,
+  const TString&                      CacheNameAndPath,
   int                                 MaxAnalyzeThreads);
 
 static bool SIgnoreRootDirectory(const TDirectory& BaseDirectory);
@@ -119,13 +140,14 @@ static bool SIgnoreFile(const TString& Filename);
 static void SCollectFiles(
   const TString&                      DirectoryOrFileNames,
   TDirectory::TSymLinkRecursionTest&  RecursionTester,
-  TList<TString>&                     AudioFiles);
+  TSampleFileQueue&                   AudioFiles);
 
-static void SBuildChangeList(
-  const TList<TString>&               AudioFiles,
-  TSqliteSampleDescriptorPool*        pSamplePool,
-  TList<TString>&                     AudioFilesToAdd,
-  TList<TString>&                     AudioFilesToRemove);
+static void SDetectChanges(
+  TSampleFileQueue&                                     AudioFiles,
+  const TList<TSampleDescriptorPool::TSampleFileStat>&  ExistingFiles,
+  TSampleFileQueue&                                     AudioFilesToAdd,
+  TList< TPair<TString, TString> >&                     AudioFilesToRename,
+  TList<TString>&                                       AudioFilesToRemove);
 
 // =================================================================================================
 
@@ -164,19 +186,27 @@ int gMain(const TList<TString>& Arguments)
     ("help,h", "Show help message.")
     ("version,v", "Show version, build and other infos.")
     ("level,l", boost::program_options::value<std::string>()->default_value("high"),
-      "Create a 'high' or 'low' level database.")
+      "Create a 'high' or 'low' level database, or a 'classify' database which only "
+      "contains the high level class and category descriptors. The 'classify' level "
+      "only analyzes the features which are needed by the classification models, so "
+      "it is a lot faster than the 'high' level.")
     ("model,m", boost::program_options::value<std::vector<std::string>>()->multitoken(),
       "Specify the 'Classifiers' and 'OneShot-Categories' model files that should be used "
-      "for level='high'. When not specified, the default models from the crawler's "
+      "for level='high' or level='classify'. When not specified, the default models from the crawler's "
       "resource dir are used. Set to 'none' to explicitly avoid loading the "
       "a default model - e.g. --model \"None\" --model \"None\" will disable both.")
+    ("cache,c", boost::program_options::value<std::string>(),
+      "Optional path and name of an analysis cache db. Results are cached by the "
+      "content of the analyzed files, so moved, renamed or duplicated files won't "
+      "be analyzed again, even across different databases.")
     ("jobs,j", boost::program_options::value<int>()->default_value(-1),
       "Maximum number of samples that are analyzed simultaneously. "
       "By default all available concurrent CPU threads in the system.")
     ("out,o", boost::program_options::value<std::string>(), (std::string() +
       "Set destination directory/db_name.db or just a directory. When only a directory "
       "is specified, the database filename will be: '" + std::string(MDefaultLowLevelDatabaseName) + 
-      "' or '" + std::string(MDefaultHighLevelDatabaseName) + "', depending on the level. "
+      "', '" + std::string(MDefaultHighLevelDatabaseName) + "' or '" + 
+      std::string(MDefaultClassificationDatabaseName) + "', depending on the level. "
       "When no directory or file is specified, the database will be written into the current "
       "working dir.").c_str())
     ("paths", boost::program_options::value<std::vector<std::string>>(),
@@ -192,6 +222,7 @@ int gMain(const TList<TString>& Arguments)
   // ... parse arguments
 
   TString DbNameAndPath;
+  TString CacheNameAndPath;
   TString ClassificationModelNameAndPath, CategorizationModelNameAndPath;
   TList<TString> DirectoriesOrFiles;
 
@@ -239,10 +270,14 @@ int gMain(const TList<TString>& Arguments)
       {
         DescriptorSet = TSampleDescriptors::kHighLevelDescriptors;
       }
+      else if (gStringsEqualIgnoreCase(Level, "classify"))
+      {
+        DescriptorSet = TSampleDescriptors::kClassificationDescriptors;
+      }
       else
       {
         std::stringstream Error;
-        Error << "ERROR: invalid -l argument: expected 'low' or 'high', got: " <<
+        Error << "ERROR: invalid -l argument: expected 'low', 'high' or 'classify', got: " <<
           Level.StdCString() << ".";
         throw boost::program_options::error(Error.str());
       }
@@ -290,6 +325,17 @@ int gMain(const TList<TString>& Arguments)
       }
     }
     
+    // cache -> CacheNameAndPath
+    if (ProgramVariablesMap.find("cache") != ProgramVariablesMap.end())
+    {
+      CacheNameAndPath = ArgumentToString(ProgramVariablesMap["cache"]);
+
+      if (TDirectory(CacheNameAndPath).IsRelative())
+      {
+        CacheNameAndPath = gCurrentWorkingDir().Path() + CacheNameAndPath;
+      }
+    }
+
     // jobs -> MaxAnalyzeThreads
     if (ProgramVariablesMap.find("jobs") != ProgramVariablesMap.end()) 
     {
@@ -310,9 +356,7 @@ int gMain(const TList<TString>& Arguments)
       if (TDirectory(DbName).Exists())
       {
         // arg is a path, append default db name
-        DbName = TDirectory(DbName).Path() +
-          ((DescriptorSet == TSampleDescriptors::kLowLevelDescriptors) ?
-            MDefaultLowLevelDatabaseName : MDefaultHighLevelDatabaseName);
+        DbName = TDirectory(DbName).Path() + SDefaultDatabaseName(DescriptorSet);
       }
 
       if (!DbName.Contains(TDirectory::SPathSeparator()) &&
@@ -442,9 +486,7 @@ int gMain(const TList<TString>& Arguments)
   // set db path
   if (DbNameAndPath.IsEmpty())
   {
-    DbNameAndPath = gCurrentWorkingDir().Path() +
-      ((DescriptorSet == TSampleDescriptors::kLowLevelDescriptors) ?
-        MDefaultLowLevelDatabaseName : MDefaultHighLevelDatabaseName);
+    DbNameAndPath = gCurrentWorkingDir().Path() + SDefaultDatabaseName(DescriptorSet);
   }
 
 
@@ -476,6 +518,7 @@ int gMain(const TList<TString>& Arguments)
     DirectoriesOrFiles, DbNameAndPath, DbBasePath,
     ClassificationModelNameAndPath, CategorizationModelNameAndPath,
     DescriptorSet, 
+    CacheNameAndPath,
     MaxAnalyzeThreads);
 
 
@@ -563,6 +606,29 @@ void SShowVersionInfo()
 
 // -------------------------------------------------------------------------------------------------
 
+const char* SDefaultDatabaseName(
+  TSampleDescriptors::TDescriptorSet  DescriptorSet)
+{
+  MStaticAssert(TSampleDescriptors::kNumberOfDescriptorSet == 3);
+  switch (DescriptorSet)
+  {
+  default:
+    MInvalid("Unexpected descriptor set");
+    return MDefaultHighLevelDatabaseName;
+
+  case TSampleDescriptors::kLowLevelDescriptors:
+    return MDefaultLowLevelDatabaseName;
+
+  case TSampleDescriptors::kHighLevelDescriptors:
+    return MDefaultHighLevelDatabaseName;
+
+  case TSampleDescriptors::kClassificationDescriptors:
+    return MDefaultClassificationDatabaseName;
+  }
+}
+
+// -------------------------------------------------------------------------------------------------
+
 int SRunExtractor(
   const TList<TString>&               DirectoriesOrFiles,
   const TString&                      DbNameAndPath,
@@ -570,6 +636,7 @@ int SRunExtractor(
   const TString&                      ClassificationModelNameAndPath,
   const TString&                      CategorizationModelNameAndPath,
   TSampleDescriptors::TDescriptorSet  DescriptorSet,
+  const TString&                      CacheNameAndPath,
   int                                 MaxAnalyzeThreads)
 {
   bool GotCrawlError = false;
@@ -599,12 +666,16 @@ int SRunExtractor(
     TOwnerPtr<TSampleAnalyser> pAnalyzer(new TSampleAnalyser(
       MDefaultSampleRate, MDefaultFFTFrameSize, MDefaultHopFrameSize));
 
-    if (DescriptorSet == TSampleDescriptors::kHighLevelDescriptors)
+    // models are needed for the high level and classification descriptors
+    if (DescriptorSet != TSampleDescriptors::kLowLevelDescriptors)
     {
       #if defined(MEnableDebugSampleDescriptors)
-        TLog::SLog()->AddLine(MLogPrefix, "Please note: "
-          "Will create/update a database with 'debug_R/VR/VVR' descriptors enabled. "
-          "This changes the default column set and should only be used in local dev-builds...");
+        if (DescriptorSet == TSampleDescriptors::kHighLevelDescriptors)
+        {
+          TLog::SLog()->AddLine(MLogPrefix, "Please note: "
+            "Will create/update a database with 'debug_R/VR/VVR' descriptors enabled. "
+            "This changes the default column set and should only be used in local dev-builds...");
+        }
       #endif
 
       // load classification model
@@ -650,111 +721,203 @@ int SRunExtractor(
       }
     }
 
-    // collect files
-    TLog::SLog()->AddLine(MLogPrefix, "Collecting files...");
+    // open analysis cache, after models got loaded: they are part of the fingerprint
+    TOwnerPtr<TSampleAnalysisCache> pAnalysisCache;
+    if (!CacheNameAndPath.IsEmpty())
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Using analysis cache: '%s'", 
+        CacheNameAndPath.StdCString().c_str());
 
-    TList<TString> AllAudioFiles;
+      pAnalysisCache = TOwnerPtr<TSampleAnalysisCache>(
+        new TSampleAnalysisCache(DescriptorSet));
 
-    for (int i = 0; i < DirectoriesOrFiles.Size() && !sAbortProcessing; ++i)
-    {
-      TDirectory::TSymLinkRecursionTest RecursionTester;
-      SCollectFiles(DirectoriesOrFiles[i], RecursionTester, AllAudioFiles);
+      if (!pAnalysisCache->Open(CacheNameAndPath, 
+            pAnalyzer->ConfigFingerprint(DescriptorSet)))
+      {
+        throw std::runtime_error("Failed to open or create analysis cache");
+      }
+
+      pAnalyzer->SetAnalysisCache(pAnalysisCache);
     }
 
-    // build change list
-    TList<TString> AudioFilesToAdd;
-    TList<TString> AudioFilesToRemove;
-    if (!sAbortProcessing)
+    // fetch existing samples, before the pool gets accessed by the writer thread
+    TList<TSampleDescriptorPool::TSampleFileStat> ExistingFiles;
+    if (!pSamplePool->IsEmpty())
     {
-      TLog::SLog()->AddLine(MLogPrefix, "Building change lists...");
-      SBuildChangeList(AllAudioFiles, pSamplePool, AudioFilesToAdd, AudioFilesToRemove);
+      ExistingFiles = pSamplePool->SampleFileStats();
     }
 
-    if (AudioFilesToAdd.IsEmpty() && AudioFilesToRemove.IsEmpty())
+    // crawl in a pipeline: directories get walked, changes get detected and files 
+    // get analyzed concurrently, so analysis starts as soon as the first files got 
+    // found. Bounded queues between the stages block stages which run ahead.
+    TSampleFileQueue AudioFiles;
+    TSampleFileQueue AudioFilesToAdd;
+    TList< TPair<TString, TString> > AudioFilesToRename;
+    TList<TString> AudioFilesToRemove;
+
+    std::mutex StageErrorLock;
+    TString StageError;
+
+    auto AbortStages = [&](const TString& Error) {
+      {
+        const std::lock_guard<std::mutex> Lock(StageErrorLock);
+        if (StageError.IsEmpty())
+        {
+          StageError = Error;
+        }
+      }
+      AudioFiles.Abort();
+      AudioFilesToAdd.Abort();
+    };
+
+    // analyze new and changed files, as soon as they got found
+    const int MaxThreads = (MaxAnalyzeThreads == -1) ? 
+      TCpu::NumberOfConcurrentThreads() : MaxAnalyzeThreads;
+
+    // write results from a single writer thread in batches, so analyzer 
+    // threads don't need to wait for the database
+    TAsyncSampleDescriptorPool AsyncSamplePool(pSamplePool);
+    TSampleDescriptorPool* pAsyncSamplePool = &AsyncSamplePool;
+
+    std::mutex SamplePoolLock;
+
+    // evaluate classification models for batches of analyzed files in a separate
+    // stage, so the models don't need to be evaluated in the analyzer threads
+    TOwnerPtr<TSampleClassificationStage> pClassificationStage;
+    if (DescriptorSet != TSampleDescriptors::kLowLevelDescriptors &&
+        (!pAnalyzer->ClassificationClasses().IsEmpty() || 
+         !pAnalyzer->OneShotCategorizationClasses().IsEmpty()))
     {
-      TLog::SLog()->AddLine(MLogPrefix, "Database content is up to date. Nothing to do.");
+      pClassificationStage = TOwnerPtr<TSampleClassificationStage>(
+        new TSampleClassificationStage(pAnalyzer, pAsyncSamplePool, SamplePoolLock));
+
+      pAnalyzer->SetClassificationStage(pClassificationStage);
     }
-    else
-    {
-      // analyze new files
-      const int MaxThreads = (MaxAnalyzeThreads == -1) ? 
-        TCpu::NumberOfConcurrentThreads() : MaxAnalyzeThreads;
 
-      const int NumberOfAudioFilesToAdd = AudioFilesToAdd.Size();
+    TSampleAnalysisScheduler Scheduler(MaxThreads);
 
-      std::mutex SamplePoolLock;
+    TLog::SLog()->AddLine(MLogPrefix, "Collecting files...");
 
-      if (MaxThreads == 1)
+    std::thread CollectThread([&]() {
+      try
       {
-        for (int i = 0; i < NumberOfAudioFilesToAdd; ++i)
+        for (int i = 0; i < DirectoriesOrFiles.Size() && 
+              !sAbortProcessing && !AudioFiles.IsAborted(); ++i)
         {
+          TDirectory::TSymLinkRecursionTest RecursionTester;
+          SCollectFiles(DirectoriesOrFiles[i], RecursionTester, AudioFiles);
+        }
+        AudioFiles.Close();
+      }
+      catch (const std::exception& Exception)
+      {
+        AbortStages(TString("Collecting files failed: ") + Exception.what());
+      }
+    });
+
+    std::thread ChangeDetectionThread([&]() {
+      try
+      {
+        SDetectChanges(AudioFiles, ExistingFiles, 
+          AudioFilesToAdd, AudioFilesToRename, AudioFilesToRemove);
+        AudioFilesToAdd.Close();
+      }
+      catch (const std::exception& Exception)
+      {
+        AbortStages(TString("Detecting changes failed: ") + Exception.what());
+      }
+    });
+
+    std::exception_ptr pAnalysisError;
+    try
+    {
+      Scheduler.Run(AudioFilesToAdd,
+        [=, &pAnalyzer, &SamplePoolLock, &AudioFilesToAdd](
+          const TString& AudioFileToAdd, int FileIndex) {
           if (sAbortProcessing)
           {
             throw std::runtime_error("Analyzation aborted...");
           }
 
-          const TString AudioFileToAdd = AudioFilesToAdd[i];
-
-          TLog::SLog()->AddLine(MLogPrefix, "Analyzing '%s' (%d of %d)",
-            AudioFileToAdd.StdCString().c_str(), i + 1, NumberOfAudioFilesToAdd);
+          TLog::SLog()->AddLine(MLogPrefix, "Analyzing '%s' (%d of %d found)",
+            AudioFileToAdd.StdCString().c_str(), FileIndex + 1, 
+            AudioFilesToAdd.NumberOfPushedFiles());
 
-          pAnalyzer->Extract(AudioFileToAdd, pSamplePool, SamplePoolLock);
+          pAnalyzer->Extract(AudioFileToAdd, pAsyncSamplePool, SamplePoolLock);
         }
-      }
-      else
-      {
-        ctpl::thread_pool ThreadPool(
-          MMin(MaxThreads, AudioFilesToAdd.Size()),
-          AudioFilesToAdd.Size());
+      );
+    }
+    catch (...)
+    {
+      pAnalysisError = std::current_exception();
 
-        std::list< std::future<void> > JobList;
-        for (int i = 0; i < NumberOfAudioFilesToAdd; ++i)
-        {
-          const TString AudioFileToAdd = AudioFilesToAdd[i];
+      // stop all producers, which may be blocked by the full queues
+      AudioFiles.Abort();
+      AudioFilesToAdd.Abort();
+    }
 
-          JobList.push_back(ThreadPool.push(
-            [=, &pAnalyzer, &pSamplePool, &SamplePoolLock](int _ThreadId) {
-              if (sAbortProcessing)
-              {
-                throw std::runtime_error("Analyzation aborted...");
-              }
+    CollectThread.join();
+    ChangeDetectionThread.join();
 
-              TLog::SLog()->AddLine(MLogPrefix, "Analyzing '%s' (%d of %d)",
-                AudioFileToAdd.StdCString().c_str(), i + 1, NumberOfAudioFilesToAdd);
+    if (pAnalysisError)
+    {
+      std::rethrow_exception(pAnalysisError);
+    }
+    if (!StageError.IsEmpty())
+    {
+      throw std::runtime_error(StageError.StdCString());
+    }
+    if (sAbortProcessing)
+    {
+      throw std::runtime_error("Crawling aborted...");
+    }
 
-              pAnalyzer->Extract(AudioFileToAdd, pSamplePool, SamplePoolLock);
-            }
-          ));
-        }
+    // wait until all results got classified and written
+    if (pClassificationStage)
+    {
+      pClassificationStage->Flush();
+    }
+    AsyncSamplePool.Flush();
 
-        // wait until all tasks completed
-        while (! JobList.empty())
-        {
-          try
-          {
-            JobList.front().get();
-          }
-          catch (const std::exception&)
-          {
-            // stop thread pool, wait until its down and clear all tasks on errors
-            ThreadPool.stop();
-            JobList.clear();
+    const int NumberOfAddedFiles = AudioFilesToAdd.NumberOfPushedFiles();
 
-            throw;
-          }
+    TLog::SLog()->AddLine(MLogPrefix, 
+      "Collected %d files: %d new or changed, %d moved, %d no longer existing",
+      AudioFiles.NumberOfPushedFiles(), NumberOfAddedFiles, 
+      AudioFilesToRename.Size(), AudioFilesToRemove.Size());
 
-          // remove successfully finished tasks
-          JobList.pop_front();
-        }
+    if (NumberOfAddedFiles == 0 && 
+        AudioFilesToRename.IsEmpty() && AudioFilesToRemove.IsEmpty())
+    {
+      TLog::SLog()->AddLine(MLogPrefix, "Database content is up to date. Nothing to do.");
+    }
+    else
+    {
+      // trace how often analysis setups got reused
+      const TSampleAnalyser::TWorkspaceCounters WorkspaceCounters =
+        TSampleAnalyser::SWorkspaceCounters();
 
-        // remove no longer existing files
-        if (! AudioFilesToRemove.IsEmpty())
-        {
-          TLog::SLog()->AddLine(MLogPrefix, "Removing %d samples",
-            AudioFilesToRemove.Size());
+      TLog::SLog()->AddLine(MLogPrefix,
+        "Analysis workspaces: %d created, %d allocations for %d analyzed files",
+        WorkspaceCounters.mWorkspaces, WorkspaceCounters.mAllocations,
+        WorkspaceCounters.mResets);
 
-          pSamplePool->RemoveSamples(AudioFilesToRemove);
-        }
+      // move descriptors of moved or renamed files
+      if (! AudioFilesToRename.IsEmpty())
+      {
+        TLog::SLog()->AddLine(MLogPrefix, "Moving %d samples",
+          AudioFilesToRename.Size());
+
+        pSamplePool->RenameSamples(AudioFilesToRename);
+      }
+
+      // remove no longer existing files
+      if (! AudioFilesToRemove.IsEmpty())
+      {
+        TLog::SLog()->AddLine(MLogPrefix, "Removing %d samples",
+          AudioFilesToRemove.Size());
+
+        pSamplePool->RemoveSamples(AudioFilesToRemove);
       }
     }
   }
@@ -872,10 +1035,10 @@ bool SIgnoreFile(const TString& Filename)
 void SCollectFiles(
   const TString&                      DirectoryOrFileName,
   TDirectory::TSymLinkRecursionTest&  RecursionTester,
-  TList<TString>&                     DestAudioFiles)
+  TSampleFileQueue&                   DestAudioFiles)
 {
   // check if indexing got aborted
-  if (sAbortProcessing) 
+  if (sAbortProcessing || DestAudioFiles.IsAborted()) 
   {
     return;
   }
@@ -893,106 +1056,291 @@ void SCollectFiles(
       return;
     }
 
-    // analyze all audio files within this path
-    const TList<TString> AudioFileNames = Directory.FindFileNames(
-      TAudioFile::SSupportedExtensions());
-    for (int i = 0; i < AudioFileNames.Size() && !sAbortProcessing; ++i)
-    {
-      // check for ignored files
-      if (!SIgnoreFile(AudioFileNames[i]))
+    // collect all audio files within this path and all sub paths
+    auto CollectFiles = [&](
+      const TDirectory&     FilesDirectory, 
+      const TList<TString>& AudioFileNames) {
+      for (int i = 0; i < AudioFileNames.Size(); ++i)
       {
-        DestAudioFiles.Append(Directory.Path() + AudioFileNames[i]);
+        // check for ignored files
+        if (!SIgnoreFile(AudioFileNames[i]))
+        {
+          // blocks while the change detection is busy
+          if (!DestAudioFiles.Push(FilesDirectory.Path() + AudioFileNames[i]))
+          {
+            return false;
+          }
+        }
       }
-    }
 
-    // collect recursively within all sub paths
-    const TList<TString> SubDirNames = Directory.FindSubDirNames("*", &RecursionTester);
-    for (int i = 0; i < SubDirNames.Size() && !sAbortProcessing; ++i)
-    {
-      const TDirectory FullSubDir = TDirectory(Directory).Descend(SubDirNames[i]);
+      return !sAbortProcessing;
+    };
 
+    auto FilterSubDir = [&](
+      const TDirectory& ParentDirectory, 
+      const TString&    SubDirName) {
       // check for ignored sub folders
-      if (SIgnoreSubDirectory(SubDirNames[i]))
+      if (SIgnoreSubDirectory(SubDirName))
       {
-        TLog::SLog()->AddLine(MLogPrefix,
-          "Ignoring contents of (sub)directory: '%s'", FullSubDir.Path().StdCString().c_str());
+        TLog::SLog()->AddLine(MLogPrefix, "Ignoring contents of (sub)directory: '%s'", 
+          TDirectory(ParentDirectory).Descend(SubDirName).Path().StdCString().c_str());
 
-        continue;
+        return false;
       }
-      
-      SCollectFiles(FullSubDir.Path(), RecursionTester, DestAudioFiles);
-    }
+
+      return !sAbortProcessing;
+    };
+
+    Directory.Traverse(TAudioFile::SSupportedExtensions(), 
+      CollectFiles, FilterSubDir, MCollectFilesThreads, &RecursionTester);
   }
   else if (TFile(DirectoryOrFileName).Exists()) // is a file?
   {
-    DestAudioFiles.Append(DirectoryOrFileName);
+    DestAudioFiles.Push(DirectoryOrFileName);
   }
 }
 
 // -------------------------------------------------------------------------------------------------
 
-static void SBuildChangeList(
-  const TList<TString>&               AudioFiles,
-  TSqliteSampleDescriptorPool*        pSamplePool,
-  TList<TString>&                     AudioFilesToAdd,
-  TList<TString>&                     AudioFilesToRemove)
+// Run the given function in \param NumberOfThreads threads (including the calling one)
+// and wait until all of them finished. Rethrows the first exception of the functions.
+
+static void SRunInParallel(
+  int                           NumberOfThreads, 
+  const std::function<void()>&  Function)
 {
-  // . create new content
+  std::mutex ErrorLock;
+  std::exception_ptr pError;
+
+  auto RunFunction = [&]() {
+    try
+    {
+      Function();
+    }
+    catch (...)
+    {
+      const std::lock_guard<std::mutex> Lock(ErrorLock);
+      if (!pError)
+      {
+        pError = std::current_exception();
+      }
+    }
+  };
 
-  if (pSamplePool->IsEmpty())
+  std::vector<std::thread> Threads;
+  for (int i = 1; i < NumberOfThreads; ++i)
   {
-    AudioFilesToAdd = AudioFiles;
-    AudioFilesToRemove.Empty();
+    Threads.push_back(std::thread(RunFunction));
+  }
 
-    return;
+  RunFunction();
+
+  for (auto& Thread : Threads)
+  {
+    Thread.join();
   }
 
+  if (pError)
+  {
+    std::rethrow_exception(pError);
+  }
+}
 
-  // . update existing content
+// -------------------------------------------------------------------------------------------------
+
+// normalized path as key for the existing files map: different slashes may be used
+
+static std::string SNormalizedPathKey(const TString& FileName)
+{
+  return TString(FileName).ReplaceChar(TDirectory::SWrongPathSeparatorChar(), 
+    TDirectory::SPathSeparatorChar()).StdCString(TString::kUtf8);
+}
+
+// -------------------------------------------------------------------------------------------------
+
+// check if a file changed since its stat got stored in the db. Sizes are unknown (0) 
+// for samples, which got stored before sizes got recorded.
 
-  AudioFilesToAdd.Empty();
-  AudioFilesToRemove.Empty();
+static bool SFileChanged(
+  const TFile::TStat& ActualStat,
+  const TFile::TStat& StoredStat)
+{
+  return (ActualStat.mModificationStatTime != StoredStat.mModificationStatTime) ||
+    (StoredStat.mSizeInBytes != 0 && ActualStat.mSizeInBytes != StoredStat.mSizeInBytes);
+}
 
-  // check existing samples in db
-  const TList< TPair<TString, int> > ExistingFiles =
-    pSamplePool->SampleModificationDates();
+// -------------------------------------------------------------------------------------------------
 
-  std::set<TString> ExistingSamplesMap;
+void SDetectChanges(
+  TSampleFileQueue&                                     AudioFiles,
+  const TList<TSampleDescriptorPool::TSampleFileStat>&  ExistingFiles,
+  TSampleFileQueue&                                     AudioFilesToAdd,
+  TList< TPair<TString, TString> >&                     AudioFilesToRename,
+  TList<TString>&                                       AudioFilesToRemove)
+{
+  // map normalized paths and file ids of existing samples in the db to their 
+  // ExistingFiles index. File ids which are used by more than one sample (hard 
+  // links) are ambiguous and marked with index -1.
+  std::unordered_map<std::string, int> ExistingSamplesMap;
+  ExistingSamplesMap.reserve(ExistingFiles.Size());
+
+  std::unordered_map<long long, int> ExistingFileIdsMap;
 
   for (int i = 0; i < ExistingFiles.Size(); ++i)
   {
-    const TString AbsFilename = ExistingFiles[i].First();
+    ExistingSamplesMap.insert(std::make_pair(
+      SNormalizedPathKey(ExistingFiles[i].mFileName), i));
 
-    // add normalized paths to cache
-    ExistingSamplesMap.insert(TString(AbsFilename).ReplaceChar(
-      TDirectory::SWrongPathSeparatorChar(), TDirectory::SPathSeparatorChar()));
+    const long long FileId = ExistingFiles[i].mStat.mFileId;
+    if (FileId != 0 && !ExistingFileIdsMap.insert(std::make_pair(FileId, i)).second)
+    {
+      ExistingFileIdsMap[FileId] = -1;
+    }
+  }
 
-    if (!TFile(AbsFilename).Exists())
+  // guards FoundExistingSamples and MovedFiles while collecting
+  std::mutex Lock;
+  std::vector<char> FoundExistingSamples(ExistingFiles.Size(), false);
+  // new file names and ExistingFiles index of files which probably got moved
+  TList< TPair<TString, int> > MovedFiles;
+
+  // check collected files, while they get collected: stat each file only once, 
+  // and only when it's present in the db or may be a moved one. 
+  SRunInParallel(MDetectChangesThreads, [&]() {
+    TString AudioFile;
+    while (AudioFiles.Pop(AudioFile))
     {
-      AudioFilesToRemove.Append(AbsFilename);
+      // always compare normalized paths: different slashes may be used
+      const TString NormalizedPath = TString(AudioFile).ReplaceChar(
+        TDirectory::SWrongPathSeparatorChar(), TDirectory::SPathSeparatorChar());
+
+      const auto ExistingIter = ExistingSamplesMap.find(
+        NormalizedPath.StdCString(TString::kUtf8));
+
+      if (ExistingIter == ExistingSamplesMap.end())
+      {
+        // a moved file, when an unchanged file with the same id is present in the db
+        TFile::TStat ActualStat;
+        if (!ExistingFileIdsMap.empty() &&
+            TFile(NormalizedPath).Stat(ActualStat) && ActualStat.mFileId != 0)
+        {
+          const auto FileIdIter = ExistingFileIdsMap.find(ActualStat.mFileId);
+          if (FileIdIter != ExistingFileIdsMap.end() && FileIdIter->second != -1 &&
+              !SFileChanged(ActualStat, ExistingFiles[FileIdIter->second].mStat))
+          {
+            // resolved when all files got collected: the old file may still exist
+            const std::lock_guard<std::mutex> MovedFilesLock(Lock);
+            MovedFiles.Append(MakePair(NormalizedPath, FileIdIter->second));
+            continue;
+          }
+        }
+
+        // insert new samples to db
+        if (!AudioFilesToAdd.Push(NormalizedPath))
+        {
+          AudioFiles.Abort();
+          return;
+        }
+      }
+      else 
+      {
+        {
+          const std::lock_guard<std::mutex> FoundSamplesLock(Lock);
+          if (FoundExistingSamples[ExistingIter->second])
+          {
+            continue;
+          }
+          FoundExistingSamples[ExistingIter->second] = true;
+        }
+
+        // does it need to be refreshed?
+        const TSampleDescriptorPool::TSampleFileStat& ExistingFile = 
+          ExistingFiles[ExistingIter->second];
+
+        TFile::TStat ActualStat;
+        if (!TFile(ExistingFile.mFileName).Stat(ActualStat) ||
+            SFileChanged(ActualStat, ExistingFile.mStat))
+        {
+          if (!AudioFilesToAdd.Push(ExistingFile.mFileName))
+          {
+            AudioFiles.Abort();
+            return;
+          }
+        }
+      }
     }
-    else // file in db still exists
+  });
+
+  // don't remove anything when collecting files did not finish
+  if (AudioFiles.IsAborted() || sAbortProcessing)
+  {
+    return;
+  }
+
+  // check existing samples in db, which were not collected
+  std::vector<char> MissingExistingSamples(ExistingFiles.Size(), false);
+  std::atomic<int> NextExistingSampleIndex(0);
+
+  SRunInParallel(MDetectChangesThreads, [&]() {
+    for (int i = NextExistingSampleIndex++; i < ExistingFiles.Size(); 
+          i = NextExistingSampleIndex++)
     {
-      // does it need to be refreshed?
-      const int ActualStatTime = TFile(AbsFilename).ModificationStatTime();
-      const int StoredStatTime = ExistingFiles[i].Second();
-      if (ActualStatTime > StoredStatTime)
+      if (FoundExistingSamples[i])
+      {
+        continue;
+      }
+
+      if (sAbortProcessing || AudioFilesToAdd.IsAborted())
+      {
+        return;
+      }
+
+      TFile::TStat ActualStat;
+      if (!TFile(ExistingFiles[i].mFileName).Stat(ActualStat))
       {
-        AudioFilesToAdd.Append(AbsFilename);
+        MissingExistingSamples[i] = true;
+      }
+      else if (SFileChanged(ActualStat, ExistingFiles[i].mStat))
+      {
+        // file in db still exists, but needs to be refreshed
+        if (!AudioFilesToAdd.Push(ExistingFiles[i].mFileName))
+        {
+          return;
+        }
       }
     }
+  });
+
+  if (AudioFilesToAdd.IsAborted() || sAbortProcessing)
+  {
+    return;
   }
 
-  // insert new samples to db
-  for (int i = 0; i < AudioFiles.Size(); ++i)
+  // move samples of moved files, when their old file no longer exists
+  for (int i = 0; i < MovedFiles.Size(); ++i)
   {
-    // always compare normalized paths: different slashes may be used
-    const TString NormalizedPath = TString(AudioFiles[i]).ReplaceChar(
-      TDirectory::SWrongPathSeparatorChar(), TDirectory::SPathSeparatorChar());
+    const int ExistingIndex = MovedFiles[i].Second();
+
+    if (MissingExistingSamples[ExistingIndex])
+    {
+      // don't move a single sample to multiple new files (copies)
+      MissingExistingSamples[ExistingIndex] = false;
 
-    if (ExistingSamplesMap.find(NormalizedPath) == ExistingSamplesMap.end())
+      AudioFilesToRename.Append(MakePair(
+        ExistingFiles[ExistingIndex].mFileName, MovedFiles[i].First()));
+    }
+    else if (!AudioFilesToAdd.Push(MovedFiles[i].First()))
+    {
+      return;
+    }
+  }
+
+  // remove samples of no longer existing files
+  for (int i = 0; i < ExistingFiles.Size(); ++i)
+  {
+    if (MissingExistingSamples[i])
     {
-      AudioFilesToAdd.Append(NormalizedPath);
+      AudioFilesToRemove.Append(ExistingFiles[i].mFileName);
     }
   }
 }
@@ -234,23 +234,19 @@ int gMain(const TList<TString>& Arguments)
       TList<TSampleClassificationDescriptors> Descriptors;
       Descriptors.PreallocateSpace(NumberOfSamples);
       bool ExtractedFeatureNames = false;
-      for (int i = 0; i < NumberOfSamples; ++i)
-      {
-        if (TOwnerPtr<TSampleDescriptors> pDescriptors = Pool.Sample(i))
+      Pool.ForEachSample([&](const TSampleDescriptors& SampleDescriptors) {
+        // extract feature values by default
+        TSampleClassificationDescriptors::TFeatureExtractionFlags Flags =
+          TSampleClassificationDescriptors::kExtractFeatureValues;
+        if (!ExtractedFeatureNames)
         {
-          // extract feature values by default
-          TSampleClassificationDescriptors::TFeatureExtractionFlags Flags =
-            TSampleClassificationDescriptors::kExtractFeatureValues;
-          if (!ExtractedFeatureNames)
-          {
-            // extract feature names in/with the first entry
-            ExtractedFeatureNames = true;
-            Flags |= TSampleClassificationDescriptors::kExtractFeatureNames;
-          }
-          // add descriptor to the data set
-          Descriptors.Append(TSampleClassificationDescriptors(*pDescriptors, Flags));
+          // extract feature names in/with the first entry
+          ExtractedFeatureNames = true;
+          Flags |= TSampleClassificationDescriptors::kExtractFeatureNames;
         }
-      }
+        // add descriptor to the data set
+        Descriptors.Append(TSampleClassificationDescriptors(SampleDescriptors, Flags));
+      });
 
       // convert to classification test data set
       pTestSet = TOwnerPtr<TClassificationTestDataSet>(
@@ -11,9 +11,16 @@
 #include "CoreFileFormats/Export/ZipFile.h"
 
 #include "FeatureExtraction/Test/TestStatistics.h"
+#include "FeatureExtraction/Test/TestAutocorrelation.h"
+#include "FeatureExtraction/Test/TestSpectrumStatistics.h"
+#include "FeatureExtraction/Test/TestMelCepstrum.h"
+#include "FeatureExtraction/Test/TestSampleAnalysisCache.h"
+#include "FeatureExtraction/Test/TestSampleClassification.h"
 #include "FeatureExtraction/Export/SqliteSampleDescriptorPool.h"
 
 #include "Classification/Test/TestShark.h"
+#include "Classification/Test/TestGbdt.h"
+#include "Classification/Test/TestClassificationModel.h"
 
 #include "CoreFileFormats/Export/CoreFileFormatsInit.h"
 #include "FeatureExtraction/Export/FeatureExtractionInit.h"
@@ -62,6 +69,8 @@ namespace TCrawlerTests
   TString ModelCreatorExePathAndName();
 
   void Crawler();
+  void CrawlerFileChanges();
+  void CrawlerClassificationLevel();
   void ClassificationModel();
 
   boost::unit_test::test_suite* RegisterUnitTests(int, char*[]);
@@ -174,7 +183,44 @@ void TCrawlerTests::Crawler()
       {
         TString ColumnContent;
 
-        if (ColumnType == "BLOB")
+        if (ColumnType == "BLOB" && TSqliteSampleDescriptorPool::SIsRawArrayBlob(
+              pRawColumnContent, RawColumnContentSize))
+        {
+          // deserialize raw number array blob
+          TList< TList<double> > Rows;
+          BOOST_CHECK_NO_THROW(Rows = TSqliteSampleDescriptorPool::SDecodeRawArrayBlob(
+            ColumnName, pRawColumnContent, RawColumnContentSize));
+
+          // convert rows to JSON, so we can always test with JSON below
+          std::stringstream TempStream;
+          TempStream.precision(17);
+
+          const bool IsVector = ColumnName.EndsWith("_VR");
+          if (IsVector)
+          {
+            BOOST_CHECK_EQUAL(Rows.Size(), 1);
+          }
+          else
+          {
+            TempStream << "[";
+          }
+          for (int r = 0; r < Rows.Size(); ++r)
+          {
+            TempStream << (r > 0 ? ",[" : "[");
+            for (int c = 0; c < Rows[r].Size(); ++c)
+            {
+              TempStream << (c > 0 ? "," : "") << Rows[r][c];
+            }
+            TempStream << "]";
+          }
+          if (!IsVector)
+          {
+            TempStream << "]";
+          }
+
+          ColumnContent = TString(TempStream.str().c_str(), TString::kUtf8);
+        }
+        else if (ColumnType == "BLOB")
         {
           // deserialize msgpack blob
           msgpack::object_handle MsgPackObjectHandle = msgpack::unpack(
@@ -267,6 +313,20 @@ void TCrawlerTests::Crawler()
             }
           }
         }
+        else if (ColumnName == "filesize" || ColumnName == "fileid")
+        {
+          // file stats are integers: succeeded samples never are empty, and
+          // file ids are 0 when unknown
+          BOOST_CHECK_EQUAL(ColumnType, "INTEGER");
+          if (ColumnName == "filesize")
+          {
+            BOOST_CHECK(DbStatement.ColumnInt64(ColumnIndex) > 0);
+          }
+          else
+          {
+            BOOST_CHECK(DbStatement.ColumnInt64(ColumnIndex) >= 0);
+          }
+        }
         else
         {
           // unexpected column name
@@ -424,6 +484,298 @@ void TCrawlerTests::Crawler()
 
 // -------------------------------------------------------------------------------------------------
 
+void TCrawlerTests::CrawlerFileChanges()
+{
+  BOOST_TEST_MESSAGE("  Testing Crawler file changes...");
+
+  const bool WaitTilProcessFinished = true;
+  int LaunchResult;
+
+
+  // ... resolve crawler exe path and copy a few "train" samples to a temp folder
+
+  const TString CrawlerExePath = CrawlerExePathAndName();
+  BOOST_CHECK(TFile(CrawlerExePath).ExistsIgnoreCase());
+
+  const TDirectory SampleKicksFolder =
+    gApplicationResourceDir().Descend("Kicks-vs-Snare-Train").Descend("Kicks");
+  BOOST_CHECK(SampleKicksFolder.ExistsIgnoreCase());
+
+  const TDirectory SampleFolder = gTempDir().Descend("CrawlerFileChanges");
+  if (SampleFolder.Exists())
+  {
+    BOOST_CHECK(SampleFolder.Unlink());
+  }
+  BOOST_REQUIRE(SampleFolder.Create());
+
+  TList<TString> SampleFileNames = SampleKicksFolder.FindFileNames(
+    MakeList<TString>("*.wav"));
+  SampleFileNames.Sort();
+
+  TList<TString> CopiedFileNames;
+  for (int i = 0; i < SampleFileNames.Size() && CopiedFileNames.Size() < 3; ++i)
+  {
+    if (!SampleFileNames[i].StartsWith("._"))
+    {
+      BOOST_CHECK(gCopyFile(SampleKicksFolder.Path() + SampleFileNames[i],
+        SampleFolder.Path() + SampleFileNames[i]));
+      CopiedFileNames.Append(SampleFileNames[i]);
+    }
+  }
+  BOOST_REQUIRE_EQUAL(CopiedFileNames.Size(), 3);
+
+  const TString DescriptorDb = SampleFolder.Path() + "afec-ll.db";
+
+  const TList<TString> CrawlerArguments = MakeList<TString>(
+    "-l", "low",
+    "-o", DescriptorDb,
+    SampleFolder.Path()
+  );
+
+
+  // ... create db and check file stats
+
+  BOOST_TEST_INFO("    Creating low level descriptors...");
+
+  LaunchResult = TSystem::LaunchProcess(CrawlerExePath,
+    CrawlerArguments, WaitTilProcessFinished);
+
+  BOOST_CHECK(LaunchResult == EXIT_SUCCESS);
+  BOOST_REQUIRE(TFile(DescriptorDb).Exists());
+
+  {
+    TDatabase Database;
+    BOOST_REQUIRE(Database.Open(DescriptorDb));
+
+    TDatabase::TStatement DbStatement(Database,
+      "SELECT filename, filesize, fileid FROM assets WHERE status='succeeded';");
+
+    int NumberOfSamples = 0;
+    while (DbStatement.Step())
+    {
+      // paths are relative to the db
+      const TString FileName = DbStatement.ColumnText(0);
+      BOOST_CHECK(CopiedFileNames.Contains(FileName));
+
+      TFile::TStat Stat;
+      BOOST_CHECK(TFile(SampleFolder.Path() + FileName).Stat(Stat));
+      BOOST_CHECK_EQUAL(DbStatement.ColumnInt64(1), Stat.mSizeInBytes);
+      BOOST_CHECK_EQUAL(DbStatement.ColumnInt64(2), Stat.mFileId);
+
+      ++NumberOfSamples;
+    }
+
+    BOOST_CHECK_EQUAL(NumberOfSamples, 3);
+
+    // mark all rows, so we can detect which ones got analyzed again
+    Database.Execute("UPDATE assets SET file_type_S='unchanged';");
+  }
+
+
+  // ... rename and delete a file, then update the db
+
+  BOOST_TEST_INFO("    Updating low level descriptors...");
+
+  const TString UnchangedFileName = CopiedFileNames[0];
+  const TString RenamedFileName = CopiedFileNames[1];
+  const TString NewFileName = "Renamed " + RenamedFileName;
+  const TString DeletedFileName = CopiedFileNames[2];
+
+  BOOST_CHECK(gRenameDirOrFile(SampleFolder.Path() + RenamedFileName,
+    SampleFolder.Path() + NewFileName));
+  BOOST_CHECK(TFile(SampleFolder.Path() + DeletedFileName).Unlink());
+
+  LaunchResult = TSystem::LaunchProcess(CrawlerExePath,
+    CrawlerArguments, WaitTilProcessFinished);
+
+  BOOST_CHECK(LaunchResult == EXIT_SUCCESS);
+
+  {
+    TDatabase Database;
+    BOOST_REQUIRE(Database.Open(DescriptorDb));
+
+    TDatabase::TStatement DbStatement(Database,
+      "SELECT filename, file_type_S FROM assets;");
+
+    TList<TString> FileNames;
+    while (DbStatement.Step())
+    {
+      const TString FileName = DbStatement.ColumnText(0);
+      FileNames.Append(FileName);
+
+      if (FileName == UnchangedFileName)
+      {
+        BOOST_CHECK_EQUAL(DbStatement.ColumnText(1), "unchanged");
+      }
+      else if (FileName == NewFileName)
+      {
+        #if !defined(MWindows)
+          // moved rows must be renamed, not analyzed again
+          BOOST_CHECK_EQUAL(DbStatement.ColumnText(1), "unchanged");
+        #else
+          // file ids are not available on Windows: moved files get analyzed again
+          BOOST_CHECK(DbStatement.ColumnText(1) != "unchanged");
+        #endif
+      }
+    }
+
+    // deleted and renamed files' rows must be removed
+    BOOST_CHECK_EQUAL(FileNames.Size(), 2);
+    BOOST_CHECK(FileNames.Contains(UnchangedFileName));
+    BOOST_CHECK(FileNames.Contains(NewFileName));
+    BOOST_CHECK(!FileNames.Contains(RenamedFileName));
+    BOOST_CHECK(!FileNames.Contains(DeletedFileName));
+  }
+
+  BOOST_CHECK(SampleFolder.Unlink());
+}
+
+// -------------------------------------------------------------------------------------------------
+
+void TCrawlerTests::CrawlerClassificationLevel()
+{
+  BOOST_TEST_MESSAGE("  Testing Crawler classification level...");
+
+  const bool WaitTilProcessFinished = true;
+  int LaunchResult;
+
+  // VR column content as numbers: raw number arrays or msgpack arrays
+  auto ColumnNumbers = [] (
+    TDatabase::TStatement&  DbStatement,
+    int                     ColumnIndex) {
+
+    int RawColumnContentSize = 0;
+    const void* pRawColumnContent = DbStatement.ColumnBlob(
+      ColumnIndex, RawColumnContentSize);
+
+    std::vector<double> Numbers;
+    if (TSqliteSampleDescriptorPool::SIsRawArrayBlob(
+          pRawColumnContent, RawColumnContentSize))
+    {
+      const TList< TList<double> > Rows = TSqliteSampleDescriptorPool::SDecodeRawArrayBlob(
+        DbStatement.ColumnName(ColumnIndex), pRawColumnContent, RawColumnContentSize);
+      if (Rows.Size() == 1)
+      {
+        Numbers.assign(Rows[0].FirstRead(), Rows[0].FirstRead() + Rows[0].Size());
+      }
+    }
+    else if (RawColumnContentSize > 0)
+    {
+      msgpack::object_handle MsgPackObjectHandle = msgpack::unpack(
+        (const char*)pRawColumnContent, (size_t)RawColumnContentSize);
+      MsgPackObjectHandle.get().convert(Numbers);
+    }
+
+    return Numbers;
+  };
+
+
+  // ... resolve crawler exe path and "test" folder
+
+  const TString CrawlerExePath = CrawlerExePathAndName();
+  BOOST_CHECK(TFile(CrawlerExePath).ExistsIgnoreCase());
+
+  const TDirectory SampleTestFolder =
+    gApplicationResourceDir().Descend("Kicks-vs-Snare-Test");
+  BOOST_CHECK(SampleTestFolder.ExistsIgnoreCase());
+
+  const TDirectory DatabaseFolder = gTempDir().Descend("CrawlerClassificationLevel");
+  if (DatabaseFolder.Exists())
+  {
+    BOOST_CHECK(DatabaseFolder.Unlink());
+  }
+  BOOST_REQUIRE(DatabaseFolder.Create());
+
+
+  // ... create high level and classification dbs with the default models
+
+  BOOST_TEST_INFO("    Creating high level and classification descriptors...");
+
+  const TString HighLevelDescriptorDb = DatabaseFolder.Path() + "afec.db";
+  const TString ClassificationDescriptorDb = DatabaseFolder.Path() + "afec-classes.db";
+
+  LaunchResult = TSystem::LaunchProcess(CrawlerExePath,
+    MakeList<TString>(
+      "-l", "high",
+      "-o", HighLevelDescriptorDb,
+      SampleTestFolder.Path()
+    ),
+    WaitTilProcessFinished);
+
+  BOOST_CHECK(LaunchResult == EXIT_SUCCESS);
+  BOOST_REQUIRE(TFile(HighLevelDescriptorDb).Exists());
+
+  LaunchResult = TSystem::LaunchProcess(CrawlerExePath,
+    MakeList<TString>(
+      "-l", "classify",
+      "-o", ClassificationDescriptorDb,
+      SampleTestFolder.Path()
+    ),
+    WaitTilProcessFinished);
+
+  BOOST_CHECK(LaunchResult == EXIT_SUCCESS);
+  BOOST_REQUIRE(TFile(ClassificationDescriptorDb).Exists());
+
+
+  // ... class and category columns must match
+
+  BOOST_TEST_INFO("    Comparing class and category columns...");
+  {
+    TDatabase HighLevelDatabase;
+    BOOST_REQUIRE(HighLevelDatabase.Open(HighLevelDescriptorDb));
+
+    TDatabase ClassificationDatabase;
+    BOOST_REQUIRE(ClassificationDatabase.Open(ClassificationDescriptorDb));
+
+    const char* pQuery = 
+      "SELECT filename, classes_VS, categories_VS, class_signature_VR, "
+      "class_strengths_VR, category_signature_VR, category_strengths_VR "
+      "FROM assets WHERE status='succeeded' ORDER BY filename;";
+
+    TDatabase::TStatement HighLevelStatement(HighLevelDatabase, pQuery);
+    TDatabase::TStatement ClassificationStatement(ClassificationDatabase, pQuery);
+
+    int NumberOfSamples = 0;
+    while (HighLevelStatement.Step())
+    {
+      BOOST_REQUIRE(ClassificationStatement.Step());
+
+      const TString FileName = HighLevelStatement.ColumnText(0);
+      BOOST_TEST_CONTEXT("file: " << FileName.StdCString())
+      {
+        BOOST_CHECK_EQUAL(ClassificationStatement.ColumnText(0), FileName);
+
+        // class and category names
+        for (int Column = 1; Column <= 2; ++Column)
+        {
+          BOOST_CHECK_EQUAL(ClassificationStatement.ColumnText(Column),
+            HighLevelStatement.ColumnText(Column));
+        }
+
+        // signatures and strengths
+        for (int Column = 3; Column <= 6; ++Column)
+        {
+          const std::vector<double> Expected = ColumnNumbers(HighLevelStatement, Column);
+          const std::vector<double> Numbers = ColumnNumbers(ClassificationStatement, Column);
+
+          BOOST_CHECK(!Expected.empty());
+          BOOST_CHECK_ARRAYS_EQUAL_EPSILON(Numbers, (int)Numbers.size(),
+            Expected, (int)Expected.size(), 1e-6);
+        }
+      }
+
+      ++NumberOfSamples;
+    }
+
+    BOOST_CHECK(NumberOfSamples > 0);
+    BOOST_CHECK(!ClassificationStatement.Step());
+  }
+
+  BOOST_CHECK(DatabaseFolder.Unlink());
+}
+
+// -------------------------------------------------------------------------------------------------
+
 void TCrawlerTests::ClassificationModel()
 {
   BOOST_TEST_MESSAGE("  Testing ClassificationModel...");
@@ -627,6 +979,11 @@ boost::unit_test::test_suite* TCrawlerTests::RegisterUnitTests(int, char*[])
   boost::unit_test::test_suite* pFeatureExtractionTest = BOOST_TEST_SUITE("FeatureExtraction");
   {
     pFeatureExtractionTest->add(BOOST_TEST_CASE(TFeatureExtractionTest::Statistics));
+    pFeatureExtractionTest->add(BOOST_TEST_CASE(TFeatureExtractionTest::Autocorrelation));
+    pFeatureExtractionTest->add(BOOST_TEST_CASE(TFeatureExtractionTest::SpectrumStatistics));
+    pFeatureExtractionTest->add(BOOST_TEST_CASE(TFeatureExtractionTest::MelCepstrum));
+    pFeatureExtractionTest->add(BOOST_TEST_CASE(TFeatureExtractionTest::SampleAnalysisCache));
+    pFeatureExtractionTest->add(BOOST_TEST_CASE(TFeatureExtractionTest::SampleClassification));
   }
   boost::unit_test::framework::master_test_suite().add(pFeatureExtractionTest);
 
@@ -639,6 +996,9 @@ boost::unit_test::test_suite* TCrawlerTests::RegisterUnitTests(int, char*[])
       }));
 
     pCoreMachinelearningTests->add(BOOST_TEST_CASE(TClassificationTest::Shark));
+    pCoreMachinelearningTests->add(BOOST_TEST_CASE(TClassificationTest::Gbdt));
+    pCoreMachinelearningTests->add(BOOST_TEST_CASE(TClassificationTest::FeatureNormalization));
+    pCoreMachinelearningTests->add(BOOST_TEST_CASE(TClassificationTest::FeatureRowEvaluation));
   }
   boost::unit_test::framework::master_test_suite().add(pCoreMachinelearningTests);
 
@@ -647,6 +1007,8 @@ boost::unit_test::test_suite* TCrawlerTests::RegisterUnitTests(int, char*[])
   boost::unit_test::test_suite* pCrawlerTest = BOOST_TEST_SUITE("Crawler");
   {
     pCrawlerTest->add(BOOST_TEST_CASE(Crawler));
+    pCrawlerTest->add(BOOST_TEST_CASE(CrawlerFileChanges));
+    pCrawlerTest->add(BOOST_TEST_CASE(CrawlerClassificationLevel));
   }
   boost::unit_test::framework::master_test_suite().add(pCrawlerTest);
 
@@ -658,6 +1020,16 @@ boost::unit_test::test_suite* TCrawlerTests::RegisterUnitTests(int, char*[])
   }
   boost::unit_test::framework::master_test_suite().add(pClassificationModelTest);
 
+  // . Benchmarks
+
+  // disabled by default: run them explicitly with --run_test=Benchmarks
+  boost::unit_test::test_suite* pBenchmarkTest = BOOST_TEST_SUITE("Benchmarks");
+  {
+    pBenchmarkTest->add(BOOST_TEST_CASE(TFeatureExtractionTest::MelCepstrumBenchmark));
+  }
+  pBenchmarkTest->p_default_status.value = boost::unit_test::test_unit::RS_DISABLED;
+  boost::unit_test::framework::master_test_suite().add(pBenchmarkTest);
+
   return NULL;
 }
 